@@ -23,4 +23,171 @@
 
 #define TEST_NAME "_dl_new_hash"
 
+#include "json-lib.h"
+#define EXTRA_TESTS do_dlsym_tests
+static void do_dlsym_tests (json_ctx_t *json_ctx);
+
 #include "bench-hash-funcs.c"
+
+#include <dlfcn.h>
+#include <gnu/lib-names.h>
+#include <link.h>
+
+/* Besides the hash function, measure the whole symbol lookup, which is
+   done the same way for dlsym and for the relocations at startup:
+   look up all the symbols defined by libc.so in it, in the global
+   scope, and look up names which are not defined.  */
+
+enum { NDLSYM_ITERS = 16 };
+
+/* Return the number of symbols in the dynamic symbol table with the
+   DT_GNU_HASH table GNU_HASH.  */
+static size_t
+gnu_hash_nsyms (const Elf32_Word *gnu_hash)
+{
+  Elf32_Word nbuckets = gnu_hash[0];
+  Elf32_Word symbias = gnu_hash[1];
+  Elf32_Word bitmask_nwords = gnu_hash[2];
+  const Elf32_Word *buckets
+    = (const Elf32_Word *) ((const ElfW(Addr) *) &gnu_hash[4]
+			    + bitmask_nwords);
+  const Elf32_Word *chain_zero = &buckets[nbuckets] - symbias;
+
+  Elf32_Word last = 0;
+  for (Elf32_Word i = 0; i < nbuckets; ++i)
+    if (buckets[i] > last)
+      last = buckets[i];
+  if (last == 0)
+    return symbias;
+  while ((chain_zero[last] & 1) == 0)
+    ++last;
+  return last + 1;
+}
+
+/* Return the names of the global symbols defined by L, and store their
+   number in *COUNT.  */
+static const char **
+defined_names (struct link_map *l, size_t *count)
+{
+  const ElfW(Sym) *symtab = NULL;
+  const char *strtab = NULL;
+  const Elf32_Word *gnu_hash = NULL;
+  const ElfW(Half) *versym = NULL;
+  for (const ElfW(Dyn) *d = l->l_ld; d->d_tag != DT_NULL; ++d)
+    {
+      /* Some targets do not relocate the dynamic section.  */
+      ElfW(Addr) ptr = d->d_un.d_ptr;
+      if (ptr < l->l_addr)
+	ptr += l->l_addr;
+      if (d->d_tag == DT_SYMTAB)
+	symtab = (const ElfW(Sym) *) ptr;
+      else if (d->d_tag == DT_STRTAB)
+	strtab = (const char *) ptr;
+      else if (d->d_tag == DT_GNU_HASH)
+	gnu_hash = (const Elf32_Word *) ptr;
+      else if (d->d_tag == DT_VERSYM)
+	versym = (const ElfW(Half) *) ptr;
+    }
+
+  *count = 0;
+  if (symtab == NULL || strtab == NULL || gnu_hash == NULL)
+    return NULL;
+
+  size_t nsyms = gnu_hash_nsyms (gnu_hash);
+  const char **names = calloc (nsyms, sizeof (*names));
+  if (names == NULL)
+    return NULL;
+  /* The ELF32 macros work for both classes.  IFUNC symbols are skipped,
+     as dlsym calls their resolver, and so are hidden versions, which
+     dlsym does not find.  */
+  for (size_t i = 0; i < nsyms; ++i)
+    if (symtab[i].st_shndx != SHN_UNDEF && symtab[i].st_name != 0
+	&& (versym == NULL || (versym[i] & 0x8000) == 0)
+	&& (ELF32_ST_BIND (symtab[i].st_info) == STB_GLOBAL
+	    || ELF32_ST_BIND (symtab[i].st_info) == STB_WEAK)
+	&& ELF32_ST_TYPE (symtab[i].st_info) != STT_GNU_IFUNC)
+      names[(*count)++] = strtab + symtab[i].st_name;
+  return names;
+}
+
+static double __attribute_optimization_barrier__
+do_dlsym_kernel (void *handle, const char **names, size_t count)
+{
+  timing_t start, stop, cur;
+
+  /* Warmup.  */
+  for (size_t i = 0; i < count; ++i)
+    DO_NOT_OPTIMIZE_OUT (dlsym (handle, names[i]));
+
+  TIMING_NOW (start);
+  for (unsigned int iters = NDLSYM_ITERS; iters; --iters)
+    for (size_t i = 0; i < count; ++i)
+      DO_NOT_OPTIMIZE_OUT (dlsym (handle, names[i]));
+  TIMING_NOW (stop);
+
+  TIMING_DIFF (cur, start, stop);
+  return (double) cur / (double) (NDLSYM_ITERS * count);
+}
+
+static void
+do_one_dlsym_test (json_ctx_t *json_ctx, const char *type, void *handle,
+		   const char **names, size_t count)
+{
+  json_element_object_begin (json_ctx);
+  json_attr_string (json_ctx, "type", type);
+  json_attr_uint (json_ctx, "symbols", count);
+  json_attr_double (json_ctx, "time", do_dlsym_kernel (handle, names,
+							  count));
+  json_element_object_end (json_ctx);
+}
+
+static void
+do_dlsym_tests (json_ctx_t *json_ctx)
+{
+  void *handle = dlopen (LIBC_SO, RTLD_LAZY | RTLD_NOLOAD);
+  struct link_map *l;
+  if (handle == NULL || dlinfo (handle, RTLD_DI_LINKMAP, &l) != 0)
+    {
+      fprintf (stderr, "Failed to find %s: %s\n", LIBC_SO, dlerror ());
+      return;
+    }
+
+  size_t count;
+  const char **names = defined_names (l, &count);
+  if (names == NULL || count == 0)
+    {
+      fprintf (stderr, "Failed to read the symbols of %s\n", LIBC_SO);
+      goto done;
+    }
+
+  /* The same names with a suffix, which are usually rejected by the
+     Bloom filter, but sometimes need a scan of the hash chain.  */
+  const char **missing = calloc (count, sizeof (*missing));
+  if (missing == NULL)
+    goto done;
+  for (size_t i = 0; i < count; ++i)
+    {
+      size_t len = strlen (names[i]);
+      char *name = malloc (len + sizeof "_missing");
+      if (name == NULL)
+	{
+	  count = i;
+	  break;
+	}
+      memcpy (name, names[i], len);
+      memcpy (name + len, "_missing", sizeof "_missing");
+      missing[i] = name;
+    }
+
+  do_one_dlsym_test (json_ctx, "dlsym-object", handle, names, count);
+  do_one_dlsym_test (json_ctx, "dlsym-default", RTLD_DEFAULT, names, count);
+  do_one_dlsym_test (json_ctx, "dlsym-missing", handle, missing, count);
+
+  for (size_t i = 0; i < count; ++i)
+    free ((char *) missing[i]);
+  free (missing);
+
+done:
+  free (names);
+  dlclose (handle);
+}
@@ -132,6 +132,10 @@ do_test (void)
 
   do_rand_test (&json_ctx);
 
+#ifdef EXTRA_TESTS
+  EXTRA_TESTS (&json_ctx);
+#endif
+
   json_array_end (&json_ctx);
   json_attr_object_end (&json_ctx);
   json_attr_object_end (&json_ctx);
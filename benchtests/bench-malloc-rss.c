@@ -0,0 +1,222 @@
+/* Benchmark the resident memory of malloc over a bursty workload.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The workload alternates between bursts, which allocate and touch many
+   blocks and then free most of them, and quiet periods with a small
+   working set, as in a server handling occasional large requests.  The
+   blocks kept from each burst fragment the heap, so that the freed
+   memory cannot be returned by trimming the top of the heap.  The
+   resident set size is sampled at a fixed interval; run the benchmark
+   with different glibc.malloc.purge_* tunables to compare how quickly
+   freed memory is returned to the system.  */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "bench-timing.h"
+#include "json-lib.h"
+
+#define RAND_SEED		88
+
+/* Number of bursts.  */
+#define NUM_BURSTS		8
+/* Blocks allocated by each burst, of which one in KEEP_RATIO is kept
+   until the end of the benchmark.  */
+#define BURST_BLOCKS		16384
+#define KEEP_RATIO		16
+/* Length of the quiet period after each burst, in milliseconds.  */
+#define QUIET_MS		500
+/* Blocks in the working set of the quiet periods.  */
+#define QUIET_BLOCKS		256
+
+#define MIN_ALLOCATION_SIZE	32
+#define MAX_ALLOCATION_SIZE	8192
+
+/* Interval between samples of the resident set size, in milliseconds.  */
+#define SAMPLE_MS		10
+#define MAX_SAMPLES \
+  (NUM_BURSTS * (QUIET_MS / SAMPLE_MS + 16) + 16)
+
+static size_t samples[MAX_SAMPLES];
+static size_t num_samples;
+static uint64_t next_sample;
+
+static uint64_t
+now_ms (void)
+{
+  struct timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Return the resident set size in kilobytes.  */
+static size_t
+get_rss (void)
+{
+  char buf[128];
+  int fd = open ("/proc/self/statm", O_RDONLY);
+  if (fd < 0)
+    return 0;
+  ssize_t n = read (fd, buf, sizeof (buf) - 1);
+  close (fd);
+  if (n <= 0)
+    return 0;
+  buf[n] = '\0';
+
+  unsigned long int size, resident;
+  if (sscanf (buf, "%lu %lu", &size, &resident) != 2)
+    return 0;
+  return resident * (sysconf (_SC_PAGESIZE) / 1024);
+}
+
+static void
+maybe_sample (void)
+{
+  uint64_t now = now_ms ();
+  if (now >= next_sample && num_samples < MAX_SAMPLES)
+    {
+      samples[num_samples++] = get_rss ();
+      next_sample = now + SAMPLE_MS;
+    }
+}
+
+static size_t
+random_size (void)
+{
+  return MIN_ALLOCATION_SIZE
+	 + rand () % (MAX_ALLOCATION_SIZE - MIN_ALLOCATION_SIZE);
+}
+
+static void *burst[BURST_BLOCKS];
+static void *kept[NUM_BURSTS * (BURST_BLOCKS / KEEP_RATIO)];
+static void *quiet[QUIET_BLOCKS];
+
+static void
+do_burst (size_t n)
+{
+  for (size_t i = 0; i < BURST_BLOCKS; i++)
+    {
+      size_t size = random_size ();
+      burst[i] = malloc (size);
+      memset (burst[i], i & 0xff, size);
+      if (i % 1024 == 0)
+	maybe_sample ();
+    }
+
+  for (size_t i = 0; i < BURST_BLOCKS; i++)
+    if (i % KEEP_RATIO == 0)
+      kept[n * (BURST_BLOCKS / KEEP_RATIO) + i / KEEP_RATIO] = burst[i];
+    else
+      free (burst[i]);
+}
+
+static size_t
+do_quiet (void)
+{
+  uint64_t end = now_ms () + QUIET_MS;
+  size_t iters = 0;
+  struct timespec pause = { 0, 100000 };
+
+  while (now_ms () < end)
+    {
+      size_t idx = rand () % QUIET_BLOCKS;
+      free (quiet[idx]);
+      quiet[idx] = malloc (random_size ());
+      iters++;
+      maybe_sample ();
+      nanosleep (&pause, NULL);
+    }
+
+  return iters;
+}
+
+int
+main (int argc, char **argv)
+{
+  json_ctx_t json_ctx;
+  timing_t start, stop, elapsed;
+  size_t iters = 0;
+
+  srand (RAND_SEED);
+
+  TIMING_NOW (start);
+  for (size_t i = 0; i < NUM_BURSTS; i++)
+    {
+      do_burst (i);
+      iters += BURST_BLOCKS + do_quiet ();
+    }
+  TIMING_NOW (stop);
+  TIMING_DIFF (elapsed, start, stop);
+
+  size_t peak = 0, total = 0;
+  for (size_t i = 0; i < num_samples; i++)
+    {
+      if (samples[i] > peak)
+	peak = samples[i];
+      total += samples[i];
+    }
+
+  json_init (&json_ctx, 0, stdout);
+
+  json_document_begin (&json_ctx);
+
+  json_attr_string (&json_ctx, "timing_type", TIMING_TYPE);
+
+  json_attr_object_begin (&json_ctx, "functions");
+
+  json_attr_object_begin (&json_ctx, "malloc");
+
+  json_attr_object_begin (&json_ctx, "rss");
+
+  json_attr_double (&json_ctx, "duration", elapsed);
+  json_attr_double (&json_ctx, "iterations", iters);
+  json_attr_double (&json_ctx, "time_per_iteration", (double) elapsed / iters);
+  json_attr_double (&json_ctx, "sample_interval_ms", SAMPLE_MS);
+  json_attr_double (&json_ctx, "peak_rss_kb", peak);
+  json_attr_double (&json_ctx, "mean_rss_kb",
+		    num_samples > 0 ? (double) total / num_samples : 0);
+  json_attr_double (&json_ctx, "final_rss_kb", get_rss ());
+  json_attr_double (&json_ctx, "random_seed", RAND_SEED);
+
+  json_array_begin (&json_ctx, "rss_kb");
+  for (size_t i = 0; i < num_samples; i++)
+    json_element_uint (&json_ctx, samples[i]);
+  json_array_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  json_document_end (&json_ctx);
+
+  for (size_t i = 0; i < QUIET_BLOCKS; i++)
+    free (quiet[i]);
+  for (size_t i = 0; i < NUM_BURSTS * (BURST_BLOCKS / KEEP_RATIO); i++)
+    free (kept[i]);
+
+  return 0;
+}
@@ -0,0 +1,189 @@
+/* Benchmark free against free_sized.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <malloc.h>
+#include "bench-timing.h"
+#include "json-lib.h"
+
+/* Benchmark the deallocation of blocks of a given size with free and with
+   free_sized, which is what C++ operator delete (void *, size_t) calls
+   when sized deallocation is enabled.  Each object is freed in the reverse
+   order of allocation, as when destroying a container, or in the order
+   of allocation, as when draining a queue.  The benchmark runs on the
+   main arena and on a thread arena.  */
+
+#define NUM_ITERS 5000000
+#define NUM_ALLOCS 4
+#define MAX_ALLOCS 1600
+
+typedef struct
+{
+  size_t iters;
+  size_t size;
+  int n;
+  int sized;
+  int fifo;
+  timing_t elapsed;
+} malloc_args;
+
+static void
+do_benchmark (malloc_args *args, void **arr)
+{
+  timing_t start, stop;
+  size_t iters = args->iters;
+  size_t size = args->size;
+  int n = args->n;
+
+  TIMING_NOW (start);
+
+  for (int j = 0; j < iters; j++)
+    {
+      for (int i = 0; i < n; i++)
+	arr[i] = malloc (size);
+
+      if (args->sized)
+	for (int i = 0; i < n; i++)
+	  free_sized (arr[args->fifo ? i : n - 1 - i], size);
+      else
+	for (int i = 0; i < n; i++)
+	  free (arr[args->fifo ? i : n - 1 - i]);
+    }
+
+  TIMING_NOW (stop);
+
+  TIMING_DIFF (args->elapsed, start, stop);
+}
+
+/* Indexed by arena (main, thread), function (free, free_sized), order
+   (LIFO, FIFO) and number of objects.  */
+static malloc_args tests[2][2][2][NUM_ALLOCS];
+static int allocs[NUM_ALLOCS] = { 25, 100, 400, MAX_ALLOCS };
+
+static void
+run_arena (int arena, void **arr)
+{
+  for (int sized = 0; sized < 2; sized++)
+    for (int fifo = 0; fifo < 2; fifo++)
+      for (int i = 0; i < NUM_ALLOCS; i++)
+	do_benchmark (&tests[arena][sized][fifo][i], arr);
+}
+
+static void *
+thread_test (void *p)
+{
+  run_arena (1, p);
+  return p;
+}
+
+void
+bench (unsigned long size)
+{
+  size_t iters = NUM_ITERS;
+  void **arr = malloc (MAX_ALLOCS * sizeof (void*));
+
+  for (int a = 0; a < 2; a++)
+    for (int sized = 0; sized < 2; sized++)
+      for (int fifo = 0; fifo < 2; fifo++)
+	for (int i = 0; i < NUM_ALLOCS; i++)
+	  {
+	    malloc_args *t = &tests[a][sized][fifo][i];
+	    t->n = allocs[i];
+	    t->size = size;
+	    t->sized = sized;
+	    t->fifo = fifo;
+	    t->iters = iters / allocs[i];
+
+	    /* Do a quick warmup run.  */
+	    if (a == 0)
+	      do_benchmark (t, arr);
+	  }
+
+  /* Run benchmark in main_arena.  */
+  run_arena (0, arr);
+
+  /* Run benchmark in a thread_arena.  */
+  pthread_t t;
+  pthread_create (&t, NULL, thread_test, arr);
+  pthread_join (t, NULL);
+
+  free (arr);
+
+  json_ctx_t json_ctx;
+
+  json_init (&json_ctx, 0, stdout);
+
+  json_document_begin (&json_ctx);
+
+  json_attr_string (&json_ctx, "timing_type", TIMING_TYPE);
+
+  json_attr_object_begin (&json_ctx, "functions");
+
+  json_attr_object_begin (&json_ctx, "free_sized");
+
+  char s[100];
+  double iters2 = iters;
+  static const char *const arenas[2] = { "main_arena", "thread_arena" };
+  static const char *const funcs[2] = { "free", "free_sized" };
+  static const char *const orders[2] = { "lifo", "fifo" };
+
+  json_attr_object_begin (&json_ctx, "");
+  json_attr_double (&json_ctx, "malloc_block_size", size);
+
+  for (int a = 0; a < 2; a++)
+    for (int sized = 0; sized < 2; sized++)
+      for (int fifo = 0; fifo < 2; fifo++)
+	for (int i = 0; i < NUM_ALLOCS; i++)
+	  {
+	    sprintf (s, "%s_%s_%s_allocs_%04d_time", arenas[a], funcs[sized],
+		     orders[fifo], allocs[i]);
+	    json_attr_double (&json_ctx, s,
+			      tests[a][sized][fifo][i].elapsed / iters2);
+	  }
+
+  json_attr_object_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  json_document_end (&json_ctx);
+}
+
+static void usage (const char *name)
+{
+  fprintf (stderr, "%s: <alloc_size>\n", name);
+  exit (1);
+}
+
+int
+main (int argc, char **argv)
+{
+  long val = 16;
+  if (argc == 2)
+    val = strtol (argv[1], NULL, 0);
+
+  if (argc > 2 || val <= 0)
+    usage (argv[0]);
+
+  bench (val);
+
+  return 0;
+}
@@ -198,6 +198,57 @@ do_random_tests (json_ctx_t *json_ctx)
     }
 }
 
+/* Test needles longer than a vector register, which are not found
+   anywhere else in the haystack.  */
+static void
+do_long_tests (json_ctx_t *json_ctx)
+{
+  char *ne = (char *) buf2;
+
+  for (size_t len = 33; len <= 1024; len = 2 * len - 1)
+    for (size_t j = 0; j < 120; j += 37)
+      {
+	for (size_t i = 0; i < len; i++)
+	  ne[i] = 60 + random () % 32;
+
+	do_test (json_ctx, ne, len, BUF1PAGES * page_size / 2 + j);
+      }
+}
+
+/* Needles whose first and last characters match at every position of the
+   haystack, so that filtering on them does not help: the search has to
+   compare the rest of the needle everywhere or use another algorithm.  */
+static void
+do_hard_tests (json_ctx_t *json_ctx)
+{
+  char *ne = (char *) buf2;
+  size_t hs_len = BUF1PAGES * page_size;
+
+  memset (buf1, 'a', hs_len);
+  for (size_t len = 4; len <= 1024; len *= 4)
+    {
+      memset (ne, 'a', len);
+      ne[len / 2] = 'b';
+
+      json_element_object_begin (json_ctx);
+      json_attr_uint (json_ctx, "len_haystack", hs_len);
+      json_attr_uint (json_ctx, "len_needle", len);
+      json_attr_uint (json_ctx, "haystack_ptr", (uintptr_t) buf1);
+      json_attr_uint (json_ctx, "needle_ptr", (uintptr_t) ne);
+      json_attr_uint (json_ctx, "fail", 1);
+      json_attr_string (json_ctx, "desc",
+			"Difficult first and last characters");
+
+      json_array_begin (json_ctx, "timings");
+
+      FOR_EACH_IMPL (impl, 0)
+	do_one_test (json_ctx, impl, buf1, hs_len, ne, len, NULL);
+
+      json_array_end (json_ctx);
+      json_element_object_end (json_ctx);
+    }
+}
+
 static const char *const strs[] =
   {
     "00000", "00112233", "0123456789", "0000111100001111",
@@ -241,6 +292,10 @@ test_main (void)
 
   do_random_tests (&json_ctx);
 
+  do_long_tests (&json_ctx);
+
+  do_hard_tests (&json_ctx);
+
   json_array_end (&json_ctx);
   json_attr_object_end (&json_ctx);
   json_attr_object_end (&json_ctx);
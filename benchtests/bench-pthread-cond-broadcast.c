@@ -0,0 +1,169 @@
+/* Measure the cost of waking a number of waiters with pthread_cond_broadcast.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#define TEST_MAIN
+#define TEST_NAME "pthread-cond-broadcast"
+#define TIMEOUT (20 * 60)
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include "bench-timing.h"
+#include "bench-util.h"
+#include "json-lib.h"
+
+/* A number of threads wait on a condition variable, as the workers of a
+   thread pool would, and the main thread wakes all of them with
+   pthread_cond_broadcast, either while holding the mutex or after
+   releasing it.  A round ends when every waiter has acquired the mutex
+   again and started to wait again.  The time and the number of context
+   switches per round are measured for an increasing number of waiters.  */
+
+#define ROUNDS 2000
+#define RUN_COUNT 5
+
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done = PTHREAD_COND_INITIALIZER;
+static unsigned int generation;
+static int nwaiters;
+static int waiting;
+static bool stop;
+
+static void *
+waiter (void *v)
+{
+  unsigned int gen = 0;
+  pthread_mutex_lock (&mutex);
+  while (!stop)
+    {
+      if (++waiting == nwaiters)
+	pthread_cond_signal (&done);
+      while (generation == gen)
+	pthread_cond_wait (&cond, &mutex);
+      gen = generation;
+    }
+  pthread_mutex_unlock (&mutex);
+  return NULL;
+}
+
+/* Wake all the waiters, and wait until they wait again.  */
+static void
+broadcast (bool locked)
+{
+  pthread_mutex_lock (&mutex);
+  waiting = 0;
+  generation++;
+  if (locked)
+    pthread_cond_broadcast (&cond);
+  else
+    {
+      pthread_mutex_unlock (&mutex);
+      pthread_cond_broadcast (&cond);
+      pthread_mutex_lock (&mutex);
+    }
+  while (waiting < nwaiters)
+    pthread_cond_wait (&done, &mutex);
+  pthread_mutex_unlock (&mutex);
+}
+
+static void
+do_bench_one (int num_waiters, bool locked, json_ctx_t *js)
+{
+  struct timeval ts, te;
+  struct rusage rs, re;
+  double best = 0;
+  double best_switches = 0;
+  pthread_t *threads = malloc (num_waiters * sizeof (pthread_t));
+
+  nwaiters = num_waiters;
+  waiting = 0;
+  stop = false;
+  for (int i = 0; i < num_waiters; i++)
+    pthread_create (&threads[i], NULL, waiter, NULL);
+
+  /* Wait until all the threads wait.  */
+  pthread_mutex_lock (&mutex);
+  while (waiting < nwaiters)
+    pthread_cond_wait (&done, &mutex);
+  pthread_mutex_unlock (&mutex);
+
+  /* Keep the best run, as the others are usually disturbed by other
+     activity in the system.  */
+  for (int i = 0; i < RUN_COUNT; i++)
+    {
+      getrusage (RUSAGE_SELF, &rs);
+      gettimeofday (&ts, NULL);
+      for (int j = 0; j < ROUNDS; j++)
+	broadcast (locked);
+      gettimeofday (&te, NULL);
+      getrusage (RUSAGE_SELF, &re);
+
+      double td = ((te.tv_sec - ts.tv_sec) * 1e9
+		   + (te.tv_usec - ts.tv_usec) * 1e3) / ROUNDS;
+      double switches = (double) (re.ru_nvcsw + re.ru_nivcsw
+				  - rs.ru_nvcsw - rs.ru_nivcsw) / ROUNDS;
+      if (best == 0 || td < best)
+	{
+	  best = td;
+	  best_switches = switches;
+	}
+    }
+
+  pthread_mutex_lock (&mutex);
+  stop = true;
+  generation++;
+  pthread_cond_broadcast (&cond);
+  pthread_mutex_unlock (&mutex);
+  for (int i = 0; i < num_waiters; i++)
+    pthread_join (threads[i], NULL);
+  free (threads);
+
+  char buf[256];
+  snprintf (buf, sizeof buf, "waiters=%d,%s", num_waiters,
+	    locked ? "mutex-held" : "mutex-released");
+  json_attr_object_begin (js, buf);
+  json_attr_double (js, "duration(ns/broadcast)", best);
+  json_attr_double (js, "context-switches/broadcast", best_switches);
+  json_attr_object_end (js);
+}
+
+int
+do_bench (void)
+{
+  static const int waiters[] = { 1, 2, 4, 8, 16, 32, 64 };
+  json_ctx_t json_ctx;
+
+  json_init (&json_ctx, 2, stdout);
+  json_attr_object_begin (&json_ctx, TEST_NAME);
+
+  for (int locked = 1; locked >= 0; locked--)
+    for (int i = 0; i < sizeof waiters / sizeof waiters[0]; i++)
+      do_bench_one (waiters[i], locked, &json_ctx);
+
+  json_attr_object_end (&json_ctx);
+
+  return 0;
+}
+
+#define TEST_FUNCTION do_bench
+
+#include <support/test-driver.c>
@@ -0,0 +1,145 @@
+/* Measure the scalability of rwlock read locks with the number of readers.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#define TEST_MAIN
+#define TEST_NAME "pthread-rwlock-readers"
+#define TIMEOUT (20 * 60)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include <sys/sysinfo.h>
+#include "bench-timing.h"
+#include "bench-util.h"
+#include "json-lib.h"
+
+/* Threads acquire and release a read lock in a loop, around a short
+   critical section, and in some runs one out of WRITE_RATIO acquisitions
+   is a write lock instead.  The throughput of the whole process is
+   measured for each kind of rwlock and an increasing number of threads:
+   ideally it grows linearly with the number of threads as long as there
+   are enough CPUs.  */
+
+#define ITERS 2000000
+#define WRITE_RATIO 10000
+#define RUN_COUNT 5
+
+static pthread_rwlock_t rwlock;
+static int writes;
+static volatile unsigned long shared_data;
+
+static void *
+worker (void *v)
+{
+  unsigned long sum = 0;
+  for (int i = 0; i < ITERS; i++)
+    if (writes && i % WRITE_RATIO == WRITE_RATIO - 1)
+      {
+	pthread_rwlock_wrlock (&rwlock);
+	shared_data++;
+	pthread_rwlock_unlock (&rwlock);
+      }
+    else
+      {
+	pthread_rwlock_rdlock (&rwlock);
+	sum += shared_data;
+	pthread_rwlock_unlock (&rwlock);
+      }
+  return (void *) sum;
+}
+
+static void
+do_bench_one (const char *name, int kind, int num_threads, json_ctx_t *js)
+{
+  struct timeval ts, te;
+  double best = 0;
+  pthread_t *threads = malloc (num_threads * sizeof (pthread_t));
+
+  pthread_rwlockattr_t attr;
+  pthread_rwlockattr_init (&attr);
+  pthread_rwlockattr_setkind_np (&attr, kind);
+  pthread_rwlock_init (&rwlock, &attr);
+  pthread_rwlockattr_destroy (&attr);
+
+  /* Keep the best run, as the others are usually disturbed by other
+     activity in the system.  */
+  for (int i = 0; i < RUN_COUNT; i++)
+    {
+      gettimeofday (&ts, NULL);
+      for (int j = 0; j < num_threads; j++)
+	pthread_create (&threads[j], NULL, worker, NULL);
+      for (int j = 0; j < num_threads; j++)
+	pthread_join (threads[j], NULL);
+      gettimeofday (&te, NULL);
+
+      double td = (te.tv_sec - ts.tv_sec) + (te.tv_usec - ts.tv_usec) / 1e6;
+      double throughput = (double) ITERS * num_threads / td;
+      if (throughput > best)
+	best = throughput;
+    }
+
+  pthread_rwlock_destroy (&rwlock);
+  free (threads);
+
+  char buf[256];
+  snprintf (buf, sizeof buf, "%s,write-ratio=%d,threads=%d", name,
+	    writes ? WRITE_RATIO : 0, num_threads);
+  json_attr_object_begin (js, buf);
+  json_attr_double (js, "throughput(#locks/second)", best);
+  json_attr_object_end (js);
+}
+
+int
+do_bench (void)
+{
+  static const struct
+  {
+    const char *name;
+    int kind;
+  } kinds[] =
+  {
+    { "prefer-reader", PTHREAD_RWLOCK_PREFER_READER_NP },
+    { "prefer-writer", PTHREAD_RWLOCK_PREFER_WRITER_NP },
+    { "reader-biased", PTHREAD_RWLOCK_READER_BIASED_NP },
+  };
+  json_ctx_t json_ctx;
+  int nprocs = get_nprocs ();
+
+  json_init (&json_ctx, 2, stdout);
+  json_attr_object_begin (&json_ctx, TEST_NAME);
+
+  for (writes = 0; writes < 2; writes++)
+    for (int k = 0; k < sizeof kinds / sizeof kinds[0]; k++)
+      {
+	/* From one thread up to the number of CPUs, and then twice as many
+	   threads as CPUs.  */
+	for (int n = 1; n < nprocs; n <<= 1)
+	  do_bench_one (kinds[k].name, kinds[k].kind, n, &json_ctx);
+	do_bench_one (kinds[k].name, kinds[k].kind, nprocs, &json_ctx);
+	do_bench_one (kinds[k].name, kinds[k].kind, 2 * nprocs, &json_ctx);
+      }
+
+  json_attr_object_end (&json_ctx);
+
+  return 0;
+}
+
+#define TEST_FUNCTION do_bench
+
+#include <support/test-driver.c>
@@ -0,0 +1,159 @@
+/* Measure per-CPU counters updated with restartable sequences.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#define TEST_MAIN
+#define TEST_NAME "rseq-percpu"
+#define TIMEOUT (20 * 60)
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/rseq.h>
+#include <sys/sysinfo.h>
+#include <sys/time.h>
+#include "bench-timing.h"
+#include "json-lib.h"
+
+/* A number of threads increment a counter, as a metrics library would.
+   The counter is either a single variable incremented with an atomic
+   instruction, per-CPU counters incremented with an atomic instruction
+   on the element of the CPU returned by sched_getcpu, or per-CPU counters
+   incremented with rseq_percpu_inc.  The time of an increment is
+   measured for an increasing number of threads.  */
+
+#define ITERATIONS 2000000
+#define RUN_COUNT 5
+
+/* Keep the elements of each CPU on their own cache line.  */
+#define STRIDE 64
+
+enum method
+{
+  atomic_shared,
+  atomic_percpu,
+  rseq_percpu,
+};
+
+static const char *const method_names[] =
+{
+  "atomic-shared",
+  "atomic-percpu",
+  "rseq-percpu",
+};
+
+static intptr_t shared_counter __attribute__ ((aligned (STRIDE)));
+static intptr_t *percpu_counters;
+static pthread_barrier_t barrier;
+static enum method method;
+
+static void *
+increment (void *closure)
+{
+  pthread_barrier_wait (&barrier);
+  switch (method)
+    {
+    case atomic_shared:
+      for (int i = 0; i < ITERATIONS; i++)
+	__atomic_fetch_add (&shared_counter, 1, __ATOMIC_RELAXED);
+      break;
+    case atomic_percpu:
+      for (int i = 0; i < ITERATIONS; i++)
+	{
+	  int cpu = sched_getcpu ();
+	  __atomic_fetch_add ((intptr_t *) ((char *) percpu_counters
+					    + cpu * STRIDE),
+			      1, __ATOMIC_RELAXED);
+	}
+      break;
+    case rseq_percpu:
+      for (int i = 0; i < ITERATIONS; i++)
+	rseq_percpu_inc (percpu_counters, STRIDE);
+      break;
+    }
+  pthread_barrier_wait (&barrier);
+  return NULL;
+}
+
+static void
+do_bench_one (int nthreads, enum method m, json_ctx_t *js)
+{
+  struct timeval ts, te;
+  double best = 0;
+  pthread_t *threads = malloc (nthreads * sizeof (pthread_t));
+
+  method = m;
+  for (int i = 0; i < RUN_COUNT; i++)
+    {
+      pthread_barrier_init (&barrier, NULL, nthreads + 1);
+      for (int j = 0; j < nthreads; j++)
+	pthread_create (&threads[j], NULL, increment, NULL);
+
+      /* Time from the start of the increments until all the threads are
+	 done, without the creation of the threads.  */
+      gettimeofday (&ts, NULL);
+      pthread_barrier_wait (&barrier);
+      pthread_barrier_wait (&barrier);
+      gettimeofday (&te, NULL);
+
+      for (int j = 0; j < nthreads; j++)
+	pthread_join (threads[j], NULL);
+      pthread_barrier_destroy (&barrier);
+
+      double td = ((te.tv_sec - ts.tv_sec) * 1e9
+		   + (te.tv_usec - ts.tv_usec) * 1e3) / ITERATIONS;
+      if (best == 0 || td < best)
+	best = td;
+    }
+  free (threads);
+
+  char buf[256];
+  snprintf (buf, sizeof buf, "threads=%d,%s", nthreads, method_names[m]);
+  json_attr_object_begin (js, buf);
+  json_attr_double (js, "duration(ns/increment)", best);
+  json_attr_object_end (js);
+}
+
+int
+do_bench (void)
+{
+  static const int nthreads[] = { 1, 2, 4, 8, 16, 32 };
+  json_ctx_t json_ctx;
+
+  percpu_counters = aligned_alloc (STRIDE, get_nprocs_conf () * STRIDE);
+  if (percpu_counters == NULL)
+    return 1;
+
+  json_init (&json_ctx, 2, stdout);
+  json_attr_object_begin (&json_ctx, TEST_NAME);
+  json_attr_int (&json_ctx, "rseq", __rseq_size != 0);
+
+  for (int i = 0; i < sizeof nthreads / sizeof nthreads[0]; i++)
+    for (enum method m = atomic_shared; m <= rseq_percpu; m++)
+      do_bench_one (nthreads[i], m, &json_ctx);
+
+  json_attr_object_end (&json_ctx);
+  free (percpu_counters);
+
+  return 0;
+}
+
+#define TEST_FUNCTION do_bench
+
+#include <support/test-driver.c>
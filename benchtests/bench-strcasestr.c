@@ -86,7 +86,7 @@ do_one_test (json_ctx_t *json_ctx, impl_t *impl, const char *s1,
 
 static void
 do_test (json_ctx_t *json_ctx, size_t align1, size_t align2, size_t len1,
-	 size_t len2, int fail)
+	 size_t len2, int fail, int flip_case)
 {
   char *s1 = (char *) (buf1 + align1);
   char *s2 = (char *) (buf2 + align2);
@@ -120,6 +120,13 @@ do_test (json_ctx_t *json_ctx, size_t align1, size_t align2, size_t len1,
     memcpy (s1 + len1 - len2, s2, len2);
   s1[len1] = '\0';
 
+  /* Swap the case of the ASCII letters of the haystack, so that they
+     differ from the needle.  */
+  if (flip_case)
+    for (ss1 = s1; *ss1 != '\0'; ss1++)
+      if ((unsigned char) ((*ss1 | 0x20) - 'a') < 26)
+	*ss1 ^= 0x20;
+
   /* Remove any accidental matches except for the last if !fail.  */
   for (ss1 = simple_strcasestr (s1, s2);
        ss1 != NULL;
@@ -133,6 +140,7 @@ do_test (json_ctx_t *json_ctx, size_t align1, size_t align2, size_t len1,
   json_attr_uint (json_ctx, "align_haystack", align1);
   json_attr_uint (json_ctx, "align_needle", align2);
   json_attr_uint (json_ctx, "fail", fail);
+  json_attr_uint (json_ctx, "flip_case", flip_case);
 
   json_array_begin (json_ctx, "timings");
 
@@ -281,6 +289,40 @@ test_hard_needle (json_ctx_t *json_ctx, size_t ne_len, size_t hs_len)
   }
 }
 
+/* Needles whose first and last characters match at every position of the
+   haystack, so that filtering on them does not help: the search has to
+   compare the rest of the needle everywhere or use another algorithm.  */
+
+static void
+test_hard_filter (json_ctx_t *json_ctx, size_t ne_len, size_t hs_len)
+{
+  char *ne = (char *) buf1;
+  char *hs = (char *) buf2;
+
+  memset (hs, 'a', hs_len);
+  hs[hs_len] = '\0';
+
+  memset (ne, 'a', ne_len);
+  ne[ne_len / 2] = 'b';
+  ne[ne_len] = '\0';
+
+  json_element_object_begin (json_ctx);
+  json_attr_uint (json_ctx, "len_haystack", hs_len);
+  json_attr_uint (json_ctx, "len_needle", ne_len);
+  json_attr_uint (json_ctx, "align_haystack", 0);
+  json_attr_uint (json_ctx, "align_needle", 0);
+  json_attr_uint (json_ctx, "fail", 1);
+  json_attr_string (json_ctx, "desc", "Difficult first and last characters");
+
+  json_array_begin (json_ctx, "timings");
+
+  FOR_EACH_IMPL (impl, 0)
+    do_one_test (json_ctx, impl, hs, ne, NULL);
+
+  json_array_end (json_ctx);
+  json_element_object_end (json_ctx);
+}
+
 static int
 test_main (void)
 {
@@ -306,13 +348,13 @@ test_main (void)
   for (size_t hlen = 8; hlen <= 256;)
     for (size_t klen = 1; klen <= 16; klen++)
       {
-	do_test (&json_ctx, 1, 3, hlen, klen, 0);
-	do_test (&json_ctx, 0, 9, hlen, klen, 1);
+	do_test (&json_ctx, 1, 3, hlen, klen, 0, 0);
+	do_test (&json_ctx, 0, 9, hlen, klen, 1, 0);
 
-	do_test (&json_ctx, 1, 3, hlen + 1, klen, 0);
-	do_test (&json_ctx, 0, 9, hlen + 1, klen, 1);
+	do_test (&json_ctx, 1, 3, hlen + 1, klen, 0, 0);
+	do_test (&json_ctx, 0, 9, hlen + 1, klen, 1, 0);
 
-	do_test (&json_ctx, getpagesize () - 15, 9, hlen, klen, 1);
+	do_test (&json_ctx, getpagesize () - 15, 9, hlen, klen, 1, 0);
 	if (hlen < 64)
 	  {
 	    hlen += 8;
@@ -326,22 +368,32 @@ test_main (void)
   for (size_t hlen = 256; hlen <= 65536; hlen *= 2)
     for (size_t klen = 4; klen <= 256; klen *= 2)
       {
-	do_test (&json_ctx, 1, 11, hlen, klen, 0);
-	do_test (&json_ctx, 14, 5, hlen, klen, 1);
+	do_test (&json_ctx, 1, 11, hlen, klen, 0, 0);
+	do_test (&json_ctx, 14, 5, hlen, klen, 1, 0);
 
-    do_test (&json_ctx, 1, 11, hlen + 1, klen + 1, 0);
-    do_test (&json_ctx, 14, 5, hlen + 1, klen + 1, 1);
+    do_test (&json_ctx, 1, 11, hlen + 1, klen + 1, 0, 0);
+    do_test (&json_ctx, 14, 5, hlen + 1, klen + 1, 1, 0);
 
-	do_test (&json_ctx, 1, 11, hlen + 1, klen, 0);
-	do_test (&json_ctx, 14, 5, hlen + 1, klen, 1);
+	do_test (&json_ctx, 1, 11, hlen + 1, klen, 0, 0);
+	do_test (&json_ctx, 14, 5, hlen + 1, klen, 1, 0);
 
-	do_test (&json_ctx, getpagesize () - 15, 5, hlen + 1, klen, 1);
+	do_test (&json_ctx, getpagesize () - 15, 5, hlen + 1, klen, 1, 0);
+      }
+
+  for (size_t hlen = 256; hlen <= 65536; hlen *= 4)
+    for (size_t klen = 4; klen <= 256; klen *= 4)
+      {
+	do_test (&json_ctx, 1, 11, hlen, klen, 0, 1);
+	do_test (&json_ctx, 14, 5, hlen, klen, 1, 1);
       }
 
   test_hard_needle (&json_ctx, 64, 65536);
   test_hard_needle (&json_ctx, 256, 65536);
   test_hard_needle (&json_ctx, 1024, 65536);
 
+  for (size_t klen = 4; klen <= 256; klen *= 4)
+    test_hard_filter (&json_ctx, klen, 65536);
+
   json_array_end (&json_ctx);
   json_attr_object_end (&json_ctx);
   json_attr_object_end (&json_ctx);
@@ -381,6 +381,40 @@ test_hard_needle (json_ctx_t *json_ctx, size_t ne_len, size_t hs_len)
   }
 }
 
+/* Needles whose first and last characters match at every position of the
+   haystack, so that filtering on them does not help: the search has to
+   compare the rest of the needle everywhere or use another algorithm.  */
+
+static void
+test_hard_filter (json_ctx_t *json_ctx, size_t ne_len, size_t hs_len)
+{
+  char *ne = (char *) buf1;
+  char *hs = (char *) buf2;
+
+  memset (hs, 'a', hs_len);
+  hs[hs_len] = '\0';
+
+  memset (ne, 'a', ne_len);
+  ne[ne_len / 2] = 'b';
+  ne[ne_len] = '\0';
+
+  json_element_object_begin (json_ctx);
+  json_attr_uint (json_ctx, "len_haystack", hs_len);
+  json_attr_uint (json_ctx, "len_needle", ne_len);
+  json_attr_uint (json_ctx, "align_haystack", 0);
+  json_attr_uint (json_ctx, "align_needle", 0);
+  json_attr_uint (json_ctx, "fail", 1);
+  json_attr_string (json_ctx, "desc", "Difficult first and last characters");
+
+  json_array_begin (json_ctx, "timings");
+
+  FOR_EACH_IMPL (impl, 0)
+    do_one_test (json_ctx, impl, hs, ne, NULL);
+
+  json_array_end (json_ctx);
+  json_element_object_end (json_ctx);
+}
+
 static int
 test_main (void)
 {
@@ -442,6 +476,9 @@ test_main (void)
   test_hard_needle (&json_ctx, 256, 65536);
   test_hard_needle (&json_ctx, 1024, 65536);
 
+  for (size_t klen = 4; klen <= 256; klen *= 4)
+    test_hard_filter (&json_ctx, klen, 65536);
+
   json_array_end (&json_ctx);
   json_attr_object_end (&json_ctx);
   json_attr_object_end (&json_ctx);
@@ -0,0 +1,28 @@
+/* Module with dynamic TLS for bench-tls-get-addr.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The module is built several times and loaded with dlopen, so the
+   variable is accessed with the general dynamic TLS model.  */
+
+__thread int bench_tls_var[16] = { 1 };
+
+int *
+bench_tls_get_addr (void)
+{
+  return bench_tls_var;
+}
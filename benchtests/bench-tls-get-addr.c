@@ -0,0 +1,142 @@
+/* Measure the cost of dynamic TLS accesses with __tls_get_addr.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#define TEST_MAIN
+#define TEST_NAME "tls-get-addr"
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bench-timing.h"
+#include "bench-util.h"
+#include "json-lib.h"
+
+/* NMODULES modules with TLS are loaded with dlopen, as a plugin host
+   would.  Threads are then created, and each of them accesses the TLS of
+   every module once (first access, which updates the DTV of the thread
+   and allocates the TLS blocks), and then many times (steady state).
+   The creation of the threads is measured as well, since
+   glibc.rtld.tls_prealloc=1 moves the allocation of the TLS blocks there;
+   run the benchmark with and without this tunable to compare.  */
+
+#define NMODULES 100
+#define NTHREADS 64
+#define ITERS 1000
+
+typedef int *(*get_addr_t) (void);
+static get_addr_t get_addr[NMODULES];
+
+struct result
+{
+  timing_t first;
+  timing_t steady;
+};
+
+static void *
+thread_func (void *closure)
+{
+  struct result *r = closure;
+  timing_t start, stop;
+
+  TIMING_NOW (start);
+  for (int i = 0; i < NMODULES; i++)
+    get_addr[i] ()[0]++;
+  TIMING_NOW (stop);
+  TIMING_DIFF (r->first, start, stop);
+
+  TIMING_NOW (start);
+  for (int j = 0; j < ITERS; j++)
+    for (int i = 0; i < NMODULES; i++)
+      get_addr[i] ()[0]++;
+  TIMING_NOW (stop);
+  TIMING_DIFF (r->steady, start, stop);
+
+  return NULL;
+}
+
+int
+do_bench (void)
+{
+  json_ctx_t json_ctx;
+  struct result results[NTHREADS];
+  timing_t create = 0, first = 0, steady = 0;
+
+  for (int i = 0; i < NMODULES; i++)
+    {
+      char name[64];
+      snprintf (name, sizeof name, "bench-tls-get-addr-mod%02d.so", i);
+      void *h = dlopen (name, RTLD_NOW);
+      if (h == NULL)
+	{
+	  printf ("dlopen failed: %s\n", dlerror ());
+	  return 77;
+	}
+      get_addr[i] = (get_addr_t) dlsym (h, "bench_tls_get_addr");
+      if (get_addr[i] == NULL)
+	{
+	  printf ("dlsym failed: %s\n", dlerror ());
+	  return 1;
+	}
+    }
+
+  /* Touch the TLS of every module once from the main thread, so that the
+     blocks of the threads can be allocated when they are created if
+     glibc.rtld.tls_prealloc is set.  */
+  for (int i = 0; i < NMODULES; i++)
+    get_addr[i] ()[0]++;
+
+  for (int t = 0; t < NTHREADS; t++)
+    {
+      timing_t start, stop, cur;
+      pthread_t thr;
+
+      TIMING_NOW (start);
+      if (pthread_create (&thr, NULL, thread_func, &results[t]) != 0)
+	{
+	  printf ("pthread_create failed\n");
+	  return 1;
+	}
+      TIMING_NOW (stop);
+      TIMING_DIFF (cur, start, stop);
+      TIMING_ACCUM (create, cur);
+      pthread_join (thr, NULL);
+
+      TIMING_ACCUM (first, results[t].first);
+      TIMING_ACCUM (steady, results[t].steady);
+    }
+
+  json_init (&json_ctx, 2, stdout);
+  json_attr_object_begin (&json_ctx, TEST_NAME);
+  json_attr_object_begin (&json_ctx, "");
+  json_attr_uint (&json_ctx, "modules", NMODULES);
+  json_attr_uint (&json_ctx, "threads", NTHREADS);
+  json_attr_double (&json_ctx, "thread-create", (double) create / NTHREADS);
+  json_attr_double (&json_ctx, "first-access",
+		    (double) first / (NTHREADS * NMODULES));
+  json_attr_double (&json_ctx, "steady-state",
+		    (double) steady / ((double) NTHREADS * NMODULES * ITERS));
+  json_attr_object_end (&json_ctx);
+  json_attr_object_end (&json_ctx);
+
+  return 0;
+}
+
+#define TEST_FUNCTION do_bench
+
+#include <support/test-driver.c>
@@ -1,5 +1,5 @@
 /* Measure pthread_create thread creation with different stack
-   and guard sizes.
+   and guard sizes, from one or several threads.
 
    Copyright (C) 2017-2026 Free Software Foundation, Inc.
    This file is part of the GNU C Library.
@@ -36,23 +36,71 @@ thread_dummy (void *arg)
   return NULL;
 }
 
-static void
-thread_create (int nthreads, size_t stacksize, size_t guardsize)
+struct creator
+{
+  int nthreads;
+  size_t stacksize;
+  size_t guardsize;
+  int sizes;
+  size_t pool;
+};
+
+/* Create and join NTHREADS threads, cycling through SIZES different
+   stack sizes starting at STACKSIZE.  With a non-zero POOL, the threads
+   take their stacks from a stack pool of that size.  */
+static void *
+create_threads (void *closure)
 {
-  pthread_attr_t attr;
-  xpthread_attr_init (&attr);
+  struct creator *c = closure;
+  pthread_attr_t attr[c->sizes];
+  for (int i = 0; i < c->sizes; i++)
+    {
+      xpthread_attr_init (&attr[i]);
+      xpthread_attr_setstacksize (&attr[i], c->stacksize * (i + 1));
+      xpthread_attr_setguardsize (&attr[i], c->guardsize);
+      if (c->pool != 0)
+	pthread_attr_setstackpool_np (&attr[i], c->pool);
+    }
 
-  stacksize = stacksize * pgsize;
-  guardsize = guardsize * pgsize;
+  pthread_t ts[c->nthreads];
+
+  for (int i = 0; i < c->nthreads; i++)
+    ts[i] = xpthread_create (&attr[i % c->sizes], thread_dummy, NULL);
+
+  for (int i = 0; i < c->nthreads; i++)
+    xpthread_join (ts[i]);
+
+  for (int i = 0; i < c->sizes; i++)
+    xpthread_attr_destroy (&attr[i]);
+  return NULL;
+}
+
+/* Create NTHREADS threads from each of CREATORS threads at the same time,
+   as a thread pool would, so that they contend for the stack cache.  */
+static void
+thread_create (int nthreads, size_t stacksize, size_t guardsize,
+	       int creators, int sizes, size_t pool)
+{
+  struct creator c =
+    {
+      .nthreads = nthreads,
+      .stacksize = stacksize * pgsize,
+      .guardsize = guardsize * pgsize,
+      .sizes = sizes,
+      .pool = pool
+    };
 
-  xpthread_attr_setstacksize (&attr, stacksize);
-  xpthread_attr_setguardsize (&attr, guardsize);
+  if (creators == 1)
+    {
+      create_threads (&c);
+      return;
+    }
 
-  pthread_t ts[nthreads];
+  pthread_t ts[creators];
 
-  for (int i = 0; i < nthreads; i++)
-    ts[i] = xpthread_create (&attr, thread_dummy, NULL);
+  for (int i = 0; i < creators; i++)
+    ts[i] = xpthread_create (NULL, create_threads, &c);
 
-  for (int i = 0; i < nthreads; i++)
+  for (int i = 0; i < creators; i++)
     xpthread_join (ts[i]);
 }
@@ -25,6 +25,7 @@
 #include <sys/param.h>
 #include <sys/types.h>
 #include <libc-internal.h>
+#include <malloc/malloc-internal.h>
 
 #include <ldsodefs.h>
 
@@ -69,6 +70,9 @@ _init_first (int argc, char **argv, char **envp)
 #endif
 
   __init_misc (argc, argv, envp);
+
+  /* Load the unwinder for the heap profiler.  */
+  call_function_static_weak (__malloc_profile_late_init);
 }
 
 /* This function is defined here so that if this file ever gets into
@@ -63,6 +63,9 @@ size_t _dl_tls_static_align;
    loaded modules with IE-model TLS or for TLSDESC optimization.
    See comments in elf/dl-tls.c where it is initialized.  */
 size_t _dl_tls_static_surplus;
+/* Nonzero if the dynamic TLS blocks in use are allocated when a thread
+   is created instead of on first access.  */
+int _dl_tls_prealloc;
 /* Remaining amount of static TLS that may be used for optimizing
    dynamic TLS access (e.g. with TLSDESC).  */
 size_t _dl_tls_static_optional;
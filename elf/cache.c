@@ -37,6 +37,7 @@
 #include <version.h>
 #include <stringtable.h>
 #include <tunconf.h>
+#include <dl-new-hash.h>
 
 /* Used to store library names, paths, and other strings.  */
 static struct stringtable strings;
@@ -345,6 +346,30 @@ print_extensions (struct cache_extension_all_loaded *ext,
 	  printf (")]\n");
 	}
     }
+  if (ext->sections[cache_extension_tag_directories].base != NULL)
+    {
+      const char *base = ext->sections[cache_extension_tag_directories].base;
+      size_t size = ext->sections[cache_extension_tag_directories].size;
+      const struct cache_directories *dirs = (const void *) base;
+      if (size >= sizeof (*dirs)
+	  && ((size - sizeof (*dirs)) / sizeof (dirs->directories[0])
+	      >= dirs->count))
+	{
+	  printf (_("Contents of %u directories:\n"), dirs->count);
+	  for (uint32_t i = 0; i < dirs->count; ++i)
+	    if (dirs->directories[i].name < size)
+	      printf (_("\t%s (%u names)\n"),
+		      base + dirs->directories[i].name,
+		      dirs->directories[i].count);
+	}
+    }
+  if (ext->sections[cache_extension_tag_soname_hash].base != NULL)
+    {
+      const struct cache_soname_hash *table
+	= ext->sections[cache_extension_tag_soname_hash].base;
+      printf (_("Hash table of library names with %u slots\n"),
+	      table->nslots);
+    }
 }
 
 /* Print the whole cache file, if a file contains the new cache format
@@ -499,6 +524,341 @@ compare (const struct cache_entry *e1, const struct cache_entry *e2)
   return res;
 }
 
+/* Directories named by the DT_RUNPATH entries of the cached libraries.
+   Their contents are stored in the cache_extension_tag_directories
+   section, so that the dynamic loader does not have to read them when
+   glibc.rtld.search_dir_index is set.  */
+struct runpath_directory
+{
+  struct runpath_directory *next;
+
+  /* The directory as searched by the dynamic loader, without a
+     trailing slash, and with the chroot prefix, if any.  */
+  char *path;
+  char *real_path;
+
+  /* True for the glibc-hwcaps subdirectories.  */
+  bool hwcaps;
+
+  /* Identity of the directory when it was read, and sorted, distinct
+     _dl_new_hash values of the names in it.  hashes is null if the
+     directory could not be read.  */
+  uint64_t dev;
+  uint64_t ino;
+  int64_t mtime_sec;
+  uint32_t mtime_nsec;
+  uint32_t *hashes;
+  uint32_t count;
+};
+
+/* List of the directories, in the order in which they were added.  */
+static struct runpath_directory *runpath_directories;
+static struct runpath_directory **runpath_directories_tail
+  = &runpath_directories;
+
+static void
+add_runpath_directory (char *path, char *real_path, bool hwcaps)
+{
+  for (struct runpath_directory *p = runpath_directories; p != NULL;
+       p = p->next)
+    if (strcmp (p->path, path) == 0)
+      {
+	free (path);
+	free (real_path);
+	return;
+      }
+
+  struct runpath_directory *p = xmalloc (sizeof (*p));
+  p->next = NULL;
+  p->path = path;
+  p->real_path = real_path;
+  p->hwcaps = hwcaps;
+  p->hashes = NULL;
+  p->count = 0;
+  *runpath_directories_tail = p;
+  runpath_directories_tail = &p->next;
+}
+
+/* Return the rest of DIR if it starts with the $ORIGIN dynamic string
+   token, or null.  */
+static const char *
+skip_origin (const char *dir)
+{
+  const char *rest;
+  if (strncmp (dir, "$ORIGIN", strlen ("$ORIGIN")) == 0)
+    rest = dir + strlen ("$ORIGIN");
+  else if (strncmp (dir, "${ORIGIN}", strlen ("${ORIGIN}")) == 0)
+    rest = dir + strlen ("${ORIGIN}");
+  else
+    return NULL;
+  if (*rest != '/' && *rest != '\0')
+    return NULL;
+  return rest;
+}
+
+void
+add_runpath_to_cache (const char *path, const char *runpath,
+		      const char *chroot)
+{
+  char *copy = xstrdup (runpath);
+  char *saveptr;
+  for (char *dir = strtok_r (copy, ":", &saveptr); dir != NULL;
+       dir = strtok_r (NULL, ":", &saveptr))
+    {
+      /* The directory is expanded as by the dynamic loader.  Other
+	 dynamic string tokens depend on the system running the
+	 program, so these directories are not recorded.  */
+      char *expanded;
+      const char *rest = skip_origin (dir);
+      if (rest != NULL)
+	{
+	  if (asprintf (&expanded, "%s%s", path, rest) < 0)
+	    error (EXIT_FAILURE, errno, _("Could not form directory path"));
+	}
+      else
+	expanded = xstrdup (dir);
+      if (expanded[0] != '/' || strchr (expanded, '$') != NULL)
+	{
+	  free (expanded);
+	  continue;
+	}
+
+      /* Remove the trailing slashes, like the dynamic loader.  */
+      size_t len = strlen (expanded);
+      while (len > 1 && expanded[len - 1] == '/')
+	expanded[--len] = '\0';
+      if (len == 1)
+	{
+	  free (expanded);
+	  continue;
+	}
+
+      char *real_path;
+      if (chroot != NULL)
+	{
+	  real_path = chroot_canon (chroot, expanded);
+	  if (real_path == NULL)
+	    {
+	      free (expanded);
+	      continue;
+	    }
+	}
+      else
+	real_path = xstrdup (expanded);
+      add_runpath_directory (expanded, real_path, false);
+    }
+  free (copy);
+}
+
+static int
+compare_hashes (const void *l, const void *r)
+{
+  uint32_t left = *(const uint32_t *) l;
+  uint32_t right = *(const uint32_t *) r;
+  return left < right ? -1 : left > right;
+}
+
+/* Read the directory P.  The glibc-hwcaps subdirectories of a
+   DT_RUNPATH directory are added to the list, to be read next.  */
+static void
+read_runpath_directory (struct runpath_directory *p)
+{
+  DIR *dir = opendir (p->real_path);
+  if (dir == NULL)
+    return;
+
+  /* The modification time is read first, so that the contents are
+     not used if the directory changes while it is read.  */
+  struct stat st;
+  if (fstat (dirfd (dir), &st) != 0)
+    {
+      closedir (dir);
+      return;
+    }
+
+  size_t allocated = 64;
+  size_t count = 0;
+  uint32_t *hashes = xmalloc (allocated * sizeof (*hashes));
+  struct dirent64 *direntry;
+  while ((direntry = readdir64 (dir)) != NULL)
+    {
+      if (count == allocated)
+	{
+	  allocated *= 2;
+	  hashes = xrealloc (hashes, allocated * sizeof (*hashes));
+	}
+      hashes[count++] = _dl_new_hash (direntry->d_name);
+
+      if (!p->hwcaps && strcmp (direntry->d_name, "glibc-hwcaps") == 0)
+	{
+	  char *hwcaps_path;
+	  char *hwcaps_real_path;
+	  if (asprintf (&hwcaps_path, "%s/glibc-hwcaps", p->path) < 0
+	      || asprintf (&hwcaps_real_path, "%s/glibc-hwcaps",
+			   p->real_path) < 0)
+	    error (EXIT_FAILURE, errno, _("Could not form directory path"));
+	  DIR *hwcaps_dir = opendir (hwcaps_real_path);
+	  if (hwcaps_dir != NULL)
+	    {
+	      struct dirent64 *subentry;
+	      while ((subentry = readdir64 (hwcaps_dir)) != NULL)
+		{
+		  if (strcmp (subentry->d_name, ".") == 0
+		      || strcmp (subentry->d_name, "..") == 0)
+		    continue;
+		  char *sub_path;
+		  char *sub_real_path;
+		  if (asprintf (&sub_path, "%s/%s", hwcaps_path,
+				subentry->d_name) < 0
+		      || asprintf (&sub_real_path, "%s/%s", hwcaps_real_path,
+				   subentry->d_name) < 0)
+		    error (EXIT_FAILURE, errno,
+			   _("Could not form directory path"));
+		  add_runpath_directory (sub_path, sub_real_path, true);
+		}
+	      closedir (hwcaps_dir);
+	    }
+	  free (hwcaps_path);
+	  free (hwcaps_real_path);
+	}
+    }
+  closedir (dir);
+
+  qsort (hashes, count, sizeof (*hashes), compare_hashes);
+  size_t n = 0;
+  for (size_t i = 0; i < count; ++i)
+    if (n == 0 || hashes[i] != hashes[n - 1])
+      hashes[n++] = hashes[i];
+
+  p->dev = st.st_dev;
+  p->ino = st.st_ino;
+  p->mtime_sec = st.st_mtim.tv_sec;
+  p->mtime_nsec = st.st_mtim.tv_nsec;
+  p->hashes = hashes;
+  p->count = n;
+}
+
+/* Read the DT_RUNPATH directories and return the contents of the
+   cache_extension_tag_directories section, or null if there are none.
+   Store the size of the section, a multiple of 8, in *SIZE.  */
+static void *
+runpath_directories_section (uint32_t *size)
+{
+  uint32_t count = 0;
+  size_t hashes_size = 0;
+  size_t names_size = 0;
+  for (struct runpath_directory *p = runpath_directories; p != NULL;
+       p = p->next)
+    {
+      read_runpath_directory (p);
+      if (p->hashes != NULL)
+	{
+	  ++count;
+	  hashes_size += p->count * sizeof (uint32_t);
+	  names_size += strlen (p->path) + 1;
+	}
+    }
+  if (count == 0)
+    return NULL;
+
+  size_t hashes_offset = (offsetof (struct cache_directories, directories)
+			  + count * sizeof (struct cache_directory));
+  size_t names_offset = hashes_offset + hashes_size;
+  size_t total = ALIGN_UP (names_offset + names_size, 8);
+  if (total > UINT32_MAX)
+    error (EXIT_FAILURE, 0, _("Too many DT_RUNPATH directories"));
+
+  char *section = xcalloc (1, total);
+  struct cache_directories *dirs = (struct cache_directories *) section;
+  dirs->count = count;
+  uint32_t i = 0;
+  for (struct runpath_directory *p = runpath_directories; p != NULL;
+       p = p->next)
+    if (p->hashes != NULL)
+      {
+	struct cache_directory *d = &dirs->directories[i++];
+	d->dev = p->dev;
+	d->ino = p->ino;
+	d->mtime_sec = p->mtime_sec;
+	d->mtime_nsec = p->mtime_nsec;
+	d->hashes = hashes_offset;
+	d->count = p->count;
+	d->name = names_offset;
+	memcpy (section + hashes_offset, p->hashes,
+		p->count * sizeof (uint32_t));
+	hashes_offset += p->count * sizeof (uint32_t);
+	strcpy (section + names_offset, p->path);
+	names_offset += strlen (p->path) + 1;
+      }
+
+  *size = total;
+  return section;
+}
+
+/* Return the contents of the cache_extension_tag_soname_hash section
+   for the entries, in the order in which they are written, or null if
+   there are none.  Store the size of the section, a multiple of 8, in
+   *SIZE.  */
+static void *
+soname_hash_section (uint32_t *size)
+{
+  /* The entries whose names compare equal are consecutive, and only
+     the first entry of each group is added to the table.  */
+  uint32_t groups = 0;
+  const char *previous = NULL;
+  for (struct cache_entry *entry = entries; entry != NULL;
+       entry = entry->next)
+    {
+      if (previous == NULL
+	  || _dl_cache_libcmp (entry->lib->string, previous) != 0)
+	++groups;
+      previous = entry->lib->string;
+    }
+  if (groups == 0)
+    return NULL;
+
+  /* At most half of the slots are used, so that the probe sequences
+     are short and end with an empty slot.  */
+  uint32_t nslots = 8;
+  while (nslots < 2 * (size_t) groups)
+    nslots *= 2;
+
+  struct cache_soname_hash *table;
+  size_t total = (offsetof (struct cache_soname_hash, slots)
+		  + nslots * sizeof (table->slots[0]));
+  if (total > UINT32_MAX)
+    error (EXIT_FAILURE, 0, _("Too many libraries in the cache"));
+  table = xmalloc (total);
+  table->nslots = nslots;
+  table->unused = 0;
+  for (uint32_t i = 0; i < nslots; ++i)
+    {
+      table->slots[i].hash = 0;
+      table->slots[i].index = CACHE_SONAME_HASH_EMPTY;
+    }
+
+  uint32_t index = 0;
+  previous = NULL;
+  for (struct cache_entry *entry = entries; entry != NULL;
+       entry = entry->next, ++index)
+    {
+      if (previous == NULL
+	  || _dl_cache_libcmp (entry->lib->string, previous) != 0)
+	{
+	  uint32_t hash = _dl_cache_soname_hash (entry->lib->string);
+	  uint32_t slot = hash & (nslots - 1);
+	  while (table->slots[slot].index != CACHE_SONAME_HASH_EMPTY)
+	    slot = (slot + 1) & (nslots - 1);
+	  table->slots[slot].hash = hash;
+	  table->slots[slot].index = index;
+	}
+      previous = entry->lib->string;
+    }
+
+  *size = total;
+  return table;
+}
+
 /* Size of the cache extension directory.  All tags are assumed to be
    present.  */
 enum
@@ -539,6 +899,18 @@ write_extensions (int fd, uint32_t str_offset,
       hwcaps_offset  -= sizeof (struct cache_extension_section);
     }
 
+  uint32_t directories_size = 0;
+  void *directories_data = runpath_directories_section (&directories_size);
+  if (directories_data == NULL)
+    /* There is no section for the DT_RUNPATH directories.  */
+    hwcaps_offset -= sizeof (struct cache_extension_section);
+
+  uint32_t soname_hash_size = 0;
+  void *soname_hash_data = soname_hash_section (&soname_hash_size);
+  if (soname_hash_data == NULL)
+    /* There is no section for the hash table of the names.  */
+    hwcaps_offset -= sizeof (struct cache_extension_section);
+
   /* This is the offset of the generator string.  */
   uint32_t generator_offset = hwcaps_offset;
   if (hwcaps_count == 0)
@@ -588,6 +960,47 @@ write_extensions (int fd, uint32_t str_offset,
       ext->sections[xid].size = tunable_size;
     }
 
+  /* The directories follow the tunables, or the generator string.  */
+  size_t directories_aligner = 0;
+  if (directories_data != NULL)
+    {
+      uint32_t directories_offset_ua;
+      if (tunable_data != NULL)
+	directories_offset_ua = (ext->sections[xid].offset
+				 + ext->sections[xid].size);
+      else
+	directories_offset_ua = generator_offset + strlen (generator);
+      uint32_t directories_offset = ALIGN_UP (directories_offset_ua, 8);
+      directories_aligner = directories_offset - directories_offset_ua;
+
+      ++xid;
+      ext->sections[xid].tag = cache_extension_tag_directories;
+      ext->sections[xid].flags = 0;
+      ext->sections[xid].offset = directories_offset;
+      ext->sections[xid].size = directories_size;
+    }
+
+  /* The hash table follows the directories, the tunables, or the
+     generator string.  */
+  size_t soname_hash_aligner = 0;
+  if (soname_hash_data != NULL)
+    {
+      uint32_t soname_hash_offset_ua;
+      if (tunable_data != NULL || directories_data != NULL)
+	soname_hash_offset_ua = (ext->sections[xid].offset
+				 + ext->sections[xid].size);
+      else
+	soname_hash_offset_ua = generator_offset + strlen (generator);
+      uint32_t soname_hash_offset = ALIGN_UP (soname_hash_offset_ua, 8);
+      soname_hash_aligner = soname_hash_offset - soname_hash_offset_ua;
+
+      ++xid;
+      ext->sections[xid].tag = cache_extension_tag_soname_hash;
+      ext->sections[xid].flags = 0;
+      ext->sections[xid].offset = soname_hash_offset;
+      ext->sections[xid].size = soname_hash_size;
+    }
+
   ++xid;
   ext->count = xid;
   assert (xid <= cache_extension_count);
@@ -607,6 +1020,26 @@ write_extensions (int fd, uint32_t str_offset,
       free (tunable_data);
     }
 
+  if (directories_data != NULL)
+    {
+      if (write (fd, "        ", directories_aligner) != directories_aligner
+	  || (write (fd, directories_data, directories_size)
+	      != directories_size))
+	error (EXIT_FAILURE, errno,
+	       _("Writing of cache directory data failed"));
+      free (directories_data);
+    }
+
+  if (soname_hash_data != NULL)
+    {
+      if (write (fd, "        ", soname_hash_aligner) != soname_hash_aligner
+	  || (write (fd, soname_hash_data, soname_hash_size)
+	      != soname_hash_size))
+	error (EXIT_FAILURE, errno,
+	       _("Writing of cache hash table failed"));
+      free (soname_hash_data);
+    }
+
   free (hwcaps_array);
   free (ext);
 }
@@ -915,10 +1348,11 @@ struct aux_cache_entry
   unsigned int isa_level;
   int used;
   char *soname;
+  char *runpath;
   struct aux_cache_entry *next;
 };
 
-#define AUX_CACHEMAGIC		"glibc-ld.so.auxcache-2.0"
+#define AUX_CACHEMAGIC		"glibc-ld.so.auxcache-3.0"
 
 struct aux_cache_file_entry
 {
@@ -926,6 +1360,7 @@ struct aux_cache_file_entry
   int32_t flags;		/* This is 1 for an ELF library.  */
   uint32_t soname;		/* String table indice.  */
   uint32_t isa_level;		/* Required ISA level.	 */
+  uint32_t runpath;		/* String table indice of DT_RUNPATH.  */
 };
 
 /* ldconfig maintains an auxiliary cache file that allows
@@ -976,7 +1411,7 @@ init_aux_cache (void)
 
 int
 search_aux_cache (struct stat *stat_buf, int *flags, unsigned int *isa_level,
-		  char **soname)
+		  char **soname, char **runpath)
 {
   struct aux_cache_entry_id id;
   id.ino = (uint64_t) stat_buf->st_ino;
@@ -998,6 +1433,10 @@ search_aux_cache (struct stat *stat_buf, int *flags, unsigned int *isa_level,
 	  *soname = xstrdup (entry->soname);
 	else
 	  *soname = NULL;
+	if (entry->runpath != NULL)
+	  *runpath = xstrdup (entry->runpath);
+	else
+	  *runpath = NULL;
 	entry->used = 1;
 	return 1;
       }
@@ -1007,7 +1446,8 @@ search_aux_cache (struct stat *stat_buf, int *flags, unsigned int *isa_level,
 
 static void
 insert_to_aux_cache (struct aux_cache_entry_id *id, int flags,
-		     unsigned int isa_level, const char *soname, int used)
+		     unsigned int isa_level, const char *soname,
+		     const char *runpath, int used)
 {
   size_t hash = aux_cache_entry_id_hash (id) % aux_hash_size;
   struct aux_cache_entry *entry;
@@ -1019,7 +1459,8 @@ insert_to_aux_cache (struct aux_cache_entry_id *id, int flags,
       abort ();
 
   size_t len = soname ? strlen (soname) + 1 : 0;
-  entry = xmalloc (sizeof (struct aux_cache_entry) + len);
+  size_t runpath_len = runpath ? strlen (runpath) + 1 : 0;
+  entry = xmalloc (sizeof (struct aux_cache_entry) + len + runpath_len);
   entry->id = *id;
   entry->flags = flags;
   entry->isa_level = isa_level;
@@ -1028,20 +1469,25 @@ insert_to_aux_cache (struct aux_cache_entry_id *id, int flags,
     entry->soname = memcpy ((char *) (entry + 1), soname, len);
   else
     entry->soname = NULL;
+  if (runpath != NULL)
+    entry->runpath = memcpy ((char *) (entry + 1) + len, runpath,
+			     runpath_len);
+  else
+    entry->runpath = NULL;
   entry->next = aux_hash[hash];
   aux_hash[hash] = entry;
 }
 
 void
 add_to_aux_cache (struct stat *stat_buf, int flags, unsigned int isa_level,
-		  const char *soname)
+		  const char *soname, const char *runpath)
 {
   struct aux_cache_entry_id id;
   id.ino = (uint64_t) stat_buf->st_ino;
   id.ctime = (uint64_t) stat_buf->st_ctime;
   id.size = (uint64_t) stat_buf->st_size;
   id.dev = (uint64_t) stat_buf->st_dev;
-  insert_to_aux_cache (&id, flags, isa_level, soname, 1);
+  insert_to_aux_cache (&id, flags, isa_level, soname, runpath, 1);
 }
 
 /* Load auxiliary cache to search for unchanged entries.   */
@@ -1092,6 +1538,8 @@ load_aux_cache (const char *aux_cache_name)
 			 aux_cache->libs[i].isa_level,
 			 aux_cache->libs[i].soname == 0
 			 ? NULL : aux_cache_data + aux_cache->libs[i].soname,
+			 aux_cache->libs[i].runpath == 0
+			 ? NULL : aux_cache_data + aux_cache->libs[i].runpath,
 			 0);
 
   munmap (aux_cache, aux_cache_size);
@@ -1115,6 +1563,8 @@ save_aux_cache (const char *aux_cache_name)
 	  ++cache_entry_count;
 	  if (entry->soname != NULL)
 	    total_strlen += strlen (entry->soname) + 1;
+	  if (entry->runpath != NULL)
+	    total_strlen += strlen (entry->runpath) + 1;
 	}
 
   /* Auxiliary cache.  */
@@ -1157,6 +1607,16 @@ save_aux_cache (const char *aux_cache_name)
 	      str = mempcpy (str, entry->soname, len);
 	      str_offset += len;
 	    }
+	  if (entry->runpath == NULL)
+	    file_entries->libs[idx].runpath = 0;
+	  else
+	    {
+	      file_entries->libs[idx].runpath = str_offset;
+
+	      size_t len = strlen (entry->runpath) + 1;
+	      str = mempcpy (str, entry->runpath, len);
+	      str_offset += len;
+	    }
 	  file_entries->libs[idx++].isa_level = entry->isa_level;
 	}
 
@@ -196,6 +196,113 @@ _dl_cache_file_entry (const struct file_entry *libs, size_t entry_size,
   return (const void *) libs + index * entry_size;
 }
 
+/* Return the best usable entry of the group of entries of LIBS which
+   starts at FIRST, whose name is known to match NAME, and ends at LAST
+   at the latest.  The following entries are part of the group as long
+   as their name matches NAME.  STRING_TABLE_SIZE is as for
+   search_cache below.  */
+static const char *
+search_cache_group (const char *string_table, uint32_t string_table_size,
+		    const struct file_entry *libs, uint32_t entry_size,
+		    const char *name, int first, int last)
+{
+  const char *best = NULL;
+#ifdef SHARED
+  uint32_t best_priority = 0;
+#endif
+
+  int middle = first;
+  do
+    {
+      int flags;
+      const struct file_entry *lib
+	= _dl_cache_file_entry (libs, entry_size, middle);
+
+      /* The name of the entry at FIRST is known to match.  */
+      if (middle > first
+	  /* Test whether the index is ok and whether the name
+	     matches.  Otherwise we are done.  */
+	  && (! _dl_cache_verify_ptr (lib->key, string_table_size)
+	      || (_dl_cache_libcmp (name, string_table + lib->key)
+		  != 0)))
+	break;
+
+      flags = lib->flags;
+      if (_dl_cache_check_flags (flags)
+	  && _dl_cache_verify_ptr (lib->value, string_table_size))
+	{
+	  /* Named/extension hwcaps get slightly different
+	     treatment: We keep searching for a better
+	     match.  */
+	  bool named_hwcap = false;
+
+	  if (entry_size >= sizeof (struct file_entry_new))
+	    {
+	      /* The entry is large enough to include
+		 HWCAP data.  Check it.  */
+	      struct file_entry_new *libnew
+		= (struct file_entry_new *) lib;
+
+#ifdef SHARED
+	      named_hwcap = dl_cache_hwcap_extension (libnew);
+	      if (named_hwcap
+		  && !dl_cache_hwcap_isa_level_compatible (libnew))
+		continue;
+#endif
+
+	      /* The entries with named/extension hwcaps have
+		 been exhausted (they are listed before all
+		 other entries).  Return the best match
+		 encountered so far if there is one.  */
+	      if (!named_hwcap && best != NULL)
+		break;
+
+	      /* Skip entries with the legacy hwcap/platform mechanism
+		 which was removed with glibc 2.37.  */
+	      if (!named_hwcap && libnew->hwcap != 0)
+		continue;
+
+#ifdef SHARED
+	      /* For named hwcaps, determine the priority and
+		 see if beats what has been found so far.  */
+	      if (named_hwcap)
+		{
+		  uint32_t entry_priority
+		    = glibc_hwcaps_priority (libnew->hwcap);
+		  if (entry_priority == 0)
+		    /* Not usable at all.  Skip.  */
+		    continue;
+		  else if (best == NULL
+			   || entry_priority < best_priority)
+		    /* This entry is of higher priority
+		       than the previous one, or it is the
+		       first entry.  */
+		    best_priority = entry_priority;
+		  else
+		    /* An entry has already been found,
+		       but it is a better match.  */
+		    continue;
+		}
+#endif /* SHARED */
+	    }
+
+	  best = string_table + lib->value;
+
+	  if (!named_hwcap && flags == _DL_CACHE_DEFAULT_ID)
+	    /* With named hwcaps, we need to keep searching to
+	       see if we find a better match.  A better match
+	       is also possible if the flags of the current
+	       entry do not match the expected cache flags.
+	       But if the flags match, no better entry will be
+	       found.  */
+	    break;
+	}
+    }
+  while (++middle <= last);
+
+  return best;
+}
+
 /* We use binary search since the table is sorted in the cache file.
    The first matching entry in the table is returned.  It is important
    to use the same algorithm as used while generating the cache file.
@@ -208,10 +315,6 @@ search_cache (const char *string_table, uint32_t string_table_size,
 {
   int left = 0;
   int right = nlibs - 1;
-  const char *best = NULL;
-#ifdef SHARED
-  uint32_t best_priority = 0;
-#endif
 
   while (left <= right)
     {
@@ -227,12 +330,8 @@ search_cache (const char *string_table, uint32_t string_table_size,
       int cmpres = _dl_cache_libcmp (name, string_table + key);
       if (__glibc_unlikely (cmpres == 0))
 	{
-	  /* Found it.  LEFT now marks the last entry for which we
-	     know the name is correct.  */
-	  left = middle;
-
-	  /* There might be entries with this name before the one we
-	     found.  So we have to find the beginning.  */
+	  /* Found it.  There might be entries with this name before
+	     the one we found.  So we have to find the beginning.  */
 	  while (middle > 0)
 	    {
 	      key = _dl_cache_file_entry (libs, entry_size, middle - 1)->key;
@@ -245,95 +344,8 @@ search_cache (const char *string_table, uint32_t string_table_size,
 	      --middle;
 	    }
 
-	  do
-	    {
-	      int flags;
-	      const struct file_entry *lib
-		= _dl_cache_file_entry (libs, entry_size, middle);
-
-	      /* Only perform the name test if necessary.  */
-	      if (middle > left
-		  /* We haven't seen this string so far.  Test whether the
-		     index is ok and whether the name matches.  Otherwise
-		     we are done.  */
-		  && (! _dl_cache_verify_ptr (lib->key, string_table_size)
-		      || (_dl_cache_libcmp (name, string_table + lib->key)
-			  != 0)))
-		break;
-
-	      flags = lib->flags;
-	      if (_dl_cache_check_flags (flags)
-		  && _dl_cache_verify_ptr (lib->value, string_table_size))
-		{
-		  /* Named/extension hwcaps get slightly different
-		     treatment: We keep searching for a better
-		     match.  */
-		  bool named_hwcap = false;
-
-		  if (entry_size >= sizeof (struct file_entry_new))
-		    {
-		      /* The entry is large enough to include
-			 HWCAP data.  Check it.  */
-		      struct file_entry_new *libnew
-			= (struct file_entry_new *) lib;
-
-#ifdef SHARED
-		      named_hwcap = dl_cache_hwcap_extension (libnew);
-		      if (named_hwcap
-			  && !dl_cache_hwcap_isa_level_compatible (libnew))
-			continue;
-#endif
-
-		      /* The entries with named/extension hwcaps have
-			 been exhausted (they are listed before all
-			 other entries).  Return the best match
-			 encountered so far if there is one.  */
-		      if (!named_hwcap && best != NULL)
-			break;
-
-		      /* Skip entries with the legacy hwcap/platform mechanism
-			 which was removed with glibc 2.37.  */
-		      if (!named_hwcap && libnew->hwcap != 0)
-			continue;
-
-#ifdef SHARED
-		      /* For named hwcaps, determine the priority and
-			 see if beats what has been found so far.  */
-		      if (named_hwcap)
-			{
-			  uint32_t entry_priority
-			    = glibc_hwcaps_priority (libnew->hwcap);
-			  if (entry_priority == 0)
-			    /* Not usable at all.  Skip.  */
-			    continue;
-			  else if (best == NULL
-				   || entry_priority < best_priority)
-			    /* This entry is of higher priority
-			       than the previous one, or it is the
-			       first entry.  */
-			    best_priority = entry_priority;
-			  else
-			    /* An entry has already been found,
-			       but it is a better match.  */
-			    continue;
-			}
-#endif /* SHARED */
-		    }
-
-		  best = string_table + lib->value;
-
-		  if (!named_hwcap && flags == _DL_CACHE_DEFAULT_ID)
-		    /* With named hwcaps, we need to keep searching to
-		       see if we find a better match.  A better match
-		       is also possible if the flags of the current
-		       entry do not match the expected cache flags.
-		       But if the flags match, no better entry will be
-		       found.  */
-		    break;
-		}
-	    }
-	  while (++middle <= right);
-	  break;
+	  return search_cache_group (string_table, string_table_size, libs,
+				     entry_size, name, middle, right);
 	}
 
       if (cmpres < 0)
@@ -342,7 +354,58 @@ search_cache (const char *string_table, uint32_t string_table_size,
 	right = middle - 1;
     }
 
-  return best;
+  return NULL;
+}
+
+/* Look up NAME in the cache_extension_tag_soname_hash section of the
+   new format cache.  Return false if the section is missing or
+   corrupt, in which case the sorted entries have to be searched
+   instead.  Otherwise, store in *INDEX the index of the first entry
+   whose name matches NAME, or -1 if there is none, and return
+   true.  */
+static bool
+search_cache_hash (const char *name, int *index)
+{
+  const struct cache_soname_hash *table
+    = ext.sections[cache_extension_tag_soname_hash].base;
+  size_t size = ext.sections[cache_extension_tag_soname_hash].size;
+  if (table == NULL
+      || size < sizeof (*table)
+      || table->nslots == 0
+      || (table->nslots & (table->nslots - 1)) != 0
+      || ((size - sizeof (*table)) / sizeof (table->slots[0])
+	  < table->nslots))
+    return false;
+
+  const char *string_table = (const char *) cache_new;
+  uint32_t hash = _dl_cache_soname_hash (name);
+  uint32_t mask = table->nslots - 1;
+  for (uint32_t i = 0; i <= mask; ++i)
+    {
+      uint32_t slot = (hash + i) & mask;
+      uint32_t entry = table->slots[slot].index;
+      if (entry == CACHE_SONAME_HASH_EMPTY)
+	break;
+      if (table->slots[slot].hash != hash)
+	continue;
+
+      /* Make sure the index and the string table index are not bogus
+	 before using them.  */
+      if (entry >= cache_new->nlibs
+	  || !_dl_cache_verify_ptr (cache_new->libs[entry].entry.key,
+				    cachesize))
+	return false;
+      if (_dl_cache_libcmp (name,
+			    string_table + cache_new->libs[entry].entry.key)
+	  == 0)
+	{
+	  *index = entry;
+	  return true;
+	}
+    }
+
+  *index = -1;
+  return true;
 }
 
 int
@@ -570,9 +633,17 @@ _dl_load_cache_lookup (const char *name)
   if (cache_new != NULL)
     {
       const char *string_table = (const char *) cache_new;
-      best = search_cache (string_table, cachesize,
-			   &cache_new->libs[0].entry, cache_new->nlibs,
-			   sizeof (cache_new->libs[0]), name);
+      int index;
+      if (search_cache_hash (name, &index))
+	best = (index < 0 ? NULL
+		: search_cache_group (string_table, cachesize,
+				      &cache_new->libs[0].entry,
+				      sizeof (cache_new->libs[0]), name,
+				      index, cache_new->nlibs - 1));
+      else
+	best = search_cache (string_table, cachesize,
+			     &cache_new->libs[0].entry, cache_new->nlibs,
+			     sizeof (cache_new->libs[0]), name);
     }
   else
     {
@@ -670,3 +741,69 @@ _dl_load_cache_tunables (const char **data)
 
   return thc;
 }
+
+/* Return a copy of the hash values of the names in the directory DIR,
+   of length DIRLEN and without a trailing slash, recorded in
+   ld.so.cache, and store their number in *COUNT.  Return null if the
+   directory is not recorded, or if its device DEV, inode number INO or
+   modification time MTIME_SEC and MTIME_NSEC differ from the recorded
+   ones.  The caller is responsible for freeing the returned array.  As in
+   _dl_load_cache_lookup, the returned data must not refer to the
+   mapping of ld.so.cache.  */
+uint32_t *
+_dl_load_cache_directory (const char *dir, size_t dirlen, uint64_t dev,
+			  uint64_t ino, int64_t mtime_sec, uint32_t mtime_nsec,
+			  uint32_t *count)
+{
+  if (_dl_check_ldsocache_needs_loading ())
+    _dl_maybe_load_ldsocache ();
+
+  if (cache_new == NULL)
+    return NULL;
+
+  const char *base = ext.sections[cache_extension_tag_directories].base;
+  size_t size = ext.sections[cache_extension_tag_directories].size;
+  const struct cache_directories *dirs = (const void *) base;
+  if (base == NULL
+      || size < sizeof (*dirs)
+      || ((size - sizeof (*dirs)) / sizeof (dirs->directories[0])
+	  < dirs->count))
+    return NULL;
+
+  for (uint32_t i = 0; i < dirs->count; ++i)
+    {
+      const struct cache_directory *d = &dirs->directories[i];
+      if (d->name >= size
+	  || size - d->name <= dirlen
+	  || memcmp (base + d->name, dir, dirlen) != 0
+	  || base[d->name + dirlen] != '\0')
+	continue;
+
+      if (d->dev != dev
+	  || d->ino != ino
+	  || d->mtime_sec != mtime_sec
+	  || d->mtime_nsec != mtime_nsec
+	  || (d->hashes % sizeof (uint32_t)) != 0
+	  || d->hashes > size
+	  || (size - d->hashes) / sizeof (uint32_t) < d->count)
+	return NULL;
+
+      /* Copy the hash values out of the mapping without malloc first,
+	 see _dl_load_cache_lookup.  */
+      uint32_t n = d->count;
+      size_t len = n * sizeof (uint32_t);
+      struct dl_scratch_buffer scratch = dl_scratch_buffer_init ();
+      dl_scratch_buffer_allocate (&scratch, len, DL_SCRATCH_NO_MALLOC);
+      memcpy (scratch.data, base + d->hashes, len);
+      uint32_t *result = malloc (len > 0 ? len : 1);
+      if (result != NULL)
+	{
+	  memcpy (result, scratch.data, len);
+	  *count = n;
+	}
+      dl_scratch_buffer_free (&scratch);
+      return result;
+    }
+
+  return NULL;
+}
@@ -0,0 +1,260 @@
+/* Index of the names in the library search directories.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* open_path tries to open a shared object in each directory of the
+   search path, and in each glibc-hwcaps subdirectory of them, until it
+   is found.  With glibc.rtld.search_dir_index, each directory is read
+   once instead, when it is searched for the first time, and the hash
+   values of the names it contains are kept, so that the directories
+   which do not contain the object are skipped without a system call.
+   The contents of the directories recorded by ldconfig in ld.so.cache
+   are used instead of reading them if the directories did not change
+   since.  Objects added to a directory after it was read are not
+   found, which is why the index is not used by default.  */
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ldsodefs.h>
+#include <not-cancel.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <dl-dir-index.h>
+#include <dl-new-hash.h>
+#include <dl-tunables.h>
+
+struct dl_dir_index
+{
+  struct dl_dir_index *next;
+
+  /* Sorted, distinct _dl_new_hash values of the names in the
+     directory.  Null if the directory could not be read.  */
+  uint32_t *hashes;
+  uint32_t count;
+
+  /* False if the directory does not exist.  */
+  bool exists;
+
+  /* The directory, with a trailing slash.  */
+  size_t dirlen;
+  char dir[];
+};
+
+/* The directories looked up so far.  Protected by dl_load_lock.  */
+static struct dl_dir_index *dir_indices;
+
+static void
+sift_down (uint32_t *hashes, size_t root, size_t count)
+{
+  uint32_t value = hashes[root];
+  while (true)
+    {
+      size_t child = 2 * root + 1;
+      if (child >= count)
+	break;
+      if (child + 1 < count && hashes[child + 1] > hashes[child])
+	++child;
+      if (hashes[child] <= value)
+	break;
+      hashes[root] = hashes[child];
+      root = child;
+    }
+  hashes[root] = value;
+}
+
+/* Sort the COUNT values in HASHES, remove the duplicates and return
+   the number of distinct values.  qsort cannot be used in the dynamic
+   loader, so this is a heap sort.  */
+static size_t
+sort_hashes (uint32_t *hashes, size_t count)
+{
+  for (size_t i = count / 2; i-- > 0; )
+    sift_down (hashes, i, count);
+  for (size_t end = count; end-- > 1; )
+    {
+      uint32_t tmp = hashes[0];
+      hashes[0] = hashes[end];
+      hashes[end] = tmp;
+      sift_down (hashes, 0, end);
+    }
+
+  size_t n = 0;
+  for (size_t i = 0; i < count; ++i)
+    if (n == 0 || hashes[i] != hashes[n - 1])
+      hashes[n++] = hashes[i];
+  return n;
+}
+
+/* Read the directory PATH and return the hash values of the names of
+   its entries, and store their number in *COUNT.  Return null on
+   failure.  */
+static uint32_t *
+read_directory (const char *path, uint32_t *count)
+{
+  int fd = __open64_nocancel (path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0)
+    return NULL;
+
+  char buf[4096] __attribute__ ((aligned (__alignof__ (struct dirent64))));
+  uint32_t *hashes = NULL;
+  size_t n = 0;
+  size_t allocated = 0;
+  while (true)
+    {
+      ssize_t len = __getdents64 (fd, buf, sizeof buf);
+      if (len <= 0)
+	{
+	  if (len < 0)
+	    goto fail;
+	  break;
+	}
+
+      for (size_t offset = 0; offset < len; )
+	{
+	  struct dirent64 *d = (struct dirent64 *) (buf + offset);
+	  offset += d->d_reclen;
+
+	  if (n == allocated)
+	    {
+	      /* With the minimal malloc, the array is the last block, so
+		 realloc extends it in place.  */
+	      allocated = allocated == 0 ? 64 : 2 * allocated;
+	      uint32_t *new = realloc (hashes, allocated * sizeof (*hashes));
+	      if (new == NULL)
+		goto fail;
+	      hashes = new;
+	    }
+	  hashes[n++] = _dl_new_hash (d->d_name);
+	}
+    }
+
+  __close_nocancel_nostatus (fd);
+  *count = sort_hashes (hashes, n);
+  return hashes;
+
+ fail:
+  __close_nocancel_nostatus (fd);
+  free (hashes);
+  return NULL;
+}
+
+/* Add the index of the directory DIR, of length DIRLEN, to the list.
+   Return null if it cannot be allocated.  */
+static struct dl_dir_index *
+dir_index_read (const char *dir, size_t dirlen)
+{
+  /* The path without the trailing slash, for the system calls.  */
+  char path[dirlen];
+  memcpy (path, dir, dirlen - 1);
+  path[dirlen - 1] = '\0';
+
+  bool exists = true;
+  bool cached = false;
+  uint32_t *hashes = NULL;
+  uint32_t count = 0;
+  struct __stat64_t64 st;
+  if (__stat64_time64 (path, &st) != 0)
+    {
+      if (errno != ENOENT && errno != ENOTDIR)
+	/* Let open_path report the error.  */
+	return NULL;
+      exists = false;
+    }
+  else if (!S_ISDIR (st.st_mode))
+    exists = false;
+  else
+    {
+#ifdef USE_LDCONFIG
+      hashes = _dl_load_cache_directory (path, dirlen - 1, st.st_dev,
+					 st.st_ino, st.st_mtim.tv_sec,
+					 st.st_mtim.tv_nsec, &count);
+      cached = hashes != NULL;
+#endif
+      if (hashes == NULL)
+	hashes = read_directory (path, &count);
+    }
+
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
+    {
+      if (!exists)
+	_dl_debug_printf ("  no directory=%s\n", path);
+      else if (hashes != NULL)
+	_dl_debug_printf ("  indexed directory=%s, %u names%s\n", path,
+			  (unsigned int) count,
+			  cached ? " (from ld.so.cache)" : "");
+    }
+
+  struct dl_dir_index *index = malloc (sizeof (*index) + dirlen);
+  if (index == NULL)
+    {
+      free (hashes);
+      return NULL;
+    }
+  index->hashes = hashes;
+  index->count = count;
+  index->exists = exists;
+  index->dirlen = dirlen;
+  memcpy (index->dir, dir, dirlen);
+  index->next = dir_indices;
+  dir_indices = index;
+  return index;
+}
+
+enum dl_dir_index_result
+_dl_dir_index_lookup (const char *dir, size_t dirlen, const char *name)
+{
+  /* The root directory is not indexed, as its path without the
+     trailing slash is empty.  */
+  if (TUNABLE_GET_FULL (glibc, rtld, search_dir_index, int32_t, NULL) == 0
+      || dir[0] != '/' || dirlen < 2)
+    return dl_dir_index_unknown;
+
+  struct dl_dir_index *index;
+  for (index = dir_indices; index != NULL; index = index->next)
+    if (index->dirlen == dirlen && memcmp (index->dir, dir, dirlen) == 0)
+      break;
+  if (index == NULL)
+    {
+      index = dir_index_read (dir, dirlen);
+      if (index == NULL)
+	return dl_dir_index_unknown;
+    }
+
+  if (!index->exists)
+    return dl_dir_index_no_directory;
+  if (index->hashes == NULL)
+    return dl_dir_index_unknown;
+
+  /* Different names may have the same hash value, so the name may
+     still be absent if the hash value is found.  */
+  uint32_t hash = _dl_new_hash (name);
+  size_t left = 0;
+  size_t right = index->count;
+  while (left < right)
+    {
+      size_t middle = left + (right - left) / 2;
+      if (index->hashes[middle] == hash)
+	return dl_dir_index_unknown;
+      if (index->hashes[middle] < hash)
+	left = middle + 1;
+      else
+	right = middle;
+    }
+  return dl_dir_index_absent;
+}
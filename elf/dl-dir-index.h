@@ -0,0 +1,46 @@
+/* Index of the names in the library search directories.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_DIR_INDEX_H
+#define _DL_DIR_INDEX_H
+
+#include <stddef.h>
+
+/* Result of _dl_dir_index_lookup.  */
+enum dl_dir_index_result
+{
+  /* The directory is not indexed, or it may contain the name.  The
+     file has to be opened.  */
+  dl_dir_index_unknown,
+  /* The directory does not contain the name.  */
+  dl_dir_index_absent,
+  /* The directory does not exist.  */
+  dl_dir_index_no_directory,
+};
+
+/* Look up NAME in the index of the absolute directory DIR, of length
+   DIRLEN and ending with a slash, which is read when it is looked up
+   for the first time.  Return dl_dir_index_unknown if the
+   glibc.rtld.search_dir_index tunable is not set.  Called with
+   dl_load_lock held, or before the program starts.  */
+enum dl_dir_index_result _dl_dir_index_lookup (const char *dir,
+					       size_t dirlen,
+					       const char *name)
+  attribute_hidden;
+
+#endif /* _DL_DIR_INDEX_H */
@@ -44,6 +44,7 @@
 #include <libc-pointer-arith.h>
 #include <array_length.h>
 
+#include <dl-dir-index.h>
 #include <dl-dst.h>
 #include <dl-load.h>
 #include <dl-map-segments.h>
@@ -1822,6 +1823,26 @@ open_path (const char *name, size_t namelen, int mode,
 	  buflen = (char *) __mempcpy (edp, name, namelen) - buf;
 #endif
 
+	  /* Skip the directory without trying to open the file if its
+	     index shows that the file is not there.  As below, the
+	     directory information is not used when loading auditing
+	     code.  */
+	  if (loader == NULL
+	      || GL(dl_ns)[loader->l_ns]._ns_loaded->l_auditing == 0)
+	    switch (_dl_dir_index_lookup (buf, buflen - namelen, name))
+	      {
+	      case dl_dir_index_no_directory:
+		this_dir->status[cnt] = nonexisting;
+		continue;
+	      case dl_dir_index_absent:
+		this_dir->status[cnt] = existing;
+		here_any = 1;
+		errno = ENOENT;
+		continue;
+	      case dl_dir_index_unknown:
+		break;
+	      }
+
 	  /* Print name we try if this is wanted.  */
 	  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_LIBS))
 	    _dl_debug_printf ("  trying file=%s\n", buf);
@@ -19,6 +19,7 @@
 #include <ldsodefs.h>
 #include <string.h>
 #include <elf_machine_sym_no_match.h>
+#include <dl-gnu-hash-chain.h>
 #include <dl-hash.h>
 
 /* This function corresponds to do_lookup_x in elf/dl-lookup.c.  The
@@ -80,17 +81,18 @@ _dl_lookup_direct (struct link_map *map,
         {
           const Elf32_Word *hasharr = &map->l_gnu_chain_zero[bucket];
 
-          do
-            if (((*hasharr ^ new_hash) >> 1) == 0)
-              {
-                Elf_Symndx symidx = ELF_MACHINE_HASH_SYMIDX (map, hasharr);
-                const ElfW(Sym) *sym = check_match (map, undef_name,
-                                                    version, version_hash,
-                                                    symidx);
-                if (sym != NULL)
-                  return sym;
-              }
-          while ((*hasharr++ & 1u) == 0);
+          while ((hasharr = _dl_gnu_hash_chain_find (hasharr, new_hash))
+                 != NULL)
+            {
+              Elf_Symndx symidx = ELF_MACHINE_HASH_SYMIDX (map, hasharr);
+              const ElfW(Sym) *sym = check_match (map, undef_name,
+                                                  version, version_hash,
+                                                  symidx);
+              if (sym != NULL)
+                return sym;
+              if ((*hasharr++ & 1u) != 0)
+                break;
+            }
         }
     }
   else
@@ -23,6 +23,7 @@
 #include <ldsodefs.h>
 #include <dl-hash.h>
 #include <dl-machine.h>
+#include <dl-gnu-hash-chain.h>
 #include <dl-new-hash.h>
 #include <dl-protected.h>
 #include <sysdep-cancel.h>
@@ -422,18 +423,19 @@ do_lookup_x (const char *undef_name, unsigned int new_hash,
 		{
 		  const Elf32_Word *hasharr = &map->l_gnu_chain_zero[bucket];
 
-		  do
-		    if (((*hasharr ^ new_hash) >> 1) == 0)
-		      {
-			symidx = ELF_MACHINE_HASH_SYMIDX (map, hasharr);
-			sym = check_match (undef_name, ref, version, flags,
-					   type_class, &symtab[symidx], symidx,
-					   strtab, map, &versioned_sym,
-					   &num_versions);
-			if (sym != NULL)
-			  goto found_it;
-		      }
-		  while ((*hasharr++ & 1u) == 0);
+		  while ((hasharr = _dl_gnu_hash_chain_find (hasharr, new_hash))
+			 != NULL)
+		    {
+		      symidx = ELF_MACHINE_HASH_SYMIDX (map, hasharr);
+		      sym = check_match (undef_name, ref, version, flags,
+					 type_class, &symtab[symidx], symidx,
+					 strtab, map, &versioned_sym,
+					 &num_versions);
+		      if (sym != NULL)
+			goto found_it;
+		      if ((*hasharr++ & 1u) != 0)
+			break;
+		    }
 		}
 	    }
 	  /* No symbol found.  */
@@ -473,6 +475,13 @@ do_lookup_x (const char *undef_name, unsigned int new_hash,
 	  if (__glibc_unlikely (dl_symbol_visibility_binds_local_p (sym)))
 	    goto skip;
 
+	  /* Protected symbols may produce warnings, and unique symbols
+	     are entered in a global table.  */
+	  if (__glibc_unlikely (flags & DL_LOOKUP_PARALLEL)
+	      && (ELFW(ST_VISIBILITY) (sym->st_other) == STV_PROTECTED
+		  || ELFW(ST_BIND) (sym->st_info) == STB_GNU_UNIQUE))
+	    return -1;
+
 	  if (ELFW(ST_VISIBILITY) (sym->st_other) == STV_PROTECTED)
 	    _dl_check_protected_symbol (undef_name, undef_map, ref, map,
 					type_class);
@@ -885,3 +894,57 @@ _dl_lookup_symbol_x (const char *undef_name, struct link_map *undef_map,
   *ref = current_value.s;
   return LOOKUP_VALUE (current_value.m);
 }
+
+
+/* Look up UNDEF_NAME for the initial relocation of UNDEF_MAP, like
+   _dl_lookup_symbol_x, but without marking objects as used, printing
+   debugging output, adding dependencies or reporting errors, so that it
+   can run on several threads at once.  Lookups which would need any of
+   these are left to _dl_lookup_symbol_x.  */
+int
+_dl_lookup_symbol_parallel (const char *undef_name,
+			    struct link_map *undef_map,
+			    const ElfW(Sym) *ref,
+			    struct r_scope_elem *symbol_scope[],
+			    const struct r_found_version *version,
+			    int type_class, const ElfW(Sym) **sym,
+			    struct link_map **map)
+{
+  if (ELFW(ST_VISIBILITY) (ref->st_other) == STV_PROTECTED)
+    return -1;
+
+  const unsigned int new_hash = _dl_new_hash (undef_name);
+  unsigned long int old_hash = 0xffffffff;
+  struct sym_val current_value = { NULL, NULL };
+
+  for (struct r_scope_elem **scope = symbol_scope; *scope != NULL; ++scope)
+    {
+      int res = do_lookup_x (undef_name, new_hash, &old_hash, ref,
+			     &current_value, *scope, 0, version,
+			     DL_LOOKUP_FOR_RELOCATE | DL_LOOKUP_PARALLEL,
+			     NULL, type_class, undef_map);
+      if (res < 0)
+	return -1;
+      if (res > 0)
+	break;
+    }
+
+  if (current_value.s == NULL)
+    {
+      /* The error for a strong reference is reported by
+	 _dl_lookup_symbol_x.  */
+      if (ELFW(ST_BIND) (ref->st_info) != STB_WEAK)
+	return -1;
+      *sym = NULL;
+      *map = NULL;
+      return 0;
+    }
+
+  /* Binding to a dlopened object adds a dependency.  */
+  if (current_value.m->l_type == lt_loaded)
+    return -1;
+
+  *sym = current_value.s;
+  *map = current_value.m;
+  return 1;
+}
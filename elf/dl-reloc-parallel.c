@@ -0,0 +1,298 @@
+/* Parallel symbol lookups for the initial relocation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Most of the time of the initial relocation of large objects is spent
+   looking up the symbols referenced by the relocations.  These lookups
+   only read the link maps, so with glibc.rtld.parallel_reloc they are
+   done for the large objects on several threads before the relocation,
+   one object at a time per thread, and the results are stored in a
+   table per object indexed by symbol.  The relocations themselves are
+   still applied by _dl_relocate_object on the main thread, in the usual
+   order, so that IFUNC resolvers, copy relocations, TLS and RELRO are
+   processed exactly as without the tunable, and any error is reported
+   as usual.  Lookups with side effects, such as those of protected or
+   STB_GNU_UNIQUE symbols and of undefined strong references, are left
+   to _dl_lookup_symbol_x.  */
+
+#include <atomic.h>
+#include <dl-parallel.h>
+#include <dl-reloc-parallel.h>
+#include <dl-tunables.h>
+#include <ldsodefs.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <unistd.h>
+#include <dl-machine.h>
+
+/* Only objects with at least this many relocations referencing a symbol
+   are prefetched.  */
+#define DL_RELOC_PREFETCH_MIN 1024
+
+/* A range of REL or RELA relocations.  Both start with r_offset and
+   r_info, so only the size of the entries differs.  */
+struct reloc_range
+{
+  ElfW(Addr) start;
+  ElfW(Addr) size;
+  size_t entsize;
+};
+
+/* Store in RANGES the relocations of L which are processed by
+   _dl_relocate_object before the program starts, and return their
+   number.  */
+static unsigned int
+reloc_ranges (struct link_map *l, struct reloc_range ranges[3])
+{
+  unsigned int n = 0;
+
+#if ! ELF_MACHINE_NO_REL
+  if (l->l_info[DT_REL] != NULL && l->l_info[DT_REL]->d_un.d_ptr != 0)
+    {
+      ranges[n].start = D_PTR (l, l_info[DT_REL]);
+      ranges[n].size = l->l_info[DT_RELSZ]->d_un.d_val;
+      ranges[n].entsize = sizeof (ElfW(Rel));
+      /* Skip the relative relocations, which are sorted first.  */
+      if (l->l_info[VERSYMIDX (DT_RELCOUNT)] != NULL)
+	{
+	  ElfW(Addr) skip = (l->l_info[VERSYMIDX (DT_RELCOUNT)]->d_un.d_val
+			     * sizeof (ElfW(Rel)));
+	  skip = MIN (skip, ranges[n].size);
+	  ranges[n].start += skip;
+	  ranges[n].size -= skip;
+	}
+      ++n;
+    }
+#endif
+#if ! ELF_MACHINE_NO_RELA
+  if (l->l_info[DT_RELA] != NULL && l->l_info[DT_RELA]->d_un.d_ptr != 0)
+    {
+      ranges[n].start = D_PTR (l, l_info[DT_RELA]);
+      ranges[n].size = l->l_info[DT_RELASZ]->d_un.d_val;
+      ranges[n].entsize = sizeof (ElfW(Rela));
+      if (l->l_info[VERSYMIDX (DT_RELACOUNT)] != NULL)
+	{
+	  ElfW(Addr) skip = (l->l_info[VERSYMIDX (DT_RELACOUNT)]->d_un.d_val
+			     * sizeof (ElfW(Rela)));
+	  skip = MIN (skip, ranges[n].size);
+	  ranges[n].start += skip;
+	  ranges[n].size -= skip;
+	}
+      ++n;
+    }
+#endif
+
+  if (l->l_info[DT_PLTREL] != NULL)
+    {
+      ElfW(Addr) start = D_PTR (l, l_info[DT_JMPREL]);
+      ElfW(Addr) size = l->l_info[DT_PLTRELSZ]->d_un.d_val;
+
+      /* The PLT relocations may be included in the range above, as in
+	 _ELF_DYNAMIC_DO_RELOC.  */
+      for (unsigned int i = 0; i < n; ++i)
+	if (ranges[i].size >= size
+	    && ranges[i].start + ranges[i].size == start + size)
+	  ranges[i].size -= size;
+
+      /* They are only processed now if lazy binding is not used.  */
+      if (!GLRO(dl_lazy) || l->l_info[DT_BIND_NOW] != NULL)
+	{
+	  ranges[n].start = start;
+	  ranges[n].size = size;
+	  ranges[n].entsize = (l->l_info[DT_PLTREL]->d_un.d_val == DT_RELA
+			       ? sizeof (ElfW(Rela)) : sizeof (ElfW(Rel)));
+	  ++n;
+	}
+    }
+
+  return n;
+}
+
+/* Return an upper bound of the number of relocations of L referencing
+   a symbol.  */
+static size_t
+reloc_count (struct link_map *l)
+{
+  struct reloc_range ranges[3];
+  unsigned int n = reloc_ranges (l, ranges);
+  size_t count = 0;
+  for (unsigned int i = 0; i < n; ++i)
+    count += ranges[i].size / ranges[i].entsize;
+  return count;
+}
+
+/* Look up the symbols referenced by the relocations of L, and store the
+   results in a new table.  Runs on any of the threads.  */
+static void
+prefetch_object (struct link_map *l)
+{
+  struct reloc_range ranges[3];
+  unsigned int n = reloc_ranges (l, ranges);
+
+  size_t nsyms = 0;
+  for (unsigned int i = 0; i < n; ++i)
+    for (ElfW(Addr) r = ranges[i].start;
+	 r < ranges[i].start + ranges[i].size; r += ranges[i].entsize)
+      nsyms = MAX (nsyms,
+		   (size_t) ELFW(R_SYM) (((const ElfW(Rel) *) r)->r_info) + 1);
+  if (nsyms <= 1)
+    return;
+
+  /* The table is not allocated with malloc, which is not thread-safe
+     in the dynamic linker.  */
+  size_t size = nsyms * sizeof (struct dl_reloc_prefetch);
+  struct dl_reloc_prefetch *table = __mmap (NULL, size,
+					    PROT_READ | PROT_WRITE,
+					    MAP_PRIVATE | MAP_ANONYMOUS,
+					    -1, 0);
+  if (table == MAP_FAILED)
+    return;
+
+  const ElfW(Sym) *symtab = (const void *) D_PTR (l, l_info[DT_SYMTAB]);
+  const char *strtab = (const void *) D_PTR (l, l_info[DT_STRTAB]);
+  const ElfW(Half) *versym = NULL;
+  if (l->l_info[VERSYMIDX (DT_VERSYM)] != NULL)
+    versym = (const void *) D_PTR (l, l_info[VERSYMIDX (DT_VERSYM)]);
+
+  for (unsigned int i = 0; i < n; ++i)
+    for (ElfW(Addr) r = ranges[i].start;
+	 r < ranges[i].start + ranges[i].size; r += ranges[i].entsize)
+      {
+	ElfW(Addr) info = ((const ElfW(Rel) *) r)->r_info;
+	size_t symidx = ELFW(R_SYM) (info);
+	if (symidx == 0)
+	  continue;
+	struct dl_reloc_prefetch *e = &table[symidx];
+	if (e->valid)
+	  continue;
+
+	/* Same conditions as in resolve_map.  */
+	const ElfW(Sym) *ref = &symtab[symidx];
+	if (ELFW(ST_BIND) (ref->st_info) == STB_LOCAL
+	    || dl_symbol_visibility_binds_local_p (ref))
+	  continue;
+
+	/* Same version as in elf_dynamic_do_Rel.  */
+	const struct r_found_version *version = NULL;
+	if (versym != NULL)
+	  {
+	    const struct r_found_version *v
+	      = &l->l_versions[versym[symidx] & 0x7fff];
+	    if (v->hash != 0)
+	      version = v;
+	  }
+
+	int type_class = elf_machine_type_class (ELFW(R_TYPE) (info));
+	if (_dl_lookup_symbol_parallel (strtab + ref->st_name, l, ref,
+					l->l_scope, version, type_class,
+					&e->sym, &e->map) >= 0)
+	  {
+	    e->type_class = type_class;
+	    e->valid = true;
+	  }
+      }
+
+  l->l_reloc_prefetch = table;
+  l->l_reloc_prefetch_count = nsyms;
+}
+
+struct prefetch_work
+{
+  struct link_map **maps;
+  unsigned int nmaps;
+  unsigned int next;
+};
+
+static void
+prefetch_worker (void *closure)
+{
+  struct prefetch_work *work = closure;
+  unsigned int i;
+  while ((i = atomic_fetch_add_relaxed (&work->next, 1)) < work->nmaps)
+    prefetch_object (work->maps[i]);
+}
+
+void
+_dl_reloc_prefetch (struct link_map *main_map)
+{
+  int32_t nthreads = TUNABLE_GET_FULL (glibc, rtld, parallel_reloc,
+				       int32_t, NULL);
+  if (nthreads < 2)
+    return;
+
+  /* The lookups done here are not reported to the auditors, the
+     profiler and the debugging output.  */
+  if (__libc_enable_secure || GLRO(dl_naudit) > 0
+      || GLRO(dl_profile) != NULL
+      || (GLRO(dl_debug_mask) & (DL_DEBUG_SYMBOLS | DL_DEBUG_BINDINGS
+				 | DL_DEBUG_UNUSED)) != 0)
+    return;
+
+  unsigned int nlist = main_map->l_searchlist.r_nlist;
+  struct link_map **maps = malloc (nlist * sizeof (*maps));
+  size_t *counts = malloc (nlist * sizeof (*counts));
+  if (maps == NULL || counts == NULL)
+    goto out;
+
+  /* Take the largest objects first, so that the work is balanced
+     between the threads.  */
+  unsigned int nmaps = 0;
+  for (unsigned int i = 0; i < nlist; ++i)
+    {
+      struct link_map *l = main_map->l_searchlist.r_list[i];
+      if (l->l_relocated || l->l_scope == NULL)
+	continue;
+      size_t count = reloc_count (l);
+      if (count < DL_RELOC_PREFETCH_MIN)
+	continue;
+      unsigned int j = nmaps++;
+      for (; j > 0 && counts[j - 1] < count; --j)
+	{
+	  maps[j] = maps[j - 1];
+	  counts[j] = counts[j - 1];
+	}
+      maps[j] = l;
+      counts[j] = count;
+    }
+  if (nmaps > 0)
+    {
+      struct prefetch_work work = { maps, nmaps, 0 };
+      _dl_parallel_run (prefetch_worker, &work,
+			MIN ((unsigned int) nthreads, nmaps));
+    }
+
+ out:
+  free (counts);
+  free (maps);
+}
+
+void
+_dl_reloc_prefetch_finish (struct link_map *main_map)
+{
+  for (unsigned int i = 0; i < main_map->l_searchlist.r_nlist; ++i)
+    {
+      struct link_map *l = main_map->l_searchlist.r_list[i];
+      if (l->l_reloc_prefetch != NULL)
+	{
+	  __munmap (l->l_reloc_prefetch,
+		    l->l_reloc_prefetch_count
+		    * sizeof (struct dl_reloc_prefetch));
+	  l->l_reloc_prefetch = NULL;
+	  l->l_reloc_prefetch_count = 0;
+	}
+    }
+}
@@ -0,0 +1,68 @@
+/* Parallel symbol lookups for the initial relocation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_RELOC_PARALLEL_H
+#define _DL_RELOC_PARALLEL_H
+
+#include <ldsodefs.h>
+#include <stdbool.h>
+
+/* The result of the lookup of the symbol with the same index in the
+   dynamic symbol table of the object.  */
+struct dl_reloc_prefetch
+{
+  const ElfW(Sym) *sym;
+  struct link_map *map;
+  int type_class;
+  bool valid;
+};
+
+/* Look up the symbols referenced by the relocations of the large
+   objects in the search list of MAIN_MAP on glibc.rtld.parallel_reloc
+   threads, before these objects are relocated.  */
+void _dl_reloc_prefetch (struct link_map *main_map) attribute_hidden;
+
+/* Free the results of _dl_reloc_prefetch.  Called after the initial
+   relocation of the objects.  */
+void _dl_reloc_prefetch_finish (struct link_map *main_map)
+  attribute_hidden;
+
+/* If the lookup of *REF with TYPE_CLASS for the relocation of L was
+   done by _dl_reloc_prefetch, update *REF, store the defining object in
+   *RESULT and return true.  */
+static inline bool
+_dl_reloc_prefetch_lookup (struct link_map *l, const ElfW(Sym) **ref,
+			   int type_class, struct link_map **result)
+{
+  const ElfW(Sym) *symtab = (const void *) D_PTR (l, l_info[DT_SYMTAB]);
+  size_t symidx = *ref - symtab;
+  if (symidx >= l->l_reloc_prefetch_count)
+    return false;
+  const struct dl_reloc_prefetch *e = &l->l_reloc_prefetch[symidx];
+  if (!e->valid || e->type_class != type_class)
+    return false;
+
+  /* Done here, as the lookup did not mark the object as used.  */
+  if (e->map != NULL && e->map->l_used == 0)
+    e->map->l_used = 1;
+  *ref = e->sym;
+  *result = e->map;
+  return true;
+}
+
+#endif /* _DL_RELOC_PARALLEL_H */
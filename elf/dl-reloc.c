@@ -27,6 +27,8 @@
 #include <sys/types.h>
 #include <_itoa.h>
 #include <libc-pointer-arith.h>
+#include <dl-reloc-parallel.h>
+#include <dl-symcache.h>
 #include "dynamic-link.h"
 
 /* Statistics function.  */
@@ -160,14 +162,32 @@ resolve_map (lookup_t l, struct r_scope_elem *scope[], const ElfW(Sym) **ref,
       const int tc = elf_machine_type_class (r_type);
       l->l_lookup_cache.type_class = tc;
       l->l_lookup_cache.sym = *ref;
-      const char *undef_name
-	  = (const char *) D_PTR (l, l_info[DT_STRTAB]) + (*ref)->st_name;
+      lookup_t lr;
       const struct r_found_version *v = NULL;
       if (version != NULL && version->hash != 0)
 	v = version;
-      lookup_t lr = _dl_lookup_symbol_x (
-	  undef_name, l, ref, scope, v, tc,
-	  DL_LOOKUP_ADD_DEPENDENCY | DL_LOOKUP_FOR_RELOCATE, NULL);
+#ifdef SHARED
+      if (__glibc_unlikely (l->l_symcache != NULL)
+	  && _dl_symcache_lookup (l, ref, v, tc, &lr))
+	{
+	  l->l_lookup_cache.ret = *ref;
+	  l->l_lookup_cache.value = lr;
+	  return lr;
+	}
+#endif
+      const char *undef_name
+	  = (const char *) D_PTR (l, l_info[DT_STRTAB]) + (*ref)->st_name;
+#ifdef SHARED
+      if (__glibc_likely (l->l_reloc_prefetch == NULL)
+	  || !_dl_reloc_prefetch_lookup (l, ref, tc, &lr))
+#endif
+	lr = _dl_lookup_symbol_x (
+	    undef_name, l, ref, scope, v, tc,
+	    DL_LOOKUP_ADD_DEPENDENCY | DL_LOOKUP_FOR_RELOCATE, NULL);
+#ifdef SHARED
+      if (__glibc_unlikely (l->l_symcache != NULL))
+	_dl_symcache_record (l, l->l_lookup_cache.sym, tc, lr, *ref);
+#endif
       l->l_lookup_cache.ret = *ref;
       l->l_lookup_cache.value = lr;
     }
@@ -0,0 +1,523 @@
+/* Persistent cache of the symbol lookups of the initial relocation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Programs linked against many objects spend most of their startup time
+   looking up the symbols referenced by relocations.  When the
+   glibc.rtld.symbol_cache tunable names a file, the results of these
+   lookups are written to it after the initial relocation, and the next
+   processes with the same objects in the same search list order take
+   them from the file instead of hashing the symbol names and searching
+   the scopes.  The results are stored as symbol indices, so that they do
+   not depend on the load addresses of the objects.  The objects are
+   identified by their GNU build ID and by the device, inode, size,
+   modification and status change times of their file; if any of them
+   changed, or if the lookups were done with another setting of
+   LD_DYNAMIC_WEAK, the cache is ignored and written again.  Lookups which
+   cannot be replayed that way, such as those of STB_GNU_UNIQUE symbols,
+   are not recorded and done as usual.  A cached result is still only
+   used if its symbol is a definition with the version of the reference.
+   The cache file is ignored unless it belongs to the effective user and
+   cannot be written by others.  */
+
+#include <dl-symcache.h>
+#include <dl-tunables.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <ldsodefs.h>
+#include <libc-pointer-arith.h>
+#include <not-cancel.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <_itoa.h>
+
+static struct
+{
+  /* The file named by the tunable.  */
+  char *path;
+  /* The objects of the search list of the main program.  */
+  struct link_map **maps;
+  unsigned int nobjects;
+  /* Identity of the objects.  */
+  struct dl_symcache_object *objects;
+  /* The mapping of the cache file, or of the entries being recorded.  */
+  void *mapping;
+  size_t mapping_size;
+  bool recording;
+} symcache;
+
+static inline const ElfW(Sym) *
+symtab (struct link_map *l)
+{
+  return (const ElfW(Sym) *) D_PTR (l, l_info[DT_SYMTAB]);
+}
+
+/* Return the number of symbols in the dynamic symbol table of L, or 0 if
+   it is not known.  */
+static uint32_t
+object_nsyms (struct link_map *l)
+{
+  if (l->l_info[ELF_MACHINE_GNU_HASH_ADDRIDX] != NULL)
+    {
+      /* The symbols after the bias are sorted by bucket, and the chain
+	 of the last bucket ends with the last symbol.  */
+      const Elf32_Word *hash32
+	= (const void *) D_PTR (l, l_info[ELF_MACHINE_GNU_HASH_ADDRIDX]);
+      Elf32_Word last = 0;
+      for (Elf_Symndx i = 0; i < l->l_nbuckets; ++i)
+	if (l->l_gnu_buckets[i] > last)
+	  last = l->l_gnu_buckets[i];
+      if (last == 0)
+	/* Only the symbols before the bias, which are not hashed.  */
+	return hash32[1];
+      while ((l->l_gnu_chain_zero[last] & 1) == 0)
+	++last;
+      return last + 1;
+    }
+  if (l->l_info[DT_HASH] != NULL)
+    return ((const Elf_Symndx *) D_PTR (l, l_info[DT_HASH]))[1];
+  return 0;
+}
+
+/* Store the GNU build ID of L in *ID.  */
+static void
+object_build_id (struct link_map *l, struct dl_symcache_object *id)
+{
+  for (const ElfW(Phdr) *ph = l->l_phdr; ph < &l->l_phdr[l->l_phnum]; ++ph)
+    if (ph->p_type == PT_NOTE)
+      {
+	ElfW(Addr) align = ph->p_align == 8 ? 8 : 4;
+	ElfW(Addr) start = l->l_addr + ph->p_vaddr;
+	ElfW(Addr) end = start + ph->p_memsz;
+	while (start + sizeof (ElfW(Nhdr)) <= end)
+	  {
+	    const ElfW(Nhdr) *note = (const ElfW(Nhdr) *) start;
+	    const char *name = (const char *) (note + 1);
+	    const unsigned char *desc
+	      = (const void *) (name + ALIGN_UP (note->n_namesz, align));
+	    start = (ElfW(Addr)) desc + ALIGN_UP (note->n_descsz, align);
+	    if (start > end)
+	      break;
+	    if (note->n_type == NT_GNU_BUILD_ID && note->n_namesz == 4
+		&& memcmp (name, "GNU", 4) == 0)
+	      {
+		id->build_id_len = note->n_descsz;
+		memcpy (id->build_id, desc,
+			MIN (note->n_descsz, DL_SYMCACHE_BUILD_ID_SIZE));
+		return;
+	      }
+	  }
+      }
+}
+
+/* Fill *ID with the identity of L.  Return false if L cannot be
+   identified.  */
+static bool
+object_id (struct link_map *l, struct dl_symcache_object *id)
+{
+  memset (id, 0, sizeof (*id));
+  object_build_id (l, id);
+
+  struct __stat64_t64 st;
+  if (l->l_name[0] != '\0' && __stat64_time64 (l->l_name, &st) == 0)
+    {
+      id->dev = st.st_dev;
+      id->ino = st.st_ino;
+      id->size = st.st_size;
+      id->mtime_sec = st.st_mtim.tv_sec;
+      id->mtime_nsec = st.st_mtim.tv_nsec;
+      id->ctime_sec = st.st_ctim.tv_sec;
+      id->ctime_nsec = st.st_ctim.tv_nsec;
+    }
+  else if (id->build_id_len == 0)
+    /* The main program, started by the kernel, or an object which is not
+       a file.  */
+    return false;
+
+  id->nsyms = object_nsyms (l);
+  return true;
+}
+
+/* Return the DL_SYMCACHE_* flags for the lookups of this process.  */
+static uint32_t
+symcache_flags (void)
+{
+  return GLRO(dl_dynamic_weak) ? DL_SYMCACHE_DYNAMIC_WEAK : 0;
+}
+
+/* Return true if the SIZE bytes of the cache file at FILE match the
+   identity of the objects in IDS and the flags of this process.  */
+static bool
+cache_valid (const void *file, size_t size,
+	     const struct dl_symcache_object *ids, unsigned int nobjects)
+{
+  const struct dl_symcache_header *header = file;
+  if (size < sizeof (*header)
+      || memcmp (header->magic, DL_SYMCACHE_MAGIC, sizeof (header->magic))
+	 != 0
+      || header->nobjects != nobjects
+      || header->flags != symcache_flags ())
+    return false;
+
+  size_t objects_size = nobjects * sizeof (struct dl_symcache_object);
+  if ((size - sizeof (*header)) / sizeof (struct dl_symcache_entry)
+      < header->nentries
+      || size != (sizeof (*header) + objects_size
+		  + header->nentries * sizeof (struct dl_symcache_entry)))
+    return false;
+
+  const struct dl_symcache_object *objects = (const void *) (header + 1);
+  for (unsigned int i = 0; i < nobjects; ++i)
+    if (memcmp (&objects[i], &ids[i],
+		offsetof (struct dl_symcache_object, first)) != 0
+	|| objects[i].first > header->nentries
+	|| objects[i].count > header->nentries - objects[i].first)
+      return false;
+  return true;
+}
+
+/* Map the cache file PATH and store its size in *SIZEP.  Return
+   MAP_FAILED if it cannot be read, or if it does not belong to the
+   effective user or can be written by other users, who could otherwise
+   redirect the symbol references of the program.  */
+static void *
+read_cache (const char *path, size_t *sizep)
+{
+  void *result = MAP_FAILED;
+  struct __stat64_t64 st;
+  int fd = __open64_nocancel (path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return MAP_FAILED;
+  if (__fstat64_time64 (fd, &st) == 0 && S_ISREG (st.st_mode)
+      && st.st_uid == __geteuid ()
+      && (st.st_mode & (S_IWGRP | S_IWOTH)) == 0
+      && st.st_size != 0)
+    {
+      *sizep = st.st_size;
+      result = __mmap (NULL, *sizep, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+  __close_nocancel (fd);
+  return result;
+}
+
+bool
+_dl_symcache_setup (struct link_map *main_map)
+{
+  const struct tunable_str_t *name
+    = TUNABLE_GET_FULL (glibc, rtld, symbol_cache,
+			const struct tunable_str_t *, NULL);
+  if (name->str == NULL || name->len == 0)
+    return false;
+
+  /* The lookups are not replayed to the auditors, the profiler and the
+     debugging output.  */
+  if (__libc_enable_secure || GLRO(dl_naudit) > 0
+      || GLRO(dl_profile) != NULL
+      || (GLRO(dl_debug_mask) & (DL_DEBUG_BINDINGS | DL_DEBUG_UNUSED)) != 0)
+    return false;
+
+  unsigned int nobjects = main_map->l_searchlist.r_nlist;
+  if (nobjects >= DL_SYMCACHE_UNDEFINED)
+    return false;
+  struct link_map **maps = main_map->l_searchlist.r_list;
+
+  struct dl_symcache_object *ids = malloc (nobjects * sizeof (*ids));
+  char *path = malloc (name->len + 1);
+  if (ids == NULL || path == NULL)
+    goto fail;
+  *(char *) __mempcpy (path, name->str, name->len) = '\0';
+
+  size_t total = 0;
+  for (unsigned int i = 0; i < nobjects; ++i)
+    {
+      if (!object_id (maps[i], &ids[i]))
+	goto fail;
+      maps[i]->l_symcache_index = i;
+      total += ids[i].nsyms;
+    }
+
+  size_t size;
+  void *file = read_cache (path, &size);
+  if (file != MAP_FAILED)
+    {
+      if (cache_valid (file, size, ids, nobjects))
+	{
+	  const struct dl_symcache_header *header = file;
+	  const struct dl_symcache_object *objects
+	    = (const void *) (header + 1);
+	  struct dl_symcache_entry *entries
+	    = (void *) (objects + nobjects);
+	  for (unsigned int i = 0; i < nobjects; ++i)
+	    {
+	      maps[i]->l_symcache = entries + objects[i].first;
+	      maps[i]->l_symcache_count = objects[i].count;
+	    }
+
+	  symcache.maps = maps;
+	  symcache.nobjects = nobjects;
+	  symcache.objects = (struct dl_symcache_object *) objects;
+	  symcache.mapping = file;
+	  symcache.mapping_size = size;
+
+	  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+	    _dl_debug_printf ("symbol cache: using %s\n", path);
+	  free (path);
+	  free (ids);
+	  return true;
+	}
+      __munmap (file, size);
+    }
+
+  /* Record the lookups in a table with an entry for each symbol of each
+     object.  Only the pages of the referenced symbols are touched.  */
+  size = total * sizeof (struct dl_symcache_entry);
+  if (size == 0)
+    goto fail;
+  struct dl_symcache_entry *entries = __mmap (NULL, size,
+					      PROT_READ | PROT_WRITE,
+					      MAP_PRIVATE | MAP_ANONYMOUS,
+					      -1, 0);
+  if (entries == MAP_FAILED)
+    goto fail;
+  for (unsigned int i = 0; i < nobjects; ++i)
+    {
+      maps[i]->l_symcache = entries;
+      maps[i]->l_symcache_count = ids[i].nsyms;
+      entries += ids[i].nsyms;
+    }
+
+  symcache.path = path;
+  symcache.maps = maps;
+  symcache.nobjects = nobjects;
+  symcache.objects = ids;
+  symcache.mapping = maps[0]->l_symcache;
+  symcache.mapping_size = size;
+  symcache.recording = true;
+  return false;
+
+ fail:
+  free (path);
+  free (ids);
+  return false;
+}
+
+/* Return true if the symbol with index SYMIDX of M can be the result of
+   a lookup with VERSION, as check_match in dl-lookup.c would find it.
+   Symbols which check_match only accepts when no better match is found
+   are rejected, so that the lookup is done again.  */
+static bool
+symcache_version_match (struct link_map *m, uint32_t symidx,
+			const struct r_found_version *version)
+{
+  const ElfW(Half) *verstab = m->l_versyms;
+  if (verstab == NULL)
+    return true;
+
+  ElfW(Half) ndx = verstab[symidx] & 0x7fff;
+  if (version == NULL)
+    return ndx < 3;
+  return (m->l_versions[ndx].hash == version->hash
+	  && strcmp (m->l_versions[ndx].name, version->name) == 0);
+}
+
+bool
+_dl_symcache_lookup (struct link_map *l, const ElfW(Sym) **ref,
+		     const struct r_found_version *version,
+		     int type_class, struct link_map **result)
+{
+  if (symcache.recording)
+    return false;
+
+  uint32_t symidx = *ref - symtab (l);
+  const struct dl_symcache_entry *entries = l->l_symcache;
+  size_t lo = 0;
+  size_t hi = l->l_symcache_count;
+  while (lo < hi)
+    {
+      size_t mid = (lo + hi) / 2;
+      if (entries[mid].symidx < symidx)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  if (lo == l->l_symcache_count || entries[lo].symidx != symidx
+      || entries[lo].type_class != type_class)
+    return false;
+
+  const struct dl_symcache_entry *e = &entries[lo];
+  if (e->def_object == DL_SYMCACHE_UNDEFINED)
+    {
+      *ref = NULL;
+      *result = NULL;
+      return true;
+    }
+  if (e->def_object >= symcache.nobjects
+      || e->def_symidx >= symcache.objects[e->def_object].nsyms)
+    return false;
+
+  struct link_map *m = symcache.maps[e->def_object];
+  const ElfW(Sym) *sym = symtab (m) + e->def_symidx;
+  if (sym->st_shndx == SHN_UNDEF
+      || !symcache_version_match (m, e->def_symidx, version))
+    return false;
+  *ref = sym;
+  /* As done by _dl_lookup_symbol_x.  */
+  if (__glibc_unlikely (m->l_used == 0))
+    m->l_used = 1;
+  *result = m;
+  return true;
+}
+
+void
+_dl_symcache_record (struct link_map *l, const ElfW(Sym) *undef,
+		     int type_class, struct link_map *result,
+		     const ElfW(Sym) *sym)
+{
+  if (!symcache.recording)
+    return;
+
+  uint32_t symidx = undef - symtab (l);
+  if (symidx >= l->l_symcache_count || l->l_symcache[symidx].valid)
+    return;
+
+  uint32_t def_object;
+  uint32_t def_symidx;
+  if (sym == NULL)
+    {
+      def_object = DL_SYMCACHE_UNDEFINED;
+      def_symidx = 0;
+    }
+  else
+    {
+      /* Lookups of unique symbols have to update the table of unique
+	 symbols, and objects outside the search list (such as the vDSO)
+	 cannot be identified.  */
+      if (ELFW(ST_BIND) (sym->st_info) == STB_GNU_UNIQUE)
+	return;
+      def_object = result->l_symcache_index;
+      if (def_object >= symcache.nobjects
+	  || symcache.maps[def_object] != result)
+	return;
+      def_symidx = sym - symtab (result);
+      if (def_symidx >= symcache.objects[def_object].nsyms)
+	return;
+    }
+
+  struct dl_symcache_entry *e = &l->l_symcache[symidx];
+  e->symidx = symidx;
+  e->def_symidx = def_symidx;
+  e->def_object = def_object;
+  e->type_class = type_class;
+  e->valid = 1;
+}
+
+/* Write LEN bytes at BUF to FD.  */
+static bool
+write_all (int fd, const void *buf, size_t len)
+{
+  while (len > 0)
+    {
+      ssize_t n = __write_nocancel (fd, buf, len);
+      if (n <= 0)
+	{
+	  if (n < 0 && errno == EINTR)
+	    continue;
+	  return false;
+	}
+      buf = (const char *) buf + n;
+      len -= n;
+    }
+  return true;
+}
+
+/* Compact the recorded entries and write them to the cache file.  The
+   file is written under a temporary name and renamed, so that other
+   processes never see a partial cache.  */
+static void
+write_cache (void)
+{
+  struct dl_symcache_entry *entries = symcache.mapping;
+  uint32_t nentries = 0;
+  for (unsigned int i = 0; i < symcache.nobjects; ++i)
+    {
+      struct link_map *l = symcache.maps[i];
+      symcache.objects[i].first = nentries;
+      for (uint32_t j = 0; j < l->l_symcache_count; ++j)
+	if (l->l_symcache[j].valid)
+	  entries[nentries++] = l->l_symcache[j];
+      symcache.objects[i].count = nentries - symcache.objects[i].first;
+    }
+
+  struct dl_symcache_header header = { .magic = DL_SYMCACHE_MAGIC,
+				       .nobjects = symcache.nobjects,
+				       .nentries = nentries,
+				       .flags = symcache_flags () };
+
+  size_t len = strlen (symcache.path);
+  char tmp[len + sizeof (".tmp.") + 3 * sizeof (pid_t)];
+  char pidbuf[3 * sizeof (pid_t)];
+  char *pid = _itoa_word (__getpid (), pidbuf + sizeof (pidbuf), 10, 0);
+  char *p = __mempcpy (__mempcpy (tmp, symcache.path, len), ".tmp.", 5);
+  *(char *) __mempcpy (p, pid, pidbuf + sizeof (pidbuf) - pid) = '\0';
+
+  /* A file left by a process which had the same PID would make the
+     exclusive creation fail.  */
+  __unlink (tmp);
+  int fd = __open64_nocancel (tmp, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+			      0644);
+  if (fd < 0)
+    return;
+  bool ok = (write_all (fd, &header, sizeof (header))
+	     && write_all (fd, symcache.objects,
+			   symcache.nobjects * sizeof (*symcache.objects))
+	     && write_all (fd, entries, nentries * sizeof (*entries)));
+  if (__close_nocancel (fd) != 0)
+    ok = false;
+  if (!ok || __renameat (AT_FDCWD, tmp, AT_FDCWD, symcache.path) != 0)
+    {
+      __unlink (tmp);
+      return;
+    }
+
+  if (__glibc_unlikely (GLRO(dl_debug_mask) & DL_DEBUG_FILES))
+    _dl_debug_printf ("symbol cache: wrote %s\n", symcache.path);
+}
+
+void
+_dl_symcache_finish (void)
+{
+  if (symcache.mapping == NULL)
+    return;
+
+  if (symcache.recording)
+    {
+      write_cache ();
+      free (symcache.path);
+      free (symcache.objects);
+      symcache.path = NULL;
+    }
+
+  for (unsigned int i = 0; i < symcache.nobjects; ++i)
+    symcache.maps[i]->l_symcache = NULL;
+  __munmap (symcache.mapping, symcache.mapping_size);
+  symcache.mapping = NULL;
+  symcache.recording = false;
+}
@@ -0,0 +1,117 @@
+/* Persistent cache of the symbol lookups of the initial relocation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_SYMCACHE_H
+#define _DL_SYMCACHE_H
+
+#include <link.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct r_found_version;
+
+/* The cache file starts with a struct dl_symcache_header, followed by a
+   struct dl_symcache_object for each object in the search list of the
+   main program, in search list order, and by the entries of all the
+   objects.  */
+
+#define DL_SYMCACHE_MAGIC "glibc-symcache2"
+
+struct dl_symcache_header
+{
+  char magic[sizeof (DL_SYMCACHE_MAGIC)];
+  uint32_t nobjects;
+  uint32_t nentries;
+  /* The DL_SYMCACHE_* flags of the lookups.  */
+  uint32_t flags;
+  uint32_t pad;
+};
+
+/* The lookups were done with LD_DYNAMIC_WEAK, which makes them prefer
+   global definitions over weak ones.  */
+#define DL_SYMCACHE_DYNAMIC_WEAK 1
+
+#define DL_SYMCACHE_BUILD_ID_SIZE 32
+
+/* The identity of an object and the location of its entries.  The
+   cache is used only if all the objects have the same identity as when
+   it was written.  */
+struct dl_symcache_object
+{
+  uint64_t dev;
+  uint64_t ino;
+  uint64_t size;
+  int64_t mtime_sec;
+  int64_t ctime_sec;
+  uint32_t mtime_nsec;
+  uint32_t ctime_nsec;
+  /* Length of the GNU build ID, of which at most the first
+     DL_SYMCACHE_BUILD_ID_SIZE bytes are stored.  */
+  uint32_t build_id_len;
+  unsigned char build_id[DL_SYMCACHE_BUILD_ID_SIZE];
+  /* Number of symbols in the dynamic symbol table.  */
+  uint32_t nsyms;
+  /* Index of the first entry of the object, and number of entries.  */
+  uint32_t first;
+  uint32_t count;
+};
+
+/* Value of def_object for a weak reference which was left undefined.  */
+#define DL_SYMCACHE_UNDEFINED UINT16_MAX
+
+/* The result of the lookup of the symbol with index SYMIDX in the
+   dynamic symbol table of the object.  The entries of an object are
+   sorted by SYMIDX.  */
+struct dl_symcache_entry
+{
+  uint32_t symidx;
+  /* Index of the definition in the dynamic symbol table of the object
+     with index DEF_OBJECT.  */
+  uint32_t def_symidx;
+  uint16_t def_object;
+  uint8_t type_class;
+  /* Nonzero if the entry is used, while the cache is recorded.  */
+  uint8_t valid;
+};
+
+/* Load the cache named by the glibc.rtld.symbol_cache tunable for the
+   objects in the search list of MAIN_MAP, or prepare to record it if it
+   is missing or does not match these objects.  Return true if the
+   cache was loaded.  */
+bool _dl_symcache_setup (struct link_map *main_map) attribute_hidden;
+
+/* Write the cache if it was recorded, and stop using it.  Called after
+   the initial relocation of the objects.  */
+void _dl_symcache_finish (void) attribute_hidden;
+
+/* Look up the result of the lookup of *REF with VERSION and TYPE_CLASS
+   for the relocation of L in the cache.  If it is found and its symbol
+   is still a definition with that version, update *REF, store the
+   defining object in *RESULT and return true.  */
+bool _dl_symcache_lookup (struct link_map *l, const ElfW(Sym) **ref,
+			  const struct r_found_version *version,
+			  int type_class, struct link_map **result)
+  attribute_hidden;
+
+/* Record in the cache that the lookup of UNDEF with TYPE_CLASS for the
+   relocation of L found SYM in RESULT.  */
+void _dl_symcache_record (struct link_map *l, const ElfW(Sym) *undef,
+			  int type_class, struct link_map *result,
+			  const ElfW(Sym) *sym) attribute_hidden;
+
+#endif /* _DL_SYMCACHE_H */
@@ -128,12 +128,14 @@ tls_static_surplus (int nns, int opt_tls)
 
 /* Calculate the size of the static TLS surplus, when the given
    number of audit modules are loaded.  Must be called after the
-   number of audit modules is known and before static TLS allocation.  */
+   number of audit modules is known and before static TLS allocation.
+   The other TLS tunables are read here as well.  */
 void
 _dl_tls_static_surplus_init (size_t naudit)
 {
   size_t nns, opt_tls;
 
+  GLRO(dl_tls_prealloc) = TUNABLE_GET (tls_prealloc, int32_t, NULL);
   nns = TUNABLE_GET (nns, size_t, NULL);
   opt_tls = TUNABLE_GET (optional_static_tls, size_t, NULL);
   if (nns > DL_NNS)
@@ -560,10 +562,12 @@ extern dtv_t _dl_static_dtv[];
 static dtv_t *
 _dl_resize_dtv (dtv_t *dtv, size_t max_modid, void *tcb)
 {
-  /* Resize the dtv.  */
+  /* Resize the dtv.  Grow it at least geometrically, so that a thread
+     running while many modules are loaded one after the other does not
+     have to resize it every DTV_SURPLUS modules.  */
   dtv_t *newp;
-  size_t newsize = max_modid + DTV_SURPLUS;
   size_t oldsize = dtv[-1].counter;
+  size_t newsize = MAX (max_modid + DTV_SURPLUS, 2 * oldsize);
 
   if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
     _dl_debug_printf ("tls: DTV resized for TCB 0x%lx: oldsize=%lu, newsize=%lu\n",
@@ -610,6 +614,37 @@ _dl_resize_dtv (dtv_t *dtv, size_t max_modid, void *tcb)
 }
 
 
+#ifdef SHARED
+static struct dtv_pointer allocate_dtv_entry (size_t alignment, size_t size);
+
+/* Allocate and initialize the dynamic TLS block of MAP in DTV, for the
+   thread with TCB.  This is done when the thread is created if
+   GLRO(dl_tls_prealloc), for the modules whose TLS another thread has
+   already accessed dynamically, so that the thread does not have to
+   allocate it on first access.  If the allocation fails, the block is
+   allocated on first access as usual.  */
+static void
+preallocate_dtv_entry (dtv_t *dtv, struct link_map *map, void *tcb)
+{
+  struct dtv_pointer result = allocate_dtv_entry (map->l_tls_align,
+						  map->l_tls_blocksize);
+  if (result.val == NULL)
+    return;
+
+  if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
+    _dl_debug_printf ("tls: preallocate block 0x%lx for modid %lu; size=%lu, TCB=0x%lx\n",
+		      (unsigned long int) result.to_free,
+		      (unsigned long int) map->l_tls_modid,
+		      (unsigned long int) map->l_tls_blocksize,
+		      (unsigned long int) tcb);
+
+  memset (__mempcpy (result.val, map->l_tls_initimage,
+		     map->l_tls_initimage_size),
+	  '\0', map->l_tls_blocksize - map->l_tls_initimage_size);
+  dtv[map->l_tls_modid].pointer = result;
+}
+#endif
+
 /* Allocate initial TLS.  RESULT should be a non-NULL pointer to storage
    for the TLS space.  The DTV may be resized, and so this function may
    call malloc to allocate that space.  The loader's GL(dl_load_tls_lock)
@@ -674,6 +709,12 @@ _dl_allocate_tls_init (void *result, bool main_thread)
 	  dtv[map->l_tls_modid].pointer.val = TLS_DTV_UNALLOCATED;
 	  dtv[map->l_tls_modid].pointer.to_free = NULL;
 
+#ifdef SHARED
+	  if (map->l_tls_offset == FORCED_DYNAMIC_TLS_OFFSET
+	      && GLRO(dl_tls_prealloc) && !main_thread)
+	    preallocate_dtv_entry (dtv, map, result);
+#endif
+
 	  if (map->l_tls_offset == NO_TLS_OFFSET
 	      || map->l_tls_offset == FORCED_DYNAMIC_TLS_OFFSET)
 	    continue;
@@ -878,7 +919,13 @@ _dl_update_slotinfo (unsigned long int req_modid, size_t new_gen)
      it is used in decisions that can affect concurrent stores.  But this
      should only happen if the OOTA value causes UB that justifies the
      concurrent store of the value.  This is not expected to be an issue
-     in practice.  */
+     in practice.
+
+     The max_gen field of each slotinfo list element is the highest
+     generation of its entries, and is stored with them.  If it is not
+     larger than old_gen, all the entries of the element are case (2) or
+     (1), so the whole element is skipped.  Only the elements with entries
+     changed since the last update are walked.  */
   struct dtv_slotinfo_list *listp = GL(dl_tls_dtv_slotinfo_list);
 
   if (dtv[0].counter < new_gen)
@@ -891,7 +938,13 @@ _dl_update_slotinfo (unsigned long int req_modid, size_t new_gen)
       listp =  GL(dl_tls_dtv_slotinfo_list);
       do
 	{
-	  for (size_t cnt = total == 0 ? 1 : 0; cnt < listp->len; ++cnt)
+	  size_t cnt = total == 0 ? 1 : 0;
+
+	  /* Case (2) or (1) for all the entries of this element.  */
+	  if (atomic_load_relaxed (&listp->max_gen) <= dtv[0].counter)
+	    cnt = listp->len;
+
+	  for (; cnt < listp->len; ++cnt)
 	    {
 	      size_t modid = total + cnt;
 
@@ -1282,6 +1335,7 @@ cannot create TLS data structures"));
 
       listp->len = TLS_SLOTINFO_SURPLUS;
       listp->next = NULL;
+      listp->max_gen = 0;
       memset (listp->slotinfo, '\0',
 	      TLS_SLOTINFO_SURPLUS * sizeof (struct dtv_slotinfo));
       /* Synchronize with _dl_update_slotinfo.  */
@@ -1295,6 +1349,7 @@ cannot create TLS data structures"));
       atomic_store_relaxed (&listp->slotinfo[idx].map, l);
       atomic_store_relaxed (&listp->slotinfo[idx].gen,
 			    GL(dl_tls_generation) + 1);
+      atomic_store_relaxed (&listp->max_gen, GL(dl_tls_generation) + 1);
       l->l_tls_in_slotinfo = true;
     }
 
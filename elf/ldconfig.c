@@ -574,6 +574,7 @@ manual_link (char *library)
   char *real_library;
   char *libname;
   char *soname;
+  char *runpath;
   struct stat stat_buf;
   int flag;
   unsigned int isa_level;
@@ -641,12 +642,13 @@ manual_link (char *library)
     }
 
   if (process_file (real_library, library, libname, &flag, &isa_level, &soname,
-		    0, &stat_buf))
+		    &runpath, 0, &stat_buf))
     {
       error (0, 0, _("No link created since soname could not be found for %s"),
 	     library);
       goto out;
     }
+  free (runpath);
   if (soname == NULL)
     soname = xstrdup (libname);
   create_links (real_path, path, libname, soname);
@@ -862,18 +864,30 @@ search_dir (const struct dir_entry *entry)
       /* First search whether the auxiliary cache contains this
 	 library already and it's not changed.  */
       char *soname;
+      char *runpath;
       unsigned int isa_level;
-      if (!search_aux_cache (&lstat_buf, &flag, &isa_level, &soname))
+      if (!search_aux_cache (&lstat_buf, &flag, &isa_level, &soname,
+			     &runpath))
 	{
 	  if (process_file (real_name, file_name, direntry->d_name, &flag,
-			    &isa_level, &soname, is_link, &lstat_buf))
+			    &isa_level, &soname, &runpath, is_link,
+			    &lstat_buf))
 	    {
 	      if (real_name != real_file_name)
 		free (real_name);
 	      goto next;
 	    }
 	  else if (opt_build_cache)
-	    add_to_aux_cache (&lstat_buf, flag, isa_level, soname);
+	    add_to_aux_cache (&lstat_buf, flag, isa_level, soname, runpath);
+	}
+
+      /* Record the contents of the DT_RUNPATH directories in the cache,
+	 so that the dynamic loader does not need to read them.  */
+      if (runpath != NULL)
+	{
+	  if (opt_build_cache)
+	    add_runpath_to_cache (entry->path, runpath, opt_chroot);
+	  free (runpath);
 	}
 
       if (soname == NULL)
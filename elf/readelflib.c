@@ -40,8 +40,8 @@ do								\
 /* Returns 0 if everything is ok, != 0 in case of error.  */
 int
 process_elf_file (const char *file_name, const char *lib, int *flag,
-		  unsigned int *isa_level, char **soname, void *file_contents,
-		  size_t file_length)
+		  unsigned int *isa_level, char **soname, char **runpath,
+		  void *file_contents, size_t file_length)
 {
   int i;
   unsigned int dynamic_addr;
@@ -233,16 +233,21 @@ done:
   if (dynamic_strings == NULL)
     return 1;
 
-  /* Now read the DT_SONAME entries.  */
+  /* Now read the DT_SONAME and DT_RUNPATH entries.  */
   for (dyn_entry = dynamic_segment; dyn_entry->d_tag != DT_NULL;
        ++dyn_entry)
     {
-      if (dyn_entry->d_tag == DT_SONAME)
+      if (dyn_entry->d_tag == DT_SONAME && *soname == NULL)
 	{
 	  char *name = dynamic_strings + dyn_entry->d_un.d_val;
 	  check_ptr (name);
           *soname = xstrdup (name);
-          return 0;
+	}
+      else if (dyn_entry->d_tag == DT_RUNPATH && *runpath == NULL)
+	{
+	  char *path = dynamic_strings + dyn_entry->d_un.d_val;
+	  check_ptr (path);
+	  *runpath = xstrdup (path);
 	}
     }
 
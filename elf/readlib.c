@@ -58,7 +58,8 @@ is_gdb_extension_file (const char *name)
 int
 process_file (const char *real_file_name, const char *file_name,
 	      const char *lib, int *flag, unsigned int *isa_level,
-	      char **soname, int is_link, struct stat *stat_buf)
+	      char **soname, char **runpath, int is_link,
+	      struct stat *stat_buf)
 {
   FILE *file;
   struct stat statbuf;
@@ -71,6 +72,7 @@ process_file (const char *real_file_name, const char *file_name,
   /* Just set FLAG_ELF_LIBC6 as old formats are not supported anymore.  */
   *flag = FLAG_ELF_LIBC6;
   *soname = NULL;
+  *runpath = NULL;
 
   file = fopen (real_file_name, "rb");
   if (file == NULL)
@@ -157,7 +159,7 @@ process_file (const char *real_file_name, const char *file_name,
   else if (elf_header->e_type != ET_DYN)
     ret = 1;
   else if (process_elf_file (file_name, lib, flag, isa_level, soname,
-			     file_contents, statbuf.st_size))
+			     runpath, file_contents, statbuf.st_size))
     ret = 1;
 
  done:
@@ -51,6 +51,8 @@
 #include <get-dynamic-info.h>
 #include <dl-execve.h>
 #include <dl-find_object.h>
+#include <dl-reloc-parallel.h>
+#include <dl-symcache.h>
 #include <dl-audit-check.h>
 #include <dl-call_tls_init_tp.h>
 #include <dl-exec-post.h>
@@ -2242,6 +2244,18 @@ dl_main (const ElfW(Phdr) *phdr,
   /* If we are profiling we also must do lazy relocation.  */
   GLRO(dl_lazy) |= consider_profiling;
 
+  /* Use or record the persistent cache of symbol lookups, if requested
+     with glibc.rtld.symbol_cache.  Otherwise, look up the symbols of
+     the large objects on several threads, if requested with
+     glibc.rtld.parallel_reloc.  */
+  if (!_dl_symcache_setup (main_map))
+    {
+      RTLD_TIMING_VAR (start);
+      rtld_timer_start (&start);
+      _dl_reloc_prefetch (main_map);
+      rtld_timer_accum (&relocate_time, start);
+    }
+
   /* If libc.so has been loaded, relocate it early, after the dynamic
      loader itself.  The initial self-relocation of ld.so should be
      sufficient for IFUNC resolvers in libc.so.  */
@@ -2302,6 +2316,9 @@ dl_main (const ElfW(Phdr) *phdr,
   }
   rtld_timer_stop (&relocate_time, start);
 
+  _dl_symcache_finish ();
+  _dl_reloc_prefetch_finish (main_map);
+
   /* This call must come after the slotinfo array has been filled in
      using _dl_add_to_slotinfo.  */
   _dl_tls_initial_modid_limit_setup ();
@@ -0,0 +1,55 @@
+/* Test the index of the library search directories.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The test is run with glibc.rtld.search_dir_index=1.  The objects are
+   searched in the directories of the library path of the test, and
+   tst-dir-indexmod.so is not in the first one, so the index of that
+   directory must not hide it.  The search for a missing object reads
+   all the directories, so the other searches use their index.  */
+
+#include <dlfcn.h>
+#include <string.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+
+static void
+check_missing (const char *name)
+{
+  TEST_VERIFY (dlopen (name, RTLD_NOW) == NULL);
+  const char *message = dlerror ();
+  TEST_VERIFY (message != NULL && strstr (message, name) != NULL);
+}
+
+static int
+do_test (void)
+{
+  check_missing ("tst-dir-index-missing.so");
+
+  void *handle = xdlopen ("tst-dir-indexmod.so", RTLD_NOW);
+  int (*func) (void) = xdlsym (handle, "dir_index_func");
+  TEST_COMPARE (func (), 42);
+
+  check_missing ("tst-dir-index-missing.so");
+  xdlclose (handle);
+  handle = xdlopen ("tst-dir-indexmod.so", RTLD_NOW);
+  xdlclose (handle);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
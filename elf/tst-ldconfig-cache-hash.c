@@ -0,0 +1,278 @@
+/* Test the hash table of the library names in ld.so.cache.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The hash table of the library names in ld.so.cache has a slot for
+   each group of entries whose names compare equal.  Install libraries
+   whose names are equal for _dl_cache_libcmp but spelled differently,
+   and a group of several entries in glibc-hwcaps subdirectories next to
+   a group with a similar name.  Check in a new process that they are
+   found with the table as written by ldconfig, with a damaged table,
+   and without the table, where the entries are searched with a binary
+   search instead.  */
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xdlfcn.h>
+#include <support/xunistd.h>
+
+#define LIBDIR "/hash/lib"
+
+/* The parts of the ld.so.cache format used by the test, as in
+   sysdeps/generic/dl-cache.h, which cannot be included by tests.  */
+struct cache_file_new
+{
+  char magic_version[20];
+  uint32_t nlibs;
+  uint32_t len_strings;
+  uint8_t flags;
+  uint8_t padding_unsed[3];
+  uint32_t extension_offset;
+};
+#define CACHEMAGIC_VERSION_NEW "glibc-ld.so.cache1.1"
+
+struct cache_extension
+{
+  uint32_t magic;
+  uint32_t count;
+};
+enum { cache_extension_magic = (uint32_t) -358342284 };
+
+struct cache_extension_section
+{
+  uint32_t tag;
+  uint32_t flags;
+  uint32_t offset;
+  uint32_t size;
+};
+
+enum
+  {
+    cache_extension_tag_soname_hash = 4,
+    cache_extension_count = 5,
+  };
+
+/* struct cache_soname_hash is a uint32_t number of slots, a uint32_t
+   unused field, and the slots, each with a uint32_t hash value and a
+   uint32_t index.  */
+#define CACHE_SONAME_HASH_EMPTY UINT32_MAX
+#define CACHE_SONAME_HASH_SLOT(i) (8 + (i) * 8)
+#define CACHE_SONAME_HASH_INDEX(i) (CACHE_SONAME_HASH_SLOT (i) + 4)
+
+static int restart;
+#define CMDLINE_OPTIONS \
+  { "restart", no_argument, &restart, 1 },
+
+/* Check that NAME loads the copy of tst-tls-manydynamicNNmod.so which
+   defines set_value_NN, where NN is INDEX.  */
+static void
+check_load (const char *name, int index)
+{
+  void *handle = dlopen (name, RTLD_NOW);
+  if (handle == NULL)
+    {
+      support_record_failure ();
+      printf ("error: dlopen (\"%s\"): %s\n", name, dlerror ());
+      return;
+    }
+  char *symbol = xasprintf ("set_value_%02d", index);
+  if (dlsym (handle, symbol) == NULL)
+    {
+      support_record_failure ();
+      printf ("error: %s does not define %s\n", name, symbol);
+    }
+  free (symbol);
+  xdlclose (handle);
+}
+
+static int
+handle_restart (void)
+{
+  /* The name in the cache is libhash.so.01.  */
+  check_load ("libhash.so.1", 1);
+  check_load ("libhash.so.01", 1);
+  check_load ("libhash.so.001", 1);
+  TEST_VERIFY (dlopen ("libhash.so.2", RTLD_NOW) == NULL);
+
+  /* The subdirectories prepended with --glibc-hwcaps-prepend are
+     searched first, in order.  */
+  check_load ("libhashgrp.so", 4);
+  check_load ("libhashgrp.so.1", 5);
+  return 0;
+}
+
+static void
+copy_module (int index, const char *path)
+{
+  char *src = xasprintf ("%s/elf/tst-tls-manydynamic%02dmod.so",
+			 support_objdir_root, index);
+  support_copy_file (src, path);
+  free (src);
+}
+
+/* Invoke ldconfig with ARG, which may be null, and return its
+   output.  */
+static char *
+run_ldconfig (const char *arg)
+{
+  char *prog = xasprintf ("%s/ldconfig", support_install_rootsbindir);
+  char *args[] = { prog, (char *) arg, NULL };
+  struct support_capture_subprocess result
+    = support_capture_subprogram (prog, args, NULL);
+  support_capture_subprocess_check (&result, "ldconfig", 0,
+				    sc_allow_stdout);
+  char *out = xstrdup (result.out.buffer);
+  support_capture_subprocess_free (&result);
+  free (prog);
+  return out;
+}
+
+/* Load the libraries in a new process, which reads the cache again.  */
+static void
+run_program (const char *argv0)
+{
+  char *spargv[] = { (char *) support_objdir_elf_ldso,
+		     (char *) "--glibc-hwcaps-prepend",
+		     (char *) "prepend3:prepend2",
+		     (char *) argv0, (char *) "--direct", (char *) "--restart",
+		     NULL };
+  struct support_capture_subprocess result
+    = support_capture_subprogram (spargv[0], spargv, NULL);
+  support_capture_subprocess_check (&result, "tst-ldconfig-cache-hash", 0,
+				    sc_allow_stdout);
+  support_capture_subprocess_free (&result);
+}
+
+/* Return the file offset of the extension section of the cache file FD
+   with tag TAG, and store the offset of its descriptor in *SECTION.
+   Return 0 if there is no such section.  */
+static uint32_t
+find_section (int fd, uint32_t tag, off_t *section)
+{
+  struct cache_file_new header;
+  TEST_COMPARE (pread (fd, &header, sizeof (header), 0), sizeof (header));
+  TEST_COMPARE_BLOB (header.magic_version, sizeof (header.magic_version),
+		     CACHEMAGIC_VERSION_NEW, sizeof (header.magic_version));
+  TEST_VERIFY_EXIT (header.extension_offset != 0);
+
+  struct cache_extension ext;
+  TEST_COMPARE (pread (fd, &ext, sizeof (ext), header.extension_offset),
+		sizeof (ext));
+  TEST_COMPARE (ext.magic, cache_extension_magic);
+  for (uint32_t i = 0; i < ext.count; ++i)
+    {
+      struct cache_extension_section s;
+      off_t offset = (header.extension_offset + sizeof (ext)
+		      + i * sizeof (s));
+      TEST_COMPARE (pread (fd, &s, sizeof (s), offset), sizeof (s));
+      if (s.tag == tag)
+	{
+	  *section = offset;
+	  return s.offset;
+	}
+    }
+  return 0;
+}
+
+static int
+do_test (int argc, char *argv[])
+{
+  if (restart)
+    return handle_restart ();
+
+  {
+    char *conf_path = xasprintf ("%s/ld.so.conf.d/hash.conf",
+				 support_sysconfdir_prefix);
+    xmkdirp (support_sysconfdir_prefix, 0777);
+    support_write_file_string (conf_path, LIBDIR "\n");
+    free (conf_path);
+  }
+  xmkdirp (LIBDIR "/glibc-hwcaps/prepend2", 0777);
+  xmkdirp (LIBDIR "/glibc-hwcaps/prepend3", 0777);
+  copy_module (1, LIBDIR "/libhash.so.01");
+  copy_module (2, LIBDIR "/libhashgrp.so");
+  copy_module (3, LIBDIR "/glibc-hwcaps/prepend2/libhashgrp.so");
+  copy_module (4, LIBDIR "/glibc-hwcaps/prepend3/libhashgrp.so");
+  copy_module (5, LIBDIR "/libhashgrp.so.1");
+  free (run_ldconfig (NULL));
+
+  char *out = run_ldconfig ("-p");
+  TEST_VERIFY (strstr (out, "Hash table of library names with ") != NULL);
+  free (out);
+
+  run_program (argv[0]);
+
+  char *cache = xasprintf ("%s/ld.so.cache", support_sysconfdir_prefix);
+  int fd = xopen (cache, O_RDWR, 0);
+  off_t section;
+  uint32_t offset = find_section (fd, cache_extension_tag_soname_hash,
+				  &section);
+  TEST_VERIFY_EXIT (offset != 0);
+
+  /* A number of slots which is not a power of two makes the table
+     invalid.  */
+  uint32_t nslots;
+  TEST_COMPARE (pread (fd, &nslots, sizeof (nslots), offset),
+		sizeof (nslots));
+  uint32_t bad = nslots - 1;
+  TEST_COMPARE (pwrite (fd, &bad, sizeof (bad), offset), sizeof (bad));
+  run_program (argv[0]);
+  TEST_COMPARE (pwrite (fd, &nslots, sizeof (nslots), offset),
+		sizeof (nslots));
+
+  /* So do entry indices beyond the end of the entries.  */
+  for (uint32_t i = 0; i < nslots; ++i)
+    {
+      off_t slot = offset + CACHE_SONAME_HASH_INDEX (i);
+      uint32_t index;
+      TEST_COMPARE (pread (fd, &index, sizeof (index), slot),
+		    sizeof (index));
+      if (index != CACHE_SONAME_HASH_EMPTY)
+	{
+	  index = CACHE_SONAME_HASH_EMPTY - 1;
+	  TEST_COMPARE (pwrite (fd, &index, sizeof (index), slot),
+			sizeof (index));
+	}
+    }
+  run_program (argv[0]);
+
+  /* A section with an unknown tag is ignored, as if the table was
+     missing.  */
+  uint32_t tag = cache_extension_count;
+  TEST_COMPARE (pwrite (fd, &tag, sizeof (tag), section), sizeof (tag));
+  xclose (fd);
+  fd = xopen (cache, O_RDONLY, 0);
+  TEST_COMPARE (find_section (fd, cache_extension_tag_soname_hash,
+			      &section), 0);
+  xclose (fd);
+  run_program (argv[0]);
+
+  free (cache);
+  return 0;
+}
+
+#define TEST_FUNCTION_ARGV do_test
+#include <support/test-driver.c>
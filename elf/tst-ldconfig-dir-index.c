@@ -0,0 +1,173 @@
+/* Test the directory contents recorded by ldconfig in ld.so.cache.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* libdirindex1.so is found through ld.so.cache and has a DT_RUNPATH
+   of $ORIGIN/deps, which contains libdirindex3.so and, in its
+   glibc-hwcaps/dirindex subdirectory, libdirindex2.so.  ldconfig
+   records the contents of both directories.  The test program is run
+   again with glibc.rtld.search_dir_index=1 and LD_DEBUG=libs to load
+   libdirindex1.so, and the debugging output shows whether each
+   directory was indexed from ld.so.cache or read.  After the
+   modification time of the deps directory changes, it is read again,
+   while the recorded contents of the subdirectory are still used.  */
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xdlfcn.h>
+#include <support/xunistd.h>
+
+#define LIBDIR "/dirindex/lib"
+#define DEPSDIR LIBDIR "/deps"
+#define HWCAPSDIR DEPSDIR "/glibc-hwcaps/dirindex"
+
+static int restart;
+#define CMDLINE_OPTIONS \
+  { "restart", no_argument, &restart, 1 },
+
+static int
+handle_restart (void)
+{
+  void *handle = xdlopen ("libdirindex1.so", RTLD_NOW);
+  int (*value) (void) = xdlsym (handle, "dir_index_value");
+  TEST_COMPARE (value (), 5);
+  xdlclose (handle);
+  return 0;
+}
+
+static void
+copy_module (const char *module, const char *path)
+{
+  char *src = xasprintf ("%s/elf/%s", support_objdir_root, module);
+  support_copy_file (src, path);
+  free (src);
+}
+
+/* Invoke ldconfig with ARG, which may be null, and return its
+   output.  */
+static char *
+run_ldconfig (const char *arg)
+{
+  char *prog = xasprintf ("%s/ldconfig", support_install_rootsbindir);
+  char *args[] = { prog, (char *) arg, NULL };
+  struct support_capture_subprocess result
+    = support_capture_subprogram (prog, args, NULL);
+  support_capture_subprocess_check (&result, "ldconfig", 0,
+				    sc_allow_stdout);
+  char *out = xstrdup (result.out.buffer);
+  support_capture_subprocess_free (&result);
+  free (prog);
+  return out;
+}
+
+/* Return 'c' if the debugging output OUTPUT shows that DIR was indexed
+   from ld.so.cache, 'r' if it was read, or 0 if it was not indexed.  */
+static char
+index_source (const char *output, const char *dir)
+{
+  char *prefix = xasprintf ("indexed directory=%s, ", dir);
+  const char *line = strstr (output, prefix);
+  free (prefix);
+  if (line == NULL)
+    return 0;
+  const char *end = strchrnul (line, '\n');
+  const char *cached = strstr (line, "(from ld.so.cache)");
+  return cached != NULL && cached < end ? 'c' : 'r';
+}
+
+/* Load libdirindex1.so in a new process and return the debugging
+   output.  */
+static char *
+run_program (const char *argv0)
+{
+  char *spargv[] = { (char *) support_objdir_elf_ldso,
+		     (char *) "--glibc-hwcaps-prepend", (char *) "dirindex",
+		     (char *) argv0, (char *) "--direct", (char *) "--restart",
+		     NULL };
+  struct support_capture_subprocess result
+    = support_capture_subprogram (spargv[0], spargv, NULL);
+  support_capture_subprocess_check (&result, "tst-ldconfig-dir-index", 0,
+				    sc_allow_stderr);
+  char *err = xstrdup (result.err.buffer);
+  support_capture_subprocess_free (&result);
+  return err;
+}
+
+static int
+do_test (int argc, char *argv[])
+{
+  if (restart)
+    return handle_restart ();
+
+  {
+    char *conf_path = xasprintf ("%s/ld.so.conf.d/dirindex.conf",
+				 support_sysconfdir_prefix);
+    xmkdirp (support_sysconfdir_prefix, 0777);
+    support_write_file_string (conf_path, LIBDIR "\n");
+    free (conf_path);
+  }
+  xmkdirp (HWCAPSDIR, 0777);
+  copy_module ("tst-ldconfig-dir-indexmod1.so", LIBDIR "/libdirindex1.so");
+  copy_module ("tst-ldconfig-dir-indexmod2.so", HWCAPSDIR "/libdirindex2.so");
+  copy_module ("tst-ldconfig-dir-indexmod3.so", DEPSDIR "/libdirindex3.so");
+  free (run_ldconfig (NULL));
+
+  /* $ORIGIN is expanded, and the glibc-hwcaps subdirectory is
+     recorded too.  */
+  char *out = run_ldconfig ("-p");
+  TEST_VERIFY (strstr (out, "\t" DEPSDIR " (") != NULL);
+  TEST_VERIFY (strstr (out, "\t" HWCAPSDIR " (") != NULL);
+  free (out);
+
+  setenv ("GLIBC_TUNABLES", "glibc.rtld.search_dir_index=1", 1);
+  setenv ("LD_DEBUG", "libs", 1);
+
+  char *err = run_program (argv[0]);
+  TEST_COMPARE (index_source (err, HWCAPSDIR), 'c');
+  TEST_COMPARE (index_source (err, DEPSDIR), 'c');
+  free (err);
+
+  /* A directory whose modification time changed is read again.  */
+  struct timespec times[2] = { { 1000000000, 0 }, { 1000000000, 0 } };
+  TEST_COMPARE (utimensat (AT_FDCWD, DEPSDIR, times, 0), 0);
+  err = run_program (argv[0]);
+  TEST_COMPARE (index_source (err, HWCAPSDIR), 'c');
+  TEST_COMPARE (index_source (err, DEPSDIR), 'r');
+  free (err);
+
+  /* Running ldconfig records it again.  */
+  unsetenv ("GLIBC_TUNABLES");
+  unsetenv ("LD_DEBUG");
+  free (run_ldconfig (NULL));
+  setenv ("GLIBC_TUNABLES", "glibc.rtld.search_dir_index=1", 1);
+  setenv ("LD_DEBUG", "libs", 1);
+  err = run_program (argv[0]);
+  TEST_COMPARE (index_source (err, DEPSDIR), 'c');
+  free (err);
+
+  return 0;
+}
+
+#define TEST_FUNCTION_ARGV do_test
+#include <support/test-driver.c>
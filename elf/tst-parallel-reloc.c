@@ -0,0 +1,54 @@
+/* Test the symbol lookups done in parallel before the relocation.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The test is run with glibc.rtld.parallel_reloc=4.  The modules
+   tst-parallel-relocmod2.so and tst-parallel-relocmod3.so have enough
+   data and PLT relocations to be looked up in parallel, so their lookups
+   are done concurrently on two threads.  Check that they are resolved as
+   usual, including the interposition of a definition by the main
+   program and an undefined weak reference.  */
+
+#include <stddef.h>
+#include <support/check.h>
+
+#include "tst-parallel-reloc.h"
+
+int
+parallel_reloc_interposed (void)
+{
+  return 2;
+}
+
+static int
+do_test (void)
+{
+  for (int i = 0; i < PARALLEL_RELOC_COUNT; i++)
+    TEST_COMPARE (parallel_reloc_table[i] (), PARALLEL_RELOC_FIRST + i);
+  TEST_COMPARE (parallel_reloc_call_all (), 0);
+  TEST_VERIFY (parallel_reloc_interposed_ptr == parallel_reloc_interposed);
+  TEST_COMPARE (parallel_reloc_interposed_ptr (), 2);
+  TEST_VERIFY (parallel_reloc_weak_ptr == NULL);
+
+  for (int i = 0; i < PARALLEL_RELOC_COUNT; i++)
+    TEST_VERIFY (parallel_reloc_table3[i] == parallel_reloc_table[i]);
+  TEST_COMPARE (parallel_reloc_call_all3 (), 0);
+  TEST_VERIFY (parallel_reloc_interposed_ptr3 == parallel_reloc_interposed);
+  return 0;
+}
+
+#include <support/test-driver.c>
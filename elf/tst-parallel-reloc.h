@@ -0,0 +1,52 @@
+/* Symbols of the modules of tst-parallel-reloc.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* PARALLEL_RELOC_SYMBOLS (F) expands F (N) for N from 100 to 1299, so
+   that the modules have more relocations than the threshold of
+   glibc.rtld.parallel_reloc.  */
+#define PARALLEL_RELOC_1(F, n) F (n##0) F (n##1) F (n##2) F (n##3) \
+  F (n##4) F (n##5) F (n##6) F (n##7) F (n##8) F (n##9)
+#define PARALLEL_RELOC_10(F, n) PARALLEL_RELOC_1 (F, n##0) \
+  PARALLEL_RELOC_1 (F, n##1) PARALLEL_RELOC_1 (F, n##2) \
+  PARALLEL_RELOC_1 (F, n##3) PARALLEL_RELOC_1 (F, n##4) \
+  PARALLEL_RELOC_1 (F, n##5) PARALLEL_RELOC_1 (F, n##6) \
+  PARALLEL_RELOC_1 (F, n##7) PARALLEL_RELOC_1 (F, n##8) \
+  PARALLEL_RELOC_1 (F, n##9)
+#define PARALLEL_RELOC_SYMBOLS(F) \
+  PARALLEL_RELOC_10 (F, 1) PARALLEL_RELOC_10 (F, 2) \
+  PARALLEL_RELOC_10 (F, 3) PARALLEL_RELOC_10 (F, 4) \
+  PARALLEL_RELOC_10 (F, 5) PARALLEL_RELOC_10 (F, 6) \
+  PARALLEL_RELOC_10 (F, 7) PARALLEL_RELOC_10 (F, 8) \
+  PARALLEL_RELOC_10 (F, 9) PARALLEL_RELOC_10 (F, 10) \
+  PARALLEL_RELOC_10 (F, 11) PARALLEL_RELOC_10 (F, 12)
+
+#define PARALLEL_RELOC_FIRST 100
+#define PARALLEL_RELOC_COUNT 1200
+
+typedef int (*parallel_reloc_fn) (void);
+
+/* Defined in tst-parallel-relocmod2.so.  */
+extern parallel_reloc_fn parallel_reloc_table[PARALLEL_RELOC_COUNT];
+extern parallel_reloc_fn parallel_reloc_interposed_ptr;
+extern parallel_reloc_fn parallel_reloc_weak_ptr;
+int parallel_reloc_call_all (void);
+
+/* Defined in tst-parallel-relocmod3.so.  */
+extern parallel_reloc_fn parallel_reloc_table3[PARALLEL_RELOC_COUNT];
+extern parallel_reloc_fn parallel_reloc_interposed_ptr3;
+int parallel_reloc_call_all3 (void);
@@ -0,0 +1,44 @@
+/* Second module for tst-parallel-reloc with the references.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* This module is also above the threshold of glibc.rtld.parallel_reloc,
+   so that its lookups are done on another thread than those of
+   tst-parallel-relocmod2.so.  */
+
+#include "tst-parallel-reloc.h"
+
+#define DECLARE(n) extern int parallel_reloc_f##n (void);
+PARALLEL_RELOC_SYMBOLS (DECLARE)
+
+extern int parallel_reloc_interposed (void);
+
+#define REFERENCE(n) parallel_reloc_f##n,
+parallel_reloc_fn parallel_reloc_table3[PARALLEL_RELOC_COUNT] =
+{
+  PARALLEL_RELOC_SYMBOLS (REFERENCE)
+};
+
+parallel_reloc_fn parallel_reloc_interposed_ptr3 = parallel_reloc_interposed;
+
+#define CALL(n) if (parallel_reloc_f##n () != n) return n;
+int
+parallel_reloc_call_all3 (void)
+{
+  PARALLEL_RELOC_SYMBOLS (CALL)
+  return 0;
+}
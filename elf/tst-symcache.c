@@ -0,0 +1,133 @@
+/* Test the persistent symbol cache (glibc.rtld.symbol_cache tunable).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Run the test program with the cache several times.  The first run
+   writes the cache, the second one uses it, and after the cache is
+   damaged or made writable by others it is written again.  A cache
+   written without LD_DYNAMIC_WEAK is not used with it, and the other way
+   around.  In each run, check that the references to the modules are
+   bound as without the cache.  */
+
+#include <getopt.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/temp_file.h>
+#include <support/xunistd.h>
+
+extern int symcache_value;
+extern int symcache_weak_value;
+extern int *symcache_get (void);
+extern int symcache_weak_is_null (void);
+
+static int restart;
+#define CMDLINE_OPTIONS \
+  { "restart", no_argument, &restart, 1 },
+
+static int
+handle_restart (void)
+{
+  TEST_COMPARE (symcache_value, 42);
+  TEST_VERIFY (symcache_get () == &symcache_value);
+  TEST_VERIFY (symcache_weak_is_null ());
+  /* The weak definition in tst-symcachemod.so comes first in the
+     search list.  */
+  const char *dynamic_weak = getenv ("LD_DYNAMIC_WEAK");
+  TEST_COMPARE (symcache_weak_value,
+		dynamic_weak != NULL && dynamic_weak[0] != '\0' ? 2 : 1);
+  return 0;
+}
+
+static void
+run (char **spargv, const char *expected)
+{
+  struct support_capture_subprocess result
+    = support_capture_subprogram (spargv[0], spargv, NULL);
+  support_capture_subprocess_check (&result, "tst-symcache", 0,
+				    sc_allow_stderr);
+  if (strstr (result.err.buffer, expected) == NULL)
+    FAIL ("\"%s\" not found in the debugging output", expected);
+  support_capture_subprocess_free (&result);
+}
+
+static int
+do_test (int argc, char *argv[])
+{
+  /* We must have either:
+     - One or four parameters left if called initially:
+       + path to ld.so         optional
+       + "--library-path"      optional
+       + the library path      optional
+       + the application name  */
+
+  if (restart)
+    return handle_restart ();
+
+  char *spargv[9];
+  int i = 0;
+  for (; i < argc - 1; i++)
+    spargv[i] = argv[i + 1];
+  spargv[i++] = (char *) "--direct";
+  spargv[i++] = (char *) "--restart";
+  spargv[i] = NULL;
+
+  char *dir = support_create_temp_directory ("tst-symcache-");
+  char *cache = xasprintf ("%s/cache", dir);
+  add_temp_file (cache);
+  char *tunables = xasprintf ("glibc.rtld.symbol_cache=%s", cache);
+  setenv ("GLIBC_TUNABLES", tunables, 1);
+  setenv ("LD_DEBUG", "files", 1);
+
+  run (spargv, "symbol cache: wrote ");
+  struct stat st;
+  TEST_COMPARE (stat (cache, &st), 0);
+  TEST_VERIFY (st.st_size > 0);
+  run (spargv, "symbol cache: using ");
+
+  /* A damaged cache is ignored and written again.  */
+  TEST_COMPARE (truncate (cache, st.st_size - 1), 0);
+  run (spargv, "symbol cache: wrote ");
+  run (spargv, "symbol cache: using ");
+
+  /* A cache which other users can write is ignored, and replaced.  */
+  TEST_COMPARE (chmod (cache, 0666), 0);
+  run (spargv, "symbol cache: wrote ");
+  TEST_COMPARE (stat (cache, &st), 0);
+  TEST_COMPARE (st.st_mode & (S_IWGRP | S_IWOTH), 0);
+  run (spargv, "symbol cache: using ");
+
+  /* LD_DYNAMIC_WEAK changes the results of the lookups.  */
+  setenv ("LD_DYNAMIC_WEAK", "1", 1);
+  run (spargv, "symbol cache: wrote ");
+  run (spargv, "symbol cache: using ");
+  unsetenv ("LD_DYNAMIC_WEAK");
+  run (spargv, "symbol cache: wrote ");
+  run (spargv, "symbol cache: using ");
+
+  free (tunables);
+  free (cache);
+  free (dir);
+  return 0;
+}
+
+#define TEST_FUNCTION_ARGV do_test
+#include <support/test-driver.c>
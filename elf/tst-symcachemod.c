@@ -0,0 +1,39 @@
+/* Module for tst-symcache.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <stddef.h>
+
+int symcache_value = 42;
+
+/* Overridden by the global definition in tst-symcachemod2.so with
+   LD_DYNAMIC_WEAK.  */
+int symcache_weak_value __attribute__ ((weak)) = 1;
+
+extern void symcache_undefined (void) __attribute__ ((weak));
+
+int *
+symcache_get (void)
+{
+  return &symcache_value;
+}
+
+int
+symcache_weak_is_null (void)
+{
+  return symcache_undefined == NULL;
+}
@@ -0,0 +1,75 @@
+/* Test the preallocation of dynamic TLS (glibc.rtld.tls_prealloc).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Two modules with TLS are loaded with dlopen, and only the TLS of the
+   first one is accessed by the main thread.  A new thread must then have
+   the TLS block of the first module allocated and initialized when it
+   starts, and the one of the second module allocated on first access.  */
+
+#include <dlfcn.h>
+#include <stddef.h>
+#include <support/check.h>
+#include <support/xdlfcn.h>
+#include <support/xthread.h>
+
+static void *mod1;
+static void *mod2;
+
+static void *
+thread_func (void *closure)
+{
+  void *block = NULL;
+  TEST_COMPARE (dlinfo (mod1, RTLD_DI_TLS_DATA, &block), 0);
+  TEST_VERIFY_EXIT (block != NULL);
+  TEST_COMPARE (*(int *) block, 42);
+
+  block = &block;
+  TEST_COMPARE (dlinfo (mod2, RTLD_DI_TLS_DATA, &block), 0);
+  TEST_VERIFY (block == NULL);
+
+  int *(*get_tls_var1) (void) = xdlsym (mod1, "get_tls_var");
+  int *(*get_tls_var2) (void) = xdlsym (mod2, "get_tls_var");
+  dlinfo (mod1, RTLD_DI_TLS_DATA, &block);
+  TEST_VERIFY (get_tls_var1 () == block);
+  TEST_COMPARE (*get_tls_var2 (), 42);
+  dlinfo (mod2, RTLD_DI_TLS_DATA, &block);
+  TEST_VERIFY (get_tls_var2 () == block);
+
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  mod1 = xdlopen ("tst-tls-preallocmod1.so", RTLD_NOW);
+  mod2 = xdlopen ("tst-tls-preallocmod2.so", RTLD_NOW);
+
+  /* Force the TLS of the first module to be dynamic.  The new thread gets
+     the initial value, not the one of the main thread.  */
+  int *(*get_tls_var) (void) = xdlsym (mod1, "get_tls_var");
+  TEST_COMPARE (*get_tls_var (), 42);
+  *get_tls_var () = 1;
+
+  xpthread_join (xpthread_create (NULL, thread_func, NULL));
+
+  xdlclose (mod2);
+  xdlclose (mod1);
+  return 0;
+}
+
+#include <support/test-driver.c>
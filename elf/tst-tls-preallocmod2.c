@@ -0,0 +1 @@
+#include "tst-tls-preallocmod1.c"
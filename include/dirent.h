@@ -43,6 +43,10 @@ extern __ssize_t __getdents (int __fd, void *__buf, size_t __nbytes)
      attribute_hidden;
 extern __ssize_t __getdents64 (int __fd, void *__buf, size_t __nbytes);
 libc_hidden_proto (__getdents64)
+# if IS_IN (rtld)
+/* Used by the dynamic linker to index the library search directories.  */
+extern __typeof (__getdents64) __getdents64 attribute_hidden;
+# endif
 
 extern int __alphasort64 (const struct dirent64 **a, const struct dirent64 **b)
      __attribute_pure__;
@@ -306,6 +306,19 @@ struct link_map
       const ElfW(Sym) *ret;
     } l_lookup_cache;
 
+    /* Entries of the persistent symbol cache for the initial relocation
+       of this object, and their number, or NULL.  See elf/dl-symcache.c.  */
+    struct dl_symcache_entry *l_symcache;
+    unsigned int l_symcache_count;
+    /* Index of this object in the cache.  */
+    unsigned int l_symcache_index;
+
+    /* Results of the symbol lookups done in parallel before the initial
+       relocation of this object, indexed by symbol, and their number,
+       or NULL.  See elf/dl-reloc-parallel.c.  */
+    struct dl_reloc_prefetch *l_reloc_prefetch;
+    size_t l_reloc_prefetch_count;
+
     /* Thread-local storage related info.  */
 
     /* Start of the initialization image.  */
@@ -28,6 +28,10 @@ libc_hidden_proto (__clone)
 extern int __clone2 (int (*__fn) (void *__arg), void *__child_stack_base,
 		     size_t __child_stack_size, int __flags, void *__arg, ...);
 libc_hidden_proto (__clone2)
+# if IS_IN (rtld)
+/* Used by the dynamic linker to run its lookups in parallel.  */
+extern __typeof (__clone) __clone attribute_hidden;
+# endif
 /* NB: Can't use "__typeof__ (getcpu)" since getcpu is Linux specific
    and Hurd doesn't have it.  */
 extern int __getcpu (unsigned int *, unsigned int *);
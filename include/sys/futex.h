@@ -0,0 +1,18 @@
+#ifndef _SYS_FUTEX_H
+#include_next <sys/futex.h>
+
+# ifndef _ISOMAC
+
+#if __TIMESIZE == 64
+# define __futex_waitv_time64 futex_waitv
+#else
+extern int __futex_waitv_time64 (struct futex_waitv *waiters,
+				 unsigned int nr_futexes, unsigned int flags,
+				 const struct __timespec64 *timeout,
+				 clockid_t clockid)
+       __nonnull ((1));
+libc_hidden_proto (__futex_waitv_time64)
+#endif
+
+# endif /* !_ISOMAC */
+#endif
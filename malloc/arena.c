@@ -88,6 +88,11 @@ extern int sanity_check_heap_info_alignment[(sizeof (heap_info)
 
 static __thread mstate thread_arena attribute_tls_model_ie;
 
+/* NUMA node the thread ran on when it selected thread_arena, used with
+   glibc.malloc.numa to select a new arena after the thread migrated to
+   another node.  */
+static __thread int thread_arena_node attribute_tls_model_ie;
+
 /* Arena free list.  free_list_lock synchronizes access to the
    free_list variable below, and the next_free and attached_threads
    members of struct malloc_state objects.  No other locks must be
@@ -126,6 +131,12 @@ __libc_lock_define_initialized (static, list_lock);
 
 #define arena_get(ptr, size) do { \
       ptr = thread_arena;						      \
+      if (__glibc_unlikely (mp_.numa) && ptr != NULL)			      \
+        {								      \
+          int __node = malloc_getnode (true);				      \
+          if (__node >= 0 && __node != thread_arena_node)		      \
+            ptr = NULL;							      \
+        }								      \
       arena_lock (ptr, size);						      \
   } while (0)
 
@@ -168,6 +179,10 @@ __malloc_fork_lock_parent (void)
   /* We do not acquire free_list_lock here because we completely
      reconstruct free_list in __malloc_fork_unlock_child.  */
 
+  tcache_percpu_fork_lock ();
+  slab_fork_lock ();
+  profile_fork_lock ();
+
   __libc_lock_lock (list_lock);
 
   for (mstate ar_ptr = &main_arena;; )
@@ -190,6 +205,10 @@ __malloc_fork_unlock_parent (void)
         break;
     }
   __libc_lock_unlock (list_lock);
+
+  profile_fork_unlock (false);
+  slab_fork_unlock (false);
+  tcache_percpu_fork_unlock (false);
 }
 
 void
@@ -217,6 +236,10 @@ __malloc_fork_unlock_child (void)
     }
 
   __libc_lock_init (list_lock);
+
+  profile_fork_unlock (true);
+  slab_fork_unlock (true);
+  tcache_percpu_fork_unlock (true);
 }
 
 #define TUNABLE_CALLBACK_FNDECL(__name, __type) \
@@ -235,14 +258,28 @@ TUNABLE_CALLBACK_FNDECL (set_perturb_byte, int32_t)
 TUNABLE_CALLBACK_FNDECL (set_trim_threshold, size_t)
 TUNABLE_CALLBACK_FNDECL (set_arena_max, size_t)
 TUNABLE_CALLBACK_FNDECL (set_arena_test, size_t)
+TUNABLE_CALLBACK_FNDECL (set_numa, int32_t)
+TUNABLE_CALLBACK_FNDECL (set_purge_interval, size_t)
+TUNABLE_CALLBACK_FNDECL (set_purge_threshold, size_t)
+TUNABLE_CALLBACK_FNDECL (set_purge_step, size_t)
+TUNABLE_CALLBACK_FNDECL (set_purge_lazy, int32_t)
 #if USE_TCACHE
 TUNABLE_CALLBACK_FNDECL (set_tcache_max, size_t)
 TUNABLE_CALLBACK_FNDECL (set_tcache_count, size_t)
+TUNABLE_CALLBACK_FNDECL (set_tcache_percpu, int32_t)
+TUNABLE_CALLBACK_FNDECL (set_tcache_batch, size_t)
 #endif
 TUNABLE_CALLBACK_FNDECL (set_hugetlb, size_t)
+TUNABLE_CALLBACK_FNDECL (set_slab, size_t)
+TUNABLE_CALLBACK_FNDECL (set_profile, size_t)
 
 #if USE_TCACHE
 static void tcache_key_initialize (void);
+static void tcache_percpu_init (void);
+#endif
+#if IS_IN (libc)
+static void slab_init (void);
+static void profile_init (void);
 #endif
 
 void
@@ -272,11 +309,21 @@ __ptmalloc_init (void)
   TUNABLE_GET (mmap_max, int32_t, TUNABLE_CALLBACK (set_mmaps_max));
   TUNABLE_GET (arena_max, size_t, TUNABLE_CALLBACK (set_arena_max));
   TUNABLE_GET (arena_test, size_t, TUNABLE_CALLBACK (set_arena_test));
+  TUNABLE_GET (numa, int32_t, TUNABLE_CALLBACK (set_numa));
+  TUNABLE_GET (purge_interval, size_t, TUNABLE_CALLBACK (set_purge_interval));
+  TUNABLE_GET (purge_threshold, size_t,
+	       TUNABLE_CALLBACK (set_purge_threshold));
+  TUNABLE_GET (purge_step, size_t, TUNABLE_CALLBACK (set_purge_step));
+  TUNABLE_GET (purge_lazy, int32_t, TUNABLE_CALLBACK (set_purge_lazy));
 # if USE_TCACHE
   TUNABLE_GET (tcache_max, size_t, TUNABLE_CALLBACK (set_tcache_max));
   TUNABLE_GET (tcache_count, size_t, TUNABLE_CALLBACK (set_tcache_count));
+  TUNABLE_GET (percpu, int32_t, TUNABLE_CALLBACK (set_tcache_percpu));
+  TUNABLE_GET (tcache_batch, size_t, TUNABLE_CALLBACK (set_tcache_batch));
 # endif
   TUNABLE_GET (hugetlb, size_t, TUNABLE_CALLBACK (set_hugetlb));
+  TUNABLE_GET (slab, size_t, TUNABLE_CALLBACK (set_slab));
+  TUNABLE_GET (profile, size_t, TUNABLE_CALLBACK (set_profile));
 
   if (mp_.hp_pagesize > 0 && mp_.hp_pagesize <= heap_max_size ())
     {
@@ -288,6 +335,25 @@ __ptmalloc_init (void)
 	do_set_mmap_threshold (mp_.hp_pagesize);
       __always_fail_morecore = true;
     }
+  else if (mp_.thp_pagesize > 0 && !mp_.no_dyn_threshold
+	   && mp_.mmap_threshold < mp_.thp_pagesize
+	   && mp_.thp_pagesize <= DEFAULT_MMAP_THRESHOLD_MAX)
+    {
+      /* The heaps are grown and trimmed in transparent huge page units,
+	 so serve requests smaller than a huge page from them instead of
+	 mapping each one separately.  The threshold is still adjusted
+	 dynamically, in huge page units.  */
+      mp_.mmap_threshold = mp_.thp_pagesize;
+      mp_.trim_threshold = 2 * mp_.mmap_threshold;
+    }
+
+#if USE_TCACHE
+  tcache_percpu_init ();
+#endif
+#if IS_IN (libc)
+  slab_init ();
+  profile_init ();
+#endif
 }
 
 /* Managing heaps and arenas (for concurrent threads) */
@@ -337,11 +403,12 @@ dump_heap (heap_info *heap)
 static char *aligned_heap_area;
 
 /* Create a new heap.  size is automatically rounded up to a multiple
-   of the page size. */
+   of the page size.  If node is not -1, the memory of the heap is
+   preferably placed on that NUMA node. */
 
 static heap_info *
 alloc_new_heap  (size_t size, size_t top_pad, size_t pagesize,
-		 int mmap_flags)
+		 int mmap_flags, int node)
 {
   char *p1, *p2;
   unsigned long ul;
@@ -409,6 +476,11 @@ alloc_new_heap  (size_t size, size_t top_pad, size_t pagesize,
       return NULL;
     }
 
+  /* Bind the whole reservation, so that the pages added by grow_heap
+     are placed on the same node.  */
+  if (node >= 0)
+    malloc_bind_node (p2, max_size, node);
+
   /* Only consider the actual usable range.  */
   __set_vma_name (p2, size, " glibc: malloc arena");
 
@@ -423,7 +495,7 @@ alloc_new_heap  (size_t size, size_t top_pad, size_t pagesize,
 }
 
 static heap_info *
-new_heap (size_t size, size_t top_pad)
+new_heap (size_t size, size_t top_pad, int node)
 {
   bool use_hugepage = mp_.hp_pagesize != 0;
   size_t pagesize = use_hugepage ? mp_.hp_pagesize : mp_.thp_pagesize;
@@ -431,11 +503,11 @@ new_heap (size_t size, size_t top_pad)
   if (pagesize != 0 && pagesize <= heap_max_size ())
     {
       heap_info *h = alloc_new_heap (size, top_pad, pagesize,
-				     use_hugepage ? mp_.hp_flags : 0);
+				     use_hugepage ? mp_.hp_flags : 0, node);
       if (h != NULL)
 	return h;
     }
-  return alloc_new_heap (size, top_pad, GLRO (dl_pagesize), 0);
+  return alloc_new_heap (size, top_pad, GLRO (dl_pagesize), 0, node);
 }
 
 /* Grow a heap.  size is automatically rounded up to a
@@ -598,7 +670,7 @@ detach_arena (mstate replaced_arena)
 }
 
 static mstate
-_int_new_arena (size_t size)
+_int_new_arena (size_t size, int node)
 {
   mstate a;
   heap_info *h;
@@ -606,13 +678,14 @@ _int_new_arena (size_t size)
   unsigned long misalign;
 
   h = new_heap (size + (sizeof (*h) + sizeof (*a) + MALLOC_ALIGNMENT),
-                mp_.top_pad);
+                mp_.top_pad, node);
   if (!h)
     {
       /* Maybe size is too large to fit in a single heap.  So, just try
          to create a minimally-sized arena and let _int_malloc() attempt
          to deal with the large request via mmap_chunk().  */
-      h = new_heap (sizeof (*h) + sizeof (*a) + MALLOC_ALIGNMENT, mp_.top_pad);
+      h = new_heap (sizeof (*h) + sizeof (*a) + MALLOC_ALIGNMENT, mp_.top_pad,
+		    node);
       if (!h)
         return NULL;
     }
@@ -621,6 +694,7 @@ _int_new_arena (size_t size)
   a->attached_threads = 1;
   /*a->next = NULL;*/
   a->system_mem = a->max_system_mem = h->size;
+  a->node = node;
 
   /* Set up the top chunk, with proper alignment. */
   ptr = (char *) (a + 1);
@@ -633,6 +707,7 @@ _int_new_arena (size_t size)
   LIBC_PROBE (memory_arena_new, 2, a, size);
   mstate replaced_arena = thread_arena;
   thread_arena = a;
+  thread_arena_node = node;
   __libc_lock_init (a->mutex);
 
   __libc_lock_lock (list_lock);
@@ -667,19 +742,28 @@ _int_new_arena (size_t size)
 }
 
 
-/* Remove an arena from free_list.  */
+/* Remove an arena from free_list.  Prefer an arena placed on NODE,
+   unless NODE is -1.  */
 static mstate
-get_free_list (void)
+get_free_list (int node)
 {
   mstate replaced_arena = thread_arena;
   mstate result = free_list;
   if (result != NULL)
     {
       __libc_lock_lock (free_list_lock);
-      result = free_list;
+      mstate *previous = &free_list;
+      if (node >= 0)
+	for (mstate *p = &free_list; *p != NULL; p = &(*p)->next_free)
+	  if ((*p)->node == node)
+	    {
+	      previous = p;
+	      break;
+	    }
+      result = *previous;
       if (result != NULL)
 	{
-	  free_list = result->next_free;
+	  *previous = result->next_free;
 
 	  /* The arena will be attached to this thread.  */
 	  assert (result->attached_threads == 0);
@@ -694,6 +778,7 @@ get_free_list (void)
           LIBC_PROBE (memory_arena_reuse_free_list, 1, result);
           __libc_lock_lock (result->mutex);
 	  thread_arena = result;
+	  thread_arena_node = node;
         }
     }
 
@@ -722,9 +807,10 @@ remove_from_free_list (mstate arena)
 
 /* Lock and return an arena that can be reused for memory allocation.
    Avoid AVOID_ARENA as we have already failed to allocate memory in
-   it and it is currently locked.  */
+   it and it is currently locked.  Prefer an uncontended arena placed
+   on NODE, unless NODE is -1.  */
 static mstate
-reused_arena (mstate avoid_arena)
+reused_arena (mstate avoid_arena, int node)
 {
   mstate result;
   /* FIXME: Access to next_to_use suffers from data races.  */
@@ -732,6 +818,22 @@ reused_arena (mstate avoid_arena)
   if (next_to_use == NULL)
     next_to_use = &main_arena;
 
+  /* Look for an arena on the same node first.  */
+  if (node >= 0)
+    {
+      result = next_to_use;
+      do
+	{
+	  if (result->node == node && result != avoid_arena
+	      && !__libc_lock_trylock (result->mutex))
+	    goto out;
+
+	  /* FIXME: This is a data race, see _int_new_arena.  */
+	  result = result->next;
+	}
+      while (result != next_to_use);
+    }
+
   /* Iterate over all arenas (including those linked from
      free_list).  */
   result = next_to_use;
@@ -779,6 +881,7 @@ out:
 
   LIBC_PROBE (memory_arena_reuse, 2, result, avoid_arena);
   thread_arena = result;
+  thread_arena_node = node;
   next_to_use = result->next;
 
   return result;
@@ -791,7 +894,11 @@ arena_get2 (size_t size, mstate avoid_arena)
 
   static size_t narenas_limit;
 
-  a = get_free_list ();
+  /* With glibc.malloc.numa, select an arena on the node the thread is
+     running on.  */
+  int node = mp_.numa ? malloc_getnode (false) : -1;
+
+  a = get_free_list (node);
   if (a == NULL)
     {
       /* Nothing immediately available, so generate a new arena.  */
@@ -819,12 +926,12 @@ arena_get2 (size_t size, mstate avoid_arena)
         {
           if (atomic_compare_and_exchange_bool_acq (&narenas, n + 1, n))
             goto repeat;
-          a = _int_new_arena (size);
+          a = _int_new_arena (size, node);
 	  if (__glibc_unlikely (a == NULL))
             atomic_fetch_add_relaxed (&narenas, -1);
         }
       else
-        a = reused_arena (avoid_arena);
+        a = reused_arena (avoid_arena, node);
     }
   return a;
 }
@@ -385,6 +385,16 @@ __debug_calloc (size_t nmemb, size_t size)
 }
 strong_alias (__debug_calloc, calloc)
 
+#define LIBC_SYMBOL(sym) libc_ ## sym
+#define SYMHANDLE(sym) sym ## _handle
+
+#define LOAD_SYM(sym) ({ \
+  static void *SYMHANDLE (sym);						      \
+  if (SYMHANDLE (sym) == NULL)						      \
+    SYMHANDLE (sym) = dlsym (RTLD_NEXT, #sym);				      \
+  SYMHANDLE (sym);							      \
+})
+
 size_t
 malloc_usable_size (void *mem)
 {
@@ -396,19 +406,16 @@ malloc_usable_size (void *mem)
   if (__is_malloc_debug_enabled (MALLOC_CHECK_HOOK))
     return malloc_check_get_size (mem);
 
+  /* The block was allocated by the libc malloc, which may have served it
+     from a slab without a chunk header.  */
+  size_t (*LIBC_SYMBOL (malloc_usable_size)) (void *)
+    = LOAD_SYM (malloc_usable_size);
+  if (LIBC_SYMBOL (malloc_usable_size) != NULL)
+    return LIBC_SYMBOL (malloc_usable_size) (mem);
+
   return musable (mem);
 }
 
-#define LIBC_SYMBOL(sym) libc_ ## sym
-#define SYMHANDLE(sym) sym ## _handle
-
-#define LOAD_SYM(sym) ({ \
-  static void *SYMHANDLE (sym);						      \
-  if (SYMHANDLE (sym) == NULL)						      \
-    SYMHANDLE (sym) = dlsym (RTLD_NEXT, #sym);				      \
-  SYMHANDLE (sym);							      \
-})
-
 int
 malloc_info (int options, FILE *fp)
 {
@@ -43,4 +43,8 @@ void __malloc_check_init (void) attribute_hidden;
 /* Initialize malloc.  */
 void __ptmalloc_init (void) attribute_hidden;
 
+/* Initialization which needs dlopen, called from the constructor of
+   libc.  */
+void __malloc_profile_late_init (void) attribute_hidden;
+
 #endif /* _MALLOC_INTERNAL_H */
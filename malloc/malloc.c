@@ -233,6 +233,9 @@
 /* For ALIGN_UP et. al.  */
 #include <libc-pointer-arith.h>
 
+/* For array_length.  */
+#include <array_length.h>
+
 /* For internal malloc interfaces and declarations.  */
 #include <malloc/malloc-internal.h>
 
@@ -246,6 +249,13 @@
 #include <sys/random.h>
 #include <not-cancel.h>
 
+/* For the incremental purge interval.  */
+#include <time.h>
+
+/* For the heap profiler.  */
+#include <execinfo.h>
+#include <unwind-link.h>
+
 verify (sizeof (unsigned long) == sizeof (size_t));
 verify (sizeof (void *) == sizeof (size_t));
 verify (sizeof (void *) == 4 || sizeof (void *) == 8);
@@ -937,6 +947,9 @@ static INTERNAL_SIZE_T _int_free_create_chunk (mstate,
 					       mchunkptr, INTERNAL_SIZE_T,
 					       mchunkptr, INTERNAL_SIZE_T);
 static void _int_free_maybe_trim (mstate, INTERNAL_SIZE_T);
+static void _int_free_remote_drain (mstate);
+static void malloc_purge_maybe (mstate);
+static void purge_cursor_unlink (mstate, mchunkptr);
 static void*  _int_realloc(mstate, mchunkptr, INTERNAL_SIZE_T,
 			   INTERNAL_SIZE_T);
 static void*  _int_memalign(mstate, size_t, size_t);
@@ -1433,6 +1446,7 @@ unlink_chunk (mstate av, mchunkptr p)
   if (__glibc_unlikely (fd->bk != p || bk->fd != p))
     malloc_printerr ("corrupted double-linked list");
 
+  purge_cursor_unlink (av, p);
   fd->bk = bk;
   bk->fd = fd;
   if (!in_smallbin_range (chunksize_nomask (p)) && p->fd_nextsize != NULL)
@@ -1533,6 +1547,45 @@ unlink_chunk (mstate av, mchunkptr p)
 
 #define ATTEMPT_TRIMMING_THRESHOLD  (65536UL)
 
+/*
+   PURGE_CLOCK_CALLS is the number of calls to malloc_purge_maybe between
+   reads of the clock for glibc.malloc.purge_interval, so that the clock
+   is not read on every allocation.
+ */
+
+#define PURGE_CLOCK_CALLS  64
+
+/* The default maximum number of bytes purged in one step.  */
+
+#define DEFAULT_PURGE_STEP  (1024 * 1024)
+
+/* The maximum number of free chunks visited in one step, so that a step
+   over many chunks which are already purged or too small to be purged
+   does not hold the arena lock for long.  */
+
+#define PURGE_STEP_CHUNKS  256
+
+/*
+   The free chunks purged by malloc_purge_step are marked by a word
+   following their free list pointers, which is not purged, so that the
+   next passes skip them.  The mark depends on the address and the size of
+   the chunk, so that it no longer matches once the chunk is split or
+   merged, and it is cleared when the chunk is freed again.
+ */
+
+#define PURGE_MARK_MAGIC  ((uintptr_t) 0x70757267)
+#define PURGE_KEEP_SIZE   (sizeof (struct malloc_chunk) + sizeof (uintptr_t))
+
+#define purge_mark_ptr(p) \
+  ((uintptr_t *) ((char *) (p) + sizeof (struct malloc_chunk)))
+#define purge_mark_value(p, size) \
+  ((uintptr_t) (p) ^ (size) ^ PURGE_MARK_MAGIC)
+#define purge_mark_clear(p, size)					\
+  do {									\
+    if ((size) >= GLRO (dl_pagesize) + PURGE_KEEP_SIZE)		\
+      *purge_mark_ptr (p) = 0;						\
+  } while (0)
+
 /*
    NONCONTIGUOUS_BIT indicates that MORECORE does not return contiguous
    regions.  Otherwise, contiguity is exploited in merging together,
@@ -1589,8 +1642,43 @@ struct malloc_state
   /* Memory allocated from the system in this arena.  */
   INTERNAL_SIZE_T system_mem;
   INTERNAL_SIZE_T max_system_mem;
+
+  /* NUMA node the heaps of this arena are placed on, or -1.  */
+  int node;
+
+  /* Chunks freed by threads which found the arena locked, see
+     remote_free_enabled.  They are linked through their fd fields and
+     are freed by the next thread which acquires the mutex.  Accessed
+     atomically.  */
+  mchunkptr remote_free;
+
+  /* Incremental purging of free chunks: the number of bytes freed since
+     the last purge step, the bin the next step starts at (0 starts a new
+     pass), the chunk of that bin the next step starts at (NULL starts at
+     the last chunk of the bin), and the time of the last step in
+     milliseconds.  PURGE_NEXT is moved to the following chunk when it is
+     taken off the bin, see purge_cursor_unlink.  PURGE_TOP is the top
+     chunk at the time it was purged, and is cleared when a chunk is
+     merged into it.  */
+  INTERNAL_SIZE_T purge_freed;
+  unsigned int purge_bin;
+  unsigned int purge_calls;
+  mchunkptr purge_next;
+  uint64_t purge_time;
+  mchunkptr purge_top;
 };
 
+/* Called before the free chunk P is taken off its bin in arena AV.  If P
+   is where the next purge step starts, move the cursor to the chunk the
+   step would have visited after P, which is the bin itself if P is the
+   first chunk of the bin.  */
+static __always_inline void
+purge_cursor_unlink (mstate av, mchunkptr p)
+{
+  if (__glibc_unlikely (av->purge_next == p))
+    av->purge_next = p->bk;
+}
+
 struct malloc_par
 {
   /* Tunable parameters */
@@ -1630,7 +1718,34 @@ struct malloc_par
   size_t tcache_max_bytes;
   /* Maximum number of chunks in each bucket.  */
   size_t tcache_count;
+  /* Cache chunks per CPU instead of per thread.  */
+  int tcache_percpu;
+  /* Maximum number of chunks moved at once between a bin and the
+     arena.  */
+  size_t tcache_batch;
 #endif
+
+  /* Place arenas on the NUMA node of the threads using them.  */
+  int numa;
+
+  /* Incremental purging of free chunks.  A purge step is done after
+     purge_interval milliseconds or once purge_threshold bytes have been
+     freed, and purges at most purge_step bytes.  */
+  size_t purge_interval;
+  size_t purge_threshold;
+  size_t purge_step;
+  /* Use MADV_FREE instead of MADV_DONTNEED.  */
+  int purge_lazy;
+
+  /* Mean number of bytes allocated between heap profile samples, zero
+     if the profiler is not enabled.  */
+  size_t profile;
+
+  /* Largest request served from slabs, as set by the tunable.  */
+  size_t slab_max;
+  /* Requests smaller than this are served from slabs.  Zero if the slabs
+     are not used.  */
+  size_t slab_max_bytes;
 };
 
 /* There are several instances of this struct ("arenas") in this
@@ -1643,7 +1758,8 @@ static struct malloc_state main_arena =
 {
   .mutex = _LIBC_LOCK_INITIALIZER,
   .next = &main_arena,
-  .attached_threads = 1
+  .attached_threads = 1,
+  .node = -1
 };
 
 /* There is only one instance of the malloc parameters.  */
@@ -1655,7 +1771,8 @@ static struct malloc_par mp_ =
   .mmap_threshold = DEFAULT_MMAP_THRESHOLD,
   .trim_threshold = DEFAULT_TRIM_THRESHOLD,
   .arena_test = sizeof (long) == 4 ? 2 : 8,
-  .thp_mode = thp_mode_unknown
+  .thp_mode = thp_mode_unknown,
+  .purge_step = DEFAULT_PURGE_STEP
 #if USE_TCACHE
   ,
   .tcache_count = TCACHE_FILL_COUNT,
@@ -1706,6 +1823,19 @@ static int      systrim (size_t, mstate);
    thread cache (if it exists).  */
 static void tcache_thread_shutdown (void);
 
+/* These functions are called from the fork handlers in arena.c to
+   acquire and release the per-CPU cache locks.  */
+static void tcache_percpu_fork_lock (void);
+static void tcache_percpu_fork_unlock (bool child);
+
+/* Likewise for the slab locks.  */
+static void slab_fork_lock (void);
+static void slab_fork_unlock (bool child);
+
+/* Likewise for the heap profiler lock.  */
+static void profile_fork_lock (void);
+static void profile_fork_unlock (bool child);
+
 /* ------------------ Testing support ----------------------------------*/
 
 static int perturb_byte;
@@ -1753,6 +1883,25 @@ madvise_thp (void *p, INTERNAL_SIZE_T size)
 #endif
 }
 
+/* Shrink the range of SIZE bytes at P, which is about to be discarded, to
+   the huge pages it fully contains if transparent huge pages are in use,
+   so that discarding it does not split a huge page which is still partly
+   in use.  Return false if nothing is left of the range.  */
+static inline bool
+thp_clip_range (char **p, size_t *size)
+{
+  if (mp_.thp_pagesize == 0)
+    return *size != 0;
+
+  char *start = PTR_ALIGN_UP (*p, mp_.thp_pagesize);
+  char *end = PTR_ALIGN_DOWN (*p + *size, mp_.thp_pagesize);
+  if (start >= end)
+    return false;
+  *p = start;
+  *size = end - start;
+  return true;
+}
+
 /* ------------------- Support for multiple arenas -------------------- */
 #include "arena.c"
 
@@ -2073,11 +2222,27 @@ sysmalloc_mmap (INTERNAL_SIZE_T nb, size_t pagesize, int extra_flags)
   size_t padding = MALLOC_ALIGNMENT - CHUNK_HDR_SZ;
   size_t size = ALIGN_UP (nb + padding + CHUNK_HDR_SZ, pagesize);
 
-  char *mm = (char *) MMAP (NULL, size,
+  /* Place chunks of at least a transparent huge page at a huge page
+     boundary, so that they can be backed by huge pages from their start.
+     Map enough to align the chunk and unmap the excess.  */
+  size_t thp_extra = 0;
+  if (extra_flags == 0 && mp_.thp_pagesize != 0 && size >= mp_.thp_pagesize)
+    thp_extra = mp_.thp_pagesize - pagesize;
+
+  char *mm = (char *) MMAP (NULL, size + thp_extra,
 			    extra_mmap_prot | PROT_READ | PROT_WRITE,
 			    extra_flags);
   if (mm == MAP_FAILED)
     return mm;
+  if (thp_extra != 0)
+    {
+      char *aligned = PTR_ALIGN_UP (mm, mp_.thp_pagesize);
+      if (aligned != mm)
+	__munmap (mm, aligned - mm);
+      if (aligned + size != mm + size + thp_extra)
+	__munmap (aligned + size, mm + thp_extra - aligned);
+      mm = aligned;
+    }
   if (extra_flags == 0)
     madvise_thp (mm, size);
 
@@ -2220,7 +2385,8 @@ sysmalloc (INTERNAL_SIZE_T nb, mstate av)
           set_head (old_top, (((char *) old_heap + old_heap->size) - (char *) old_top)
                     | PREV_INUSE);
         }
-      else if ((heap = new_heap (nb + (MINSIZE + sizeof (*heap)), mp_.top_pad)))
+      else if ((heap = new_heap (nb + (MINSIZE + sizeof (*heap)), mp_.top_pad,
+				 av->node)))
         {
           /* Use a newly allocated heap.  */
           heap->ar_ptr = av;
@@ -2818,9 +2984,10 @@ large_csize2tidx(size_t nb)
 }
 
 /* Caller must ensure that we know tc_idx is valid and there's room
-   for more chunks.  */
+   for more chunks in cache TC.  */
 static __always_inline void
-tcache_put_n (mchunkptr chunk, size_t tc_idx, tcache_entry **ep, bool mangled)
+tcache_put_n (tcache_perthread_struct *tc, mchunkptr chunk, size_t tc_idx,
+	      tcache_entry **ep, bool mangled)
 {
   tcache_entry *e = (tcache_entry *) chunk2mem (chunk);
 
@@ -2838,14 +3005,15 @@ tcache_put_n (mchunkptr chunk, size_t tc_idx, tcache_entry **ep, bool mangled)
       e->next = PROTECT_PTR (&e->next, REVEAL_PTR (*ep));
       *ep = PROTECT_PTR (ep, e);
     }
-  --(tcache->num_slots[tc_idx]);
+  --(tc->num_slots[tc_idx]);
 }
 
 /* Caller must ensure that we know tc_idx is valid and there's
-   available chunks to remove.  Removes chunk from the middle of the
-   list.  */
+   available chunks to remove from cache TC.  Removes chunk from the
+   middle of the list.  */
 static __always_inline void *
-tcache_get_n (size_t tc_idx, tcache_entry **ep, bool mangled)
+tcache_get_n (tcache_perthread_struct *tc, size_t tc_idx, tcache_entry **ep,
+	      bool mangled)
 {
   tcache_entry *e;
   if (!mangled)
@@ -2861,7 +3029,7 @@ tcache_get_n (size_t tc_idx, tcache_entry **ep, bool mangled)
   else
     *ep = PROTECT_PTR (ep, REVEAL_PTR (e->next));
 
-  ++(tcache->num_slots[tc_idx]);
+  ++(tc->num_slots[tc_idx]);
   e->key = 0;
   return (void *) e;
 }
@@ -2869,14 +3037,14 @@ tcache_get_n (size_t tc_idx, tcache_entry **ep, bool mangled)
 static __always_inline void
 tcache_put (mchunkptr chunk, size_t tc_idx)
 {
-  tcache_put_n (chunk, tc_idx, &tcache->entries[tc_idx], false);
+  tcache_put_n (tcache, chunk, tc_idx, &tcache->entries[tc_idx], false);
 }
 
 /* Like the above, but removes from the head of the list.  */
 static __always_inline void *
 tcache_get (size_t tc_idx)
 {
-  return tcache_get_n (tc_idx, &tcache->entries[tc_idx], false);
+  return tcache_get_n (tcache, tc_idx, &tcache->entries[tc_idx], false);
 }
 
 static __always_inline tcache_entry **
@@ -2905,7 +3073,7 @@ tcache_put_large (mchunkptr chunk, size_t tc_idx)
   tcache_entry *te;
   entry = tcache_location_large (chunksize (chunk), tc_idx, &mangled, &te);
 
-  return tcache_put_n (chunk, tc_idx, entry, mangled);
+  return tcache_put_n (tcache, chunk, tc_idx, entry, mangled);
 }
 
 static __always_inline void *
@@ -2919,7 +3087,7 @@ tcache_get_large (size_t tc_idx, size_t nb)
   if (te == NULL || nb != chunksize (mem2chunk (te)))
     return NULL;
 
-  return tcache_get_n (tc_idx, entry, mangled);
+  return tcache_get_n (tcache, tc_idx, entry, mangled);
 }
 
 static void tcache_init (mstate av);
@@ -2952,11 +3120,324 @@ tcache_get_align (size_t nb, size_t alignment)
       if (te != NULL
 	  && csize == nb
 	  && PTR_IS_ALIGNED (te, alignment))
-	return tcache_get_n (tc_idx, tep, mangled);
+	return tcache_get_n (tcache, tc_idx, tep, mangled);
     }
   return NULL;
 }
 
+/* Free the chunks in the list of tcache entries starting at E, following
+   at most N links, back to their arenas.  Consecutive chunks which
+   belong to the same arena are freed under a single acquisition of the
+   arena lock.  No arena lock may be held by the caller.  */
+static void
+tcache_free_entries (tcache_entry *e, size_t n)
+{
+  bool lock = !SINGLE_THREAD_P;
+  mstate locked = NULL;
+
+  for (; e != NULL && n > 0; n--)
+    {
+      if (__glibc_unlikely (misaligned_mem (e)))
+	malloc_printerr ("free(): unaligned tcache chunk detected");
+      tcache_entry *next = REVEAL_PTR (e->next);
+      e->key = 0;
+
+      mchunkptr p = mem2chunk (e);
+      if (chunk_is_mmapped (p))
+	_int_free_chunk (arena_for_chunk (p), p, chunksize (p));
+      else
+	{
+	  mstate av = arena_for_chunk (p);
+	  if (lock && av != locked)
+	    {
+	      if (locked != NULL)
+		__libc_lock_unlock (locked->mutex);
+	      __libc_lock_lock (av->mutex);
+	      _int_free_remote_drain (av);
+	      locked = av;
+	    }
+	  _int_free_merge_chunk (av, p, chunksize (p));
+	}
+      e = next;
+    }
+
+  if (locked != NULL)
+    __libc_lock_unlock (locked->mutex);
+}
+
+/* Called by free if the tcache bin TC_IDX for chunk P is full.  Instead
+   of freeing P to its arena, which takes the arena lock for every chunk
+   freed past the limit, return the last mp_.tcache_batch chunks of the
+   bin to their arenas at once and cache P.  The bin is a LIFO list, so
+   its tail holds the entries that have been cached longest and are the
+   least likely to still be in the CPU caches.  Return false if batching
+   is disabled.  */
+static __attribute__ ((noinline)) bool
+tcache_flush_batch (mchunkptr p, size_t tc_idx)
+{
+  size_t n = mp_.tcache_batch;
+  if (n <= 1 || tcache->entries[tc_idx] == NULL)
+    return false;
+
+  /* Count the entries in the bin.  */
+  size_t count = 0;
+  for (tcache_entry *e = tcache->entries[tc_idx]; e != NULL;
+       e = REVEAL_PTR (e->next))
+    {
+      if (__glibc_unlikely (misaligned_mem (e)))
+	malloc_printerr ("free(): unaligned tcache chunk detected");
+      count++;
+    }
+
+  /* Unlink the last N entries.  */
+  tcache_entry *tail;
+  if (count <= n)
+    {
+      n = count;
+      tail = tcache->entries[tc_idx];
+      tcache->entries[tc_idx] = NULL;
+    }
+  else
+    {
+      tcache_entry *e = tcache->entries[tc_idx];
+      for (size_t i = 1; i < count - n; i++)
+	e = REVEAL_PTR (e->next);
+      tail = REVEAL_PTR (e->next);
+      e->next = PROTECT_PTR (&e->next, NULL);
+    }
+  tcache->num_slots[tc_idx] += n;
+
+  tcache_put (p, tc_idx);
+  tcache_free_entries (tail, n);
+  return true;
+}
+
+/* Called from _int_malloc with the arena AV locked, after VICTIM was
+   split off the top chunk for a request of NB bytes with tcache bin
+   TC_IDX.  Carve up to mp_.tcache_batch - 1 more chunks of the same size
+   from the top chunk and put them in the tcache, so that the following
+   allocations of that size do not need to take the arena lock.  */
+static void
+tcache_refill_batch (mstate av, mchunkptr victim, INTERNAL_SIZE_T nb,
+		     size_t tc_idx)
+{
+  mchunkptr top = av->top;
+  INTERNAL_SIZE_T top_size = chunksize (top);
+
+  size_t n = mp_.tcache_batch - 1;
+  if (n > tcache->num_slots[tc_idx])
+    n = tcache->num_slots[tc_idx];
+  if (n > (top_size - MINSIZE) / nb)
+    n = (top_size - MINSIZE) / nb;
+  if (n == 0)
+    return;
+
+  av->top = chunk_at_offset (top, n * nb);
+  set_head (av->top, (top_size - n * nb) | PREV_INUSE);
+
+  /* Insert the chunks in reverse order, so that they are handed out in
+     address order.  */
+  for (size_t i = n; i > 0; i--)
+    {
+      mchunkptr p = chunk_at_offset (victim, i * nb);
+      set_head (p, nb | PREV_INUSE
+		   | (av != &main_arena ? NON_MAIN_ARENA : 0));
+      tcache_put (p, tc_idx);
+    }
+}
+
+/* Per-CPU caches.  If the glibc.malloc.percpu tunable is set, the
+   per-thread caches are disabled and small chunks are cached per CPU
+   instead, so that the amount of cached memory scales with the number of
+   CPUs rather than with the number of threads.  The cache is selected
+   with the CPU number the kernel publishes in the rseq area, which does
+   not need a system call.  Each cache has its own lock, which is only
+   contended if the owner was preempted or migrated while holding it; in
+   that case the caller does not wait but uses the arena instead.  */
+
+# define TCACHE_PERCPU_ALIGN 64
+
+typedef struct tcache_percpu_struct
+{
+  __libc_lock_define (, lock);
+  tcache_perthread_struct cache;
+} __attribute__ ((aligned (TCACHE_PERCPU_ALIGN))) tcache_percpu_struct;
+
+/* Array of TCACHE_PERCPU_COUNT caches, indexed by CPU number.  NULL if
+   the per-CPU caches are not used.  Both are only written by
+   tcache_percpu_init.  */
+static tcache_percpu_struct *tcache_percpu;
+static unsigned int tcache_percpu_count;
+
+/* Allocate the per-CPU caches if requested by glibc.malloc.percpu.  Called
+   once from ptmalloc_init, after all tunables have been applied.  */
+static void
+tcache_percpu_init (void)
+{
+  if (!mp_.tcache_percpu || mp_.tcache_count == 0)
+    return;
+
+  /* Without rseq there is no cheap way to obtain the CPU number, so keep
+     using the per-thread caches.  */
+  if (malloc_getcpu () < 0)
+    return;
+
+  int ncpus = __get_nprocs_conf ();
+  if (ncpus <= 0)
+    return;
+
+  size_t size = ALIGN_UP (ncpus * sizeof (tcache_percpu_struct),
+			  GLRO (dl_pagesize));
+  char *mm = (char *) MMAP (NULL, size, PROT_READ | PROT_WRITE, 0);
+  if (mm == MAP_FAILED)
+    return;
+
+  __set_vma_name (mm, size, " glibc: malloc per-CPU cache");
+
+  /* The mapping is zero-filled, so all locks are already initialized and
+     all bins are empty.  */
+  tcache_percpu_struct *pc = (tcache_percpu_struct *) mm;
+  for (int i = 0; i < ncpus; i++)
+    for (size_t j = 0; j < mp_.tcache_small_bins; j++)
+      pc[i].cache.num_slots[j] = mp_.tcache_count;
+
+  tcache_percpu_count = ncpus;
+  tcache_percpu = pc;
+}
+
+/* Lock and return the cache of the CPU the calling thread is running on.
+   Return NULL if there is none or if it is currently locked by another
+   thread.  */
+static __always_inline tcache_percpu_struct *
+tcache_percpu_lock (void)
+{
+  unsigned int cpu = malloc_getcpu ();
+  if (__glibc_unlikely (cpu >= tcache_percpu_count))
+    return NULL;
+
+  tcache_percpu_struct *pc = &tcache_percpu[cpu];
+  if (__libc_lock_trylock (pc->lock) != 0)
+    return NULL;
+  return pc;
+}
+
+/* Try to take a chunk of normalized size NB from the cache of the current
+   CPU.  */
+static void *
+tcache_percpu_get (size_t nb)
+{
+  if (nb >= mp_.tcache_max_bytes)
+    return NULL;
+  size_t tc_idx = csize2tidx (nb);
+  if (tc_idx >= mp_.tcache_small_bins)
+    return NULL;
+
+  tcache_percpu_struct *pc = tcache_percpu_lock ();
+  if (pc == NULL)
+    return NULL;
+
+  void *victim = NULL;
+  if (pc->cache.entries[tc_idx] != NULL)
+    victim = tcache_get_n (&pc->cache, tc_idx, &pc->cache.entries[tc_idx],
+			   false);
+  __libc_lock_unlock (pc->lock);
+  return victim;
+}
+
+/* Try to put chunk P of SIZE bytes in the cache of the current CPU.
+   Return false if the chunk has to be freed to its arena instead.  */
+static bool
+tcache_percpu_put (mchunkptr p, INTERNAL_SIZE_T size)
+{
+  size_t tc_idx = csize2tidx (size);
+  if (tc_idx >= mp_.tcache_small_bins)
+    return false;
+
+  tcache_percpu_struct *pc = tcache_percpu_lock ();
+  if (pc == NULL)
+    return false;
+
+  bool cached = pc->cache.num_slots[tc_idx] != 0;
+  if (cached)
+    tcache_put_n (&pc->cache, p, tc_idx, &pc->cache.entries[tc_idx], false);
+  __libc_lock_unlock (pc->lock);
+  return cached;
+}
+
+/* Return all chunks held in the per-CPU caches to their arenas.  No arena
+   lock may be held by the caller.  */
+static void
+tcache_percpu_flush (void)
+{
+  for (unsigned int i = 0; i < tcache_percpu_count; i++)
+    {
+      tcache_percpu_struct *pc = &tcache_percpu[i];
+      __libc_lock_lock (pc->lock);
+      for (size_t tc_idx = 0; tc_idx < TCACHE_SMALL_BINS; tc_idx++)
+	while (pc->cache.entries[tc_idx] != NULL)
+	  {
+	    void *mem = tcache_get_n (&pc->cache, tc_idx,
+				      &pc->cache.entries[tc_idx], false);
+	    mchunkptr p = mem2chunk (mem);
+	    _int_free_chunk (arena_for_chunk (p), p, chunksize (p));
+	  }
+      __libc_lock_unlock (pc->lock);
+    }
+}
+
+/* Like tcache_double_free_verify, for the cache of the current CPU.
+   Only this cache is checked, under its lock, just as only the cache of
+   the calling thread is checked without the per-CPU caches; taking the
+   locks of all the CPUs would contend with their fast paths.  A double
+   free of a chunk held by the cache of another CPU is detected when the
+   chunk is freed again on that CPU.  */
+static void
+tcache_percpu_double_free_verify (tcache_entry *e)
+{
+  tcache_percpu_struct *pc = tcache_percpu_lock ();
+  if (pc == NULL)
+    return;
+
+  for (size_t tc_idx = 0; tc_idx < TCACHE_SMALL_BINS; ++tc_idx)
+    {
+      size_t cnt = 0;
+      for (tcache_entry *tmp = pc->cache.entries[tc_idx];
+	   tmp;
+	   tmp = REVEAL_PTR (tmp->next), ++cnt)
+	{
+	  if (cnt >= mp_.tcache_count)
+	    malloc_printerr ("free(): too many chunks detected in "
+			     "per-CPU tcache");
+	  if (__glibc_unlikely (misaligned_mem (tmp)))
+	    malloc_printerr ("free(): unaligned chunk detected in "
+			     "per-CPU tcache");
+	  if (tmp == e)
+	    malloc_printerr ("free(): double free detected in "
+			     "per-CPU tcache");
+	}
+    }
+  __libc_lock_unlock (pc->lock);
+}
+
+/* The per-CPU cache locks are acquired around fork, like the arena
+   locks.  */
+static void
+tcache_percpu_fork_lock (void)
+{
+  for (unsigned int i = 0; i < tcache_percpu_count; i++)
+    __libc_lock_lock (tcache_percpu[i].lock);
+}
+
+static void
+tcache_percpu_fork_unlock (bool child)
+{
+  for (unsigned int i = 0; i < tcache_percpu_count; i++)
+    if (child)
+      __libc_lock_init (tcache_percpu[i].lock);
+    else
+      __libc_lock_unlock (tcache_percpu[i].lock);
+}
+
 /* Verify if the suspicious tcache_entry is double free.
    It's not expected to execute very often, mark it as noinline.  */
 static __attribute__ ((noinline)) void
@@ -2979,6 +3460,9 @@ tcache_double_free_verify (tcache_entry *e)
 	    malloc_printerr ("free(): double free detected in tcache 2");
 	}
     }
+  if (tcache_percpu != NULL)
+    tcache_percpu_double_free_verify (e);
+
   /* No double free detected - it might be in a tcache of another thread,
      or user data that happens to match the key.  Since we are not sure,
      clear the key and retry freeing it.  */
@@ -3002,19 +3486,7 @@ tcache_thread_shutdown (void)
   /* Free all of the entries and the tcache itself back to the arena
      heap for coalescing.  */
   for (i = 0; i < TCACHE_MAX_BINS; ++i)
-    {
-      while (tcache_tmp->entries[i])
-	{
-	  tcache_entry *e = tcache_tmp->entries[i];
-	  if (__glibc_unlikely (misaligned_mem (e)))
-	    malloc_printerr ("tcache_thread_shutdown(): "
-			     "unaligned tcache chunk detected");
-	  tcache_tmp->entries[i] = REVEAL_PTR (e->next);
-	  e->key = 0;
-	  p = mem2chunk (e);
-	  _int_free_chunk (arena_for_chunk (p), p, chunksize (p));
-	}
-    }
+    tcache_free_entries (tcache_tmp->entries[i], SIZE_MAX);
 
   p = mem2chunk (tcache_tmp);
   _int_free_chunk (arena_for_chunk (p), p, chunksize (p));
@@ -3027,7 +3499,7 @@ tcache_init (mstate av)
 {
   /* Set this unconditionally to avoid infinite loops.  */
   tcache_set_disabled ();
-  if (mp_.tcache_count == 0)
+  if (mp_.tcache_count == 0 || tcache_percpu != NULL)
     return;
 
   size_t bytes = sizeof (tcache_perthread_struct);
@@ -3058,98 +3530,906 @@ tcache_thread_shutdown (void)
   /* Nothing to do if there is no thread cache.  */
 }
 
+static void
+tcache_percpu_fork_lock (void)
+{
+}
+
+static void
+tcache_percpu_fork_unlock (bool child)
+{
+}
+
 #endif /* !USE_TCACHE  */
 
-#if IS_IN (libc)
+/* ------------------------------ Slabs ------------------------------ */
+
+/* If the glibc.malloc.slab tunable is set, requests of up to that many
+   bytes are served from slabs instead of the arenas.  A slab is a page
+   holding objects of a single size class, a multiple of MALLOC_ALIGNMENT,
+   without any chunk header or boundary tag.  All slabs are carved from a
+   single reserved address range, so free and malloc_usable_size recognize
+   slab objects by their address, and the metadata of each slab is kept
+   out of line in an array indexed by page number.
+
+   Each size class is sharded by the CPU the allocating thread is running
+   on to reduce lock contention.  A slab belongs to the class it was
+   allocated for until it becomes empty, when it is put on a global list
+   of empty slabs which any class can reuse.  malloc_trim releases the
+   memory of the empty slabs.  */
+
+/* Largest request which may be served from a slab.  */
+#define SLAB_MAX_SIZE 256
+#define SLAB_CLASSES (SLAB_MAX_SIZE / MALLOC_ALIGNMENT)
+#define SLAB_SHARDS 8
+
+/* Address space reserved for the slabs, which is made accessible in steps
+   of SLAB_GROW_SIZE bytes.  */
+#if __WORDSIZE == 64
+# define SLAB_RESERVE_SIZE ((size_t) 4 << 30)
+#else
+# define SLAB_RESERVE_SIZE ((size_t) 64 << 20)
+#endif
+#define SLAB_GROW_SIZE ((size_t) 256 << 10)
 
-static void * __attribute_noinline__
-__libc_malloc2 (size_t bytes)
+struct malloc_slab_class;
+
+struct malloc_slab
 {
-  mstate ar_ptr;
-  void *victim;
+  /* Links in the partial list of the class or in the empty list.  */
+  struct malloc_slab *next;
+  struct malloc_slab *prev;
+  /* Class the slab belongs to, NULL if the slab is empty.  */
+  struct malloc_slab_class *class;
+  /* Freed objects, linked through their first word.  */
+  void *free_list;
+  /* Size and number of the objects.  */
+  uint32_t size;
+  uint32_t count;
+  /* Number of allocated objects.  */
+  uint32_t used;
+  /* Number of objects handed out at least once.  The objects after them
+     have never been touched.  */
+  uint32_t carved;
+};
 
-  if (SINGLE_THREAD_P)
-    {
-      victim = _int_malloc (&main_arena, bytes);
-      assert (!victim || chunk_is_mmapped (mem2chunk (victim)) ||
-	      &main_arena == arena_for_chunk (mem2chunk (victim)));
-      return victim;
-    }
+/* We overlay this structure on a freed slab object.  */
+struct malloc_slab_object
+{
+  struct malloc_slab_object *next;
+  /* This field exists to detect double frees, like the key of
+     tcache_entry.  */
+  uintptr_t key;
+};
 
-  arena_get (ar_ptr, bytes);
+struct malloc_slab_class
+{
+  __libc_lock_define (, lock);
+  /* Slabs with at least one free object.  */
+  struct malloc_slab *partial;
+  /* Number of slabs owned and of objects allocated, for mallinfo.  */
+  size_t slabs;
+  size_t used;
+} __attribute__ ((aligned (64)));
+
+static struct malloc_slab_class slab_classes[SLAB_SHARDS][SLAB_CLASSES];
+
+/* Start and size of the reserved range, NULL and zero if the slabs are not
+   used.  Only written by slab_init.  */
+static char *slab_base;
+static size_t slab_reserved;
+static struct malloc_slab *slab_meta;
+static unsigned int slab_page_shift;
+/* Value of the key field of the freed slab objects.  */
+static uintptr_t slab_key;
+
+/* slab_lock protects the variables below.  It may be acquired while a
+   class lock is held, but not the other way around.  */
+__libc_lock_define_initialized (static, slab_lock);
+/* Size of the accessible part of the reserved range.  */
+static size_t slab_committed;
+/* Number of pages which have been used for slabs.  */
+static size_t slab_pages;
+/* Empty slabs.  */
+static struct malloc_slab *slab_empty;
 
-  victim = _int_malloc (ar_ptr, bytes);
-  /* Retry with another arena only if we were able to find a usable arena
-     before.  */
-  if (!victim && ar_ptr != NULL)
-    {
-      LIBC_PROBE (memory_malloc_retry, 1, bytes);
-      ar_ptr = arena_get_retry (ar_ptr, bytes);
-      victim = _int_malloc (ar_ptr, bytes);
-    }
+static __always_inline bool
+slab_ptr (void *mem)
+{
+  return (uintptr_t) mem - (uintptr_t) slab_base < slab_reserved;
+}
 
-  if (ar_ptr != NULL)
-    __libc_lock_unlock (ar_ptr->mutex);
+static __always_inline struct malloc_slab *
+slab_for_ptr (void *mem)
+{
+  return &slab_meta[((char *) mem - slab_base) >> slab_page_shift];
+}
 
-  assert (!victim || chunk_is_mmapped (mem2chunk (victim)) ||
-          ar_ptr == arena_for_chunk (mem2chunk (victim)));
-  return victim;
+static __always_inline char *
+slab_page (struct malloc_slab *s)
+{
+  return slab_base + ((size_t) (s - slab_meta) << slab_page_shift);
 }
 
-void *
-__libc_malloc (size_t bytes)
+/* Remove slab S from the partial list of class C.  */
+static void
+slab_unlink (struct malloc_slab_class *c, struct malloc_slab *s)
 {
-#if USE_TCACHE
-  size_t nb = checked_request2size (bytes);
+  if (s->prev != NULL)
+    s->prev->next = s->next;
+  else
+    c->partial = s->next;
+  if (s->next != NULL)
+    s->next->prev = s->prev;
+  s->next = s->prev = NULL;
+}
 
-  if (nb < mp_.tcache_max_bytes)
-    {
-      size_t tc_idx = csize2tidx (nb);
+/* Add slab S to the partial list of class C.  */
+static void
+slab_link (struct malloc_slab_class *c, struct malloc_slab *s)
+{
+  s->prev = NULL;
+  s->next = c->partial;
+  if (s->next != NULL)
+    s->next->prev = s;
+  c->partial = s;
+}
 
-      if (__glibc_likely (tc_idx < TCACHE_SMALL_BINS))
-        {
-	  if (tcache->entries[tc_idx] != NULL)
-	    return tcache_get (tc_idx);
-	}
-      else
-        {
-	  tc_idx = large_csize2tidx (nb);
-	  void *victim = tcache_get_large (tc_idx, nb);
-	  if (victim != NULL)
-	    return victim;
-	}
+/* Return the usable size of slab object MEM.  */
+static size_t
+slab_usable (void *mem)
+{
+  return slab_for_ptr (mem)->size;
+}
+
+/* Check whether object O of slab S, whose key matches slab_key, is
+   on the free list of S.  The lock of the class of S is held.  */
+static __attribute__ ((noinline)) void
+slab_double_free_verify (struct malloc_slab *s, struct malloc_slab_object *o)
+{
+  size_t cnt = 0;
+  for (struct malloc_slab_object *tmp = s->free_list; tmp != NULL;
+       tmp = REVEAL_PTR (tmp->next), ++cnt)
+    {
+      if (cnt >= s->count)
+	malloc_printerr ("free(): too many objects detected in slab");
+      if (__glibc_unlikely (misaligned_mem (tmp)))
+	malloc_printerr ("free(): unaligned slab object detected");
+      if (tmp == o)
+	malloc_printerr ("free(): double free detected in slab");
     }
-#endif
 
-  return __libc_malloc2 (bytes);
+  /* The key is user data which happens to match slab_key.  */
 }
-libc_hidden_def (__libc_malloc)
 
-static void __attribute_noinline__
-tcache_free_init (void *mem)
+/* Free slab object MEM.  */
+static void
+slab_free (void *mem)
 {
-  tcache_init (NULL);
-  __libc_free (mem);
+  struct malloc_slab *s = slab_for_ptr (mem);
+  struct malloc_slab_class *c = s->class;
+  if (__glibc_unlikely (c == NULL
+			|| ((char *) mem - slab_page (s)) % s->size != 0))
+    malloc_printerr ("free(): invalid pointer");
+
+  struct malloc_slab_object *o = mem;
+  __libc_lock_lock (c->lock);
+  if (__glibc_unlikely (s->used == 0))
+    malloc_printerr ("free(): double free detected in slab");
+  if (__glibc_unlikely (o->key == slab_key))
+    slab_double_free_verify (s, o);
+
+  o->next = PROTECT_PTR (&o->next, s->free_list);
+  o->key = slab_key;
+  s->free_list = o;
+  c->used--;
+  if (s->used-- == s->count)
+    slab_link (c, s);
+  else if (s->used == 0 && (c->partial != s || s->next != NULL))
+    {
+      /* Keep the last partial slab of the class, so that allocating and
+	 freeing a single object does not move a slab back and forth.  */
+      slab_unlink (c, s);
+      c->slabs--;
+      s->class = NULL;
+      __libc_lock_lock (slab_lock);
+      s->next = slab_empty;
+      slab_empty = s;
+      __libc_lock_unlock (slab_lock);
+    }
+  __libc_lock_unlock (c->lock);
 }
 
-void
-__libc_free (void *mem)
+/* Release the memory of the empty slabs.  Return 1 if memory was
+   released.  */
+static int
+slab_trim (void)
 {
-  mchunkptr p;                          /* chunk corresponding to mem */
+  int result = 0;
+  size_t pagesize = GLRO (dl_pagesize);
 
-  if (mem == NULL)                              /* free(0) has no effect */
+  __libc_lock_lock (slab_lock);
+  for (struct malloc_slab *s = slab_empty; s != NULL; s = s->next)
+    if (s->carved != 0)
+      {
+	__madvise (slab_page (s), pagesize, MADV_DONTNEED);
+	s->carved = 0;
+	result = 1;
+      }
+  __libc_lock_unlock (slab_lock);
+
+  return result;
+}
+
+/* Add the slab statistics to M.  The pages used for slabs count as
+   arena memory.  */
+static void
+slab_mallinfo (struct mallinfo2 *m)
+{
+  if (slab_base == NULL)
     return;
 
-  p = mem2chunk (mem);
+  size_t used = 0;
+  for (size_t i = 0; i < SLAB_SHARDS; i++)
+    for (size_t j = 0; j < SLAB_CLASSES; j++)
+      {
+	struct malloc_slab_class *c = &slab_classes[i][j];
+	__libc_lock_lock (c->lock);
+	used += c->used * (j + 1) * MALLOC_ALIGNMENT;
+	__libc_lock_unlock (c->lock);
+      }
 
-  INTERNAL_SIZE_T size = chunksize (p);
+  __libc_lock_lock (slab_lock);
+  size_t total = slab_pages << slab_page_shift;
+  __libc_lock_unlock (slab_lock);
 
-  if (__glibc_unlikely (misaligned_chunk (p)))
-    return malloc_printerr_tail ("free(): invalid pointer");
+  m->arena += total;
+  m->uordblks += used;
+  m->fordblks += total - used;
+}
 
-#if USE_TCACHE
-  if (__glibc_likely (size < mp_.tcache_max_bytes))
-    {
+/* The slab locks are acquired around fork, like the arena locks.  */
+static void
+slab_fork_lock (void)
+{
+  if (slab_base == NULL)
+    return;
+  for (size_t i = 0; i < SLAB_SHARDS; i++)
+    for (size_t j = 0; j < SLAB_CLASSES; j++)
+      __libc_lock_lock (slab_classes[i][j].lock);
+  __libc_lock_lock (slab_lock);
+}
+
+static void
+slab_fork_unlock (bool child)
+{
+  if (slab_base == NULL)
+    return;
+  if (child)
+    {
+      for (size_t i = 0; i < SLAB_SHARDS; i++)
+	for (size_t j = 0; j < SLAB_CLASSES; j++)
+	  __libc_lock_init (slab_classes[i][j].lock);
+      __libc_lock_init (slab_lock);
+    }
+  else
+    {
+      __libc_lock_unlock (slab_lock);
+      for (size_t i = 0; i < SLAB_SHARDS; i++)
+	for (size_t j = 0; j < SLAB_CLASSES; j++)
+	  __libc_lock_unlock (slab_classes[i][j].lock);
+    }
+}
+
+#if IS_IN (libc)
+
+/* Reserve the address range for the slabs if requested by
+   glibc.malloc.slab.  Called once from ptmalloc_init.  */
+static void
+slab_init (void)
+{
+  if (mp_.slab_max == 0)
+    return;
+
+  size_t pagesize = GLRO (dl_pagesize);
+  size_t meta_size = ALIGN_UP ((SLAB_RESERVE_SIZE / pagesize)
+			       * sizeof (struct malloc_slab), pagesize);
+  char *p = (char *) MMAP (NULL, meta_size + SLAB_RESERVE_SIZE, PROT_NONE,
+			   MAP_NORESERVE);
+  if (p == MAP_FAILED)
+    return;
+
+  __set_vma_name (p, meta_size + SLAB_RESERVE_SIZE, " glibc: malloc slab");
+
+  slab_meta = (struct malloc_slab *) p;
+  slab_page_shift = stdc_trailing_zeros (pagesize);
+  slab_base = p + meta_size;
+  slab_reserved = SLAB_RESERVE_SIZE;
+#if __WORDSIZE == 64
+  slab_key = ((uintptr_t) random_bits () << 32) | random_bits ();
+#else
+  slab_key = random_bits ();
+#endif
+  /* Zero is the key of the allocated objects.  */
+  slab_key |= 1;
+  mp_.slab_max_bytes = mp_.slab_max + 1;
+}
+
+/* Make SLAB_GROW_SIZE more bytes of the reserved range accessible, along
+   with their metadata.  Called with slab_lock held.  */
+static bool
+slab_grow (void)
+{
+  size_t pagesize = GLRO (dl_pagesize);
+  size_t size = ALIGN_UP (SLAB_GROW_SIZE, pagesize);
+  if (slab_committed + size > slab_reserved)
+    return false;
+
+  size_t meta_start = ALIGN_UP ((slab_committed >> slab_page_shift)
+				* sizeof (struct malloc_slab), pagesize);
+  size_t meta_end = ALIGN_UP (((slab_committed + size) >> slab_page_shift)
+			      * sizeof (struct malloc_slab), pagesize);
+  if (meta_end > meta_start
+      && __mprotect ((char *) slab_meta + meta_start, meta_end - meta_start,
+		     PROT_READ | PROT_WRITE) != 0)
+    return false;
+  if (__mprotect (slab_base + slab_committed, size,
+		  PROT_READ | PROT_WRITE) != 0)
+    return false;
+
+  slab_committed += size;
+  return true;
+}
+
+/* Get a slab for objects of SIZE bytes and add it to class C, which is
+   locked by the caller.  */
+static struct malloc_slab *
+slab_new (struct malloc_slab_class *c, size_t size)
+{
+  struct malloc_slab *s = NULL;
+
+  __libc_lock_lock (slab_lock);
+  if (slab_empty != NULL)
+    {
+      s = slab_empty;
+      slab_empty = s->next;
+    }
+  else if ((slab_pages << slab_page_shift) < slab_committed || slab_grow ())
+    s = &slab_meta[slab_pages++];
+  __libc_lock_unlock (slab_lock);
+
+  if (s == NULL)
+    return NULL;
+
+  s->class = c;
+  s->free_list = NULL;
+  s->size = size;
+  s->count = GLRO (dl_pagesize) / size;
+  s->used = 0;
+  s->carved = 0;
+  slab_link (c, s);
+  c->slabs++;
+  return s;
+}
+
+/* Allocate BYTES bytes from a slab.  Return NULL if no slab is
+   available, in which case the caller uses the arenas.  */
+static void *
+slab_malloc (size_t bytes)
+{
+  size_t idx = bytes == 0 ? 0 : (bytes - 1) / MALLOC_ALIGNMENT;
+  int cpu = malloc_getcpu ();
+  struct malloc_slab_class *c
+    = &slab_classes[cpu < 0 ? 0 : cpu % SLAB_SHARDS][idx];
+
+  __libc_lock_lock (c->lock);
+  struct malloc_slab *s = c->partial;
+  if (s == NULL)
+    {
+      s = slab_new (c, (idx + 1) * MALLOC_ALIGNMENT);
+      if (s == NULL)
+	{
+	  __libc_lock_unlock (c->lock);
+	  return NULL;
+	}
+    }
+
+  struct malloc_slab_object *o = s->free_list;
+  void *mem = o;
+  if (o != NULL)
+    {
+      if (__glibc_unlikely (misaligned_mem (o)))
+	malloc_printerr ("malloc(): unaligned slab object detected");
+      s->free_list = REVEAL_PTR (o->next);
+      o->key = 0;
+    }
+  else
+    mem = slab_page (s) + s->carved++ * s->size;
+
+  c->used++;
+  if (++s->used == s->count)
+    slab_unlink (c, s);
+  __libc_lock_unlock (c->lock);
+
+  return mem;
+}
+
+/* Resize slab object OLDMEM to BYTES bytes.  */
+static void *
+slab_realloc (void *oldmem, size_t bytes)
+{
+  size_t usable = slab_usable (oldmem);
+  if (bytes <= usable)
+    return oldmem;
+
+  void *newmem = __libc_malloc (bytes);
+  if (newmem == NULL)
+    return NULL;
+  memcpy (newmem, oldmem, usable);
+  slab_free (oldmem);
+  return newmem;
+}
+
+#endif /* IS_IN (libc) */
+
+/* ------------------------- Heap profiling ------------------------- */
+
+/* If the glibc.malloc.profile tunable is set, allocations are sampled as
+   a Poisson process with a mean of one sample per that many bytes
+   allocated: each thread counts down the bytes it allocates, and when the
+   count drops below zero the allocation is sampled and the count is reset
+   to an exponentially distributed random value.  The stack trace of each
+   sampled allocation is recorded in a table of live samples, from which
+   the sample is removed when the allocation is freed.
+   malloc_info (MALLOC_INFO_PROFILE, fp) writes the table in the heap
+   profile format of gperftools, which pprof reads.
+
+   free has to find out cheaply whether a pointer was sampled.  The table
+   is a hash table whose chain lengths are kept in a separate array which
+   is read without taking the table lock, so that only frees of pointers
+   which hash to a non-empty chain take the lock.  */
+
+#define PROFILE_MAX_DEPTH 32
+#define PROFILE_HASH_BITS 14
+#define PROFILE_POOL_SIZE ((size_t) 64 << 10)
+
+struct profile_sample
+{
+  /* Next sample in the hash chain or in the free list.  */
+  struct profile_sample *next;
+  void *ptr;
+  size_t size;
+  int depth;
+  void *stack[PROFILE_MAX_DEPTH];
+};
+
+/* Chain lengths and chains of the table of live samples, NULL if the
+   profiler is not enabled.  Only written by profile_init.  */
+static unsigned int *profile_counts;
+static struct profile_sample **profile_chains;
+
+/* profile_lock protects the table and the variables below.  */
+__libc_lock_define_initialized (static, profile_lock);
+static struct profile_sample *profile_free_samples;
+static size_t profile_live;
+static size_t profile_live_bytes;
+
+/* True once the unwinder used by __backtrace is loaded.  Only written by
+   __malloc_profile_late_init.  */
+static bool profile_unwinder;
+
+/* Bytes the thread may allocate before the next sample, the state of its
+   random number generator (zero until its first allocation), and whether
+   it is recording a sample.  */
+static __thread ssize_t profile_left;
+static __thread uint64_t profile_rand;
+static __thread bool profile_busy;
+
+static __always_inline unsigned int
+profile_hash (void *p)
+{
+  return (uint32_t) (((uintptr_t) p / MALLOC_ALIGNMENT) * 2654435761U)
+	 >> (32 - PROFILE_HASH_BITS);
+}
+
+static void
+profile_fork_lock (void)
+{
+  if (profile_counts != NULL)
+    __libc_lock_lock (profile_lock);
+}
+
+static void
+profile_fork_unlock (bool child)
+{
+  if (profile_counts == NULL)
+    return;
+  if (child)
+    __libc_lock_init (profile_lock);
+  else
+    __libc_lock_unlock (profile_lock);
+}
+
+#if IS_IN (libc)
+
+/* Allocate the table of live samples if requested by
+   glibc.malloc.profile.  Called once from ptmalloc_init.  */
+static void
+profile_init (void)
+{
+  if (mp_.profile == 0)
+    return;
+
+  size_t counts_size = sizeof (*profile_counts) << PROFILE_HASH_BITS;
+  size_t size = counts_size + (sizeof (*profile_chains) << PROFILE_HASH_BITS);
+  char *p = (char *) MMAP (NULL, size, PROT_READ | PROT_WRITE, 0);
+  if (p == MAP_FAILED)
+    {
+      mp_.profile = 0;
+      return;
+    }
+  __set_vma_name (p, size, " glibc: malloc profile");
+
+  profile_counts = (unsigned int *) p;
+  profile_chains = (struct profile_sample **) (p + counts_size);
+}
+
+/* Load the unwinder used by __backtrace if the profiler is enabled.
+   __backtrace loads it with dlopen on its first call, which allocates
+   memory and takes dl_load_lock, so it must not happen in
+   profile_record, with whatever locks the caller of malloc holds.
+   Called from the constructor of libc, once it can use dlopen.  */
+void
+__malloc_profile_late_init (void)
+{
+  if (profile_counts != NULL && __libc_unwind_link_get () != NULL)
+    atomic_store_release (&profile_unwinder, true);
+}
+
+/* Return the number of bytes to allocate before the next sample, drawn
+   from an exponential distribution with a mean of mp_.profile bytes.  */
+static size_t
+profile_next_sample (void)
+{
+  /* xorshift64*.  */
+  uint64_t x = profile_rand;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  profile_rand = x;
+  uint32_t r = ((x * 0x2545f4914f6cdd1dULL) >> 32) | 1;
+
+  /* -ln (r / 2^32) in 16.16 fixed point, with the base 2 logarithm
+     interpolated linearly between powers of two.  The error of less than
+     0.09 does not matter for sampling.  45426 is ln 2 in 16.16 fixed
+     point.  */
+  unsigned int e = stdc_bit_width (r) - 1;
+  uint64_t log2r = (((uint64_t) e << 16)
+		    + (((uint64_t) (r - (1U << e)) << 16) >> e));
+  uint64_t neg_ln = ((((uint64_t) 32 << 16) - log2r) * 45426) >> 16;
+  return ((neg_ln * mp_.profile) >> 16) + 1;
+}
+
+/* Called when the calling thread has allocated enough bytes for a sample,
+   before it allocates BYTES bytes with profiling disabled.  Reset the
+   byte count, and return true if the allocation has to be sampled.  */
+static bool
+profile_start (size_t bytes)
+{
+  bool sample = !profile_busy;
+  if (profile_rand == 0)
+    {
+      /* The first allocation of the thread only starts the count.  */
+      profile_rand = ((uint64_t) random_bits () << 32
+		      | (uint32_t) (uintptr_t) &profile_rand) | 1;
+      sample = false;
+    }
+  /* BYTES is counted again when the caller allocates.  */
+  profile_left = profile_next_sample () + bytes;
+  return sample;
+}
+
+/* Record MEM, an allocation of SIZE bytes, in the table of live samples
+   if SAMPLE.  Return MEM.  */
+static void *
+profile_record (void *mem, size_t size, bool sample)
+{
+  if (!sample || mem == NULL)
+    return mem;
+
+  /* Allocations done by __backtrace are not sampled.  Until the
+     unwinder is loaded, the samples have no stack trace, see
+     __malloc_profile_late_init.  */
+  void *stack[PROFILE_MAX_DEPTH + 2];
+  int depth = 0;
+  if (atomic_load_acquire (&profile_unwinder))
+    {
+      profile_busy = true;
+      depth = __backtrace (stack, PROFILE_MAX_DEPTH + 2);
+      profile_busy = false;
+    }
+
+  __libc_lock_lock (profile_lock);
+  struct profile_sample *s = profile_free_samples;
+  if (s == NULL)
+    {
+      char *p = (char *) MMAP (NULL, PROFILE_POOL_SIZE,
+			       PROT_READ | PROT_WRITE, 0);
+      if (p == MAP_FAILED)
+	{
+	  __libc_lock_unlock (profile_lock);
+	  return mem;
+	}
+      __set_vma_name (p, PROFILE_POOL_SIZE, " glibc: malloc profile");
+      for (size_t i = 0; i < PROFILE_POOL_SIZE / sizeof (*s); i++)
+	{
+	  s = (struct profile_sample *) p + i;
+	  s->next = profile_free_samples;
+	  profile_free_samples = s;
+	}
+    }
+  profile_free_samples = s->next;
+
+  /* Skip the frames of the profiler.  */
+  s->ptr = mem;
+  s->size = size;
+  s->depth = depth > 2 ? depth - 2 : 0;
+  memcpy (s->stack, stack + 2, s->depth * sizeof (void *));
+
+  unsigned int h = profile_hash (mem);
+  s->next = profile_chains[h];
+  profile_chains[h] = s;
+  atomic_store_relaxed (&profile_counts[h], profile_counts[h] + 1);
+  profile_live++;
+  profile_live_bytes += size;
+  __libc_lock_unlock (profile_lock);
+
+  return mem;
+}
+
+/* Remove MEM from the table of live samples, if it was sampled.  */
+static void __attribute_noinline__
+profile_remove (void *mem)
+{
+  unsigned int h = profile_hash (mem);
+
+  __libc_lock_lock (profile_lock);
+  for (struct profile_sample **p = &profile_chains[h]; *p != NULL;
+       p = &(*p)->next)
+    if ((*p)->ptr == mem)
+      {
+	struct profile_sample *s = *p;
+	*p = s->next;
+	atomic_store_relaxed (&profile_counts[h], profile_counts[h] - 1);
+	profile_live--;
+	profile_live_bytes -= s->size;
+	s->next = profile_free_samples;
+	profile_free_samples = s;
+	break;
+      }
+  __libc_lock_unlock (profile_lock);
+}
+
+/* Return true if the allocation of BYTES bytes the caller is about to do
+   has to be sampled.  */
+static __always_inline bool
+profile_tick (size_t bytes)
+{
+  return (__glibc_unlikely (mp_.profile != 0)
+	  && (profile_left -= bytes) < 0);
+}
+
+/* Called for every pointer MEM being freed.  */
+static __always_inline void
+profile_forget (void *mem)
+{
+  if (__glibc_unlikely (profile_counts != NULL)
+      && atomic_load_relaxed (&profile_counts[profile_hash (mem)]) != 0)
+    profile_remove (mem);
+}
+
+static void * __attribute_noinline__
+profile_malloc (size_t bytes)
+{
+  bool sample = profile_start (bytes);
+  return profile_record (__libc_malloc (bytes), bytes, sample);
+}
+
+static void * __attribute_noinline__
+profile_calloc (size_t bytes)
+{
+  bool sample = profile_start (bytes);
+  return profile_record (__libc_calloc (1, bytes), bytes, sample);
+}
+
+static void * __attribute_noinline__
+profile_realloc (void *oldmem, size_t bytes)
+{
+  bool sample = profile_start (bytes);
+  return profile_record (__libc_realloc (oldmem, bytes), bytes, sample);
+}
+
+static void * __attribute_noinline__
+profile_memalign (size_t alignment, size_t bytes)
+{
+  bool sample = profile_start (bytes);
+  return profile_record (_mid_memalign (alignment, bytes), bytes, sample);
+}
+
+/* Write the live samples to FP in the legacy heap profile format of
+   gperftools, followed by the memory map of the process.  Return 0, or
+   EINVAL if the profiler is not enabled.  */
+static int
+profile_dump (FILE *fp)
+{
+  if (profile_counts == NULL)
+    return EINVAL;
+
+  /* Copy the samples, so that FP is not written with profile_lock held,
+     since writing to it may allocate or free memory.  Allocations done
+     while copying are not sampled.  */
+  profile_busy = true;
+  __libc_lock_lock (profile_lock);
+  size_t count = profile_live;
+  size_t size = ALIGN_UP (count * sizeof (struct profile_sample) + 1,
+			  GLRO (dl_pagesize));
+  struct profile_sample *copy
+    = (struct profile_sample *) MMAP (NULL, size, PROT_READ | PROT_WRITE, 0);
+  if (copy == MAP_FAILED)
+    {
+      __libc_lock_unlock (profile_lock);
+      profile_busy = false;
+      return ENOMEM;
+    }
+  size_t n = 0;
+  size_t bytes = 0;
+  for (size_t h = 0; h < ((size_t) 1 << PROFILE_HASH_BITS); h++)
+    for (struct profile_sample *s = profile_chains[h]; s != NULL; s = s->next)
+      {
+	copy[n++] = *s;
+	bytes += s->size;
+      }
+  __libc_lock_unlock (profile_lock);
+  profile_busy = false;
+
+  fprintf (fp, "heap profile: %zu: %zu [%zu: %zu] @ heap_v2/%zu\n",
+	   n, bytes, n, bytes, mp_.profile);
+  for (size_t i = 0; i < n; i++)
+    {
+      fprintf (fp, "1: %zu [1: %zu] @", copy[i].size, copy[i].size);
+      for (int j = 0; j < copy[i].depth; j++)
+	fprintf (fp, " %p", copy[i].stack[j]);
+      fputc ('\n', fp);
+    }
+  __munmap (copy, size);
+
+  /* pprof uses the memory map to symbolize the stack traces.  */
+  fputs ("\nMAPPED_LIBRARIES:\n", fp);
+  int fd = __open_nocancel ("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+  if (fd >= 0)
+    {
+      char buf[1024];
+      ssize_t len;
+      while ((len = __read_nocancel (fd, buf, sizeof (buf))) > 0)
+	fwrite (buf, 1, len, fp);
+      __close_nocancel_nostatus (fd);
+    }
+
+  return 0;
+}
+
+static void * __attribute_noinline__
+__libc_malloc2 (size_t bytes)
+{
+  mstate ar_ptr;
+  void *victim;
+
+#if USE_TCACHE
+  if (__glibc_unlikely (tcache_percpu != NULL))
+    {
+      victim = tcache_percpu_get (checked_request2size (bytes));
+      if (victim != NULL)
+	return victim;
+    }
+#endif
+
+  if (SINGLE_THREAD_P)
+    {
+      victim = _int_malloc (&main_arena, bytes);
+      assert (!victim || chunk_is_mmapped (mem2chunk (victim)) ||
+	      &main_arena == arena_for_chunk (mem2chunk (victim)));
+      return victim;
+    }
+
+  arena_get (ar_ptr, bytes);
+
+  victim = _int_malloc (ar_ptr, bytes);
+  /* Retry with another arena only if we were able to find a usable arena
+     before.  */
+  if (!victim && ar_ptr != NULL)
+    {
+      LIBC_PROBE (memory_malloc_retry, 1, bytes);
+      ar_ptr = arena_get_retry (ar_ptr, bytes);
+      victim = _int_malloc (ar_ptr, bytes);
+    }
+
+  if (ar_ptr != NULL)
+    __libc_lock_unlock (ar_ptr->mutex);
+
+  assert (!victim || chunk_is_mmapped (mem2chunk (victim)) ||
+          ar_ptr == arena_for_chunk (mem2chunk (victim)));
+  return victim;
+}
+
+void *
+__libc_malloc (size_t bytes)
+{
+  if (profile_tick (bytes))
+    return profile_malloc (bytes);
+
+  if (__glibc_unlikely (bytes < mp_.slab_max_bytes))
+    {
+      void *victim = slab_malloc (bytes);
+      if (victim != NULL)
+	return victim;
+    }
+
+#if USE_TCACHE
+  size_t nb = checked_request2size (bytes);
+
+  if (nb < mp_.tcache_max_bytes)
+    {
+      size_t tc_idx = csize2tidx (nb);
+
+      if (__glibc_likely (tc_idx < TCACHE_SMALL_BINS))
+        {
+	  if (tcache->entries[tc_idx] != NULL)
+	    return tcache_get (tc_idx);
+	}
+      else
+        {
+	  tc_idx = large_csize2tidx (nb);
+	  void *victim = tcache_get_large (tc_idx, nb);
+	  if (victim != NULL)
+	    return victim;
+	}
+    }
+#endif
+
+  return __libc_malloc2 (bytes);
+}
+libc_hidden_def (__libc_malloc)
+
+static void __attribute_noinline__
+tcache_free_init (void *mem)
+{
+  tcache_init (NULL);
+  __libc_free (mem);
+}
+
+void
+__libc_free (void *mem)
+{
+  mchunkptr p;                          /* chunk corresponding to mem */
+
+  if (mem == NULL)                              /* free(0) has no effect */
+    return;
+
+  profile_forget (mem);
+
+  if (__glibc_unlikely (slab_ptr (mem)))
+    return slab_free (mem);
+
+  p = mem2chunk (mem);
+
+  INTERNAL_SIZE_T size = chunksize (p);
+
+  if (__glibc_unlikely (misaligned_chunk (p)))
+    return malloc_printerr_tail ("free(): invalid pointer");
+
+#if USE_TCACHE
+  if (__glibc_likely (size < mp_.tcache_max_bytes))
+    {
       /* Check to see if it's already in the tcache.  */
       tcache_entry *e = (tcache_entry *) chunk2mem (p);
 
@@ -3162,6 +4442,8 @@ __libc_free (void *mem)
 	{
           if (__glibc_likely (tcache->num_slots[tc_idx] != 0))
 	    return tcache_put (p, tc_idx);
+	  if (tcache_flush_batch (p, tc_idx))
+	    return;
 	}
       else
 	{
@@ -3173,6 +4455,10 @@ __libc_free (void *mem)
 
       if (__glibc_unlikely (tcache_inactive ()))
 	return tcache_free_init (mem);
+
+      if (__glibc_unlikely (tcache_percpu != NULL)
+	  && tcache_percpu_put (p, size))
+	return;
     }
 #endif
 
@@ -3204,6 +4490,14 @@ __libc_realloc (void *oldmem, size_t bytes)
     }
 #endif
 
+  /* A sampled block is forgotten even if the reallocation fails.  */
+  profile_forget (oldmem);
+  if (profile_tick (bytes))
+    return profile_realloc (oldmem, bytes);
+
+  if (__glibc_unlikely (slab_ptr (oldmem)))
+    return slab_realloc (oldmem, bytes);
+
   /* chunk corresponding to oldmem */
   const mchunkptr oldp = mem2chunk (oldmem);
 
@@ -3332,15 +4626,58 @@ aligned_alloc (size_t alignment, size_t bytes)
   return _mid_memalign (alignment, bytes);
 }
 
+#if USE_TCACHE
+/* Try to put MEM, a block of BYTES bytes, in the tcache bin found from
+   BYTES instead of from the chunk header.  The header is only compared
+   with the expected size, which also rejects mmapped chunks and most
+   blocks whose size does not match.  Return false to leave the block to
+   free, which handles everything else and diagnoses double frees.  If
+   malloc has been replaced, the tcache is never initialized and BYTES
+   never selects a bin.  */
+static __always_inline bool
+tcache_free_sized (void *mem, size_t bytes)
+{
+  size_t nb = checked_request2size (bytes);
+  if (__glibc_unlikely (nb >= mp_.tcache_max_bytes))
+    return false;
+
+  size_t tc_idx = csize2tidx (nb);
+  if (__glibc_unlikely (tc_idx >= TCACHE_SMALL_BINS)
+      || __glibc_unlikely (tcache->num_slots[tc_idx] == 0))
+    return false;
+
+  /* Slab objects have no chunk header, and the profiler has to see the
+     block being freed.  */
+  if (mem == NULL || __glibc_unlikely (slab_ptr (mem))
+      || __glibc_unlikely (profile_counts != NULL))
+    return false;
+
+  mchunkptr p = mem2chunk (mem);
+  if (__glibc_unlikely ((chunksize_nomask (p) & ~(PREV_INUSE | NON_MAIN_ARENA))
+			!= nb)
+      || __glibc_unlikely (misaligned_chunk (p))
+      || __glibc_unlikely (((tcache_entry *) mem)->key == tcache_key))
+    return false;
+
+  tcache_put (p, tc_idx);
+  return true;
+}
+#endif
+
 /* For ISO C23.  */
 void
 weak_function
-free_sized (void *ptr, __attribute_maybe_unused__ size_t size)
+free_sized (void *ptr, size_t size)
 {
   /* We do not perform validation that size is the same as the original
-     requested size at this time. We leave that to the sanitizers.  We
-     simply forward to `free`.  This allows existing malloc replacements
-     to continue to work.  */
+     requested size at this time.  We leave that to the sanitizers.  The
+     size only selects the tcache bin when it matches the chunk, and any
+     other block is forwarded to `free`.  This allows existing malloc
+     replacements to continue to work.  */
+#if USE_TCACHE
+  if (tcache_free_sized (ptr, size))
+    return;
+#endif
 
   free (ptr);
 }
@@ -3349,12 +4686,18 @@ free_sized (void *ptr, __attribute_maybe_unused__ size_t size)
 void
 weak_function
 free_aligned_sized (void *ptr, __attribute_maybe_unused__ size_t alignment,
-                    __attribute_maybe_unused__ size_t size)
+                    size_t size)
 {
   /* We do not perform validation that size and alignment is the same as
      the original requested size and alignment at this time.  We leave that
-     to the sanitizers.  We simply forward to `free`.  This allows existing
-     malloc replacements to continue to work.  */
+     to the sanitizers.  Aligned blocks are usually exactly the requested
+     size, so they take the same path as in free_sized; the others are
+     forwarded to `free`.  This allows existing malloc replacements to
+     continue to work.  */
+#if USE_TCACHE
+  if (tcache_free_sized (ptr, size))
+    return;
+#endif
 
   free (ptr);
 }
@@ -3369,6 +4712,9 @@ _mid_memalign (size_t alignment, size_t bytes)
   if (alignment <= MALLOC_ALIGNMENT)
     return __libc_malloc (bytes);
 
+  if (profile_tick (bytes))
+    return profile_memalign (alignment, bytes);
+
 #if USE_TCACHE
   void *victim = tcache_get_align (checked_request2size (bytes), alignment);
   if (victim != NULL)
@@ -3432,6 +4778,15 @@ __libc_calloc2 (size_t sz)
   INTERNAL_SIZE_T oldtopsize, csz;
   void *mem;
 
+#if USE_TCACHE
+  if (__glibc_unlikely (tcache_percpu != NULL))
+    {
+      mem = tcache_percpu_get (checked_request2size (sz));
+      if (mem != NULL)
+	return clear_memory (mem, memsize (mem2chunk (mem)));
+    }
+#endif
+
   if (SINGLE_THREAD_P)
     av = &main_arena;
   else
@@ -3521,6 +4876,16 @@ __libc_calloc (size_t n, size_t elem_size)
        return NULL;
     }
 
+  if (profile_tick (bytes))
+    return profile_calloc (bytes);
+
+  if (__glibc_unlikely (bytes < mp_.slab_max_bytes))
+    {
+      void *mem = slab_malloc (bytes);
+      if (mem != NULL)
+	return memset (mem, 0, bytes);
+    }
+
 #if USE_TCACHE
   size_t nb = checked_request2size (bytes);
 
@@ -3597,6 +4962,9 @@ _int_malloc (mstate av, size_t bytes)
       return p;
     }
 
+  _int_free_remote_drain (av);
+  malloc_purge_maybe (av);
+
   /*
      If a small request, check regular bin.  Since these "smallbins"
      hold one size each, no searching within bins is necessary.
@@ -3616,6 +4984,7 @@ _int_malloc (mstate av, size_t bytes)
 	  if (__glibc_unlikely (bck->fd != victim))
 	    malloc_printerr ("malloc(): smallbin double linked list corrupted");
           set_inuse_bit_at_offset (victim, nb);
+          purge_cursor_unlink (av, victim);
           bin->bk = bck;
           bck->fd = bin;
 
@@ -3643,6 +5012,7 @@ _int_malloc (mstate av, size_t bytes)
 		      set_inuse_bit_at_offset (tc_victim, nb);
 		      if (av != &main_arena)
 			set_non_main_arena (tc_victim);
+		      purge_cursor_unlink (av, tc_victim);
 		      bin->bk = bck;
 		      bck->fd = bin;
 
@@ -3708,6 +5078,7 @@ _int_malloc (mstate av, size_t bytes)
               /* split and reattach remainder */
               remainder_size = size - nb;
               remainder = chunk_at_offset (victim, nb);
+              purge_cursor_unlink (av, victim);
               unsorted_chunks (av)->bk = unsorted_chunks (av)->fd = remainder;
               av->last_remainder = remainder;
               remainder->bk = remainder->fd = unsorted_chunks (av);
@@ -3729,6 +5100,7 @@ _int_malloc (mstate av, size_t bytes)
             }
 
           /* remove from unsorted list */
+          purge_cursor_unlink (av, victim);
           unsorted_chunks (av)->bk = bck;
           bck->fd = unsorted_chunks (av);
 
@@ -4027,6 +5399,15 @@ _int_malloc (mstate av, size_t bytes)
                     (av != &main_arena ? NON_MAIN_ARENA : 0));
           set_head (remainder, remainder_size | PREV_INUSE);
 
+#if USE_TCACHE
+	  if (mp_.tcache_batch > 1)
+	    {
+	      size_t tc_idx = csize2tidx (nb);
+	      if (tc_idx < mp_.tcache_small_bins)
+		tcache_refill_batch (av, victim, nb, tc_idx);
+	    }
+#endif
+
           check_malloced_chunk (av, victim, nb);
           void *p = chunk2mem (victim);
           alloc_perturb (p, bytes);
@@ -4050,6 +5431,20 @@ _int_malloc (mstate av, size_t bytes)
    ------------------------------ free ------------------------------
  */
 
+/* True if chunks freed to an arena locked by another thread are queued
+   on its remote free list instead of waiting for the lock.  This is only
+   done with glibc.malloc.tcache_batch: the queued chunks are not reused
+   until the arena is locked again.  */
+static __always_inline bool
+remote_free_enabled (void)
+{
+#if USE_TCACHE
+  return mp_.tcache_batch != 0;
+#else
+  return false;
+#endif
+}
+
 /* Free chunk P of SIZE bytes to the arena AV (which is not locked).
    Caller must ensure chunk and size are valid.  */
 static __attribute_maybe_unused__ void
@@ -4062,11 +5457,39 @@ _int_free_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size)
   if (!chunk_is_mmapped(p)) {
 
     if (SINGLE_THREAD_P)
-      _int_free_merge_chunk (av, p, size);
+      {
+	_int_free_merge_chunk (av, p, size);
+	malloc_purge_maybe (av);
+      }
     else
       {
-	__libc_lock_lock (av->mutex);
+	if (!remote_free_enabled ())
+	  __libc_lock_lock (av->mutex);
+	else if (__libc_lock_trylock (av->mutex) != 0)
+	  {
+	    /* Do not wait for the thread which holds the lock, typically
+	       the owner of the arena allocating from it.  Queue the chunk
+	       so that it is freed the next time the arena is locked.  A
+	       queued chunk is marked with the address of its arena in its
+	       bk field.  If P carries the mark, it may already be queued:
+	       wait for the lock and free P after the queued chunks, so
+	       that a double free is detected as without the queue.  User
+	       data which happens to match the mark only costs the wait.  */
+	    if (__glibc_likely (p->bk != (mchunkptr) av))
+	      {
+		p->bk = (mchunkptr) av;
+		mchunkptr old = atomic_load_relaxed (&av->remote_free);
+		do
+		  p->fd = PROTECT_PTR (&p->fd, old);
+		while (!atomic_compare_exchange_weak_release (&av->remote_free,
+							      &old, p));
+		return;
+	      }
+	    __libc_lock_lock (av->mutex);
+	  }
+	_int_free_remote_drain (av);
 	_int_free_merge_chunk (av, p, size);
+	malloc_purge_maybe (av);
 	__libc_lock_unlock (av->mutex);
       }
   }
@@ -4086,6 +5509,11 @@ _int_free_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size)
         && chunksize_nomask (p) <= DEFAULT_MMAP_THRESHOLD_MAX)
       {
         mp_.mmap_threshold = chunksize (p);
+        /* Keep the threshold in huge page units, see ptmalloc_init.  */
+        if (mp_.thp_pagesize != 0)
+          mp_.mmap_threshold = MIN (ALIGN_UP (mp_.mmap_threshold,
+                                              mp_.thp_pagesize),
+                                    DEFAULT_MMAP_THRESHOLD_MAX);
         mp_.trim_threshold = 2 * mp_.mmap_threshold;
         LIBC_PROBE (memory_mallopt_free_dyn_thresholds, 2,
 		    mp_.mmap_threshold, mp_.trim_threshold);
@@ -4097,6 +5525,25 @@ _int_free_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size)
   }
 }
 
+/* Free the chunks queued on the remote free list of the locked arena AV
+   by threads which could not acquire its lock.  */
+static void
+_int_free_remote_drain (mstate av)
+{
+  if (atomic_load_relaxed (&av->remote_free) == NULL)
+    return;
+
+  mchunkptr p = atomic_exchange_acquire (&av->remote_free, NULL);
+  while (p != NULL)
+    {
+      if (__glibc_unlikely (misaligned_chunk (p)))
+	malloc_printerr ("free(): unaligned chunk detected in remote list");
+      mchunkptr next = REVEAL_PTR (p->fd);
+      _int_free_merge_chunk (av, p, chunksize (p));
+      p = next;
+    }
+}
+
 /* Try to merge chunk P of SIZE bytes from locked arena AV with its neighbors.
    Put the resulting chunk on the appropriate bin list.  P must not be on a
    bin list yet, and it can be in use.  */
@@ -4140,6 +5587,7 @@ _int_free_merge_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size)
 
   /* Write the chunk header, maybe after merging with the following chunk.  */
   size = _int_free_create_chunk (av, p, size, nextchunk, nextsize);
+  av->purge_freed += size;
   _int_free_maybe_trim (av, size);
 }
 
@@ -4203,6 +5651,7 @@ _int_free_create_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size,
 
       set_head(p, size | PREV_INUSE);
       set_foot(p, size);
+      purge_mark_clear (p, size);
 
       check_free_chunk(av, p);
     }
@@ -4213,6 +5662,7 @@ _int_free_create_chunk (mstate av, mchunkptr p, INTERNAL_SIZE_T size,
       size += nextsize;
       set_head(p, size | PREV_INUSE);
       av->top = p;
+      av->purge_top = NULL;
       check_chunk(av, p);
     }
 
@@ -4444,6 +5894,137 @@ _int_memalign (mstate av, size_t alignment, size_t bytes)
 }
 
 
+/*
+   ------------------------------ purge ------------------------------
+ */
+
+/* Return the unused pages of the free chunk P to the system, with the
+   advice selected by glibc.malloc.purge_lazy.  If MARK, skip the chunk
+   if it is marked as purged already, and mark it otherwise.  Return the
+   number of bytes purged.  */
+static size_t
+purge_chunk (mchunkptr p, INTERNAL_SIZE_T size, bool mark)
+{
+  const size_t psm1 = GLRO (dl_pagesize) - 1;
+
+  /* Keep the chunk header, the free list pointers and the mark.  */
+  if (size <= psm1 + PURGE_KEEP_SIZE)
+    return 0;
+  if (mark && *purge_mark_ptr (p) == purge_mark_value (p, size))
+    return 0;
+  char *paligned_mem = (char *) (((uintptr_t) p + PURGE_KEEP_SIZE + psm1)
+				 & ~psm1);
+  size_t len = ((char *) p + size - paligned_mem) & ~psm1;
+  if (!thp_clip_range (&paligned_mem, &len))
+    return 0;
+
+#ifdef MADV_FREE
+  if (mp_.purge_lazy && __madvise (paligned_mem, len, MADV_FREE) != 0)
+    /* The kernel does not support MADV_FREE.  */
+    mp_.purge_lazy = 0;
+  if (!mp_.purge_lazy)
+#endif
+    __madvise (paligned_mem, len, MADV_DONTNEED);
+
+  if (mark)
+    *purge_mark_ptr (p) = purge_mark_value (p, size);
+  return len;
+}
+
+/* Purge the free chunks of the locked arena AV, continuing where the
+   previous step stopped, until mp_.purge_step bytes have been purged or
+   PURGE_STEP_CHUNKS chunks have been visited.  A pass goes over the bins
+   which may hold chunks larger than a page and finishes with the part of
+   the top chunk beyond mp_.top_pad.  */
+static void
+malloc_purge_step (mstate av)
+{
+  const unsigned int psindex = bin_index (GLRO (dl_pagesize));
+  size_t budget = mp_.purge_step;
+  size_t purged = 0;
+  unsigned int visited = 0;
+
+  if (av->purge_bin == 0)
+    {
+      av->purge_bin = 1;
+      av->purge_next = NULL;
+    }
+
+  while (purged < budget && visited < PURGE_STEP_CHUNKS)
+    {
+      unsigned int i = av->purge_bin;
+      if (i == NBINS)
+	{
+	  /* Finish the pass with the top chunk.  */
+	  mchunkptr top = av->top;
+	  INTERNAL_SIZE_T size = chunksize (top);
+	  if (size > mp_.top_pad && top != av->purge_top)
+	    {
+	      purge_chunk (chunk_at_offset (top, mp_.top_pad),
+			   size - mp_.top_pad, false);
+	      av->purge_top = top;
+	    }
+	  av->purge_bin = 0;
+	  av->purge_freed = 0;
+	  return;
+	}
+
+      mbinptr bin = bin_at (av, i);
+      mchunkptr p = av->purge_next != NULL ? av->purge_next : last (bin);
+      while (p != bin && purged < budget && visited < PURGE_STEP_CHUNKS)
+	{
+	  purged += purge_chunk (p, chunksize (p), true);
+	  visited++;
+	  p = p->bk;
+	}
+
+      if (p != bin)
+	{
+	  /* Continue with this bin in the next step.  */
+	  av->purge_next = p;
+	  break;
+	}
+
+      av->purge_bin = i == 1 && psindex > 2 ? psindex : i + 1;
+      av->purge_next = NULL;
+    }
+
+  av->purge_freed -= MIN (av->purge_freed, purged);
+}
+
+/* Do a purge step on the locked arena AV if glibc.malloc.purge_interval
+   has elapsed since the last one, or if glibc.malloc.purge_threshold
+   bytes have been freed since then.  Nothing is done if nothing has been
+   freed since the last pass over the arena completed.  */
+static void
+malloc_purge_maybe (mstate av)
+{
+  if (__glibc_likely ((mp_.purge_interval | mp_.purge_threshold) == 0)
+      || av->purge_freed == 0)
+    return;
+
+  if (mp_.purge_threshold == 0 || av->purge_freed < mp_.purge_threshold)
+    {
+      if (mp_.purge_interval == 0
+	  || ++av->purge_calls % PURGE_CLOCK_CALLS != 0)
+	return;
+
+      struct __timespec64 ts;
+      __clock_gettime64 (CLOCK_MONOTONIC, &ts);
+      uint64_t now = ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+      if (now - av->purge_time < mp_.purge_interval)
+	return;
+      av->purge_time = now;
+    }
+
+  /* Preserve errno.  */
+  int err = errno;
+  LIBC_PROBE (memory_purge_step, 3, av, av->purge_bin, av->purge_freed);
+  malloc_purge_step (av);
+  __set_errno (err);
+}
+
+
 /*
    ------------------------------ malloc_trim ------------------------------
  */
@@ -4455,6 +6036,14 @@ mtrim (mstate av, size_t pad)
   int psindex = bin_index (ps);
   const size_t psm1 = ps - 1;
 
+  _int_free_remote_drain (av);
+
+  /* All the free chunks are purged, so a new incremental pass is only
+     needed after more memory has been freed.  */
+  av->purge_freed = 0;
+  av->purge_bin = 0;
+  av->purge_next = NULL;
+
   int result = 0;
   for (int i = 1; i < NBINS; ++i)
     if (i == 1 || i >= psindex)
@@ -4479,14 +6068,15 @@ mtrim (mstate av, size_t pad)
                 /* This is the size we could potentially free.  */
                 size -= paligned_mem - (char *) p;
 
-                if (size > psm1)
+                size_t len = size & ~psm1;
+                if (thp_clip_range (&paligned_mem, &len))
                   {
 #if MALLOC_DEBUG
                     /* When debugging we simulate destroying the memory
                        content.  */
-                    memset (paligned_mem, 0x89, size & ~psm1);
+                    memset (paligned_mem, 0x89, len);
 #endif
-                    __madvise (paligned_mem, size & ~psm1, MADV_DONTNEED);
+                    __madvise (paligned_mem, len, MADV_DONTNEED);
 
                     result = 1;
                   }
@@ -4508,6 +6098,14 @@ __malloc_trim (size_t s)
 {
   int result = 0;
 
+#if USE_TCACHE
+  /* Chunks in the per-CPU caches are not owned by any thread, so give
+     them back to the arenas before trimming.  */
+  tcache_percpu_flush ();
+#endif
+
+  result |= slab_trim ();
+
   mstate ar_ptr = &main_arena;
   do
     {
@@ -4530,6 +6128,9 @@ __malloc_trim (size_t s)
 static size_t
 musable (void *mem)
 {
+  if (slab_ptr (mem))
+    return slab_usable (mem);
+
   mchunkptr p = mem2chunk (mem);
 
   if (chunk_is_mmapped (p))
@@ -4563,6 +6164,7 @@ int_mallinfo (mstate av, struct mallinfo2 *m)
   INTERNAL_SIZE_T avail;
   int nblocks;
 
+  _int_free_remote_drain (av);
   check_malloc_state (av);
 
   /* Account for top */
@@ -4612,6 +6214,8 @@ __libc_mallinfo2 (void)
     }
   while (ar_ptr != &main_arena);
 
+  slab_mallinfo (&m);
+
   return m;
 }
 libc_hidden_def (__libc_mallinfo2)
@@ -4672,6 +6276,18 @@ __malloc_stats (void)
       if (ar_ptr == &main_arena)
         break;
     }
+  if (slab_base != NULL)
+    {
+      struct mallinfo2 mi;
+
+      memset (&mi, 0, sizeof (mi));
+      slab_mallinfo (&mi);
+      fprintf (stderr, "Slabs:\n");
+      fprintf (stderr, "system bytes     = %10u\n", (unsigned int) mi.arena);
+      fprintf (stderr, "in use bytes     = %10u\n", (unsigned int) mi.uordblks);
+      system_b += mi.arena;
+      in_use_b += mi.uordblks;
+    }
   fprintf (stderr, "Total (incl. mmap):\n");
   fprintf (stderr, "system bytes     = %10u\n", system_b);
   fprintf (stderr, "in use bytes     = %10u\n", in_use_b);
@@ -4794,8 +6410,84 @@ do_set_tcache_count (size_t value)
   return 0;
 }
 
+static __always_inline int
+do_set_tcache_percpu (int32_t value)
+{
+  LIBC_PROBE (memory_tunable_tcache_percpu, 2, value, mp_.tcache_percpu);
+  mp_.tcache_percpu = value != 0;
+  return 1;
+}
+
+static __always_inline int
+do_set_tcache_batch (size_t value)
+{
+  if (value <= MAX_TCACHE_COUNT)
+    {
+      LIBC_PROBE (memory_tunable_tcache_batch, 2, value, mp_.tcache_batch);
+      mp_.tcache_batch = value;
+      return 1;
+    }
+  return 0;
+}
+
 #endif
 
+static __always_inline int
+do_set_purge_interval (size_t value)
+{
+  LIBC_PROBE (memory_tunable_purge_interval, 2, value, mp_.purge_interval);
+  mp_.purge_interval = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_purge_threshold (size_t value)
+{
+  LIBC_PROBE (memory_tunable_purge_threshold, 2, value, mp_.purge_threshold);
+  mp_.purge_threshold = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_purge_step (size_t value)
+{
+  LIBC_PROBE (memory_tunable_purge_step, 2, value, mp_.purge_step);
+  mp_.purge_step = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_purge_lazy (int32_t value)
+{
+  LIBC_PROBE (memory_tunable_purge_lazy, 2, value, mp_.purge_lazy);
+  mp_.purge_lazy = value != 0;
+  return 1;
+}
+
+static __always_inline int
+do_set_profile (size_t value)
+{
+  LIBC_PROBE (memory_tunable_profile, 2, value, mp_.profile);
+  mp_.profile = value;
+  return 1;
+}
+
+static __always_inline int
+do_set_numa (int32_t value)
+{
+  LIBC_PROBE (memory_tunable_numa, 2, value, mp_.numa);
+  mp_.numa = value != 0;
+  return 1;
+}
+
+static __always_inline int
+do_set_slab (size_t value)
+{
+  LIBC_PROBE (memory_tunable_slab, 2, value, mp_.slab_max);
+  mp_.slab_max = value;
+  return 1;
+}
+
 static __always_inline int
 do_set_mxfast (size_t value)
 {
@@ -5132,9 +6824,54 @@ __posix_memalign (void **memptr, size_t alignment, size_t size)
 #endif /* IS_IN (libc) */
 
 
+/* Return the amount of memory backed by transparent huge pages between
+   START and END, from the N mappings in RANGES.  The huge pages of a
+   mapping which is only partly in the range, such as one which spans
+   several heaps, are counted in proportion to the part in the range.  */
+static size_t
+thp_range_size (const struct thp_range *ranges, size_t n,
+		uintptr_t start, uintptr_t end)
+{
+  const size_t ps = GLRO (dl_pagesize);
+  size_t size = 0;
+  for (size_t i = 0; i < n; i++)
+    {
+      uintptr_t lo = MAX (start, ranges[i].start);
+      uintptr_t hi = MIN (end, ranges[i].end);
+      if (lo >= hi)
+	continue;
+      if (hi - lo == ranges[i].end - ranges[i].start)
+	size += ranges[i].size;
+      else
+	{
+	  /* Scale the page counts, reducing the precision of the part in
+	     the range if the product does not fit.  */
+	  uint64_t pages = ranges[i].size / ps;
+	  uint64_t part = (hi - lo) / ps;
+	  uint64_t total = (ranges[i].end - ranges[i].start) / ps;
+	  uint64_t product;
+	  while (__builtin_mul_overflow (pages, part, &product))
+	    {
+	      part >>= 1;
+	      total >>= 1;
+	    }
+	  if (total != 0)
+	    size += product / total * ps;
+	}
+    }
+  return size;
+}
+
 int
 __malloc_info (int options, FILE *fp)
 {
+  if (options == MALLOC_INFO_PROFILE)
+#if IS_IN (libc)
+    return profile_dump (fp);
+#else
+    return EINVAL;
+#endif
+
   /* For now, at least.  */
   if (options != 0)
     return EINVAL;
@@ -5146,6 +6883,39 @@ __malloc_info (int options, FILE *fp)
   size_t total_max_system = 0;
   size_t total_aspace = 0;
   size_t total_aspace_mprotect = 0;
+  size_t total_thp = 0;
+
+  /* If transparent huge pages are in use, find the mappings backed by them
+     before locking the arenas, since this reads /proc.  */
+  struct thp_range thp_buf[64];
+  struct thp_range *thp_ranges = thp_buf;
+  size_t thp_alloc = 0;
+  ssize_t thp_count = 0;
+  if (mp_.thp_pagesize != 0)
+    {
+      thp_count = __get_thp_ranges (thp_buf, array_length (thp_buf));
+      if (thp_count > (ssize_t) array_length (thp_buf))
+	{
+	  /* Leave room for mappings created in the meantime.  */
+	  thp_alloc = ALIGN_UP ((thp_count + array_length (thp_buf))
+				* sizeof (struct thp_range),
+				GLRO (dl_pagesize));
+	  void *p = MMAP (NULL, thp_alloc, PROT_READ | PROT_WRITE, 0);
+	  if (p != MAP_FAILED)
+	    {
+	      thp_ranges = p;
+	      thp_count = __get_thp_ranges (thp_ranges,
+					    thp_alloc / sizeof (*thp_ranges));
+	      thp_count = MIN (thp_count,
+			       (ssize_t) (thp_alloc / sizeof (*thp_ranges)));
+	    }
+	  else
+	    {
+	      thp_alloc = 0;
+	      thp_count = array_length (thp_buf);
+	    }
+	}
+    }
 
   fputs ("<malloc version=\"1\">\n", fp);
 
@@ -5208,6 +6978,7 @@ __malloc_info (int options, FILE *fp)
       size_t heap_size = 0;
       size_t heap_mprotect_size = 0;
       size_t heap_count = 0;
+      size_t heap_thp = 0;
       if (ar_ptr != &main_arena)
 	{
 	  /* Iterate over the arena heaps from back to front.  */
@@ -5216,11 +6987,20 @@ __malloc_info (int options, FILE *fp)
 	    {
 	      heap_size += heap->size;
 	      heap_mprotect_size += heap->mprotect_size;
+	      if (thp_count > 0)
+		heap_thp += thp_range_size (thp_ranges, thp_count,
+					    (uintptr_t) heap,
+					    (uintptr_t) heap + heap->size);
 	      heap = heap->prev;
 	      ++heap_count;
 	    }
 	  while (heap != NULL);
 	}
+      else if (thp_count > 0 && contiguous (ar_ptr) && mp_.sbrk_base != NULL)
+	heap_thp = thp_range_size (thp_ranges, thp_count,
+				   (uintptr_t) mp_.sbrk_base,
+				   (uintptr_t) mp_.sbrk_base
+				   + ar_ptr->system_mem);
 
       __libc_lock_unlock (ar_ptr->mutex);
 
@@ -5269,23 +7049,53 @@ __malloc_info (int options, FILE *fp)
 	  total_aspace_mprotect += ar_ptr->system_mem;
 	}
 
+      if (mp_.thp_pagesize != 0)
+	{
+	  fprintf (fp, "<aspace type=\"thp\" size=\"%zu\"/>\n", heap_thp);
+	  total_thp += heap_thp;
+	}
+
       fputs ("</heap>\n", fp);
       ar_ptr = ar_ptr->next;
     }
   while (ar_ptr != &main_arena);
 
+  if (slab_base != NULL)
+    {
+      struct mallinfo2 mi;
+
+      memset (&mi, 0, sizeof (mi));
+      slab_mallinfo (&mi);
+      /* Slab pages are never returned to the system, only their memory
+	 is released, so the current size is also the maximum.  */
+      fprintf (fp,
+	       "<slabs>\n"
+	       "<total type=\"inuse\" size=\"%zu\"/>\n"
+	       "<total type=\"rest\" size=\"%zu\"/>\n"
+	       "<system type=\"current\" size=\"%zu\"/>\n"
+	       "</slabs>\n",
+	       mi.uordblks, mi.fordblks, mi.arena);
+      total_system += mi.arena;
+      total_max_system += mi.arena;
+    }
+
   fprintf (fp,
 	   "<total type=\"rest\" count=\"%zu\" size=\"%zu\"/>\n"
 	   "<total type=\"mmap\" count=\"%d\" size=\"%zu\"/>\n"
 	   "<system type=\"current\" size=\"%zu\"/>\n"
 	   "<system type=\"max\" size=\"%zu\"/>\n"
 	   "<aspace type=\"total\" size=\"%zu\"/>\n"
-	   "<aspace type=\"mprotect\" size=\"%zu\"/>\n"
-	   "</malloc>\n",
+	   "<aspace type=\"mprotect\" size=\"%zu\"/>\n",
 	   total_nblocks, total_avail,
 	   mp_.n_mmaps, mp_.mmapped_mem,
 	   total_system, total_max_system,
 	   total_aspace, total_aspace_mprotect);
+  if (mp_.thp_pagesize != 0)
+    fprintf (fp, "<aspace type=\"thp\" size=\"%zu\"/>\n", total_thp);
+  fputs ("</malloc>\n", fp);
+
+  if (thp_alloc != 0)
+    __munmap (thp_ranges, thp_alloc);
 
   return 0;
 }
@@ -154,6 +154,9 @@ extern size_t malloc_usable_size (void *__ptr) __THROW;
 /* Prints brief summary statistics on stderr. */
 extern void malloc_stats (void) __THROW;
 
+/* malloc_info options.  */
+#define MALLOC_INFO_PROFILE 1	/* Write the heap profile instead.  */
+
 /* Output information about state of allocator to stream FP.  */
 extern int malloc_info (int __options, FILE *__fp) __THROW;
 
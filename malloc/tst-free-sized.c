@@ -18,6 +18,19 @@
 
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <support/check.h>
+#include <support/support.h>
+
+static void
+check_block (const unsigned char *p, unsigned char value, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    if (p[i] != value)
+      FAIL_EXIT1 ("block %p of size %zu corrupted at offset %zu",
+		  p, size, i);
+}
 
 static int
 do_test (void)
@@ -31,6 +44,32 @@ do_test (void)
   void *p = malloc (128);
   free_sized (p, 128);
 
+  /* Free blocks of the sizes handled by the tcache and some larger ones,
+     while other blocks of the same size are in use.  */
+  for (size_t size = 0; size <= 2048; size += 7)
+    {
+      unsigned char *a = xmalloc (size);
+      unsigned char *b = xmalloc (size);
+      unsigned char *c = xcalloc (1, size);
+      memset (a, 0x11, size);
+      memset (b, 0x22, size);
+      free_sized (a, size);
+
+      unsigned char *d = xmalloc (size);
+      memset (d, 0x33, size);
+      check_block (b, 0x22, size);
+      check_block (c, 0, size);
+      free_sized (b, size);
+      free_sized (c, size);
+      check_block (d, 0x33, size);
+      free_sized (d, size);
+    }
+
+  /* A block shrunk by realloc may keep a larger chunk than its size.  */
+  p = xmalloc (1000);
+  p = xrealloc (p, 990);
+  free_sized (p, 990);
+
   return 0;
 }
 
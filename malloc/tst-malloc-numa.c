@@ -0,0 +1,109 @@
+/* Test NUMA-aware arena placement (glibc.malloc.numa=1).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The threads move themselves over all the CPUs they may run on while
+   allocating, so that on a NUMA system they change nodes and have to
+   switch arenas, and free blocks allocated on other nodes.  On a system
+   with a single node the test still exercises the arena selection.  */
+
+#include <malloc.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+enum { threads = 16 };
+enum { iterations = 4000 };
+enum { slots = 64 };
+
+static cpu_set_t allowed;
+
+static void
+migrate (unsigned int i)
+{
+  int count = CPU_COUNT (&allowed);
+  int target = i % count;
+  for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    if (CPU_ISSET (cpu, &allowed) && target-- == 0)
+      {
+	cpu_set_t set;
+	CPU_ZERO (&set);
+	CPU_SET (cpu, &set);
+	/* The CPU may have gone offline; the test does not depend on
+	   actually running there.  */
+	sched_setaffinity (0, sizeof (set), &set);
+	return;
+      }
+}
+
+static void *
+worker (void *closure)
+{
+  unsigned int self = (uintptr_t) closure;
+  unsigned char *local[slots] = { NULL };
+  size_t sizes[slots] = { 0 };
+
+  for (unsigned int i = 0; i < iterations; i++)
+    {
+      if (i % 100 == 0)
+	migrate (self + i / 100);
+
+      unsigned int slot = (i * 13 + self) % slots;
+      if (local[slot] != NULL)
+	{
+	  for (size_t j = 0; j < sizes[slot]; j++)
+	    if (local[slot][j] != (slot & 0xff))
+	      FAIL_EXIT1 ("block %p corrupted at offset %zu", local[slot], j);
+	  free (local[slot]);
+	}
+      sizes[slot] = 1 + (i * 37 + self * 11) % 20000;
+      local[slot] = xmalloc (sizes[slot]);
+      TEST_VERIFY (malloc_usable_size (local[slot]) >= sizes[slot]);
+      memset (local[slot], slot & 0xff, sizes[slot]);
+    }
+
+  for (unsigned int i = 0; i < slots; i++)
+    free (local[i]);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  if (sched_getaffinity (0, sizeof (allowed), &allowed) != 0)
+    FAIL_UNSUPPORTED ("sched_getaffinity failed: %m");
+
+  pthread_t thr[threads];
+  for (unsigned int i = 0; i < threads; i++)
+    thr[i] = xpthread_create (NULL, worker, (void *) (uintptr_t) i);
+  for (unsigned int i = 0; i < threads; i++)
+    xpthread_join (thr[i]);
+
+  malloc_trim (0);
+  struct mallinfo2 mi = mallinfo2 ();
+  TEST_VERIFY (mi.uordblks <= mi.arena + mi.hblkhd);
+  free (xmalloc (100));
+
+  return 0;
+}
+
+#include <support/test-driver.c>
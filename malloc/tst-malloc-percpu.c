@@ -0,0 +1,153 @@
+/* Test malloc with per-CPU caches (glibc.malloc.percpu=1).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The test runs many more threads than there are CPUs, so that several
+   threads share each per-CPU cache, and passes blocks between threads so
+   that chunks cached on one CPU are freed on another.  The contents of
+   every block are checked before it is freed to catch a chunk handed out
+   twice.  */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+enum { threads = 64 };
+enum { iterations = 2000 };
+enum { slots = 32 };
+
+/* Blocks handed over from thread I to thread (I + 1) % THREADS.  */
+static void *mailbox[threads][slots];
+static pthread_mutex_t mailbox_lock[threads];
+
+static void
+fill (unsigned char *p, size_t size, unsigned int tag)
+{
+  memset (p, tag & 0xff, size);
+}
+
+static void
+check (const unsigned char *p, size_t size, unsigned int tag)
+{
+  for (size_t i = 0; i < size; i++)
+    if (p[i] != (tag & 0xff))
+      FAIL_EXIT1 ("block %p corrupted at offset %zu", p, i);
+}
+
+struct block_header
+{
+  size_t size;
+  unsigned int tag;
+};
+
+static void *
+allocate (size_t size, unsigned int tag)
+{
+  struct block_header *h = xmalloc (sizeof (*h) + size);
+  TEST_VERIFY (malloc_usable_size (h) >= sizeof (*h) + size);
+  h->size = size;
+  h->tag = tag;
+  fill ((unsigned char *) (h + 1), size, tag);
+  return h;
+}
+
+static void
+release (void *p)
+{
+  struct block_header *h = p;
+  check ((unsigned char *) (h + 1), h->size, h->tag);
+  free (h);
+}
+
+static void *
+worker (void *closure)
+{
+  unsigned int self = (uintptr_t) closure;
+  unsigned int next = (self + 1) % threads;
+  void *local[slots] = { NULL };
+
+  for (unsigned int i = 0; i < iterations; i++)
+    {
+      unsigned int slot = (i * 7 + self) % slots;
+      size_t size = 1 + (i * 13 + self * 31) % 1000;
+
+      /* Replace a block owned by this thread.  */
+      if (local[slot] != NULL)
+	release (local[slot]);
+      local[slot] = allocate (size, self * iterations + i);
+
+      /* Exchange a block with the next thread, so that it is freed by a
+	 thread that did not allocate it.  */
+      xpthread_mutex_lock (&mailbox_lock[next]);
+      void *remote = mailbox[next][slot];
+      mailbox[next][slot] = allocate (size / 2, i);
+      xpthread_mutex_unlock (&mailbox_lock[next]);
+      if (remote != NULL)
+	release (remote);
+
+      xpthread_mutex_lock (&mailbox_lock[self]);
+      void *mine = mailbox[self][slot];
+      mailbox[self][slot] = NULL;
+      xpthread_mutex_unlock (&mailbox_lock[self]);
+      if (mine != NULL)
+	release (mine);
+
+      if (i % 500 == 0)
+	malloc_trim (0);
+    }
+
+  for (unsigned int i = 0; i < slots; i++)
+    if (local[i] != NULL)
+      release (local[i]);
+
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_t thr[threads];
+
+  for (unsigned int i = 0; i < threads; i++)
+    xpthread_mutex_init (&mailbox_lock[i], NULL);
+
+  for (unsigned int i = 0; i < threads; i++)
+    thr[i] = xpthread_create (NULL, worker, (void *) (uintptr_t) i);
+  for (unsigned int i = 0; i < threads; i++)
+    xpthread_join (thr[i]);
+
+  for (unsigned int i = 0; i < threads; i++)
+    for (unsigned int j = 0; j < slots; j++)
+      if (mailbox[i][j] != NULL)
+	release (mailbox[i][j]);
+
+  /* Cached chunks must be returned to the arenas by malloc_trim, and the
+     allocator must still be usable afterwards.  */
+  malloc_trim (0);
+  struct mallinfo2 mi = mallinfo2 ();
+  TEST_VERIFY (mi.uordblks <= mi.arena);
+  release (allocate (100, 1));
+
+  return 0;
+}
+
+#include <support/test-driver.c>
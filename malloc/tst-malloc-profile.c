@@ -0,0 +1,113 @@
+/* Test the sampling heap profiler (glibc.malloc.profile=4096).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xmemstream.h>
+#include <support/xthread.h>
+
+enum { blocks = 4096 };
+enum { block_size = 1024 };
+enum { sample_rate = 4096 };
+
+static void *block[blocks];
+
+/* Return the number of live samples and their total size reported in the
+   heap profile, after checking its format.  */
+static size_t
+read_profile (size_t *bytes)
+{
+  struct xmemstream stream;
+  xopen_memstream (&stream);
+  TEST_COMPARE (malloc_info (MALLOC_INFO_PROFILE, stream.out), 0);
+  xfclose_memstream (&stream);
+
+  size_t count, count2, bytes2, rate;
+  TEST_COMPARE (sscanf (stream.buffer,
+			"heap profile: %zu: %zu [%zu: %zu] @ heap_v2/%zu\n",
+			&count, bytes, &count2, &bytes2, &rate), 5);
+  TEST_COMPARE (count, count2);
+  TEST_COMPARE (*bytes, bytes2);
+  TEST_COMPARE (rate, sample_rate);
+
+  /* Each sample has a stack trace, and the samples add up to the
+     total.  */
+  size_t lines = 0;
+  size_t total = 0;
+  char *line = strchr (stream.buffer, '\n') + 1;
+  while (strncmp (line, "1: ", 3) == 0)
+    {
+      size_t size;
+      TEST_COMPARE (sscanf (line, "1: %zu [1: %zu] @ 0x", &size, &size), 2);
+      TEST_VERIFY (strstr (line, " @ 0x") != NULL);
+      total += size;
+      lines++;
+      line = strchr (line, '\n') + 1;
+    }
+  TEST_COMPARE (lines, count);
+  TEST_COMPARE (total, *bytes);
+  TEST_VERIFY (strncmp (line, "\nMAPPED_LIBRARIES:\n", 19) == 0);
+
+  free (stream.buffer);
+  return count;
+}
+
+static void *
+allocate_half (void *closure)
+{
+  uintptr_t start = (uintptr_t) closure;
+  for (size_t i = start; i < blocks; i += 2)
+    block[i] = xmalloc (block_size);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  size_t bytes;
+  size_t before = read_profile (&bytes);
+
+  /* Allocate 4 MiB from two threads, of which about 1024 blocks should
+     be sampled.  */
+  pthread_t thr = xpthread_create (NULL, allocate_half, (void *) 1);
+  allocate_half ((void *) 0);
+  xpthread_join (thr);
+
+  size_t during = read_profile (&bytes);
+  TEST_VERIFY (during > before + 256);
+  TEST_VERIFY (bytes >= (during - before) * block_size);
+
+  /* Samples of realloc'ed and freed blocks are removed.  */
+  for (size_t i = 0; i < blocks; i++)
+    block[i] = xrealloc (block[i], block_size / 2);
+  for (size_t i = 0; i < blocks; i++)
+    free (block[i]);
+
+  size_t after = read_profile (&bytes);
+  TEST_VERIFY (after < before + 16);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
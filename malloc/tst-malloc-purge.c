@@ -0,0 +1,125 @@
+/* Test incremental purging of free chunks (glibc.malloc.purge_threshold).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The test runs with a small purge threshold and step, so that the
+   unused pages of free chunks are purged in many steps while blocks
+   next to them are still in use.  The blocks in use must keep their
+   contents, and the purged chunks must be usable again, including by
+   calloc which must still return zeroed memory.  */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+enum { blocks = 4096 };
+enum { bursts = 8 };
+
+static unsigned char *block[blocks];
+
+static size_t
+block_size (size_t i)
+{
+  return 1 + (i * 7919) % 40000;
+}
+
+static void
+check_block (size_t i, unsigned char value)
+{
+  for (size_t j = 0; j < block_size (i); j++)
+    if (block[i][j] != value)
+      FAIL_EXIT1 ("block %zu corrupted at offset %zu", i, j);
+}
+
+static void *
+burst (void *closure)
+{
+  unsigned int self = (uintptr_t) closure;
+
+  for (unsigned int n = 0; n < bursts; n++)
+    {
+      /* Free most blocks, keeping every eighth one, so that the free
+	 chunks are surrounded by blocks in use.  */
+      for (size_t i = self; i < blocks; i += 2)
+	if (i % 8 != 0 || n == 0)
+	  {
+	    if (block[i] != NULL && n > 0)
+	      check_block (i, (i + n - 1) & 0xff);
+	    free (block[i]);
+	    block[i] = NULL;
+	  }
+
+      for (size_t i = self; i < blocks; i += 2)
+	if (block[i] == NULL)
+	  {
+	    if (i % 3 == 0)
+	      {
+		block[i] = xcalloc (1, block_size (i));
+		check_block (i, 0);
+	      }
+	    else
+	      block[i] = xmalloc (block_size (i));
+	    memset (block[i], (i + n) & 0xff, block_size (i));
+	  }
+	else
+	  {
+	    check_block (i, (i + n - 1) & 0xff);
+	    memset (block[i], (i + n) & 0xff, block_size (i));
+	  }
+    }
+
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  /* Run the bursts on the main arena first, then on two threads which
+     use other arenas.  */
+  burst ((void *) (uintptr_t) 0);
+  burst ((void *) (uintptr_t) 1);
+  for (size_t i = 0; i < blocks; i++)
+    {
+      free (block[i]);
+      block[i] = NULL;
+    }
+
+  pthread_t thr[2];
+  for (unsigned int i = 0; i < 2; i++)
+    thr[i] = xpthread_create (NULL, burst, (void *) (uintptr_t) i);
+  for (unsigned int i = 0; i < 2; i++)
+    xpthread_join (thr[i]);
+
+  for (size_t i = 0; i < blocks; i++)
+    {
+      check_block (i, (i + bursts - 1) & 0xff);
+      free (block[i]);
+    }
+
+  struct mallinfo2 mi = mallinfo2 ();
+  TEST_VERIFY (mi.uordblks <= mi.arena + mi.hblkhd);
+  free (xmalloc (100));
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,169 @@
+/* Test the slab allocator for small objects (glibc.malloc.slab=64).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <malloc.h>
+#include <signal.h>
+#include <stdalign.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xmemstream.h>
+#include <support/xthread.h>
+
+enum { max_slab_size = 64 };
+enum { objects = 10000 };
+enum { threads = 8 };
+
+static void *blocks[objects];
+
+static void
+check_block (void *p, size_t size)
+{
+  TEST_VERIFY ((uintptr_t) p % alignof (max_align_t) == 0);
+  TEST_VERIFY (malloc_usable_size (p) >= size);
+}
+
+static void *
+worker (void *closure)
+{
+  unsigned int self = (uintptr_t) closure;
+  void *local[256] = { NULL };
+
+  for (unsigned int i = 0; i < 20000; i++)
+    {
+      unsigned int slot = (i * 31 + self) % 256;
+      size_t size = (i + self) % (max_slab_size + 1);
+      free (local[slot]);
+      local[slot] = xmalloc (size);
+      memset (local[slot], self, size);
+      check_block (local[slot], size);
+    }
+
+  for (unsigned int i = 0; i < 256; i++)
+    free (local[i]);
+  return NULL;
+}
+
+/* Free an object which is not at the head of the free list of its slab
+   a second time.  */
+static void
+double_free (void *closure)
+{
+  void *volatile a = xmalloc (32);
+  void *volatile b = xmalloc (32);
+  free (a);
+  free (b);
+  free (a);
+}
+
+static int
+do_test (void)
+{
+  struct mallinfo2 before = mallinfo2 ();
+
+  /* Fill many slabs of every size class.  */
+  for (size_t i = 0; i < objects; i++)
+    {
+      size_t size = i % (max_slab_size + 1);
+      blocks[i] = xmalloc (size);
+      check_block (blocks[i], size);
+      memset (blocks[i], i & 0xff, size);
+    }
+
+  struct mallinfo2 during = mallinfo2 ();
+  TEST_VERIFY (during.uordblks > before.uordblks);
+  TEST_VERIFY (during.uordblks <= during.arena);
+
+  /* The slabs are not used with MALLOC_CHECK_, in which case
+     malloc_info does not report them.  */
+  struct xmemstream info;
+  xopen_memstream (&info);
+  TEST_COMPARE (malloc_info (0, info.out), 0);
+  xfclose_memstream (&info);
+  bool slabs = strstr (info.buffer, "<slabs>\n") != NULL;
+  if (slabs)
+    TEST_VERIFY (strstr (info.buffer, "<slabs>\n"
+				      "<total type=\"inuse\"") != NULL);
+  free (info.buffer);
+
+  /* Check the contents, then free every other block and reuse the holes
+     with calloc, which must return zeroed memory.  */
+  for (size_t i = 0; i < objects; i++)
+    {
+      size_t size = i % (max_slab_size + 1);
+      for (size_t j = 0; j < size; j++)
+	TEST_COMPARE (((unsigned char *) blocks[i])[j], i & 0xff);
+    }
+  for (size_t i = 0; i < objects; i += 2)
+    free (blocks[i]);
+  for (size_t i = 0; i < objects; i += 2)
+    {
+      size_t size = i % (max_slab_size + 1);
+      blocks[i] = xcalloc (1, size);
+      check_block (blocks[i], size);
+      for (size_t j = 0; j < size; j++)
+	TEST_COMPARE (((unsigned char *) blocks[i])[j], 0);
+    }
+
+  /* Growing a slab object beyond the slab sizes preserves its
+     contents.  */
+  unsigned char *p = xmalloc (32);
+  memset (p, 0xa5, 32);
+  p = xrealloc (p, 16);
+  TEST_VERIFY (malloc_usable_size (p) >= 16);
+  p = xrealloc (p, 4096);
+  for (size_t j = 0; j < 16; j++)
+    TEST_COMPARE (p[j], 0xa5);
+  check_block (p, 4096);
+  free (p);
+
+  for (size_t i = 0; i < objects; i++)
+    free (blocks[i]);
+
+  pthread_t thr[threads];
+  for (unsigned int i = 0; i < threads; i++)
+    thr[i] = xpthread_create (NULL, worker, (void *) (uintptr_t) i);
+  for (unsigned int i = 0; i < threads; i++)
+    xpthread_join (thr[i]);
+
+  /* All objects have been freed, so the empty slabs can be released.  */
+  malloc_trim (0);
+  struct mallinfo2 after = mallinfo2 ();
+  TEST_VERIFY (after.uordblks < during.uordblks);
+
+  if (slabs)
+    {
+      struct support_capture_subprocess result
+	= support_capture_subprocess (double_free, NULL);
+      support_capture_subprocess_check (&result, "double free", -SIGABRT,
+					sc_allow_stderr);
+      TEST_VERIFY (strstr (result.err.buffer,
+			   "free(): double free detected in slab") != NULL);
+      support_capture_subprocess_free (&result);
+    }
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,133 @@
+/* Test batched tcache transfers and the arena remote free list.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Pairs of threads form a pipeline: the producer allocates blocks and
+   passes them through a ring buffer to the consumer, which checks and
+   frees them.  The consumer frees into the producer's arena while the
+   producer is allocating from it.  With glibc.malloc.tcache_batch set,
+   these frees go through the remote free list, and the tcache bins of
+   both threads are refilled and flushed in batches.  */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+enum { pairs = 8 };
+enum { iterations = 20000 };
+enum { ring_size = 64 };
+
+struct ring
+{
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  unsigned int head;
+  unsigned int tail;
+  unsigned char *blocks[ring_size];
+};
+
+static struct ring rings[pairs];
+
+static size_t
+block_size (unsigned int i)
+{
+  /* Mostly small sizes, which use the tcache, with an occasional larger
+     one.  */
+  return i % 64 == 0 ? 2000 + i % 3000 : 1 + (i * 17) % 500;
+}
+
+static void *
+producer (void *closure)
+{
+  struct ring *r = closure;
+
+  for (unsigned int i = 0; i < iterations; i++)
+    {
+      size_t size = block_size (i);
+      unsigned char *p = xmalloc (size);
+      memset (p, i & 0xff, size);
+
+      xpthread_mutex_lock (&r->lock);
+      while (r->head - r->tail == ring_size)
+	xpthread_cond_wait (&r->cond, &r->lock);
+      r->blocks[r->head++ % ring_size] = p;
+      xpthread_cond_signal (&r->cond);
+      xpthread_mutex_unlock (&r->lock);
+    }
+
+  return NULL;
+}
+
+static void *
+consumer (void *closure)
+{
+  struct ring *r = closure;
+
+  for (unsigned int i = 0; i < iterations; i++)
+    {
+      xpthread_mutex_lock (&r->lock);
+      while (r->head == r->tail)
+	xpthread_cond_wait (&r->cond, &r->lock);
+      unsigned char *p = r->blocks[r->tail++ % ring_size];
+      xpthread_cond_signal (&r->cond);
+      xpthread_mutex_unlock (&r->lock);
+
+      size_t size = block_size (i);
+      TEST_VERIFY (malloc_usable_size (p) >= size);
+      for (size_t j = 0; j < size; j++)
+	if (p[j] != (i & 0xff))
+	  FAIL_EXIT1 ("block %u corrupted at offset %zu", i, j);
+      free (p);
+    }
+
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_t thr[2 * pairs];
+
+  for (unsigned int i = 0; i < pairs; i++)
+    {
+      xpthread_mutex_init (&rings[i].lock, NULL);
+      TEST_COMPARE (pthread_cond_init (&rings[i].cond, NULL), 0);
+    }
+
+  for (unsigned int i = 0; i < pairs; i++)
+    {
+      thr[2 * i] = xpthread_create (NULL, producer, &rings[i]);
+      thr[2 * i + 1] = xpthread_create (NULL, consumer, &rings[i]);
+    }
+  for (unsigned int i = 0; i < 2 * pairs; i++)
+    xpthread_join (thr[i]);
+
+  /* mallinfo2 and malloc_trim free the queued chunks first.  */
+  struct mallinfo2 mi = mallinfo2 ();
+  TEST_VERIFY (mi.uordblks <= mi.arena);
+  malloc_trim (0);
+  free (xmalloc (100));
+
+  return 0;
+}
+
+#include <support/test-driver.c>
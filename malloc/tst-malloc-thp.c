@@ -0,0 +1,143 @@
+/* Test the transparent huge page aware heap layout (glibc.malloc.hugetlb=1).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xmemstream.h>
+#include <support/xthread.h>
+
+enum { blocks = 1024 };
+enum { block_size = 16 * 1024 };
+
+static unsigned char *block[blocks];
+
+/* Return the huge page coverage of the process from malloc_info, after
+   checking that the coverage of each heap is part of the total.  */
+static size_t
+read_thp (void)
+{
+  struct xmemstream stream;
+  xopen_memstream (&stream);
+  TEST_COMPARE (malloc_info (0, stream.out), 0);
+  xfclose_memstream (&stream);
+
+  static const char tag[] = "<aspace type=\"thp\" size=\"";
+  size_t sum = 0, total = 0;
+  int heaps = 0, found = 0;
+  for (char *p = strstr (stream.buffer, "<heap nr="); p != NULL;
+       p = strstr (p + 1, "<heap nr="))
+    heaps++;
+  for (char *p = strstr (stream.buffer, tag); p != NULL;
+       p = strstr (p + 1, tag))
+    {
+      total = strtoul (p + sizeof (tag) - 1, NULL, 10);
+      sum += total;
+      found++;
+    }
+  free (stream.buffer);
+
+  if (found == 0)
+    FAIL_UNSUPPORTED ("transparent huge pages are not supported");
+
+  /* One entry for each heap, and the last one for the total.  */
+  TEST_COMPARE (found, heaps + 1);
+  TEST_COMPARE (sum - total, total);
+  return total;
+}
+
+static size_t
+thp_size (void)
+{
+  FILE *f = fopen ("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size", "r");
+  size_t size = 0;
+  if (f == NULL || fscanf (f, "%zu", &size) != 1)
+    FAIL_UNSUPPORTED ("cannot read the transparent huge page size");
+  fclose (f);
+  /* malloc does not use larger huge pages for its heaps.  */
+  if (size > 32 * 1024 * 1024)
+    FAIL_UNSUPPORTED ("transparent huge page size %zu is too large", size);
+  return size;
+}
+
+static void *
+allocate (void *closure)
+{
+  uintptr_t start = (uintptr_t) closure;
+  for (size_t i = start; i < blocks; i += 2)
+    {
+      block[i] = xmalloc (block_size);
+      memset (block[i], i & 0xff, block_size);
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  read_thp ();
+  size_t hpsize = thp_size ();
+
+  /* Requests smaller than a huge page are served from the heaps.  */
+  struct mallinfo2 before = mallinfo2 ();
+  void *p = xmalloc (hpsize / 2);
+  struct mallinfo2 after = mallinfo2 ();
+  TEST_COMPARE (after.hblkhd, before.hblkhd);
+  free (p);
+
+  /* Larger requests are mapped at a huge page boundary.  */
+  unsigned char *large = xmalloc (2 * hpsize);
+  TEST_VERIFY ((uintptr_t) large % hpsize <= 4 * sizeof (size_t));
+  memset (large, 0xa5, 2 * hpsize);
+
+  pthread_t thr = xpthread_create (NULL, allocate, (void *) 1);
+  allocate ((void *) 0);
+  xpthread_join (thr);
+  read_thp ();
+
+  /* Trimming discards only whole huge pages, and keeps the blocks in use
+     next to them intact.  */
+  for (size_t i = 0; i < blocks; i++)
+    if (i % 4 != 0)
+      {
+	free (block[i]);
+	block[i] = NULL;
+      }
+  malloc_trim (0);
+  for (size_t i = 0; i < blocks; i += 4)
+    for (size_t j = 0; j < block_size; j++)
+      if (block[i][j] != (i & 0xff))
+	FAIL_EXIT1 ("block %zu corrupted at offset %zu", i, j);
+  for (size_t j = 0; j < 2 * hpsize; j++)
+    if (large[j] != 0xa5)
+      FAIL_EXIT1 ("large block corrupted at offset %zu", j);
+  read_thp ();
+
+  free (large);
+  for (size_t i = 0; i < blocks; i++)
+    free (block[i]);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -54,65 +54,18 @@
 # define MAP_STACK 0
 #endif
 
-/* Get a stack frame from the cache.  We have to match by size since
-   some blocks might be too small or far too large.  */
+/* Prepare the stack RESULT, just taken from the cache or from a pool,
+   for a new thread.  Must be called with the cache lock held, which is
+   released.  */
 static struct pthread *
-get_cached_stack (size_t *sizep, void **memp)
+reuse_stack (struct pthread *result, size_t *sizep, void **memp)
 {
-  size_t size = *sizep;
-  struct pthread *result = NULL;
-  list_t *entry;
-
-  lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
-
-  /* Search the cache for a matching entry.  We search for the
-     smallest stack which has at least the required size.  Note that
-     in normal situations the size of all allocated stacks is the
-     same.  As the very least there are only a few different sizes.
-     Therefore this loop will exit early most of the time with an
-     exact match.  */
-  list_for_each (entry, &GL (dl_stack_cache))
-    {
-      struct pthread *curr;
-
-      curr = list_entry (entry, struct pthread, list);
-      if (__nptl_stack_in_use (curr) && curr->stackblock_size >= size)
-	{
-	  if (curr->stackblock_size == size)
-	    {
-	      result = curr;
-	      break;
-	    }
-
-	  if (result == NULL
-	      || result->stackblock_size > curr->stackblock_size)
-	    result = curr;
-	}
-    }
-
-  if (__builtin_expect (result == NULL, 0)
-      /* Make sure the size difference is not too excessive.  In that
-	 case we do not use the block.  */
-      || __builtin_expect (result->stackblock_size > 4 * size, 0))
-    {
-      /* Release the lock.  */
-      lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
-
-      return NULL;
-    }
-
   /* Don't allow setxid until cloned.  */
   result->setxid_futex = -1;
 
-  /* Dequeue the entry.  */
-  __nptl_stack_list_del (&result->list);
-
   /* And add to the list of stacks in use.  */
   __nptl_stack_list_add (&result->list, &GL (dl_stack_used));
 
-  /* And decrease the cache size.  */
-  GL (dl_stack_cache_actsize) -= result->stackblock_size;
-
   /* Release the lock early.  */
   lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
 
@@ -135,6 +88,7 @@ get_cached_stack (size_t *sizep, void **memp)
   result->exiting = false;
   __libc_lock_init (result->exit_lock);
   memset (&result->tls_state, 0, sizeof result->tls_state);
+  result->rwlock_readers = NULL;
 
   result->getrandom_buf = NULL;
 
@@ -150,6 +104,38 @@ get_cached_stack (size_t *sizep, void **memp)
   return result;
 }
 
+/* Get a stack frame from the cache.  We have to match by size since
+   some blocks might be too small or far too large.  */
+static struct pthread *
+get_cached_stack (size_t *sizep, void **memp)
+{
+  size_t size = *sizep;
+  struct pthread *result;
+
+  /* Threads are often created while no stack of a suitable size is
+     cached, for instance when the number of threads grows, so check
+     first without taking the lock.  */
+  if (!__nptl_stack_cache_has (size))
+    return NULL;
+
+  lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+
+  /* Search the cache for the smallest stack which has at least the
+     required size.  The cache is organized by size classes, and in
+     normal situations the size of all allocated stacks is the same, so
+     this usually finds an exact match among the first entries.  */
+  result = __nptl_stack_cache_take (size);
+  if (result == NULL)
+    {
+      /* Release the lock.  */
+      lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+
+      return NULL;
+    }
+
+  return reuse_stack (result, sizep, memp);
+}
+
 /* Assume support for MADV_ADVISE_GUARD, setup_stack_prot will disable it
    and fallback to ALLOCATE_GUARD_PROT_NONE if the madvise call fails.  */
 static int allocate_stack_mode = ALLOCATE_GUARD_MADV_GUARD;
@@ -349,6 +335,194 @@ advise_stack_range (void *mem, size_t size, uintptr_t pd, size_t guardsize)
 #endif
 }
 
+/* Allocate a new stack of SIZE bytes, including a guard area of
+   GUARDSIZE bytes, with the thread descriptor and the DTV, and store the
+   start of the memory block in *MEMP.  Return the thread descriptor, or
+   NULL with errno set on failure.  */
+static struct pthread *
+allocate_new_stack (size_t size, size_t guardsize, size_t pagesize_m1,
+		    void **memp)
+{
+  size_t tls_static_align_m1 = GLRO (dl_tls_static_align) - 1;
+  struct pthread *pd;
+  void *mem;
+
+  mem = allocate_thread_stack (size, guardsize);
+  if (__glibc_unlikely (mem == MAP_FAILED))
+    return NULL;
+
+  /* Do madvise in case the tunable glibc.pthread.stack_hugetlb is
+     set to 0, disabling hugetlb.  */
+  if (__glibc_unlikely (__nptl_stack_hugetlb == 0)
+      && __madvise (mem, size, MADV_NOHUGEPAGE) != 0)
+    {
+      __munmap (mem, size);
+      return NULL;
+    }
+
+  /* SIZE is guaranteed to be greater than zero.
+     So we can never get a null pointer back from mmap.  */
+  assert (mem != NULL);
+
+  /* Place the thread descriptor at the end of the stack.  */
+#if TLS_TCB_AT_TP
+  pd = (struct pthread *) ((((uintptr_t) mem + size)
+			    - TLS_TCB_SIZE)
+			   & ~tls_static_align_m1);
+#elif TLS_DTV_AT_TP
+  pd = (struct pthread *) ((((uintptr_t) mem + size
+			    - __nptl_tls_static_size_for_stack ())
+			    & ~tls_static_align_m1)
+			   - TLS_PRE_TCB_SIZE);
+#endif
+
+  /* Now mprotect the required region excluding the guard area.  */
+  if (!setup_stack_prot (mem, size, pd, guardsize, pagesize_m1))
+    {
+      __munmap (mem, size);
+      return NULL;
+    }
+
+  /* Remember the stack-related values.  */
+  pd->stackblock = mem;
+  pd->stackblock_size = size;
+  /* Update guardsize for newly allocated guardsize to avoid
+     an mprotect in guard resize below.  */
+  pd->guardsize = guardsize;
+
+  /* We allocated the first block thread-specific data array.
+     This address will not change for the lifetime of this
+     descriptor.  */
+  pd->specific[0] = pd->specific_1stblock;
+
+  /* This is at least the second thread.  */
+  pd->header.multiple_threads = 1;
+
+#ifdef NEED_DL_SYSINFO
+  SETUP_THREAD_SYSINFO (pd);
+#endif
+
+  /* Don't allow setxid until cloned.  */
+  pd->setxid_futex = -1;
+
+  if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
+    GLRO (dl_debug_printf) ("tls: TCB allocated (new stack): 0x%lx\n",
+			    (unsigned long int) pd);
+
+  /* Allocate the DTV for this thread.  */
+  if (_dl_allocate_tls (TLS_TPADJ (pd)) == NULL)
+    {
+      /* Something went wrong.  */
+      assert (errno == ENOMEM);
+
+      /* Free the stack memory we just allocated.  */
+      (void) __munmap (mem, size);
+
+      return NULL;
+    }
+
+  /* Note that all of the stack and the thread descriptor is
+     zeroed.  This means we do not have to initialize fields
+     with initial value zero.  This is specifically true for
+     the 'tid' field which is always set back to zero once the
+     stack is not used anymore and for the 'guardsize' field
+     which will be read next.  */
+
+  *memp = mem;
+  return pd;
+}
+
+/* Number of bytes at the top of the stacks of the pool which are
+   faulted in when they are allocated, so that the threads which use
+   them first do not take page faults for their first frames.  */
+#define STACK_POOL_PREFAULT (64 * 1024)
+
+/* Allocate N stacks of SIZE bytes, including a guard area of GUARDSIZE
+   bytes, for the pool of stacks of these sizes, which counts them
+   already.  The new stacks are fully set up, with the top of the stack
+   faulted in, and put in the pool, from where get_pooled_stack takes
+   them without any system call.  Failures are ignored, since the new
+   thread can still allocate its stack.  */
+static void
+fill_stack_pool (size_t n, size_t size, size_t guardsize,
+		 size_t pagesize_m1)
+{
+  for (; n > 0; n--)
+    {
+      void *mem;
+      struct pthread *pd = allocate_new_stack (size, guardsize, pagesize_m1,
+					       &mem);
+      if (pd == NULL)
+	break;
+      pd->stack_pooled = true;
+
+#ifdef MADV_POPULATE_WRITE
+      /* The thread descriptor and the static TLS block were written
+	 already.  Errors are ignored, the pages are faulted in later.  */
+      char *stack_start;
+      size_t stack_len = size - guardsize;
+# if _STACK_GROWS_DOWN
+      if (stack_len > STACK_POOL_PREFAULT)
+	stack_len = STACK_POOL_PREFAULT;
+      stack_start = (char *) mem + size - stack_len;
+# else
+      stack_start = mem;
+      stack_len = (guard_position (mem, size, guardsize, pd, pagesize_m1)
+		   - stack_start);
+      if (stack_len > STACK_POOL_PREFAULT)
+	stack_len = STACK_POOL_PREFAULT;
+# endif
+      __madvise (stack_start, stack_len, MADV_POPULATE_WRITE);
+#endif
+
+      /* The stack is not used, as if its thread had exited.  */
+      pd->joinstate = THREAD_STATE_EXITED;
+
+      lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+      __nptl_stack_pool_add (pd);
+      lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+    }
+
+  if (n > 0)
+    {
+      lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+      __nptl_stack_pool_release (n, size, guardsize);
+      lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+    }
+}
+
+/* Get a stack frame from the pool of stacks of SIZE bytes, including a
+   guard area of GUARDSIZE bytes, after growing the pool to at least
+   COUNT stacks.  Return NULL if all the stacks of the pool are used, or
+   if there is no room for another pool.  */
+static struct pthread *
+get_pooled_stack (size_t count, size_t size, size_t guardsize,
+		  size_t pagesize_m1, void **memp)
+{
+  struct pthread *result = NULL;
+
+  lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+
+  size_t n = __nptl_stack_pool_resize (count, size, guardsize);
+  if (n == 0)
+    result = __nptl_stack_pool_take (size, guardsize);
+  else
+    {
+      lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+      fill_stack_pool (n, size, guardsize, pagesize_m1);
+      lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+      result = __nptl_stack_pool_take (size, guardsize);
+    }
+
+  if (result == NULL)
+    {
+      lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
+      return NULL;
+    }
+
+  return reuse_stack (result, &size, memp);
+}
+
 /* Returns a usable stack for a new thread either by allocating a
    new stack or reusing a cached stack of sufficient size.
    ATTR must be non-NULL and point to a valid pthread_attr.
@@ -501,82 +675,22 @@ allocate_stack (const struct pthread_attr *attr, struct pthread **pdp,
 	/* The stack is too small (or the guard too large).  */
 	return EINVAL;
 
-      /* Try to get a stack from the cache.  */
-      pd = get_cached_stack (&size, &mem);
+      /* Try to get a stack from the pool if the attribute asks for one,
+	 or else from the cache.  The stacks of the pools are only used
+	 by threads created with a stack pool attribute.  */
+      pd = NULL;
+      if (__glibc_unlikely (attr->extension != NULL
+			    && attr->extension->stackpool != 0))
+	pd = get_pooled_stack (attr->extension->stackpool, size, guardsize,
+			       pagesize_m1, &mem);
+      if (pd == NULL)
+	pd = get_cached_stack (&size, &mem);
       if (pd == NULL)
 	{
-	  mem = allocate_thread_stack (size, guardsize);
-	  if (__glibc_unlikely (mem == MAP_FAILED))
-	    return errno;
-
-	  /* Do madvise in case the tunable glibc.pthread.stack_hugetlb is
-	     set to 0, disabling hugetlb.  */
-	  if (__glibc_unlikely (__nptl_stack_hugetlb == 0)
-	      && __madvise (mem, size, MADV_NOHUGEPAGE) != 0)
+	  pd = allocate_new_stack (size, guardsize, pagesize_m1, &mem);
+	  if (pd == NULL)
 	    return errno;
 
-	  /* SIZE is guaranteed to be greater than zero.
-	     So we can never get a null pointer back from mmap.  */
-	  assert (mem != NULL);
-
-	  /* Place the thread descriptor at the end of the stack.  */
-#if TLS_TCB_AT_TP
-	  pd = (struct pthread *) ((((uintptr_t) mem + size)
-				    - TLS_TCB_SIZE)
-				   & ~tls_static_align_m1);
-#elif TLS_DTV_AT_TP
-	  pd = (struct pthread *) ((((uintptr_t) mem + size
-				    - tls_static_size_for_stack)
-				    & ~tls_static_align_m1)
-				   - TLS_PRE_TCB_SIZE);
-#endif
-
-	  /* Now mprotect the required region excluding the guard area.  */
-	  if (!setup_stack_prot (mem, size, pd, guardsize, pagesize_m1))
-	    {
-	      __munmap (mem, size);
-	      return errno;
-	    }
-
-	  /* Remember the stack-related values.  */
-	  pd->stackblock = mem;
-	  pd->stackblock_size = size;
-	  /* Update guardsize for newly allocated guardsize to avoid
-	     an mprotect in guard resize below.  */
-	  pd->guardsize = guardsize;
-
-	  /* We allocated the first block thread-specific data array.
-	     This address will not change for the lifetime of this
-	     descriptor.  */
-	  pd->specific[0] = pd->specific_1stblock;
-
-	  /* This is at least the second thread.  */
-	  pd->header.multiple_threads = 1;
-
-#ifdef NEED_DL_SYSINFO
-	  SETUP_THREAD_SYSINFO (pd);
-#endif
-
-	  /* Don't allow setxid until cloned.  */
-	  pd->setxid_futex = -1;
-
-	  if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
-	    GLRO (dl_debug_printf) ("tls: TCB allocated (new stack): 0x%lx\n",
-				    (unsigned long int) pd);
-
-	  /* Allocate the DTV for this thread.  */
-	  if (_dl_allocate_tls (TLS_TPADJ (pd)) == NULL)
-	    {
-	      /* Something went wrong.  */
-	      assert (errno == ENOMEM);
-
-	      /* Free the stack memory we just allocated.  */
-	      (void) __munmap (mem, size);
-
-	      return errno;
-	    }
-
-
 	  /* Prepare to modify global data.  */
 	  lll_lock (GL (dl_stack_cache_lock), LLL_PRIVATE);
 
@@ -584,13 +698,6 @@ allocate_stack (const struct pthread_attr *attr, struct pthread **pdp,
 	  __nptl_stack_list_add (&pd->list, &GL (dl_stack_used));
 
 	  lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
-
-	  /* Note that all of the stack and the thread descriptor is
-	     zeroed.  This means we do not have to initialize fields
-	     with initial value zero.  This is specifically true for
-	     the 'tid' field which is always set back to zero once the
-	     stack is not used anymore and for the 'guardsize' field
-	     which will be read next.  */
 	}
 
       /* Create or resize the guard area if necessary on an already
@@ -602,6 +709,10 @@ allocate_stack (const struct pthread_attr *attr, struct pthread **pdp,
 	  /* Remove the thread from the list.  */
 	  __nptl_stack_list_del (&pd->list);
 
+	  /* And from its pool.  */
+	  if (pd->stack_pooled)
+	    __nptl_stack_pool_release (1, pd->stackblock_size, pd->guardsize);
+
 	  lll_unlock (GL (dl_stack_cache_lock), LLL_PRIVATE);
 
 	  /* Get rid of the TLS block we allocated.  */
@@ -343,6 +343,9 @@ struct pthread
   /* True if the user provided the stack.  */
   enum allocate_stack_mode_t stack_mode;
 
+  /* True if the stack belongs to a stack pool.  */
+  bool stack_pooled;
+
   /* True if thread must stop at startup time.  */
   bool stopped_start;
 
@@ -388,9 +391,19 @@ struct pthread
   /* This is what the user specified and what we will report.  */
   size_t reported_guardsize;
 
+  /* This descriptor's link on the list of cached stacks of its size
+     class, while it is on the GL (dl_stack_cache) list.  */
+  list_t cache_class_list;
+
   /* Thread Priority Protection data.  */
   struct priority_protection_data *tpp;
 
+  /* The reader slots in which this thread records the rwlocks of kind
+     PTHREAD_RWLOCK_READER_BIASED_NP that it has read-locked without
+     updating the lock itself, or NULL if it has not used such a lock yet
+     (see pthread_rwlock_readers.c).  */
+  struct pthread_rwlock_readers *rwlock_readers;
+
   /* Resolver state.  */
   struct __res_state res;
 
@@ -41,7 +41,8 @@ MUTEX_TYPES = {
     PTHREAD_MUTEX_NORMAL: ('Type', 'Normal'),
     PTHREAD_MUTEX_RECURSIVE: ('Type', 'Recursive'),
     PTHREAD_MUTEX_ERRORCHECK: ('Type', 'Error check'),
-    PTHREAD_MUTEX_ADAPTIVE_NP: ('Type', 'Adaptive')
+    PTHREAD_MUTEX_ADAPTIVE_NP: ('Type', 'Adaptive'),
+    PTHREAD_MUTEX_QUEUED_NP: ('Type', 'Queued')
 }
 
 class MutexPrinter(object):
@@ -93,7 +94,14 @@ class MutexPrinter(object):
     def read_type(self):
         """Read the mutex's type."""
 
-        mutex_type = self.kind & PTHREAD_MUTEX_KIND_MASK
+        # The queued type is a whole kind value rather than a flag, so it
+        # must be compared against the kind without the pshared bit, as
+        # PTHREAD_MUTEX_TYPE does.
+        if (self.kind & (PTHREAD_MUTEX_PSHARED_BIT - 1)
+            == PTHREAD_MUTEX_QUEUED_NP):
+            mutex_type = PTHREAD_MUTEX_QUEUED_NP
+        else:
+            mutex_type = self.kind & PTHREAD_MUTEX_KIND_MASK
 
         # mutex_type must be casted to int because it's a gdb.Value
         self.values.append(MUTEX_TYPES[int(mutex_type)])
@@ -492,6 +500,8 @@ class RWLockPrinter(object):
             self.values.append(('Prefers', 'Readers'))
         elif self.flags == PTHREAD_RWLOCK_PREFER_WRITER_NP:
             self.values.append(('Prefers', 'Writers'))
+        elif self.flags == PTHREAD_RWLOCK_READER_BIASED_NP:
+            self.values.append(('Prefers', 'Writers, biased to readers'))
         else:
             self.values.append(('Prefers', 'Writers no recursive readers'))
 
@@ -558,6 +568,8 @@ class RWLockAttributesPrinter(object):
             self.values.append(('Prefers', 'Readers'))
         elif rwlock_type == PTHREAD_RWLOCK_PREFER_WRITER_NP:
             self.values.append(('Prefers', 'Writers'))
+        elif rwlock_type == PTHREAD_RWLOCK_READER_BIASED_NP:
+            self.values.append(('Prefers', 'Writers, biased to readers'))
         else:
             self.values.append(('Prefers', 'Writers no recursive readers'))
 
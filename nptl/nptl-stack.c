@@ -19,10 +19,207 @@
 #include <nptl-stack.h>
 #include <ldsodefs.h>
 #include <pthreadP.h>
+#include <limits.h>
+#include <stdbit.h>
 
 size_t __nptl_stack_cache_maxsize = 40 * 1024 * 1024;
 int32_t __nptl_stack_hugetlb = 1;
 
+/* Besides GL (dl_stack_cache), which is ordered by the time the stacks
+   were cached, the cached stacks are kept on one list per size class, so
+   that a stack of a given size is found without walking the whole cache.
+   The stacks of class C have C + 1 significant bits in their size.  The
+   lists are protected by the cache lock, but their lengths are also read
+   without it to avoid taking the lock when no stack can match.  A list is
+   only valid while its length is not zero.  */
+#define STACK_CACHE_CLASSES (sizeof (size_t) * CHAR_BIT)
+static list_t stack_cache_class[STACK_CACHE_CLASSES];
+static unsigned int stack_cache_class_len[STACK_CACHE_CLASSES];
+
+static inline size_t
+stack_cache_class_of (size_t size)
+{
+  return stdc_bit_width (size) - 1;
+}
+
+/* Add STACK to the list of its size class.  */
+static void
+stack_cache_class_add (struct pthread *stack)
+{
+  size_t c = stack_cache_class_of (stack->stackblock_size);
+  unsigned int len = stack_cache_class_len[c];
+  if (len == 0)
+    INIT_LIST_HEAD (&stack_cache_class[c]);
+  /* Add at the beginning, so that the stacks freed most recently, which
+     are the most likely to be still in the CPU caches, are reused
+     first.  */
+  list_add (&stack->cache_class_list, &stack_cache_class[c]);
+  atomic_store_relaxed (&stack_cache_class_len[c], len + 1);
+}
+
+/* Remove STACK from the list of its size class.  */
+static void
+stack_cache_class_del (struct pthread *stack)
+{
+  size_t c = stack_cache_class_of (stack->stackblock_size);
+  list_del (&stack->cache_class_list);
+  atomic_store_relaxed (&stack_cache_class_len[c],
+			stack_cache_class_len[c] - 1);
+}
+
+/* A cached stack is not used for requests of less than a quarter of its
+   size, so only the class of SIZE and the two classes above it may have
+   a suitable stack.  */
+
+bool
+__nptl_stack_cache_has (size_t size)
+{
+  size_t c = stack_cache_class_of (size);
+  for (size_t i = c; i < c + 3 && i < STACK_CACHE_CLASSES; i++)
+    if (atomic_load_relaxed (&stack_cache_class_len[i]) != 0)
+      return true;
+  return false;
+}
+
+struct pthread *
+__nptl_stack_cache_take (size_t size)
+{
+  struct pthread *result = NULL;
+  size_t c = stack_cache_class_of (size);
+
+  /* The stacks of a class are all smaller than those of the next class,
+     so the search stops at the first class with a suitable stack.  */
+  for (size_t i = c; i < c + 3 && i < STACK_CACHE_CLASSES; i++)
+    {
+      if (stack_cache_class_len[i] == 0)
+	continue;
+
+      list_t *entry;
+      list_for_each (entry, &stack_cache_class[i])
+	{
+	  struct pthread *curr;
+
+	  curr = list_entry (entry, struct pthread, cache_class_list);
+	  if (__nptl_stack_in_use (curr) && curr->stackblock_size >= size
+	      && curr->stackblock_size <= 4 * size)
+	    {
+	      if (curr->stackblock_size == size)
+		{
+		  result = curr;
+		  break;
+		}
+
+	      if (result == NULL
+		  || result->stackblock_size > curr->stackblock_size)
+		result = curr;
+	    }
+	}
+
+      if (result != NULL)
+	break;
+    }
+
+  if (result == NULL)
+    return NULL;
+
+  stack_cache_class_del (result);
+  __nptl_stack_list_del (&result->list);
+  GL (dl_stack_cache_actsize) -= result->stackblock_size;
+  return result;
+}
+
+/* The stack pools (see pthread_attr_setstackpool_np), one per stack
+   size and guard size.  The unused stacks of a pool are on
+   GL (dl_stack_cache) like the other cached stacks, so that fork and
+   __libc_freeres handle them, but they are on the FREE list of their
+   pool instead of a size class list, so that they are only reused by
+   threads created with a stack pool attribute for the same sizes.  They
+   are not accounted in GL (dl_stack_cache_actsize) and are never freed
+   to make room for other stacks.  COUNT is the number of stacks of the
+   pool, used or not, including those which are being allocated, and
+   TARGET is the largest number of stacks requested for the pool, or zero
+   if the entry is not used.  Pools only grow, so that threads created
+   with attributes asking for different counts do not free and allocate
+   the stacks again and again.  Entries are never reused for other sizes,
+   so there are at most STACK_POOLS pools.  Everything is protected by
+   the cache lock.  */
+struct stack_pool
+{
+  size_t size;
+  size_t guardsize;
+  size_t count;
+  size_t target;
+  list_t free;
+};
+
+#define STACK_POOLS 8
+static struct stack_pool stack_pools[STACK_POOLS];
+
+/* Return the pool of stacks of SIZE bytes with a guard area of
+   GUARDSIZE bytes, or NULL if there is none.  If CREATE, create it if
+   there is an unused entry.  */
+static struct stack_pool *
+stack_pool_find (size_t size, size_t guardsize, bool create)
+{
+  for (size_t i = 0; i < STACK_POOLS; i++)
+    {
+      struct stack_pool *pool = &stack_pools[i];
+      if (pool->target == 0)
+	{
+	  if (!create)
+	    break;
+	  pool->size = size;
+	  pool->guardsize = guardsize;
+	  pool->count = 0;
+	  INIT_LIST_HEAD (&pool->free);
+	  return pool;
+	}
+      if (pool->size == size && pool->guardsize == guardsize)
+	return pool;
+    }
+  return NULL;
+}
+
+/* Return the pool of the pooled stack STACK.  */
+static inline struct stack_pool *
+stack_pool_of (struct pthread *stack)
+{
+  return stack_pool_find (stack->stackblock_size, stack->guardsize, false);
+}
+
+void
+__nptl_stack_cache_reclaim (void)
+{
+  for (size_t i = 0; i < STACK_CACHE_CLASSES; i++)
+    stack_cache_class_len[i] = 0;
+
+  /* Stacks being allocated by other threads are lost, so count the
+     stacks of the pools again.  */
+  for (size_t i = 0; i < STACK_POOLS && stack_pools[i].target != 0; i++)
+    {
+      stack_pools[i].count = 0;
+      INIT_LIST_HEAD (&stack_pools[i].free);
+    }
+
+  list_t *entry;
+  list_for_each (entry, &GL (dl_stack_cache))
+    {
+      struct pthread *curr = list_entry (entry, struct pthread, list);
+      if (curr->stack_pooled)
+	{
+	  struct stack_pool *pool = stack_pool_of (curr);
+	  list_add (&curr->cache_class_list, &pool->free);
+	  pool->count++;
+	}
+      else
+	stack_cache_class_add (curr);
+    }
+
+  struct pthread *self = THREAD_SELF;
+  if (self->stack_pooled)
+    stack_pool_of (self)->count++;
+}
+
 void
 __nptl_stack_list_del (list_t *elem)
 {
@@ -53,6 +250,37 @@ __nptl_stack_list_add (list_t *elem, list_t *list)
 }
 libc_hidden_def (__nptl_stack_list_add)
 
+/* Remove the unused stack CURR from the cache and free it.  */
+static void
+free_cached_stack (struct pthread *curr)
+{
+  /* Unlink the block and account for the freed memory.  */
+  if (curr->stack_pooled)
+    {
+      list_del (&curr->cache_class_list);
+      stack_pool_of (curr)->count--;
+    }
+  else
+    {
+      stack_cache_class_del (curr);
+      GL (dl_stack_cache_actsize) -= curr->stackblock_size;
+    }
+  __nptl_stack_list_del (&curr->list);
+
+  if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
+    GLRO (dl_debug_printf) (
+	"tls: TCB deallocating from full cache; TID=%ld, TCB=0x%lx\n",
+	(long int) curr->tid, (unsigned long int) curr);
+
+  /* Free the memory associated with the ELF TLS.  */
+  _dl_deallocate_tls (TLS_TPADJ (curr), false);
+
+  /* Remove this block.  This should never fail.  If it does
+     something is really wrong.  */
+  if (__munmap (curr->stackblock, curr->stackblock_size) != 0)
+    abort ();
+}
+
 void
 __nptl_free_stacks (size_t limit)
 {
@@ -67,32 +295,87 @@ __nptl_free_stacks (size_t limit)
       struct pthread *curr;
 
       curr = list_entry (entry, struct pthread, list);
-      if (__nptl_stack_in_use (curr))
+      if (__nptl_stack_in_use (curr) && !curr->stack_pooled)
 	{
-	  /* Unlink the block.  */
-	  __nptl_stack_list_del (entry);
+	  free_cached_stack (curr);
 
-	  /* Account for the freed memory.  */
-	  GL (dl_stack_cache_actsize) -= curr->stackblock_size;
+	  /* Maybe we have freed enough.  */
+	  if (GL (dl_stack_cache_actsize) <= limit)
+	    break;
+	}
+    }
+}
 
-	  if (__glibc_unlikely (GLRO (dl_debug_mask) & DL_DEBUG_TLS))
-	    GLRO (dl_debug_printf) (
-		"tls: TCB deallocating from full cache; TID=%ld, TCB=0x%lx\n",
-		(long int) curr->tid, (unsigned long int) curr);
+/* Free the unused stacks of POOL until it has no more than COUNT
+   stacks.  */
+static void
+stack_pool_trim (struct stack_pool *pool, size_t count)
+{
+  list_t *entry;
+  list_t *prev;
 
-	  /* Free the memory associated with the ELF TLS.  */
-	  _dl_deallocate_tls (TLS_TPADJ (curr), false);
+  list_for_each_prev_safe (entry, prev, &pool->free)
+    {
+      if (pool->count <= count)
+	break;
 
-	  /* Remove this block.  This should never fail.  If it does
-	     something is really wrong.  */
-	  if (__munmap (curr->stackblock, curr->stackblock_size) != 0)
-	    abort ();
+      struct pthread *curr = list_entry (entry, struct pthread,
+					 cache_class_list);
+      if (__nptl_stack_in_use (curr))
+	free_cached_stack (curr);
+    }
+}
 
-	  /* Maybe we have freed enough.  */
-	  if (GL (dl_stack_cache_actsize) <= limit)
-	    break;
+void
+__nptl_stack_pool_free (void)
+{
+  for (size_t i = 0; i < STACK_POOLS && stack_pools[i].target != 0; i++)
+    stack_pool_trim (&stack_pools[i], 0);
+}
+
+size_t
+__nptl_stack_pool_resize (size_t count, size_t size, size_t guardsize)
+{
+  struct stack_pool *pool = stack_pool_find (size, guardsize, true);
+  if (pool == NULL)
+    return 0;
+
+  pool->target = MAX (pool->target, count);
+  if (pool->count >= pool->target)
+    return 0;
+
+  size_t n = pool->target - pool->count;
+  pool->count = pool->target;
+  return n;
+}
+
+void
+__nptl_stack_pool_release (size_t n, size_t size, size_t guardsize)
+{
+  stack_pool_find (size, guardsize, false)->count -= n;
+}
+
+struct pthread *
+__nptl_stack_pool_take (size_t size, size_t guardsize)
+{
+  struct stack_pool *pool = stack_pool_find (size, guardsize, false);
+  if (pool == NULL)
+    return NULL;
+
+  list_t *entry;
+  list_for_each (entry, &pool->free)
+    {
+      struct pthread *curr = list_entry (entry, struct pthread,
+					 cache_class_list);
+      if (__nptl_stack_in_use (curr))
+	{
+	  list_del (&curr->cache_class_list);
+	  __nptl_stack_list_del (&curr->list);
+	  return curr;
 	}
     }
+
+  return NULL;
 }
 
 /* Add a stack frame which is not used anymore to the stack.  Must be
@@ -107,10 +390,17 @@ queue_stack (struct pthread *stack)
     GLRO (dl_debug_printf) ("tls: TCB deallocated into cache; TID=%ld, TCB=0x%lx\n",
 			    (long int) stack->tid, (unsigned long int) stack);
 
+  if (stack->stack_pooled)
+    {
+      __nptl_stack_pool_add (stack);
+      return;
+    }
+
   /* We unconditionally add the stack to the list.  The memory may
      still be in use but it will not be reused until the kernel marks
      the stack as not used anymore.  */
   __nptl_stack_list_add (&stack->list, &GL (dl_stack_cache));
+  stack_cache_class_add (stack);
 
   GL (dl_stack_cache_actsize) += stack->stackblock_size;
   if (__glibc_unlikely (GL (dl_stack_cache_actsize)
@@ -118,6 +408,14 @@ queue_stack (struct pthread *stack)
     __nptl_free_stacks (__nptl_stack_cache_maxsize);
 }
 
+void
+__nptl_stack_pool_add (struct pthread *stack)
+{
+  /* Add at the beginning, like stack_cache_class_add.  */
+  __nptl_stack_list_add (&stack->list, &GL (dl_stack_cache));
+  list_add (&stack->cache_class_list, &stack_pool_of (stack)->free);
+}
+
 void
 __nptl_deallocate_stack (struct pthread *pd)
 {
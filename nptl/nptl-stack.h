@@ -50,9 +50,55 @@ libc_hidden_proto (__nptl_stack_list_add)
 extern void __nptl_deallocate_stack (struct pthread *pd);
 libc_hidden_proto (__nptl_deallocate_stack)
 
-/* Free stacks until cache size is lower than LIMIT.  */
+/* Free stacks until cache size is lower than LIMIT.  The stacks of the
+   pools are not freed.  */
 void __nptl_free_stacks (size_t limit) attribute_hidden;
 
+/* Free the stacks of the pools which are not used.  */
+void __nptl_stack_pool_free (void) attribute_hidden;
+
+/* Return true if the cache may have a stack for a request of SIZE bytes.
+   This is checked without the cache lock, so the result may be stale.  */
+bool __nptl_stack_cache_has (size_t size) attribute_hidden;
+
+/* Remove from the cache the smallest stack which is no longer used and
+   has at least SIZE bytes, but not excessively more, and return it, or
+   return NULL if there is none.  Must be called with the cache lock
+   held.  */
+struct pthread *__nptl_stack_cache_take (size_t size) attribute_hidden;
+
+/* Grow the pool of stacks of SIZE bytes with a guard area of GUARDSIZE
+   bytes to COUNT stacks, which must not be zero, creating the pool if
+   needed.  A pool which already has COUNT stacks or more is left as is.
+   Return the number of stacks which the caller must allocate and add
+   with __nptl_stack_pool_add, or release with __nptl_stack_pool_release
+   if it fails.  If there is no room for another pool, return zero.  Must be
+   called with the cache lock held.  */
+size_t __nptl_stack_pool_resize (size_t count, size_t size,
+				 size_t guardsize) attribute_hidden;
+
+/* Remove N stacks from the count of the pool of stacks of SIZE bytes
+   with a guard area of GUARDSIZE bytes, because they could not be
+   allocated or were freed.  Must be called with the cache lock held.  */
+void __nptl_stack_pool_release (size_t n, size_t size,
+				size_t guardsize) attribute_hidden;
+
+/* Remove from the pool of stacks of SIZE bytes with a guard area of
+   GUARDSIZE bytes a stack which is no longer used and return it, or
+   return NULL if there is none.  Must be called with the cache lock
+   held.  */
+struct pthread *__nptl_stack_pool_take (size_t size,
+					size_t guardsize) attribute_hidden;
+
+/* Add the stack STACK, which must be marked as pooled and must have been
+   counted in its pool, to the cache.  Must be called with the cache lock
+   held.  */
+void __nptl_stack_pool_add (struct pthread *stack) attribute_hidden;
+
+/* Rebuild the size classes of the cache from GL (dl_stack_cache) in a
+   new child process, where they may have been left inconsistent.  */
+void __nptl_stack_cache_reclaim (void) attribute_hidden;
+
 /* Compute the size of the static TLS area based on data from the
    dynamic loader.  */
 static inline size_t
@@ -27,4 +27,5 @@ __libpthread_freeres (void)
 {
   call_function_static_weak (__default_pthread_attr_freeres);
   __nptl_free_stacks (0);
+  __nptl_stack_pool_free ();
 }
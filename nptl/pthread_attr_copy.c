@@ -47,6 +47,11 @@ __pthread_attr_copy (pthread_attr_t *target, const pthread_attr_t *source)
       if (ret == 0 && isource->extension->sigmask_set)
         ret = __pthread_attr_setsigmask_internal ((pthread_attr_t *) &temp,
                                                   &isource->extension->sigmask);
+
+      /* Propagate the size of the stack pool.  */
+      if (ret == 0 && isource->extension->stackpool != 0)
+        ret = __pthread_attr_setstackpool_np (&temp.external,
+                                              isource->extension->stackpool);
     }
 
   if (ret != 0)
@@ -40,7 +40,7 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
   LIBC_PROBE (cond_broadcast, 1, cond);
 
   unsigned int wrefs = atomic_load_relaxed (&cond->__data.__wrefs);
-  if (wrefs >> 3 == 0)
+  if (wrefs >> 4 == 0)
     return 0;
   int private = __condvar_get_private (wrefs);
 
@@ -51,20 +51,25 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
   unsigned int g1 = g2 ^ 1;
   wseq >>= 1;
   bool do_futex_wake = false;
+  unsigned int signals;
 
   /* Step (1): signal all waiters remaining in G1.  */
   if (cond->__data.__g_size[g1] != 0)
     {
       /* Add as many signals as the remaining size of the group.  */
-      atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
-				cond->__data.__g_size[g1]);
+      signals = atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
+					  cond->__data.__g_size[g1]);
+      signals += cond->__data.__g_size[g1];
       cond->__data.__g_size[g1] = 0;
 
-      /* We need to wake G1 waiters before we switch G1 below.  */
+      /* We need to wake G1 waiters before we switch G1 below.  If
+	 possible, move them to the mutex instead (see
+	 __condvar_requeue).  */
       /* TODO Only set it if there are indeed futex waiters.  We could
 	 also try to move this out of the critical section in cases when
 	 G2 is empty (and we don't need to quiesce).  */
-      futex_wake (cond->__data.__g_signals + g1, INT_MAX, private);
+      if (!__condvar_requeue (cond, g1, signals, INT_MAX, private))
+	futex_wake (cond->__data.__g_signals + g1, INT_MAX, private);
     }
 
   /* G1 is complete.  Step (2) is next unless there are no waiters in G2, in
@@ -72,8 +77,9 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
   if (__condvar_switch_g1 (cond, wseq, &g1, private))
     {
       /* Step (3): Send signals to all waiters in the old G2 / new G1.  */
-      atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
-				cond->__data.__g_size[g1]);
+      signals = atomic_fetch_add_relaxed (cond->__data.__g_signals + g1,
+					  cond->__data.__g_size[g1]);
+      signals += cond->__data.__g_size[g1];
       cond->__data.__g_size[g1] = 0;
       /* TODO Only set it if there are indeed futex waiters.  */
       do_futex_wake = true;
@@ -81,7 +87,8 @@ ___pthread_cond_broadcast (pthread_cond_t *cond)
 
   __condvar_release_lock (cond, private);
 
-  if (do_futex_wake)
+  if (do_futex_wake
+      && !__condvar_requeue (cond, g1, signals, INT_MAX, private))
     futex_wake (cond->__data.__g_signals + g1, INT_MAX, private);
 
   return 0;
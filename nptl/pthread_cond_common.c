@@ -21,12 +21,12 @@
 #include <stdint.h>
 #include <pthread.h>
 
-/* We need 3 least-significant bits on __wrefs for something else.
+/* We need 4 least-significant bits on __wrefs for something else.
    This also matches __atomic_wide_counter requirements: The highest
    value we add is __PTHREAD_COND_MAX_GROUP_SIZE << 2 to __g1_start
    (the two extra bits are for the lock in the two LSBs of
    __g1_start).  */
-#define __PTHREAD_COND_MAX_GROUP_SIZE ((unsigned) 1 << 29)
+#define __PTHREAD_COND_MAX_GROUP_SIZE ((unsigned) 1 << 28)
 
 static inline uint64_t
 __condvar_load_wseq_relaxed (pthread_cond_t *cond)
@@ -189,6 +189,101 @@ __condvar_get_private (int flags)
     return FUTEX_SHARED;
 }
 
+/* Wait morphing.  Waiters which are woken first have to acquire the mutex
+   again, which is often still held by the signaler, so they would just
+   block again on the mutex.  Instead, signalers move them from the futex of
+   their group to the futex of the mutex with lll_futex_requeue, so that
+   they are woken one at a time when the mutex is released.  This is only
+   done for process-private condvars and mutexes whose __lock is a plain
+   lowlevellock (normal, recursive, error checking and adaptive mutexes,
+   without the robust, PI, PP or queued variants), since waiters acquire it
+   again with __pthread_mutex_cond_lock, which marks it as contended.
+   Waiters publish such a mutex in __mutex before they acquire a position
+   in __wseq, and NULL otherwise.
+
+   A waiter blocked on the futex of the mutex must either acquire the mutex
+   after being woken, or pass the wake-up on to the other waiters of the
+   mutex: see __pthread_cond_wait_common.  The kernel does not tell waiters
+   whether they were moved, so signalers set bit 3 of __wrefs before they
+   move waiters, and waiters only pass wake-ups on if it is set.  It is
+   cleared when the last waiter removes its reference, since no waiter can
+   be blocked on the futex of the mutex then.  */
+
+/* Publish MUTEX, the mutex of a waiter, in COND if the waiters can be moved
+   to its futex.  Return true if they can.  */
+static bool __attribute__ ((unused))
+__condvar_set_mutex (pthread_cond_t *cond, pthread_mutex_t *mutex)
+{
+  /* Relaxed MO is sufficient because the flags of __wrefs do not
+     change.  */
+  int private = __condvar_get_private (atomic_load_relaxed
+				       (&cond->__data.__wrefs));
+  if (private != FUTEX_PRIVATE)
+    return false;
+
+  pthread_mutex_t *m = NULL;
+  if ((PTHREAD_MUTEX_TYPE (mutex) & ~PTHREAD_MUTEX_KIND_MASK_NP) == 0
+      && PTHREAD_MUTEX_PSHARED (mutex) == LLL_PRIVATE)
+    m = mutex;
+  /* Waiters use the same mutex until they all returned, so the value only
+     changes if the program binds the condvar to another mutex.  */
+  if (atomic_load_relaxed (&cond->__data.__mutex) != m)
+    {
+      atomic_store_relaxed (&cond->__data.__mutex, m);
+      /* Release fence so that the signalers which observe the position of
+	 this waiter in __wseq also observe the mutex.  See
+	 __condvar_requeue.  */
+      atomic_thread_fence_release ();
+    }
+  return m != NULL;
+}
+
+/* Move up to NR waiters blocked on the futex of group G, whose value is
+   SIGNALS after the signals were added, to the futex of the mutex.  Only
+   call this after having observed the positions of these waiters in
+   __wseq.  Return false if the waiters have to be woken instead.  */
+static bool __attribute__ ((unused))
+__condvar_requeue (pthread_cond_t *cond, unsigned int g, unsigned int signals,
+		   int nr, int private)
+{
+  if (private != FUTEX_PRIVATE)
+    return false;
+  /* Synchronize with the release fence in __condvar_set_mutex.  */
+  atomic_thread_fence_acquire ();
+  pthread_mutex_t *mutex = atomic_load_relaxed (&cond->__data.__mutex);
+  if (mutex == NULL)
+    return false;
+
+  /* Tell the waiters that they may have been moved, before moving them
+     since they can be woken right afterwards.  The flag is only cleared
+     when there are no waiters, so it stays set for the waiters which
+     registered before.  Use a read-modify-write operation with release MO
+     even if the flag is set already, so that the waiters which register
+     later see the signals we added and do not block with the value of the
+     futex word that we expect.  */
+  atomic_fetch_or_release (&cond->__data.__wrefs, 8);
+
+  int *lock = &mutex->__data.__lock;
+  if (lll_futex_requeue (cond->__data.__g_signals + g, 0, nr, lock, signals,
+			 FUTEX_PRIVATE) != 0)
+    return false;
+
+  /* The waiters we moved, if any, block on the mutex as if they had called
+     __lll_lock_wait, so make sure that the mutex is marked as contended, or
+     wake one of them if it is not acquired anymore.  The mutex cannot have
+     been destroyed since the waiters use it.  */
+  int v = atomic_load_relaxed (lock);
+  while (v != 2)
+    if (v == 0)
+      {
+	futex_wake ((unsigned int *) lock, 1, FUTEX_PRIVATE);
+	break;
+      }
+    else if (atomic_compare_exchange_weak_relaxed (lock, &v, 2))
+      break;
+  return true;
+}
+
 /* This closes G1 (whose index is in G1INDEX), converts G1 into a fresh G2,
    and then switches group roles so that the former G2 becomes the new G1
    ending at the current __wseq value when we eventually make the switch
@@ -48,7 +48,14 @@ __pthread_cond_destroy (pthread_cond_t *cond)
      that they finished.  */
   unsigned int wrefs = atomic_fetch_or_acquire (&cond->__data.__wrefs, 4);
   int private = __condvar_get_private (wrefs);
-  while (wrefs >> 3 != 0)
+  /* The remaining waiters may have been moved to the futex of the mutex,
+     which the caller may hold (see __condvar_requeue).  Wake them, so that
+     they confirm the wake-up before blocking on the mutex again.  */
+  pthread_mutex_t *mutex = atomic_load_relaxed (&cond->__data.__mutex);
+  if (wrefs >> 4 != 0 && mutex != NULL)
+    futex_wake ((unsigned int *) &mutex->__data.__lock, INT_MAX,
+		FUTEX_PRIVATE);
+  while (wrefs >> 4 != 0)
     {
       futex_wait_simple (&cond->__data.__wrefs, wrefs, private);
       /* See above.  */
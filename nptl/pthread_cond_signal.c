@@ -39,7 +39,7 @@ ___pthread_cond_signal (pthread_cond_t *cond)
      the same reasons that relaxed MO is fine when observing __wseq (see
      below).  */
   unsigned int wrefs = atomic_load_relaxed (&cond->__data.__wrefs);
-  if (wrefs >> 3 == 0)
+  if (wrefs >> 4 == 0)
     return 0;
   int private = __condvar_get_private (wrefs);
 
@@ -67,6 +67,7 @@ ___pthread_cond_signal (pthread_cond_t *cond)
   unsigned int g1 = (wseq & 1) ^ 1;
   wseq >>= 1;
   bool do_futex_wake = false;
+  unsigned int signals;
 
   /* If G1 is still receiving signals, we put the signal there.  If not, we
      check if G2 has waiters, and if so, switch G1 to the former G2; if this
@@ -80,7 +81,8 @@ ___pthread_cond_signal (pthread_cond_t *cond)
          release-MO store when initializing a group in __condvar_switch_g1
          because we use an atomic read-modify-write and thus extend that
          store's release sequence.  */
-      atomic_fetch_add_relaxed (cond->__data.__g_signals + g1, 1);
+      signals = atomic_fetch_add_relaxed (cond->__data.__g_signals + g1, 1);
+      signals++;
       cond->__data.__g_size[g1]--;
       /* TODO Only set it if there are indeed futex waiters.  */
       do_futex_wake = true;
@@ -88,7 +90,8 @@ ___pthread_cond_signal (pthread_cond_t *cond)
 
   __condvar_release_lock (cond, private);
 
-  if (do_futex_wake)
+  /* Move the waiter to the mutex if possible (see __condvar_requeue).  */
+  if (do_futex_wake && !__condvar_requeue (cond, g1, signals, 1, private))
     futex_wake (cond->__data.__g_signals + g1, 1, private);
 
   return 0;
@@ -46,11 +46,27 @@ struct _condvar_cleanup_buffer
 static void
 __condvar_confirm_wakeup (pthread_cond_t *cond, int private)
 {
+  /* If we are the last waiter, no waiter can be blocked on the futex of
+     the mutex anymore, so clear the requeue flag as well (see
+     __condvar_requeue).  This must be done in the same atomic operation,
+     since the condvar may be destroyed as soon as we removed our
+     reference.  */
+  unsigned int wrefs = atomic_load_relaxed (&cond->__data.__wrefs);
+  unsigned int new_wrefs;
+  do
+    {
+      new_wrefs = wrefs - 16;
+      if (new_wrefs >> 4 == 0)
+	new_wrefs &= ~8U;
+    }
+  while (!atomic_compare_exchange_weak_release (&cond->__data.__wrefs,
+						&wrefs, new_wrefs));
+
   /* If destruction is pending (i.e., the wake-request flag is nonzero) and we
-     are the last waiter (prior value of __wrefs was 1 << 3), then wake any
+     are the last waiter (prior value of __wrefs was 1 << 4), then wake any
      threads waiting in pthread_cond_destroy.  Release MO to synchronize with
      these threads.  Don't bother clearing the wake-up request flag.  */
-  if ((atomic_fetch_add_release (&cond->__data.__wrefs, -8) >> 2) == 3)
+  if (wrefs >> 4 == 1 && (wrefs & 4) != 0)
     futex_wake (&cond->__data.__wrefs, INT_MAX, private);
 }
 
@@ -265,6 +281,9 @@ __condvar_cleanup_waiting (void *arg)
      * The two least-significant bits represent the condvar-internal lock.
      * Only accessed while having acquired the condvar-internal lock.
    __wrefs: Waiter reference counter.
+     * Bit 3 is true if signalers may have moved waiters to the futex of the
+       mutex (see __condvar_requeue).  It is cleared when the last
+       reference is removed.
      * Bit 2 is true if waiters should run futex_wake when they remove the
        last reference.  pthread_cond_destroy uses this as futex word.
      * Bit 1 is the clock ID (0 == CLOCK_REALTIME, 1 == CLOCK_MONOTONIC).
@@ -286,6 +305,10 @@ __condvar_cleanup_waiting (void *arg)
      * Although this is of unsigned type, we rely on using unsigned overflow
        rules to make this hold effectively negative values too (in
        particular, when waiters in G2 cancel waiting).
+   __mutex: The mutex of the waiters, if they can be moved to its futex
+     instead of being woken (see __condvar_requeue), or NULL.
+     * Set by waiters before they acquire a position in __wseq, and read by
+       signalers and pthread_cond_destroy.
 
    A PTHREAD_COND_INITIALIZER condvar has all fields set to zero, which yields
    a condvar that has G2 starting at position 0 and a G1 that is closed.
@@ -340,6 +363,11 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
      don't use it if abstime is NULL, so we don't need to check it
      here. */
 
+  /* Let signalers move us to the futex of MUTEX if possible (see
+     __condvar_requeue).  */
+  bool requeue = __condvar_set_mutex (cond, mutex);
+  bool requeued = false;
+
   /* Acquire a position (SEQ) in the waiter sequence (WSEQ).  We use an
      atomic operation because signals and broadcasts may update the group
      switch without acquiring the mutex.  We do not need release MO here
@@ -353,9 +381,12 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
   unsigned int g = wseq & 1;
   uint64_t seq = wseq >> 1;
 
-  /* Increase the waiter reference count.  Relaxed MO is sufficient because
-     we only need to synchronize when decrementing the reference count.  */
-  unsigned int flags = atomic_fetch_add_relaxed (&cond->__data.__wrefs, 8);
+  /* Increase the waiter reference count.  Acquire MO to synchronize with
+     the signalers which set the requeue flag before we registered, so that
+     we see the signals they added and do not block on the value of the
+     futex word with which they move waiters to the mutex (see
+     __condvar_requeue).  */
+  unsigned int flags = atomic_fetch_add_acquire (&cond->__data.__wrefs, 16);
   int private = __condvar_get_private (flags);
 
   /* Now that we are registered as a waiter, we can release the mutex.
@@ -409,6 +440,13 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
 	      continue;
 	}
 
+      /* If we may have been moved to the futex of the mutex and woken by
+	 its release, we have to pass the wake-up on since we do not acquire
+	 the mutex now.  This only happens if another waiter consumed the
+	 signal we were moved for.  */
+      if (requeued)
+	futex_wake ((unsigned int *) &mutex->__data.__lock, 1, FUTEX_PRIVATE);
+
       // Now block.
       struct _pthread_cleanup_buffer buffer;
       struct _condvar_cleanup_buffer cbuffer;
@@ -422,6 +460,10 @@ __pthread_cond_wait_common (pthread_cond_t *cond, pthread_mutex_t *mutex,
         cond->__data.__g_signals + g, signals, clockid, abstime, private);
 
       __pthread_cleanup_pop (&buffer, 0);
+      /* A wake-up can only have come from the futex of the mutex if a
+	 signaler moved waiters there since we registered.  */
+      requeued = (requeue && err == 0
+		  && (atomic_load_relaxed (&cond->__data.__wrefs) & 8) != 0);
 
       if (__glibc_unlikely (err == ETIMEDOUT || err == EOVERFLOW))
         {
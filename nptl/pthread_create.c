@@ -573,7 +573,11 @@ start_thread (void *arg)
      to avoid creating a new free-state block during thread release.  */
   __getrandom_vdso_release (pd);
 
-  if (pd->stack_mode != ALLOCATE_GUARD_USER)
+  /* Return the reader slots of the thread to the registry.  */
+  __pthread_rwlock_readers_release (pd);
+
+  /* The stacks of the pool are kept faulted in for the next thread.  */
+  if (pd->stack_mode != ALLOCATE_GUARD_USER && !pd->stack_pooled)
     advise_stack_range (pd->stackblock, pd->stackblock_size, (uintptr_t) pd,
 			pd->guardsize);
 
@@ -0,0 +1,108 @@
+/* Initialize an object only once, without a futex per object.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include "pthreadP.h"
+#include <futex-internal.h>
+#include <atomic.h>
+#include <libc-lockP.h>
+
+/* The controls use the same states as pthread_once controls (see
+   __pthread_once_slow), but threads waiting for any initialization to
+   finish block on LAZY_WAKE_SEQ instead of the control itself, which
+   is incremented whenever an initialization finishes or is interrupted
+   while LAZY_WAITERS is not zero.  This way an initialization which
+   nobody waits for costs no futex call, and many small objects can be
+   initialized lazily without futex wake-ups on each of them.  A waiter
+   may be woken up by the initialization of another object; it then
+   checks its control again and goes back to sleep.  */
+static unsigned int lazy_wake_seq;
+static unsigned int lazy_waiters;
+
+static void
+lazy_wake (void)
+{
+  /* Pairs with the fence in __pthread_lazy_init_np: either the waiter
+     sees the new state of its control, or we see the waiter.  */
+  atomic_thread_fence_seq_cst ();
+  if (atomic_load_relaxed (&lazy_waiters) != 0)
+    {
+      /* Release memory order so that a waiter which sees the new sequence
+	 number also sees the new state of the control.  */
+      atomic_fetch_add_release (&lazy_wake_seq, 1);
+      futex_wake (&lazy_wake_seq, INT_MAX, FUTEX_PRIVATE);
+    }
+}
+
+static void
+clear_lazy_control (void *arg)
+{
+  /* Reset to the uninitialized state, as clear_once_control does.  */
+  atomic_store_relaxed ((pthread_once_t *) arg, 0);
+  lazy_wake ();
+}
+
+int
+__pthread_lazy_init_np (pthread_once_t *lazy_control,
+			void (*init_routine) (void *), void *arg)
+{
+  /* Acquire memory order so that we see the data modifications done
+     during the initialization.  */
+  int val = atomic_load_acquire (lazy_control);
+  while (1)
+    {
+      if (__glibc_likely ((val & __PTHREAD_ONCE_DONE) != 0))
+	return 0;
+
+      int newval = __fork_generation | __PTHREAD_ONCE_INPROGRESS;
+      if (val != newval)
+	{
+	  /* Either not initialized yet, or the initialization was
+	     interrupted by a fork.  Try to run it.  */
+	  if (atomic_compare_exchange_weak_acquire (lazy_control, &val,
+						    newval))
+	    break;
+	  continue;
+	}
+
+      /* Another thread of this process runs the initialization.  */
+      atomic_fetch_add_relaxed (&lazy_waiters, 1);
+      atomic_thread_fence_seq_cst ();
+      unsigned int seq = atomic_load_acquire (&lazy_wake_seq);
+      val = atomic_load_acquire (lazy_control);
+      if (val == newval)
+	futex_wait_simple (&lazy_wake_seq, seq, FUTEX_PRIVATE);
+      atomic_fetch_add_relaxed (&lazy_waiters, -1);
+      val = atomic_load_acquire (lazy_control);
+    }
+
+  /* Register a cleanup handler so that in case the thread gets
+     interrupted the initialization can be restarted.  */
+  pthread_cleanup_combined_push (clear_lazy_control, lazy_control);
+
+  init_routine (arg);
+
+  pthread_cleanup_combined_pop (0);
+
+  /* Release memory order so that other threads which see the control
+     done also see the initialized data.  */
+  atomic_store_release (lazy_control, __PTHREAD_ONCE_DONE);
+  lazy_wake ();
+
+  return 0;
+}
+weak_alias (__pthread_lazy_init_np, pthread_lazy_init_np)
@@ -29,6 +29,7 @@ struct mutex_config __mutex_aconf =
   /* The maximum number of times a thread should spin on the lock before
   calling into kernel to block.  */
   .spin_count = DEFAULT_ADAPTIVE_COUNT,
+  .sem_spin_count = DEFAULT_ADAPTIVE_COUNT,
 };
 libc_hidden_data_def (__mutex_aconf)
 
@@ -38,6 +39,24 @@ TUNABLE_CALLBACK (set_mutex_spin_count) (tunable_val_t *valp)
   __mutex_aconf.spin_count = (int32_t) (valp)->numval;
 }
 
+static void
+TUNABLE_CALLBACK (set_mutex_profile) (tunable_val_t *valp)
+{
+  __mutex_aconf.profile = (int32_t) valp->numval;
+}
+
+static void
+TUNABLE_CALLBACK (set_mutex_profile_signal) (tunable_val_t *valp)
+{
+  __mutex_aconf.profile_signal = (int32_t) valp->numval;
+}
+
+static void
+TUNABLE_CALLBACK (set_sem_spin_count) (tunable_val_t *valp)
+{
+  __mutex_aconf.sem_spin_count = (int32_t) valp->numval;
+}
+
 static void
 TUNABLE_CALLBACK (set_stack_cache_size) (tunable_val_t *valp)
 {
@@ -59,4 +78,13 @@ __pthread_tunables_init (void)
                TUNABLE_CALLBACK (set_stack_cache_size));
   TUNABLE_GET (stack_hugetlb, int32_t,
 	       TUNABLE_CALLBACK (set_stack_hugetlb));
+  TUNABLE_GET (mutex_profile_signal, int32_t,
+	       TUNABLE_CALLBACK (set_mutex_profile_signal));
+  TUNABLE_GET (mutex_profile, int32_t,
+	       TUNABLE_CALLBACK (set_mutex_profile));
+  TUNABLE_GET (sem_spin_count, int32_t,
+	       TUNABLE_CALLBACK (set_sem_spin_count));
+
+  if (__mutex_aconf.profile)
+    __pthread_mutex_profile_init ();
 }
@@ -38,6 +38,9 @@ ___pthread_mutex_destroy (pthread_mutex_t *mutex)
      it with pthread_mutex_init.  */
   atomic_store_relaxed (&(mutex->__data.__kind), -1);
 
+  if (__glibc_unlikely (__mutex_aconf.profile))
+    __pthread_mutex_profile_destroy (mutex);
+
   return 0;
 }
 versioned_symbol (libc, ___pthread_mutex_destroy, pthread_mutex_destroy,
@@ -85,6 +85,16 @@ ___pthread_mutex_init (pthread_mutex_t *mutex,
       break;
     }
 
+  /* Queued mutexes do not support the robust and priority protocols.
+     They cannot be shared with other processes either, because their
+     queue is made of nodes on the stacks of the waiting threads.  */
+  if ((imutexattr->mutexkind & ~PTHREAD_MUTEXATTR_FLAG_BITS)
+      == PTHREAD_MUTEX_QUEUED_NP
+      && (imutexattr->mutexkind & (PTHREAD_MUTEXATTR_FLAG_ROBUST
+				   | PTHREAD_MUTEXATTR_FLAG_PSHARED
+				   | PTHREAD_MUTEXATTR_PROTOCOL_MASK)) != 0)
+    return ENOTSUP;
+
   /* Clear the whole variable.  */
   memset (mutex, '\0', __SIZEOF_PTHREAD_MUTEX_T);
 
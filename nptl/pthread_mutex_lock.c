@@ -26,6 +26,7 @@
 #include <futex-internal.h>
 #include <stap-probe.h>
 #include <shlib-compat.h>
+#include <pthread_mutex_numa.h>
 
 /* Some of the following definitions differ when pthread_mutex_cond_lock.c
    includes this file.  */
@@ -63,6 +64,201 @@ lll_mutex_lock_optimized (pthread_mutex_t *mutex)
   atomic_load_relaxed (&(mutex)->__data.__lock)
 #endif
 
+/* PTHREAD_MUTEX_QUEUED_NP mutexes are acquired and released through
+   __lock like normal mutexes, but the threads which find the mutex
+   acquired queue up instead of all spinning on __lock and blocking on it
+   together.  The queue is a linked list of mutex_queue_node, one on the
+   stack of each waiting thread, whose tail is stored in __list.__next.
+   Only the thread at the head of the queue competes for __lock (with the
+   threads which did not queue up yet), spinning then blocking on it like
+   an adaptive mutex.  The other threads spin on their own node, which is
+   not shared with other CPUs, and then block on it with a futex.  Once the
+   head acquired the mutex, it hands the head of the queue over to the
+   next waiter, preferring the waiters which run on its NUMA node, so that
+   the data protected by the mutex stays in the caches of that node.  The
+   waiters skipped that way move to a secondary queue, which is passed
+   along with the head of the queue and goes first when no waiter is on
+   the node of the head anymore, or after QUEUE_MAX_LOCAL_HANDOFFS handoffs
+   within the same node.  */
+
+struct mutex_queue_node
+{
+  /* The next waiter in the queue.  Set by that waiter.  */
+  struct mutex_queue_node *next;
+  /* QUEUE_WAITING, QUEUE_SLEEPING, or QUEUE_HEAD.  Futex word.  */
+  unsigned int state;
+  /* The NUMA node of the waiter when it queued up.  */
+  int numa_node;
+  /* Only used by the head of the queue: the secondary queue and the
+     number of handoffs since the secondary queue last went first.  */
+  struct mutex_queue_node *sec_head;
+  struct mutex_queue_node *sec_tail;
+  unsigned int local_handoffs;
+};
+
+enum
+{
+  QUEUE_WAITING,
+  QUEUE_SLEEPING,
+  QUEUE_HEAD
+};
+
+#define QUEUE_MAX_LOCAL_HANDOFFS 256
+
+/* The tail is stored with the type of __list.__next, which differs
+   between the mutex layouts.  */
+#define MUTEX_QUEUE_TAIL(mutex) (&(mutex)->__data.__list.__next)
+#define MUTEX_QUEUE_NODE(mutex, node) \
+  ((__typeof ((mutex)->__data.__list.__next)) (node))
+
+/* Make NODE the head of the queue.  */
+static void
+mutex_queue_grant (struct mutex_queue_node *node,
+		   struct mutex_queue_node *sec_head,
+		   struct mutex_queue_node *sec_tail,
+		   unsigned int local_handoffs)
+{
+  node->sec_head = sec_head;
+  node->sec_tail = sec_tail;
+  node->local_handoffs = local_handoffs;
+  /* Release MO so that the new head sees the fields above and the links of
+     the nodes.  NODE may be gone when futex_wake runs, which is harmless
+     (the futex word could be reused for anything else).  */
+  if (atomic_exchange_release (&node->state, QUEUE_HEAD) == QUEUE_SLEEPING)
+    futex_wake (&node->state, 1, FUTEX_PRIVATE);
+}
+
+/* Wait until NODE is the head of the queue.  */
+static void
+mutex_queue_wait (struct mutex_queue_node *node)
+{
+  for (int cnt = max_adaptive_count (); cnt > 0; cnt--)
+    {
+      if (atomic_load_acquire (&node->state) == QUEUE_HEAD)
+	return;
+      atomic_spin_nop ();
+    }
+
+  /* Block until mutex_queue_grant changes the state to QUEUE_HEAD.  */
+  unsigned int state = QUEUE_WAITING;
+  while (state != QUEUE_HEAD)
+    {
+      if (state == QUEUE_SLEEPING
+	  || atomic_compare_exchange_weak_relaxed (&node->state, &state,
+						   QUEUE_SLEEPING))
+	futex_wait (&node->state, QUEUE_SLEEPING, FUTEX_PRIVATE);
+      state = atomic_load_relaxed (&node->state);
+    }
+  /* Synchronize with mutex_queue_grant.  */
+  atomic_thread_fence_acquire ();
+}
+
+/* Called by NODE, the head of the queue, once it acquired MUTEX: make the
+   next waiter the head of the queue, if there is one.  */
+static void
+mutex_queue_pass (pthread_mutex_t *mutex, struct mutex_queue_node *node)
+{
+  struct mutex_queue_node *sec_head = node->sec_head;
+  struct mutex_queue_node *sec_tail = node->sec_tail;
+  unsigned int local_handoffs = node->local_handoffs;
+
+  struct mutex_queue_node *next = atomic_load_acquire (&node->next);
+  if (next == NULL)
+    {
+      /* No other thread queued up, so the secondary queue becomes the
+	 queue, or the queue is now empty.  */
+      __typeof (*MUTEX_QUEUE_TAIL (mutex)) expected
+	= MUTEX_QUEUE_NODE (mutex, node);
+      do
+	if (atomic_compare_exchange_weak_release
+	    (MUTEX_QUEUE_TAIL (mutex), &expected,
+	     MUTEX_QUEUE_NODE (mutex, sec_tail)))
+	  {
+	    if (sec_head != NULL)
+	      mutex_queue_grant (sec_head, NULL, NULL, 0);
+	    return;
+	  }
+      while (expected == MUTEX_QUEUE_NODE (mutex, node));
+
+      /* A thread queued up after NODE: wait until it links itself.  */
+      while ((next = atomic_load_acquire (&node->next)) == NULL)
+	atomic_spin_nop ();
+    }
+
+  if (sec_head == NULL || local_handoffs < QUEUE_MAX_LOCAL_HANDOFFS)
+    {
+      /* Look for the first waiter on the same node.  */
+      struct mutex_queue_node *prev = NULL;
+      for (struct mutex_queue_node *p = next; p != NULL;
+	   p = atomic_load_acquire (&p->next))
+	{
+	  if (p->numa_node == node->numa_node)
+	    {
+	      if (prev != NULL)
+		{
+		  /* Move the waiters from NEXT to PREV to the secondary
+		     queue.  PREV is not the tail of the queue, so no other
+		     thread uses its link.  */
+		  atomic_store_relaxed (&prev->next, NULL);
+		  if (sec_tail != NULL)
+		    atomic_store_relaxed (&sec_tail->next, next);
+		  else
+		    sec_head = next;
+		  sec_tail = prev;
+		}
+	      mutex_queue_grant (p, sec_head, sec_tail, local_handoffs + 1);
+	      return;
+	    }
+	  prev = p;
+	}
+    }
+
+  /* The waiters in the secondary queue waited longer than the others.  */
+  if (sec_head != NULL)
+    {
+      atomic_store_relaxed (&sec_tail->next, next);
+      next = sec_head;
+    }
+  mutex_queue_grant (next, NULL, NULL, 0);
+}
+
+/* Acquire MUTEX, of type PTHREAD_MUTEX_QUEUED_NP, after the fast path
+   failed.  */
+static void
+mutex_queue_lock (pthread_mutex_t *mutex)
+{
+  struct mutex_queue_node node =
+    {
+      .state = QUEUE_WAITING,
+      .numa_node = mutex_numa_node ()
+    };
+
+  /* Acquire MO so that the head of the queue sees the fields of NODE.  */
+  struct mutex_queue_node *prev
+    = (struct mutex_queue_node *) atomic_exchange_acquire
+      (MUTEX_QUEUE_TAIL (mutex), MUTEX_QUEUE_NODE (mutex, &node));
+  if (prev != NULL)
+    {
+      /* Release MO so that the head of the queue sees the fields of NODE
+	 when it walks the queue.  */
+      atomic_store_release (&prev->next, &node);
+      mutex_queue_wait (&node);
+    }
+
+  int cnt = max_adaptive_count ();
+  while (LLL_MUTEX_READ_LOCK (mutex) != 0 || LLL_MUTEX_TRYLOCK (mutex) != 0)
+    {
+      if (--cnt <= 0)
+	{
+	  LLL_MUTEX_LOCK (mutex);
+	  break;
+	}
+      atomic_spin_nop ();
+    }
+
+  mutex_queue_pass (mutex, &node);
+}
+
 static int __pthread_mutex_lock_full (pthread_mutex_t *mutex)
      __attribute_noinline__;
 
@@ -78,6 +274,11 @@ PTHREAD_MUTEX_LOCK (pthread_mutex_t *mutex)
   if (__glibc_unlikely (type & ~PTHREAD_MUTEX_KIND_MASK_NP))
     return __pthread_mutex_lock_full (mutex);
 
+#ifndef NO_INCR
+  if (__glibc_unlikely (__mutex_aconf.profile))
+    return __pthread_mutex_lock_profile (mutex, __builtin_return_address (0));
+#endif
+
   pid_t id = THREAD_GETMEM (THREAD_SELF, tid);
 
   if (__glibc_likely (type == PTHREAD_MUTEX_TIMED_NP))
@@ -585,6 +786,12 @@ __pthread_mutex_lock_full (pthread_mutex_t *mutex)
       }
       break;
 
+    case PTHREAD_MUTEX_QUEUED_NP:
+      if (LLL_MUTEX_TRYLOCK (mutex) != 0)
+	mutex_queue_lock (mutex);
+      assert (mutex->__data.__owner == 0);
+      break;
+
     default:
       /* Correct code cannot set any other type.  */
       return EINVAL;
@@ -0,0 +1,453 @@
+/* Mutex contention profiler.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/param.h>
+#include <_itoa.h>
+#include <atomic.h>
+#include <futex-internal.h>
+#include <hp-timing.h>
+#include <not-cancel.h>
+#include <stap-probe.h>
+#include <pthreadP.h>
+#include <pthread_mutex_conf.h>
+
+/* With the glibc.pthread.mutex_profile tunable, pthread_mutex_lock of
+   normal, recursive, error checking and adaptive mutexes goes through
+   __pthread_mutex_lock_profile, which records the contention of each call
+   site of each mutex in an entry of profile_table: the number of
+   acquisitions, how many of them found the mutex acquired, the number of
+   times the waiters blocked in the kernel, and the time spent waiting and
+   holding the mutex.  The entries are found by open addressing, hashing
+   the address of the mutex only, so that unlocking finds the entry of the
+   current owner among the entries of the mutex.  At most PROFILE_PROBES
+   entries are probed: an acquisition which finds none of them free is
+   counted as dropped.  pthread_mutex_destroy turns the entries of the
+   mutex into tombstones, which keep the probe sequences of the other
+   mutexes intact and can be claimed again.  The entries are only updated
+   by the owner of their mutex, so the updates need no synchronization.  The
+   spin estimate is the exception: threads waiting for the mutex read it
+   before they acquire it, so it is accessed with relaxed MO atomics.
+
+   For adaptive mutexes, the entries also replace the __spins estimate of
+   the mutex: it is kept per call site, grows towards the number of spins
+   that acquired the mutex, and shrinks when spinning did not acquire it,
+   so that call sites which usually end up blocking stop spinning.  */
+
+#define PROFILE_BITS 12
+#define PROFILE_SIZE (1U << PROFILE_BITS)
+#define PROFILE_PROBES 8
+
+/* The mutex of an entry whose mutex was destroyed.  */
+#define PROFILE_DESTROYED ((pthread_mutex_t *) -1)
+
+struct mutex_profile
+{
+  /* Set once when the entry is claimed.  */
+  pthread_mutex_t *mutex;
+  void *site;
+  /* The statistics of the call site.  The times are in hp-timing
+     units.  */
+  uint64_t acquired;
+  uint64_t contended;
+  uint64_t sleeps;
+  hp_timing_t wait;
+  hp_timing_t hold;
+  hp_timing_t max_hold;
+  /* The spin estimate of adaptive mutexes.  */
+  int spins;
+  /* The thread which acquired the mutex through this entry and did not
+     release it yet, or 0, and when it acquired it.  */
+  pid_t holder;
+  hp_timing_t hold_start;
+};
+
+static struct mutex_profile *profile_table;
+/* The number of acquisitions not recorded because the entries where
+   they could be recorded were taken.  */
+static unsigned int profile_dropped;
+
+static size_t
+profile_hash (pthread_mutex_t *mutex)
+{
+  uintptr_t h = (uintptr_t) mutex / sizeof (void *);
+  return (h ^ (h >> PROFILE_BITS)) & (PROFILE_SIZE - 1);
+}
+
+/* Reset the statistics of entry E.  */
+static void
+profile_clear (struct mutex_profile *e)
+{
+  e->acquired = 0;
+  e->contended = 0;
+  e->sleeps = 0;
+  e->wait = 0;
+  e->hold = 0;
+  e->max_hold = 0;
+  atomic_store_relaxed (&e->spins, 0);
+  e->holder = 0;
+  e->hold_start = 0;
+}
+
+/* Whether entry E, which belongs to the mutex looked up, is the entry of
+   SITE.  */
+static bool
+profile_match (struct mutex_profile *e, void *site)
+{
+  /* The thread which claimed the entry stores the site right
+     afterwards.  */
+  void *s;
+  while ((s = atomic_load_acquire (&e->site)) == NULL)
+    atomic_spin_nop ();
+  return s == site;
+}
+
+/* Return the entry of MUTEX and SITE, claiming one if needed, or NULL if
+   the PROFILE_PROBES entries where it may be are taken.  */
+static struct mutex_profile *
+profile_lookup (pthread_mutex_t *mutex, void *site)
+{
+  size_t h = profile_hash (mutex);
+
+  /* Look for the entry first, so that a tombstone before it is not
+     claimed for the same call site.  */
+  for (size_t i = 0; i < PROFILE_PROBES; i++)
+    {
+      struct mutex_profile *e = &profile_table[(h + i) & (PROFILE_SIZE - 1)];
+      pthread_mutex_t *m = atomic_load_relaxed (&e->mutex);
+      if (m == NULL)
+	break;
+      if (m == mutex && profile_match (e, site))
+	return e;
+    }
+
+  for (size_t i = 0; i < PROFILE_PROBES; i++)
+    {
+      struct mutex_profile *e = &profile_table[(h + i) & (PROFILE_SIZE - 1)];
+      pthread_mutex_t *m = atomic_load_relaxed (&e->mutex);
+      while (m == NULL || m == PROFILE_DESTROYED)
+	if (atomic_compare_exchange_weak_relaxed (&e->mutex, &m, mutex))
+	  {
+	    /* A tombstone still has the statistics of its previous
+	       mutex.  */
+	    if (m == PROFILE_DESTROYED)
+	      profile_clear (e);
+	    /* Release MO so that the threads which find SITE see the
+	       zeroed entry.  */
+	    atomic_store_release (&e->site, site);
+	    return e;
+	  }
+      /* Another thread may have claimed the entry for SITE
+	 concurrently.  */
+      if (m == mutex && profile_match (e, site))
+	return e;
+    }
+
+  atomic_fetch_add_relaxed (&profile_dropped, 1);
+  return NULL;
+}
+
+/* Spin on the adaptive mutex MUTEX, up to a limit derived from the spin
+   estimate of E.  Return true if the mutex was acquired.  Store the new
+   spin estimate in *NEW_SPINS, for the caller to record once it owns the
+   mutex.  */
+static bool
+profile_spin (pthread_mutex_t *mutex, struct mutex_profile *e,
+	      int *new_spins)
+{
+  int spins = (e != NULL ? atomic_load_relaxed (&e->spins)
+	       : mutex->__data.__spins);
+  int max_cnt = MIN (max_adaptive_count (), spins * 2 + 10);
+  int cnt = 0;
+  bool acquired = false;
+
+  while (cnt < max_cnt)
+    {
+      atomic_spin_nop ();
+      cnt++;
+      if (atomic_load_relaxed (&mutex->__data.__lock) == 0
+	  && lll_trylock (mutex->__data.__lock) == 0)
+	{
+	  acquired = true;
+	  break;
+	}
+    }
+
+  /* Spinning in vain costs CPU time on top of the wait, so shrink the
+     estimate when it did not pay off.  */
+  if (acquired)
+    spins += (cnt - spins) / 8;
+  else
+    spins -= spins / 8 + 1;
+  if (spins < 0)
+    spins = 0;
+  *new_spins = spins;
+  return acquired;
+}
+
+int
+__pthread_mutex_lock_profile (pthread_mutex_t *mutex, void *site)
+{
+  unsigned int type = PTHREAD_MUTEX_TYPE (mutex);
+  pid_t id = THREAD_GETMEM (THREAD_SELF, tid);
+
+  if (type == PTHREAD_MUTEX_RECURSIVE_NP && mutex->__data.__owner == id)
+    {
+      /* Just bump the counter.  */
+      if (__glibc_unlikely (mutex->__data.__count + 1 == 0))
+	/* Overflow of the counter.  */
+	return EAGAIN;
+
+      ++mutex->__data.__count;
+
+      return 0;
+    }
+  if (type == PTHREAD_MUTEX_ERRORCHECK_NP
+      && __glibc_unlikely (mutex->__data.__owner == id))
+    return EDEADLK;
+
+  struct mutex_profile *e = profile_lookup (mutex, site);
+  bool contended = false;
+  unsigned int sleeps = 0;
+  hp_timing_t wait = 0;
+
+  bool spun = false;
+  int spins = 0;
+
+  if (lll_trylock (mutex->__data.__lock) != 0)
+    {
+      contended = true;
+      hp_timing_t start, end;
+      HP_TIMING_NOW (start);
+      spun = type == PTHREAD_MUTEX_ADAPTIVE_NP;
+      if (!spun || !profile_spin (mutex, e, &spins))
+	{
+	  /* Like __lll_lock_wait, counting the sleeps.  */
+	  int *futex = &mutex->__data.__lock;
+	  int private = PTHREAD_MUTEX_PSHARED (mutex);
+	  if (atomic_load_relaxed (futex) == 2)
+	    goto futex;
+
+	  while (atomic_exchange_acquire (futex, 2) != 0)
+	    {
+	    futex:
+	      LIBC_PROBE (lll_lock_wait, 1, futex);
+	      sleeps++;
+	      futex_wait ((unsigned int *) futex, 2, private);
+	    }
+	}
+      HP_TIMING_NOW (end);
+      wait = end - start;
+    }
+
+  assert (mutex->__data.__owner == 0);
+  if (type == PTHREAD_MUTEX_RECURSIVE_NP)
+    mutex->__data.__count = 1;
+
+  /* Record the ownership.  */
+  mutex->__data.__owner = id;
+  ++mutex->__data.__nusers;
+
+  /* The estimate is updated once the mutex is acquired, like __spins in
+     pthread_mutex_lock.c.  */
+  if (spun)
+    {
+      if (e != NULL)
+	atomic_store_relaxed (&e->spins, spins);
+      else
+	mutex->__data.__spins = spins;
+    }
+
+  if (e != NULL)
+    {
+      e->acquired++;
+      if (contended)
+	{
+	  e->contended++;
+	  e->sleeps += sleeps;
+	  e->wait += wait;
+	}
+      e->holder = id;
+      HP_TIMING_NOW (e->hold_start);
+    }
+
+  LIBC_PROBE (mutex_acquired, 1, mutex);
+
+  return 0;
+}
+
+/* Called by every path of __pthread_mutex_unlock_usercnt which releases
+   a mutex of a kind which __pthread_mutex_lock_profile acquires.  */
+void
+__pthread_mutex_profile_release (pthread_mutex_t *mutex)
+{
+  pid_t id = THREAD_GETMEM (THREAD_SELF, tid);
+  size_t h = profile_hash (mutex);
+  for (size_t i = 0; i < PROFILE_PROBES; i++)
+    {
+      struct mutex_profile *e = &profile_table[(h + i) & (PROFILE_SIZE - 1)];
+      pthread_mutex_t *m = atomic_load_acquire (&e->mutex);
+      if (m == NULL)
+	/* The mutex was not acquired through __pthread_mutex_lock_profile,
+	   for example with pthread_mutex_trylock.  */
+	return;
+      if (m == mutex && e->holder == id)
+	{
+	  hp_timing_t now;
+	  HP_TIMING_NOW (now);
+	  hp_timing_t held = now - e->hold_start;
+	  e->hold += held;
+	  if (held > e->max_hold)
+	    e->max_hold = held;
+	  e->holder = 0;
+	  return;
+	}
+    }
+}
+
+/* Called by pthread_mutex_destroy to turn the entries of MUTEX into
+   tombstones, so that they do not fill the table and a new mutex at the
+   same address starts with fresh statistics.  */
+void
+__pthread_mutex_profile_destroy (pthread_mutex_t *mutex)
+{
+  size_t h = profile_hash (mutex);
+  for (size_t i = 0; i < PROFILE_PROBES; i++)
+    {
+      struct mutex_profile *e = &profile_table[(h + i) & (PROFILE_SIZE - 1)];
+      pthread_mutex_t *m = atomic_load_relaxed (&e->mutex);
+      if (m == NULL)
+	return;
+      if (m == mutex)
+	{
+	  /* The report skips the entries without a site.  */
+	  atomic_store_relaxed (&e->site, NULL);
+	  atomic_store_release (&e->mutex, PROFILE_DESTROYED);
+	}
+    }
+}
+
+static char *
+profile_put_number (char *p, const char *label, uint64_t value,
+		    unsigned int base)
+{
+  char buf[24];
+  char *end = buf + sizeof (buf);
+  char *s = _itoa (value, end, base, 0);
+  p = __stpcpy (p, label);
+  if (base == 16)
+    p = __mempcpy (p, "0x", 2);
+  return __mempcpy (p, s, end - s);
+}
+
+/* Write the entries to standard error, followed by the memory map of the
+   process to symbolize the call sites.  This is async-signal-safe, so the
+   entries of mutexes held by other threads may be written while they
+   are updated.  */
+static void
+profile_report (void *closure)
+{
+  char line[256];
+  char *p;
+  size_t entries = 0;
+
+  for (size_t i = 0; i < PROFILE_SIZE; i++)
+    if (atomic_load_relaxed (&profile_table[i].site) != NULL)
+      entries++;
+  p = profile_put_number (line, "mutex profile: ", entries, 10);
+  p = profile_put_number (p, " entries, ",
+			  atomic_load_relaxed (&profile_dropped), 10);
+  p = __stpcpy (p, " dropped\n");
+  __write_nocancel (STDERR_FILENO, line, p - line);
+
+  for (size_t i = 0; i < PROFILE_SIZE; i++)
+    {
+      struct mutex_profile *e = &profile_table[i];
+      void *site = atomic_load_acquire (&e->site);
+      if (site == NULL)
+	continue;
+      p = profile_put_number (line, "", (uintptr_t) e->mutex, 16);
+      p = profile_put_number (p, " ", (uintptr_t) site, 16);
+      p = profile_put_number (p, " acquired ", e->acquired, 10);
+      p = profile_put_number (p, " contended ", e->contended, 10);
+      p = profile_put_number (p, " sleeps ", e->sleeps, 10);
+      p = profile_put_number (p, " wait ", e->wait, 10);
+      p = profile_put_number (p, " hold ", e->hold, 10);
+      p = profile_put_number (p, " max_hold ", e->max_hold, 10);
+      p = profile_put_number (p, " spins ", atomic_load_relaxed (&e->spins),
+			      10);
+      *p++ = '\n';
+      __write_nocancel (STDERR_FILENO, line, p - line);
+    }
+
+  static const char mapped[] = "MAPPED_LIBRARIES:\n";
+  __write_nocancel (STDERR_FILENO, mapped, sizeof (mapped) - 1);
+  int fd = __open_nocancel ("/proc/self/maps", O_RDONLY | O_CLOEXEC);
+  if (fd >= 0)
+    {
+      char buf[1024];
+      ssize_t len;
+      while ((len = __read_nocancel (fd, buf, sizeof (buf))) > 0)
+	__write_nocancel (STDERR_FILENO, buf, len);
+      __close_nocancel_nostatus (fd);
+    }
+}
+
+static void
+profile_signal (int sig)
+{
+  int saved_errno = errno;
+  profile_report (NULL);
+  __set_errno (saved_errno);
+}
+
+/* Called by __pthread_tunables_init if glibc.pthread.mutex_profile is
+   set, before any thread is created.  */
+void
+__pthread_mutex_profile_init (void)
+{
+  void *table = __mmap (NULL, PROFILE_SIZE * sizeof (struct mutex_profile),
+			PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+			-1, 0);
+  if (table == MAP_FAILED)
+    {
+      __mutex_aconf.profile = 0;
+      return;
+    }
+  profile_table = table;
+
+  __cxa_atexit (profile_report, NULL, NULL);
+
+  if (__mutex_aconf.profile_signal != 0)
+    {
+      struct sigaction sa = { .sa_handler = profile_signal,
+			      .sa_flags = SA_RESTART };
+      __sigemptyset (&sa.sa_mask);
+      /* Unlike __libc_sigaction, this rejects the signals used internally
+	 by the library.  */
+      __sigaction (__mutex_aconf.profile_signal, &sa, NULL);
+    }
+}
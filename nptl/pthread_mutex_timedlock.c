@@ -79,6 +79,9 @@ __pthread_mutex_clocklock_common (pthread_mutex_t *mutex,
       [[fallthrough]];
 
     case PTHREAD_MUTEX_TIMED_NP:
+    /* Waiters with a timeout do not queue up, since they could not leave
+       the queue when it expires.  */
+    case PTHREAD_MUTEX_QUEUED_NP:
       /* Normal mutex.  */
       result = __futex_clocklock64 (&mutex->__data.__lock, clockid, abstime,
                                     PTHREAD_MUTEX_PSHARED (mutex));
@@ -57,6 +57,8 @@ __pthread_mutex_unlock_usercnt (pthread_mutex_t *mutex, int decr)
     {
       /* Always reset the owner field.  */
     normal:
+      if (__glibc_unlikely (__mutex_aconf.profile))
+	__pthread_mutex_profile_release (mutex);
       mutex->__data.__owner = 0;
       if (decr)
 	/* One less user.  */
@@ -342,6 +344,17 @@ __pthread_mutex_unlock_full (pthread_mutex_t *mutex, int decr)
 
       return __pthread_tpp_change_priority (oldprio, -1);
 
+    case PTHREAD_MUTEX_QUEUED_NP:
+      /* The queue is only used to acquire the mutex: the head of the queue
+	 spins on the lock, so unlocking is the same as for normal mutexes.
+	 Queued mutexes are always private.  */
+      mutex->__data.__owner = 0;
+      if (decr)
+	/* One less user.  */
+	--mutex->__data.__nusers;
+      lll_unlock (mutex->__data.__lock, LLL_PRIVATE);
+      break;
+
     default:
       /* Correct code cannot set any other type.  */
       return EINVAL;
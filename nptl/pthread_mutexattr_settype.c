@@ -24,7 +24,8 @@ ___pthread_mutexattr_settype (pthread_mutexattr_t *attr, int kind)
 {
   struct pthread_mutexattr *iattr;
 
-  if (kind < PTHREAD_MUTEX_NORMAL || kind > PTHREAD_MUTEX_ADAPTIVE_NP)
+  if ((kind < PTHREAD_MUTEX_NORMAL || kind > PTHREAD_MUTEX_ADAPTIVE_NP)
+      && kind != PTHREAD_MUTEX_QUEUED_NP)
     return EINVAL;
 
   iattr = (struct pthread_mutexattr *) attr;
@@ -24,6 +24,7 @@
 #include <stap-probe.h>
 #include <atomic.h>
 #include <futex-internal.h>
+#include <hp-timing.h>
 #include <time.h>
 
 
@@ -205,6 +206,31 @@
    waiting thread because the waiting thread came first.
 
 
+   The PTHREAD_RWLOCK_READER_BIASED_NP kind adds a reader bias on top of
+   the lock described above, which behaves as with
+   PTHREAD_RWLOCK_PREFER_WRITER_NP.  Even with no writers at all, the
+   atomic addition on __readers of every rdlock and rdunlock makes the
+   cache line of the lock bounce between the CPUs of the readers.  While
+   the bias (__rbias) is enabled, readers instead record the lock in one of
+   the PTHREAD_RWLOCK_READER_SLOTS reader slots of their thread descriptor,
+   and do not write to the lock at all.  A writer first acquires the lock
+   as usual, which stops readers from acquiring it through __readers, then
+   revokes the bias and waits until no thread has the lock in its reader
+   slots anymore (see pthread_rwlock_revoke_bias.c), sleeping on __rbias
+   while it waits.  Readers that release a slot while a writer waits wake it
+   up.  The slots are allocated from a registry that writers can scan
+   without a lock (see pthread_rwlock_readers.c).  Readers that find the
+   bias disabled acquire the lock through __readers, and enable the bias
+   again once they hold the lock, unless a writer revoked the bias very
+   recently (__rbias_inhibit): the time spent revoking the bias is bounded
+   that way to a fraction of the time spent by writers.  The bias is never
+   enabled for process-shared locks, because writers cannot see the reader
+   slots of the threads of other processes.
+   A thread that read-locks the lock again while it has it in a reader slot
+   only increments the depth of that slot, even if the bias was revoked in
+   the meantime: the writer revoking the bias waits for this thread, so
+   acquiring the lock through __readers would deadlock.
+
    POSIX allows but does not require rwlock acquisitions to be a cancellation
    point.  We do not support cancellation.  */
 
@@ -271,9 +297,132 @@ __pthread_rwlock_rdunlock (pthread_rwlock_t *rwlock)
 }
 
 
+/* Clear the reader slot SLOT, in which the calling thread recorded
+   RWLOCK, and wake up the writer revoking the bias of RWLOCK, if any.  */
+static __always_inline void
+__pthread_rwlock_release_slot (pthread_rwlock_t *rwlock,
+			       pthread_rwlock_t **slot)
+{
+  /* Release MO so that a writer waiting for the slot synchronizes with
+     the critical section of this reader.  */
+  atomic_store_release (slot, NULL);
+  /* See __pthread_rwlock_revoke_bias.  */
+  atomic_thread_fence_seq_cst ();
+  unsigned int rbias = atomic_load_relaxed (&rwlock->__data.__rbias);
+  if (__glibc_likely (rbias != PTHREAD_RWLOCK_RBIAS_REVOKING))
+    return;
+  /* Do not overwrite the bias if the writer gave up and enabled it
+     again.  */
+  while (!atomic_compare_exchange_weak_relaxed (&rwlock->__data.__rbias,
+						&rbias,
+						PTHREAD_RWLOCK_RBIAS_DISABLED))
+    if (rbias != PTHREAD_RWLOCK_RBIAS_REVOKING)
+      return;
+  futex_wake (&rwlock->__data.__rbias, 1, FUTEX_PRIVATE);
+}
+
+/* Read-lock RWLOCK through one of the reader slots of the calling thread,
+   if the bias of RWLOCK is enabled or the slot records a previous read lock
+   of the thread.  Return whether the lock was acquired.  */
+static __always_inline bool
+__pthread_rwlock_rdlock_biased (pthread_rwlock_t *rwlock)
+{
+  struct pthread_rwlock_readers *readers
+    = THREAD_GETMEM (THREAD_SELF, rwlock_readers);
+  int slot = -1;
+
+  if (__glibc_unlikely (readers == NULL))
+    {
+      if (atomic_load_relaxed (&rwlock->__data.__rbias)
+	  != PTHREAD_RWLOCK_RBIAS_ENABLED)
+	return false;
+      readers = __pthread_rwlock_readers_alloc ();
+      if (readers == NULL)
+	return false;
+    }
+
+  /* Only this thread modifies its slots.  */
+  for (int i = 0; i < PTHREAD_RWLOCK_READER_SLOTS; i++)
+    {
+      if (readers->slots[i].lock == rwlock)
+	{
+	  readers->slots[i].depth++;
+	  return true;
+	}
+      if (slot < 0 && readers->slots[i].lock == NULL)
+	slot = i;
+    }
+  if (slot < 0
+      || atomic_load_relaxed (&rwlock->__data.__rbias)
+	 != PTHREAD_RWLOCK_RBIAS_ENABLED)
+    return false;
+
+  readers->slots[slot].depth = 1;
+  atomic_store_relaxed (&readers->slots[slot].lock, rwlock);
+  /* See __pthread_rwlock_revoke_bias.  The acquire MO load synchronizes
+     with the reader that enabled the bias, and so with the previous
+     writer.  */
+  atomic_thread_fence_seq_cst ();
+  if (__glibc_likely (atomic_load_acquire (&rwlock->__data.__rbias)
+		      == PTHREAD_RWLOCK_RBIAS_ENABLED))
+    return true;
+
+  /* A writer may already wait for this slot.  */
+  __pthread_rwlock_release_slot (rwlock, &readers->slots[slot].lock);
+  return false;
+}
+
+/* Release a read lock of RWLOCK acquired by __pthread_rwlock_rdlock_biased.
+   Return false if the calling thread does not have RWLOCK in its reader
+   slots.  */
+static __always_inline bool
+__pthread_rwlock_rdunlock_biased (pthread_rwlock_t *rwlock)
+{
+  struct pthread_rwlock_readers *readers
+    = THREAD_GETMEM (THREAD_SELF, rwlock_readers);
+  if (readers == NULL)
+    return false;
+
+  for (int i = 0; i < PTHREAD_RWLOCK_READER_SLOTS; i++)
+    if (readers->slots[i].lock == rwlock)
+      {
+	if (--readers->slots[i].depth == 0)
+	  __pthread_rwlock_release_slot (rwlock, &readers->slots[i].lock);
+	return true;
+      }
+  return false;
+}
+
+/* Enable the bias of RWLOCK, which the calling thread has read-locked
+   through __readers, unless a writer revoked it recently.  */
+static __always_inline void
+__pthread_rwlock_enable_bias (pthread_rwlock_t *rwlock)
+{
+  if (atomic_load_relaxed (&rwlock->__data.__rbias)
+      != PTHREAD_RWLOCK_RBIAS_DISABLED
+      || rwlock->__data.__shared != 0)
+    return;
+
+  /* The bias is inhibited if __rbias_inhibit is after the current time, by
+     at most PTHREAD_RWLOCK_RBIAS_INHIBIT_MAX (the time wraps around).  */
+  hp_timing_t now;
+  HP_TIMING_NOW (now);
+  unsigned int until = atomic_load_relaxed (&rwlock->__data.__rbias_inhibit);
+  if (until - (unsigned int) (now >> PTHREAD_RWLOCK_RBIAS_TIME_SHIFT) - 1
+      < PTHREAD_RWLOCK_RBIAS_INHIBIT_MAX)
+    return;
+
+  /* Release MO so that readers acquiring the lock through the bias
+     synchronize with the writer that this thread synchronized with.  */
+  atomic_store_release (&rwlock->__data.__rbias,
+			PTHREAD_RWLOCK_RBIAS_ENABLED);
+}
+
+
 static __always_inline int
-__pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
-                                const struct __timespec64 *abstime)
+__pthread_rwlock_rdlock_unbiased64 (pthread_rwlock_t *rwlock,
+				    clockid_t clockid,
+				    const struct __timespec64 *abstime)
 {
   unsigned int r;
 
@@ -579,8 +728,25 @@ __pthread_rwlock_wrunlock (pthread_rwlock_t *rwlock)
 
 
 static __always_inline int
-__pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
+__pthread_rwlock_rdlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
                                 const struct __timespec64 *abstime)
+{
+  if (rwlock->__data.__flags != PTHREAD_RWLOCK_READER_BIASED_NP)
+    return __pthread_rwlock_rdlock_unbiased64 (rwlock, clockid, abstime);
+
+  if (__pthread_rwlock_rdlock_biased (rwlock))
+    return 0;
+  int result = __pthread_rwlock_rdlock_unbiased64 (rwlock, clockid, abstime);
+  if (result == 0)
+    __pthread_rwlock_enable_bias (rwlock);
+  return result;
+}
+
+
+static __always_inline int
+__pthread_rwlock_wrlock_unbiased64 (pthread_rwlock_t *rwlock,
+				    clockid_t clockid,
+				    const struct __timespec64 *abstime)
 {
   /* Make sure any passed in clockid and timeout value are valid.  Note that
      the previous implementation assumed that this check *must* not be
@@ -942,3 +1108,22 @@ __pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
 			THREAD_GETMEM (THREAD_SELF, tid));
   return 0;
 }
+
+
+static __always_inline int
+__pthread_rwlock_wrlock_full64 (pthread_rwlock_t *rwlock, clockid_t clockid,
+                                const struct __timespec64 *abstime)
+{
+  int result = __pthread_rwlock_wrlock_unbiased64 (rwlock, clockid, abstime);
+  /* Only readers of reader-biased locks set __rbias, while holding the
+     lock, so acquiring the lock makes the last value visible.  */
+  if (result == 0
+      && __glibc_unlikely (atomic_load_relaxed (&rwlock->__data.__rbias)
+			   != PTHREAD_RWLOCK_RBIAS_DISABLED))
+    {
+      result = __pthread_rwlock_revoke_bias (rwlock, clockid, abstime, true);
+      if (result != 0)
+	__pthread_rwlock_wrunlock (rwlock);
+    }
+  return result;
+}
@@ -0,0 +1,148 @@
+/* Reader slots of reader-biased rwlocks.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <sys/mman.h>
+#include <futex-internal.h>
+#include <ldsodefs.h>
+#include <pthreadP.h>
+
+/* A thread gets its block of reader slots the first time it read-locks a
+   reader-biased rwlock, and returns it to the free list when it exits.
+   The blocks are allocated a page at a time and never unmapped, so that a
+   writer can look for the readers of an rwlock by walking the list of all
+   the blocks without taking a lock, while threads are created and exit
+   concurrently.  */
+static struct
+{
+  /* Protects FREE and the allocation of new blocks.  */
+  int lock;
+  /* All the blocks, linked through their NEXT fields.  Accessed
+     atomically, and only ever extended at its head.  */
+  struct pthread_rwlock_readers *all;
+  /* The blocks not used by any thread, linked through their NEXT_FREE
+     fields.  */
+  struct pthread_rwlock_readers *free;
+} registry = { .lock = LLL_LOCK_INITIALIZER };
+
+/* Allocate a page of blocks and add them to the registry.  Called with
+   the registry lock held.  */
+static bool
+registry_grow (void)
+{
+  size_t pagesize = GLRO (dl_pagesize);
+  struct pthread_rwlock_readers *blocks
+    = __mmap (NULL, pagesize, PROT_READ | PROT_WRITE,
+	      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (blocks == MAP_FAILED)
+    return false;
+
+  size_t n = pagesize / sizeof (*blocks);
+  for (size_t i = 0; i < n; i++)
+    {
+      blocks[i].next = i + 1 < n ? &blocks[i + 1] : registry.all;
+      blocks[i].next_free = i + 1 < n ? &blocks[i + 1] : registry.free;
+    }
+  /* Release MO so that writers walking the list see the NEXT fields.  */
+  atomic_store_release (&registry.all, blocks);
+  registry.free = blocks;
+  return true;
+}
+
+/* Give the calling thread a block of reader slots.  Return NULL if no
+   memory is available, in which case the thread acquires reader-biased
+   rwlocks through their reader count.  */
+struct pthread_rwlock_readers *
+__pthread_rwlock_readers_alloc (void)
+{
+  struct pthread_rwlock_readers *readers = NULL;
+
+  lll_lock (registry.lock, LLL_PRIVATE);
+  if (registry.free != NULL || registry_grow ())
+    {
+      readers = registry.free;
+      registry.free = readers->next_free;
+    }
+  lll_unlock (registry.lock, LLL_PRIVATE);
+
+  THREAD_SETMEM (THREAD_SELF, rwlock_readers, readers);
+  return readers;
+}
+
+/* Called when thread PD terminates, to put its reader slots back on the
+   free list.  */
+void
+__pthread_rwlock_readers_release (struct pthread *pd)
+{
+  struct pthread_rwlock_readers *readers = pd->rwlock_readers;
+  if (readers == NULL)
+    return;
+
+  /* A thread which exits while holding a read lock does not block the
+     writers forever.  Wake up a writer waiting for the slot, as in
+     __pthread_rwlock_release_slot.  */
+  for (int i = 0; i < PTHREAD_RWLOCK_READER_SLOTS; i++)
+    {
+      pthread_rwlock_t *rwlock = readers->slots[i].lock;
+      if (rwlock == NULL)
+	continue;
+      atomic_store_release (&readers->slots[i].lock, NULL);
+      atomic_thread_fence_seq_cst ();
+      unsigned int rbias = atomic_load_relaxed (&rwlock->__data.__rbias);
+      while (rbias == PTHREAD_RWLOCK_RBIAS_REVOKING
+	     && !atomic_compare_exchange_weak_relaxed
+		   (&rwlock->__data.__rbias, &rbias,
+		    PTHREAD_RWLOCK_RBIAS_DISABLED))
+	;
+      if (rbias == PTHREAD_RWLOCK_RBIAS_REVOKING)
+	futex_wake (&rwlock->__data.__rbias, 1, FUTEX_PRIVATE);
+    }
+
+  /* Remove the block from the thread before it becomes visible on the
+     free list, so that a fork in the meantime at worst leaks it.  */
+  pd->rwlock_readers = NULL;
+  atomic_thread_fence_seq_cst ();
+
+  lll_lock (registry.lock, LLL_PRIVATE);
+  readers->next_free = registry.free;
+  registry.free = readers;
+  lll_unlock (registry.lock, LLL_PRIVATE);
+}
+
+/* Whether any thread holds RWLOCK through one of its reader slots.  */
+bool
+__pthread_rwlock_readers_hold (pthread_rwlock_t *rwlock)
+{
+  for (struct pthread_rwlock_readers *readers
+	 = atomic_load_acquire (&registry.all);
+       readers != NULL; readers = readers->next)
+    for (int i = 0; i < PTHREAD_RWLOCK_READER_SLOTS; i++)
+      /* Acquire MO synchronizes with the release of the slot by the
+	 reader, so that its critical section happens before the
+	 writer's.  */
+      if (atomic_load_acquire (&readers->slots[i].lock) == rwlock)
+	return true;
+  return false;
+}
+
+/* Reset the registry lock in the child of fork, in case another thread
+   held it.  The blocks of the other threads are not reused.  */
+void
+__pthread_rwlock_readers_fork_subprocess (void)
+{
+  registry.lock = LLL_LOCK_INITIALIZER;
+}
@@ -0,0 +1,95 @@
+/* Revoke the bias of a reader-biased rwlock.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <time.h>
+#include <futex-internal.h>
+#include <hp-timing.h>
+#include <pthreadP.h>
+
+/* Called by a writer that acquired RWLOCK while its bias was enabled.
+   Disable the bias and wait for the readers that acquired RWLOCK through
+   their reader slots (see pthread_rwlock_common.c) to release it, sleeping
+   on __rbias until a reader that releases its slot wakes us up.  If WAIT
+   is false, return EBUSY instead of waiting; if ABSTIME is not NULL,
+   return ETIMEDOUT if the readers do not release the lock before ABSTIME,
+   measured against CLOCKID.  The bias is enabled again in both cases, and
+   the caller, which still owns the write lock, must release it.  */
+int
+__pthread_rwlock_revoke_bias (pthread_rwlock_t *rwlock, clockid_t clockid,
+			      const struct __timespec64 *abstime, bool wait)
+{
+  hp_timing_t start, end;
+  HP_TIMING_NOW (start);
+
+  atomic_store_relaxed (&rwlock->__data.__rbias,
+			PTHREAD_RWLOCK_RBIAS_DISABLED);
+  /* Readers publish their slot and then check the bias, and we clear the
+     bias and then check the slots: with the fences on both sides, either
+     the reader sees the bias cleared and backs off, or we see its slot.  */
+  atomic_thread_fence_seq_cst ();
+
+  while (__pthread_rwlock_readers_hold (rwlock))
+    {
+      int result = 0;
+      if (!wait)
+	result = EBUSY;
+      else
+	{
+	  /* Readers release their slot and then check whether we wait, and
+	     we announce that we wait and then check the slots again: either
+	     the last reader sees that we wait and wakes us up, or we see
+	     that it released its slot.  */
+	  atomic_store_relaxed (&rwlock->__data.__rbias,
+				PTHREAD_RWLOCK_RBIAS_REVOKING);
+	  atomic_thread_fence_seq_cst ();
+	  if (!__pthread_rwlock_readers_hold (rwlock))
+	    break;
+	  /* Reader-biased locks are never process-shared.  */
+	  int err = __futex_abstimed_wait64 (&rwlock->__data.__rbias,
+					     PTHREAD_RWLOCK_RBIAS_REVOKING,
+					     clockid, abstime, FUTEX_PRIVATE);
+	  if (err == ETIMEDOUT || err == EOVERFLOW)
+	    result = err;
+	}
+      if (result != 0)
+	{
+	  /* Later writers would not look for the readers that still hold
+	     the lock through their slots, so enable the bias again.
+	     Release MO as in __pthread_rwlock_enable_bias.  */
+	  atomic_store_release (&rwlock->__data.__rbias,
+				PTHREAD_RWLOCK_RBIAS_ENABLED);
+	  return result;
+	}
+    }
+  atomic_store_relaxed (&rwlock->__data.__rbias,
+			PTHREAD_RWLOCK_RBIAS_DISABLED);
+
+  /* Do not let the readers enable the bias again for some time, so that
+     the revocations take a bounded fraction of the time of the writers.  */
+  HP_TIMING_NOW (end);
+  hp_timing_t inhibit = ((end - start) >> PTHREAD_RWLOCK_RBIAS_TIME_SHIFT)
+			* PTHREAD_RWLOCK_RBIAS_INHIBIT_FACTOR;
+  if (inhibit > PTHREAD_RWLOCK_RBIAS_INHIBIT_MAX)
+    inhibit = PTHREAD_RWLOCK_RBIAS_INHIBIT_MAX;
+  atomic_store_relaxed (&rwlock->__data.__rbias_inhibit,
+			(unsigned int) ((end >> PTHREAD_RWLOCK_RBIAS_TIME_SHIFT)
+					+ inhibit));
+
+  return 0;
+}
@@ -36,6 +36,10 @@ ___pthread_rwlock_tryrdlock (pthread_rwlock_t *rwlock)
      Because POSIX does not require a failed trylock to "synchronize memory",
      relaxed MO is sufficient here and on the failure path of the CAS
      below.  */
+  bool biased = rwlock->__data.__flags == PTHREAD_RWLOCK_READER_BIASED_NP;
+  if (biased && __pthread_rwlock_rdlock_biased (rwlock))
+    return 0;
+
   unsigned int r = atomic_load_relaxed (&rwlock->__data.__readers);
   unsigned int rnew;
   do
@@ -111,6 +115,9 @@ ___pthread_rwlock_tryrdlock (pthread_rwlock_t *rwlock)
 	}
     }
 
+  if (biased)
+    __pthread_rwlock_enable_bias (rwlock);
+
   return 0;
 
 
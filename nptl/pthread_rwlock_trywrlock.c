@@ -19,6 +19,7 @@
 #include "pthreadP.h"
 #include <atomic.h>
 #include <shlib-compat.h>
+#include "pthread_rwlock_common.c"
 
 /* See pthread_rwlock_common.c for an overview.  */
 int
@@ -57,6 +58,15 @@ ___pthread_rwlock_trywrlock (pthread_rwlock_t *rwlock)
 	    atomic_store_relaxed (&rwlock->__data.__wrphase_futex, 1);
 	  atomic_store_relaxed (&rwlock->__data.__cur_writer,
 	      THREAD_GETMEM (THREAD_SELF, tid));
+	  /* Fail if readers still hold the lock through the reader bias
+	     (see pthread_rwlock_common.c).  */
+	  if (__glibc_unlikely (atomic_load_relaxed (&rwlock->__data.__rbias)
+				!= PTHREAD_RWLOCK_RBIAS_DISABLED)
+	      && __pthread_rwlock_revoke_bias (rwlock, 0, NULL, false) != 0)
+	    {
+	      __pthread_rwlock_wrunlock (rwlock);
+	      return EBUSY;
+	    }
 	  return 0;
 	}
       /* TODO Back-off.  */
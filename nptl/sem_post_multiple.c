@@ -0,0 +1,82 @@
+/* sem_post_multiple -- post several tokens to a POSIX semaphore.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.	 See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <atomic.h>
+#include <errno.h>
+#include <sysdep.h>
+#include <futex-internal.h>
+#include <internaltypes.h>
+#include <semaphore.h>
+
+
+/* Like sem_post, but add COUNT tokens at once, and wake as many waiters
+   with a single futex call.  See sem_wait for an explanation of the
+   algorithm.  */
+int
+sem_post_multiple (sem_t *sem, unsigned int count)
+{
+  struct new_sem *isem = (struct new_sem *) sem;
+  int private = isem->private;
+
+  if (count == 0)
+    return 0;
+
+#if USE_64B_ATOMICS_ON_SEM_T
+  /* Add the tokens to the semaphore.  We use release MO for the same
+     reasons as sem_post.  */
+  uint64_t d = atomic_load_relaxed (&isem->data);
+  do
+    {
+      if (count > SEM_VALUE_MAX - (d & SEM_VALUE_MASK))
+	{
+	  __set_errno (EOVERFLOW);
+	  return -1;
+	}
+    }
+  while (!atomic_compare_exchange_weak_release (&isem->data, &d, d + count));
+
+  /* Wake one waiter per token, but not more than there are potentially
+     blocked waiters.  We must not access the semaphore anymore after the
+     tokens have been added, so use the number of waiters that was read
+     atomically with the addition.  */
+  uint64_t nwaiters = d >> SEM_NWAITERS_SHIFT;
+  if (nwaiters > 0)
+    futex_wake (((unsigned int *) &isem->data) + SEM_VALUE_OFFSET,
+		nwaiters < count ? nwaiters : count, private);
+#else
+  /* Add the tokens to the semaphore.  Similar to 64b version.  */
+  unsigned int v = atomic_load_relaxed (&isem->value);
+  do
+    {
+      if (count > SEM_VALUE_MAX - (v >> SEM_VALUE_SHIFT))
+	{
+	  __set_errno (EOVERFLOW);
+	  return -1;
+	}
+    }
+  while (!atomic_compare_exchange_weak_release
+	 (&isem->value, &v, v + (count << SEM_VALUE_SHIFT)));
+
+  /* If there is any potentially blocked waiter, wake up to one waiter per
+     token.  The number of waiters is not known here.  */
+  if ((v & SEM_NWAITERS_MASK) != 0)
+    futex_wake (&isem->value, count, private);
+#endif
+
+  return 0;
+}
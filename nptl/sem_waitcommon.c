@@ -22,9 +22,11 @@
 #include <futex-internal.h>
 #include <internaltypes.h>
 #include <semaphore.h>
+#include <sys/param.h>
 #include <sys/time.h>
 
 #include <pthreadP.h>
+#include <pthread_mutex_backoff.h>
 #include <shlib-compat.h>
 #include <atomic.h>
 
@@ -75,7 +77,15 @@
    it will have to clean up by waking any other sem_wait call (i.e., what
    sem_post would do otherwise).  This does not conflict with the destruction
    requirement because the semaphore must not be destructed while any sem_wait
-   is still executing.  */
+   is still executing.
+
+   Before blocking, sem_wait spins for a while in case a token is posted
+   soon, like adaptive mutexes do (see pthread_mutex_lock).  It does not
+   register as a waiter while spinning, so that sem_post does not need to
+   wake it.  The number of spins is bounded by the
+   glibc.pthread.sem_spin_count tunable and adapts to the time the previous
+   sem_wait calls needed to get a token, which is estimated in the spins
+   field.  */
 
 #if !USE_64B_ATOMICS_ON_SEM_T
 static void
@@ -158,6 +168,46 @@ __new_sem_wait_fast (struct new_sem *sem, int definitive_result)
 #endif
 }
 
+/* Spin until a token can be grabbed, or give up after a number of spins
+   based on the estimate of the previous calls.  Return 0 if we grabbed a
+   token.  */
+static int
+__new_sem_wait_spin (struct new_sem *sem)
+{
+  int max_spin_count = __mutex_aconf.sem_spin_count;
+  if (max_spin_count == 0)
+    return -1;
+
+  /* The estimate is only a hint, so relaxed MO is sufficient and races
+     with other waiters updating it are benign.  */
+  int spins = atomic_load_relaxed (&sem->spins);
+  int max_cnt = MIN (max_spin_count, spins * 2 + 10);
+  int cnt = 0;
+  int spin_count, exp_backoff = 1;
+  unsigned int jitter = get_jitter ();
+  int err;
+  do
+    {
+      /* See pthread_mutex_lock for the exponential backoff with random
+	 jitter.  */
+      spin_count = exp_backoff + (jitter & (exp_backoff - 1));
+      cnt += spin_count;
+      if (cnt >= max_cnt)
+	{
+	  err = -1;
+	  break;
+	}
+      do
+	atomic_spin_nop ();
+      while (--spin_count > 0);
+      exp_backoff = get_next_backoff (exp_backoff);
+    }
+  while ((err = __new_sem_wait_fast (sem, 0)) != 0);
+
+  atomic_store_relaxed (&sem->spins, spins + (cnt - spins) / 8);
+  return err;
+}
+
 /* Slow path that blocks.  */
 static int
 __attribute__ ((noinline))
@@ -166,6 +216,9 @@ __new_sem_wait_slow64 (struct new_sem *sem, clockid_t clockid,
 {
   int err = 0;
 
+  if (__new_sem_wait_spin (sem) == 0)
+    return 0;
+
 #if USE_64B_ATOMICS_ON_SEM_T
   /* Add a waiter.  Relaxed MO is sufficient because we can rely on the
      ordering provided by the RMW operations we use.  */
@@ -30,8 +30,7 @@ static inline void __new_sem_open_init (struct new_sem *sem, unsigned value)
   sem->value = value << SEM_VALUE_SHIFT;
   sem->nwaiters = 0;
 #endif
-  /* pad is used as a mutex on pre-v9 sparc and ignored otherwise.  */
-  sem->pad = 0;
+  sem->spins = 0;
 
   /* This always is a shared semaphore.  */
   sem->private = FUTEX_SHARED;
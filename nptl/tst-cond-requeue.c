@@ -0,0 +1,226 @@
+/* Test moving condition variable waiters to the futex of the mutex.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* pthread_cond_signal and pthread_cond_broadcast move the waiters to the
+   futex of the mutex instead of waking them.  Check that no wake-up is
+   lost that way: waiters are woken with signals and broadcasts, with and
+   without holding the mutex, with each kind of mutex, while other threads
+   contend for the mutex without waiting on the condvar, and the condvar is
+   switched to another mutex between rounds.  Finally, check that the
+   condvar can be destroyed right after a broadcast while holding the
+   mutex.  */
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <support/check.h>
+#include <support/xthread.h>
+
+enum { waiters = 8 };
+enum { lockers = 2 };
+enum { rounds = 500 };
+
+static const int kinds[] =
+{
+  PTHREAD_MUTEX_NORMAL,
+  PTHREAD_MUTEX_RECURSIVE,
+  PTHREAD_MUTEX_ERRORCHECK,
+  PTHREAD_MUTEX_ADAPTIVE_NP,
+};
+#define NKINDS (sizeof (kinds) / sizeof (kinds[0]))
+
+/* The mutexes; the last one is process-shared, so that the waiters are not
+   moved to it.  */
+static pthread_mutex_t mutexes[NKINDS + 1];
+static pthread_mutex_t *mutex;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t done = PTHREAD_COND_INITIALIZER;
+static unsigned int generation;
+static unsigned int woken;
+static unsigned int waiting;
+static bool stop;
+static atomic_bool stop_lockers;
+
+static void *
+waiter (void *closure)
+{
+  unsigned int gen = 0;
+  while (true)
+    {
+      pthread_mutex_t *m = mutex;
+      xpthread_mutex_lock (m);
+      if (stop)
+	{
+	  xpthread_mutex_unlock (m);
+	  return NULL;
+	}
+      /* The main thread changes the mutex while all the waiters wait.  */
+      TEST_VERIFY (m == mutex);
+      if (gen != 0 && ++woken == waiters)
+	xpthread_cond_signal (&done);
+      if (++waiting == waiters)
+	xpthread_cond_signal (&done);
+      gen = generation;
+      while (generation == gen)
+	xpthread_cond_wait (&cond, m);
+      gen = generation;
+      xpthread_mutex_unlock (m);
+    }
+}
+
+/* Lock the mutexes without waiting on the condvar, so that the waiters
+   moved to their futexes compete with other threads.  */
+static void *
+locker (void *closure)
+{
+  while (!atomic_load (&stop_lockers))
+    for (int k = 0; k <= NKINDS; k++)
+      {
+	xpthread_mutex_lock (&mutexes[k]);
+	xpthread_mutex_unlock (&mutexes[k]);
+      }
+  return NULL;
+}
+
+/* Wake all the waiters, by signals or a broadcast, with or without holding
+   the mutex, and wait until they all woke up.  */
+static void
+wake_all (int how)
+{
+  xpthread_mutex_lock (mutex);
+  while (waiting < waiters)
+    xpthread_cond_wait (&done, mutex);
+  waiting = 0;
+  woken = 0;
+  generation++;
+  bool locked = how & 1;
+  if (!locked)
+    xpthread_mutex_unlock (mutex);
+  if (how & 2)
+    TEST_COMPARE (pthread_cond_broadcast (&cond), 0);
+  else
+    for (int i = 0; i < waiters; i++)
+      xpthread_cond_signal (&cond);
+  if (!locked)
+    xpthread_mutex_lock (mutex);
+  while (woken < waiters)
+    xpthread_cond_wait (&done, mutex);
+  xpthread_mutex_unlock (mutex);
+}
+
+static void *
+destroy_waiter (void *closure)
+{
+  pthread_cond_t *c = closure;
+  xpthread_mutex_lock (&mutexes[0]);
+  waiting++;
+  xpthread_cond_signal (&done);
+  while (generation == 0)
+    xpthread_cond_wait (c, &mutexes[0]);
+  xpthread_mutex_unlock (&mutexes[0]);
+  return NULL;
+}
+
+/* Destroy the condvar right after the broadcast, while holding the mutex
+   to which the waiters may have been moved.  */
+static void
+check_destroy (void)
+{
+  pthread_cond_t c;
+  pthread_t thr[waiters];
+
+  TEST_COMPARE (pthread_cond_init (&c, NULL), 0);
+  waiting = 0;
+  generation = 0;
+  for (int i = 0; i < waiters; i++)
+    thr[i] = xpthread_create (NULL, destroy_waiter, &c);
+  xpthread_mutex_lock (&mutexes[0]);
+  while (waiting < waiters)
+    xpthread_cond_wait (&done, &mutexes[0]);
+  generation = 1;
+  TEST_COMPARE (pthread_cond_broadcast (&c), 0);
+  TEST_COMPARE (pthread_cond_destroy (&c), 0);
+  xpthread_mutex_unlock (&mutexes[0]);
+  for (int i = 0; i < waiters; i++)
+    xpthread_join (thr[i]);
+}
+
+static int
+do_test (void)
+{
+  pthread_mutexattr_t attr;
+  xpthread_mutexattr_init (&attr);
+  for (int k = 0; k < NKINDS; k++)
+    {
+      xpthread_mutexattr_settype (&attr, kinds[k]);
+      xpthread_mutex_init (&mutexes[k], &attr);
+    }
+  xpthread_mutexattr_settype (&attr, PTHREAD_MUTEX_NORMAL);
+  xpthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED);
+  xpthread_mutex_init (&mutexes[NKINDS], &attr);
+  xpthread_mutexattr_destroy (&attr);
+
+  mutex = &mutexes[0];
+  pthread_t thr[waiters + lockers];
+  for (int i = 0; i < waiters; i++)
+    thr[i] = xpthread_create (NULL, waiter, NULL);
+  for (int i = 0; i < lockers; i++)
+    thr[waiters + i] = xpthread_create (NULL, locker, NULL);
+
+  for (int r = 0; r < rounds; r++)
+    {
+      wake_all (r % 4);
+      if (r % 16 == 15)
+	{
+	  /* Switch to the next mutex once all the waiters wait on the
+	     condvar.  They read the new mutex after acquiring the old one
+	     again.  */
+	  pthread_mutex_t *old = mutex;
+	  xpthread_mutex_lock (old);
+	  while (waiting < waiters)
+	    xpthread_cond_wait (&done, old);
+	  pthread_mutex_t *new = &mutexes[(old - mutexes + 1) % (NKINDS + 1)];
+	  xpthread_mutex_lock (new);
+	  mutex = new;
+	  /* Move the waiters to the new mutex.  */
+	  waiting = 0;
+	  woken = 0;
+	  generation++;
+	  xpthread_mutex_unlock (new);
+	  TEST_COMPARE (pthread_cond_broadcast (&cond), 0);
+	  xpthread_mutex_unlock (old);
+	}
+    }
+
+  xpthread_mutex_lock (mutex);
+  stop = true;
+  generation++;
+  TEST_COMPARE (pthread_cond_broadcast (&cond), 0);
+  xpthread_mutex_unlock (mutex);
+  atomic_store (&stop_lockers, true);
+  for (int i = 0; i < waiters + lockers; i++)
+    xpthread_join (thr[i]);
+
+  check_destroy ();
+
+  return 0;
+}
+
+#include <support/test-driver.c>
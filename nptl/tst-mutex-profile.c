@@ -0,0 +1,189 @@
+/* Test the mutex profiler (glibc.pthread.mutex_profile tunable).
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* A subprocess locks mutexes of each profiled kind from several threads,
+   writes the profile with the signal set by the tunables, and exits,
+   which writes it again.  Check that both profiles are written and that
+   the last one accounts for every acquisition with pthread_mutex_lock,
+   including one which had to wait.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <support/capture_subprocess.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+enum { threads = 4 };
+enum { iterations = 10000 };
+
+static const int kinds[] =
+{
+  PTHREAD_MUTEX_NORMAL,
+  PTHREAD_MUTEX_RECURSIVE,
+  PTHREAD_MUTEX_ERRORCHECK,
+  PTHREAD_MUTEX_ADAPTIVE_NP,
+};
+#define NKINDS (sizeof (kinds) / sizeof (kinds[0]))
+
+static pthread_mutex_t locks[NKINDS];
+static unsigned long counters[NKINDS];
+static sem_t started;
+
+static void *
+increment (void *closure)
+{
+  for (unsigned int i = 0; i < iterations; i++)
+    for (int k = 0; k < NKINDS; k++)
+      {
+	xpthread_mutex_lock (&locks[k]);
+	counters[k]++;
+	xpthread_mutex_unlock (&locks[k]);
+      }
+  return NULL;
+}
+
+static void *
+wait_for_lock (void *closure)
+{
+  sem_post (&started);
+  xpthread_mutex_lock (&locks[0]);
+  xpthread_mutex_unlock (&locks[0]);
+  return NULL;
+}
+
+static void
+subprocess (void *closure)
+{
+  for (int k = 0; k < NKINDS; k++)
+    {
+      pthread_mutexattr_t attr;
+      xpthread_mutexattr_init (&attr);
+      xpthread_mutexattr_settype (&attr, kinds[k]);
+      xpthread_mutex_init (&locks[k], &attr);
+      xpthread_mutexattr_destroy (&attr);
+    }
+
+  /* The profiler keeps the semantics of the mutex kinds.  */
+  xpthread_mutex_lock (&locks[1]);
+  xpthread_mutex_lock (&locks[1]);
+  xpthread_mutex_unlock (&locks[1]);
+  xpthread_mutex_unlock (&locks[1]);
+  xpthread_mutex_lock (&locks[2]);
+  TEST_COMPARE (pthread_mutex_lock (&locks[2]), EDEADLK);
+  xpthread_mutex_unlock (&locks[2]);
+
+  /* Hold the mutex while another thread locks it.  */
+  TEST_COMPARE (sem_init (&started, 0, 0), 0);
+  xpthread_mutex_lock (&locks[0]);
+  pthread_t thr = xpthread_create (NULL, wait_for_lock, NULL);
+  TEST_COMPARE (sem_wait (&started), 0);
+  nanosleep (&(struct timespec) { 0, 200000000 }, NULL);
+  xpthread_mutex_unlock (&locks[0]);
+  xpthread_join (thr);
+
+  pthread_t thrs[threads];
+  for (int i = 0; i < threads; i++)
+    thrs[i] = xpthread_create (NULL, increment, NULL);
+  for (int i = 0; i < threads; i++)
+    xpthread_join (thrs[i]);
+  for (int k = 0; k < NKINDS; k++)
+    TEST_COMPARE (counters[k], threads * iterations);
+
+  /* Write the addresses of the mutexes, for the parent process.  */
+  for (int k = 0; k < NKINDS; k++)
+    printf ("%p\n", &locks[k]);
+  fflush (stdout);
+
+  raise (SIGHUP);
+  exit (0);
+}
+
+/* Add the counters of the entries of MUTEX in the profile starting at
+   PROFILE.  */
+static void
+sum_entries (const char *profile, const char *mutex,
+	     unsigned long *acquired, unsigned long *contended)
+{
+  *acquired = 0;
+  *contended = 0;
+  size_t len = strlen (mutex);
+  const char *line = profile;
+  while (strncmp (line, "MAPPED_LIBRARIES:", 17) != 0)
+    {
+      if (strncmp (line, mutex, len) == 0 && line[len] == ' ')
+	{
+	  const char *p = strstr (line, " acquired ");
+	  TEST_VERIFY_EXIT (p != NULL);
+	  *acquired += strtoul (p + 10, NULL, 10);
+	  p = strstr (line, " contended ");
+	  TEST_VERIFY_EXIT (p != NULL);
+	  *contended += strtoul (p + 11, NULL, 10);
+	}
+      line = strchr (line, '\n');
+      TEST_VERIFY_EXIT (line != NULL);
+      line++;
+    }
+}
+
+static int
+do_test (void)
+{
+  struct support_capture_subprocess result
+    = support_capture_subprocess (subprocess, NULL);
+  support_capture_subprocess_check (&result, "subprocess", 0,
+				    sc_allow_stdout | sc_allow_stderr);
+
+  const char *first = strstr (result.err.buffer, "mutex profile: ");
+  TEST_VERIFY_EXIT (first != NULL);
+  const char *last = strstr (first + 1, "mutex profile: ");
+  TEST_VERIFY_EXIT (last != NULL);
+  TEST_VERIFY (strstr (last + 1, "mutex profile: ") == NULL);
+  TEST_VERIFY (strstr (last, "MAPPED_LIBRARIES:\n") != NULL);
+
+  char *mutex = result.out.buffer;
+  for (int k = 0; k < NKINDS; k++)
+    {
+      char *end = strchr (mutex, '\n');
+      TEST_VERIFY_EXIT (end != NULL);
+      *end = '\0';
+
+      unsigned long acquired, contended;
+      sum_entries (last, mutex, &acquired, &contended);
+      /* The recursive lock and the lock which failed with EDEADLK do not
+	 acquire the mutex.  */
+      static const unsigned long extra[NKINDS] = { 2, 1, 1, 0 };
+      TEST_COMPARE (acquired, threads * iterations + extra[k]);
+      if (k == 0)
+	TEST_VERIFY (contended > 0);
+
+      mutex = end + 1;
+    }
+
+  support_capture_subprocess_free (&result);
+  return 0;
+}
+
+#include <support/test-driver.c>
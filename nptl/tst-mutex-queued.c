@@ -0,0 +1,155 @@
+/* Test the PTHREAD_MUTEX_QUEUED_NP mutex type.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Many threads increment a counter protected by a queued mutex, with
+   pthread_mutex_lock, pthread_mutex_trylock and pthread_mutex_timedlock,
+   so that the queue is long and timed waiters compete with it.  Then a
+   statically initialized queued mutex is used with a condition variable,
+   which relocks it through the queue.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <support/check.h>
+#include <support/timespec.h>
+#include <support/xthread.h>
+#include <support/xtime.h>
+
+enum { threads = 16 };
+enum { iterations = 20000 };
+
+static pthread_mutex_t lock;
+static unsigned long counter;
+
+static void *
+increment (void *closure)
+{
+  uintptr_t id = (uintptr_t) closure;
+  for (unsigned int i = 0; i < iterations; i++)
+    {
+      switch ((i + id) % 8)
+	{
+	case 0:
+	  if (pthread_mutex_trylock (&lock) != 0)
+	    xpthread_mutex_lock (&lock);
+	  break;
+	case 1:
+	  {
+	    struct timespec ts = timespec_add (xclock_now (CLOCK_REALTIME),
+					       make_timespec (10, 0));
+	    TEST_COMPARE (pthread_mutex_timedlock (&lock, &ts), 0);
+	  }
+	  break;
+	default:
+	  xpthread_mutex_lock (&lock);
+	}
+      /* Not atomic: lost updates show up in the final value.  */
+      unsigned long v = counter;
+      __asm__ volatile ("" : : : "memory");
+      counter = v + 1;
+      xpthread_mutex_unlock (&lock);
+    }
+  return NULL;
+}
+
+static pthread_mutex_t cond_lock = PTHREAD_QUEUED_MUTEX_INITIALIZER_NP;
+static pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+static unsigned int items;
+static unsigned int consumed;
+
+static void *
+consumer (void *closure)
+{
+  xpthread_mutex_lock (&cond_lock);
+  while (consumed < threads * 100)
+    {
+      while (items == 0 && consumed < threads * 100)
+	xpthread_cond_wait (&cond, &cond_lock);
+      if (items > 0)
+	{
+	  items--;
+	  consumed++;
+	}
+    }
+  TEST_COMPARE (pthread_cond_broadcast (&cond), 0);
+  xpthread_mutex_unlock (&cond_lock);
+  return NULL;
+}
+
+static void
+check_attributes (void)
+{
+  pthread_mutexattr_t attr;
+  pthread_mutex_t m;
+  int kind;
+
+  xpthread_mutexattr_init (&attr);
+  xpthread_mutexattr_settype (&attr, PTHREAD_MUTEX_QUEUED_NP);
+  TEST_COMPARE (pthread_mutexattr_gettype (&attr, &kind), 0);
+  TEST_COMPARE (kind, PTHREAD_MUTEX_QUEUED_NP);
+
+  /* Robust and priority protocol mutexes do not support the queue.  */
+  xpthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_ROBUST);
+  TEST_COMPARE (pthread_mutex_init (&m, &attr), ENOTSUP);
+  xpthread_mutexattr_setrobust (&attr, PTHREAD_MUTEX_STALLED);
+  xpthread_mutexattr_setprotocol (&attr, PTHREAD_PRIO_INHERIT);
+  TEST_COMPARE (pthread_mutex_init (&m, &attr), ENOTSUP);
+  xpthread_mutexattr_setprotocol (&attr, PTHREAD_PRIO_NONE);
+
+  /* Neither do process-shared mutexes.  */
+  xpthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_SHARED);
+  TEST_COMPARE (pthread_mutex_init (&m, &attr), ENOTSUP);
+
+  xpthread_mutexattr_setpshared (&attr, PTHREAD_PROCESS_PRIVATE);
+  xpthread_mutex_init (&lock, &attr);
+  xpthread_mutexattr_destroy (&attr);
+}
+
+static int
+do_test (void)
+{
+  check_attributes ();
+
+  pthread_t thr[threads];
+  for (uintptr_t i = 0; i < threads; i++)
+    thr[i] = xpthread_create (NULL, increment, (void *) i);
+  for (int i = 0; i < threads; i++)
+    xpthread_join (thr[i]);
+  TEST_COMPARE (counter, threads * iterations);
+  xpthread_mutex_destroy (&lock);
+
+  for (int i = 0; i < threads; i++)
+    thr[i] = xpthread_create (NULL, consumer, NULL);
+  for (int i = 0; i < threads * 100; i++)
+    {
+      xpthread_mutex_lock (&cond_lock);
+      items++;
+      xpthread_cond_signal (&cond);
+      xpthread_mutex_unlock (&cond_lock);
+    }
+  for (int i = 0; i < threads; i++)
+    xpthread_join (thr[i]);
+  TEST_COMPARE (items, 0);
+  TEST_COMPARE (consumed, threads * 100);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
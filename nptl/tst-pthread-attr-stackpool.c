@@ -0,0 +1,232 @@
+/* Test the stack pool of pthread_attr_setstackpool_np.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Threads created with a stack pool must keep using the stacks of the
+   pool, even though the stack cache is disabled by the tunables and
+   threads with other stacks come and go, and must see the initial value
+   of their TLS variables.  The pools of different stack sizes are
+   independent, threads created without a stack pool never get their
+   stacks, and a pool does not shrink.  */
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <support/check.h>
+#include <support/xthread.h>
+
+enum { max_pool = 4 };
+enum { rounds = 10 };
+
+struct pool
+{
+  int count;
+  size_t stacksize;
+  pthread_attr_t attr;
+  pthread_barrier_t barrier;
+  void *stacks[max_pool];
+  void *round_stacks[max_pool];
+};
+
+static struct pool pools[] =
+  {
+    { .count = 4, .stacksize = 1024 * 1024 },
+    { .count = 2, .stacksize = 2 * 1024 * 1024 },
+  };
+enum { npools = sizeof (pools) / sizeof (pools[0]) };
+
+struct closure
+{
+  struct pool *pool;
+  int index;
+};
+
+static __thread int tls_var = 42;
+
+static void *
+get_stack (void)
+{
+  pthread_attr_t attr;
+  TEST_COMPARE (pthread_getattr_np (pthread_self (), &attr), 0);
+  void *stackaddr;
+  size_t stacksize;
+  TEST_COMPARE (pthread_attr_getstack (&attr, &stackaddr, &stacksize), 0);
+  xpthread_attr_destroy (&attr);
+  return stackaddr;
+}
+
+static void *
+pooled (void *arg)
+{
+  struct closure *closure = arg;
+
+  /* The TLS block is initialized again when the stack is reused.  */
+  TEST_COMPARE (tls_var, 42);
+  tls_var = -1;
+
+  closure->pool->round_stacks[closure->index] = get_stack ();
+
+  /* Keep all the stacks of the pool in use at the same time.  */
+  xpthread_barrier_wait (&closure->pool->barrier);
+  return NULL;
+}
+
+static void *
+other (void *closure)
+{
+  tls_var = -1;
+  return get_stack ();
+}
+
+static void
+run_round (struct pool *pool)
+{
+  pthread_t thr[max_pool];
+  struct closure closure[max_pool];
+  for (int i = 0; i < pool->count; i++)
+    {
+      closure[i] = (struct closure) { pool, i };
+      thr[i] = xpthread_create (&pool->attr, pooled, &closure[i]);
+    }
+  for (int i = 0; i < pool->count; i++)
+    xpthread_join (thr[i]);
+}
+
+static bool
+in_pool (struct pool *pool, void *stack)
+{
+  for (int i = 0; i < pool->count; i++)
+    if (pool->stacks[i] == stack)
+      return true;
+  return false;
+}
+
+static bool
+in_any_pool (void *stack)
+{
+  for (int i = 0; i < npools; i++)
+    if (in_pool (&pools[i], stack))
+      return true;
+  return false;
+}
+
+static int
+do_test (void)
+{
+  pthread_attr_t attr;
+  size_t count;
+
+  xpthread_attr_init (&attr);
+  TEST_COMPARE (pthread_attr_getstackpool_np (&attr, &count), 0);
+  TEST_COMPARE (count, 0);
+  TEST_COMPARE (pthread_attr_setstackpool_np (&attr, max_pool), 0);
+  TEST_COMPARE (pthread_attr_getstackpool_np (&attr, &count), 0);
+  TEST_COMPARE (count, max_pool);
+
+  /* The size of the pool is copied with the attribute.  */
+  TEST_COMPARE (pthread_setattr_default_np (&attr), 0);
+  pthread_attr_t def;
+  TEST_COMPARE (pthread_getattr_default_np (&def), 0);
+  TEST_COMPARE (pthread_attr_getstackpool_np (&def, &count), 0);
+  TEST_COMPARE (count, max_pool);
+  TEST_COMPARE (pthread_attr_setstackpool_np (&def, 0), 0);
+  TEST_COMPARE (pthread_attr_getstackpool_np (&def, &count), 0);
+  TEST_COMPARE (count, 0);
+  TEST_COMPARE (pthread_setattr_default_np (&def), 0);
+  xpthread_attr_destroy (&def);
+  xpthread_attr_destroy (&attr);
+
+  for (int p = 0; p < npools; p++)
+    {
+      struct pool *pool = &pools[p];
+      xpthread_attr_init (&pool->attr);
+      xpthread_attr_setstacksize (&pool->attr, pool->stacksize);
+      TEST_COMPARE (pthread_attr_setstackpool_np (&pool->attr, pool->count),
+		    0);
+      xpthread_barrier_init (&pool->barrier, NULL, pool->count);
+
+      run_round (pool);
+      for (int i = 0; i < pool->count; i++)
+	{
+	  pool->stacks[i] = pool->round_stacks[i];
+	  for (int j = 0; j < i; j++)
+	    TEST_VERIFY (pool->stacks[i] != pool->stacks[j]);
+	  for (int q = 0; q < p; q++)
+	    TEST_VERIFY (!in_pool (&pools[q], pool->stacks[i]));
+	}
+    }
+
+  /* Threads with the same stack size as the first pool but without a
+     stack pool attribute must not take the unused stacks of the pool.  */
+  xpthread_attr_init (&attr);
+  xpthread_attr_setstacksize (&attr, pools[0].stacksize);
+
+  for (int r = 1; r < rounds; r++)
+    {
+      /* These stacks are freed at once, since the cache is disabled.  */
+      for (int i = 0; i < max_pool; i++)
+	{
+	  void *stack = xpthread_join (xpthread_create (&attr, other, NULL));
+	  TEST_VERIFY (!in_any_pool (stack));
+	}
+
+      for (int p = 0; p < npools; p++)
+	{
+	  run_round (&pools[p]);
+	  for (int i = 0; i < pools[p].count; i++)
+	    TEST_VERIFY (in_pool (&pools[p], pools[p].round_stacks[i]));
+	}
+    }
+
+  /* A smaller count does not shrink the pool: the threads keep using
+     its stacks, without affecting the other pool, and all of them are
+     still there for a larger count.  */
+  struct pool *pool = &pools[0];
+  void *old_stacks[max_pool];
+  for (int i = 0; i < max_pool; i++)
+    old_stacks[i] = pool->stacks[i];
+  for (int r = 0; r < rounds; r++)
+    {
+      pool->count = r % 2 == 0 ? 2 : max_pool;
+      TEST_COMPARE (pthread_attr_setstackpool_np (&pool->attr, pool->count),
+		    0);
+      xpthread_barrier_destroy (&pool->barrier);
+      xpthread_barrier_init (&pool->barrier, NULL, pool->count);
+      run_round (pool);
+      for (int i = 0; i < pool->count; i++)
+	{
+	  bool found = false;
+	  for (int j = 0; j < max_pool; j++)
+	    found |= old_stacks[j] == pool->round_stacks[i];
+	  TEST_VERIFY (found);
+	}
+      run_round (&pools[1]);
+      for (int i = 0; i < pools[1].count; i++)
+	TEST_VERIFY (in_pool (&pools[1], pools[1].round_stacks[i]));
+    }
+
+  for (int p = 0; p < npools; p++)
+    {
+      xpthread_barrier_destroy (&pools[p].barrier);
+      xpthread_attr_destroy (&pools[p].attr);
+    }
+  xpthread_attr_destroy (&attr);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,128 @@
+/* Test pthread_lazy_init_np.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Several threads initialize the same objects in different orders, some
+   of the initializations being slow so that other threads wait for them.
+   Check that each object is initialized once and that its data is seen
+   by every thread.  Then check that a waiter runs the initialization
+   when the thread running it is cancelled.  */
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <support/check.h>
+#include <support/xthread.h>
+
+enum { threads = 8 };
+enum { objects = 1000 };
+
+static pthread_once_t controls[objects];
+static unsigned int values[objects];
+static atomic_uint calls[objects];
+
+static void
+init_object (void *closure)
+{
+  uintptr_t i = (uintptr_t) closure;
+  atomic_fetch_add (&calls[i], 1);
+  if (i % 100 == 0)
+    nanosleep (&(struct timespec) { 0, 10000000 }, NULL);
+  values[i] = i + 1;
+}
+
+static void *
+use_objects (void *closure)
+{
+  uintptr_t stride = (uintptr_t) closure * 2 + 1;
+  for (uintptr_t n = 0; n < objects; n++)
+    {
+      uintptr_t i = n * stride % objects;
+      TEST_COMPARE (pthread_lazy_init_np (&controls[i], init_object,
+					  (void *) i), 0);
+      TEST_COMPARE (values[i], i + 1);
+    }
+  return NULL;
+}
+
+static pthread_once_t cancel_control = PTHREAD_ONCE_INIT;
+static sem_t started;
+static int cancel_value;
+
+static void
+init_cancelled (void *closure)
+{
+  sem_post (&started);
+  while (true)
+    pause ();
+}
+
+static void
+init_value (void *closure)
+{
+  cancel_value = *(int *) closure;
+}
+
+static void *
+run_cancelled (void *closure)
+{
+  pthread_lazy_init_np (&cancel_control, init_cancelled, NULL);
+  FAIL_EXIT1 ("pthread_lazy_init_np returned");
+  return NULL;
+}
+
+static void *
+wait_cancelled (void *closure)
+{
+  static int value = 42;
+  sem_post (&started);
+  TEST_COMPARE (pthread_lazy_init_np (&cancel_control, init_value, &value),
+		0);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_t thr[threads];
+  for (uintptr_t i = 0; i < threads; i++)
+    thr[i] = xpthread_create (NULL, use_objects, (void *) i);
+  for (int i = 0; i < threads; i++)
+    xpthread_join (thr[i]);
+  for (int i = 0; i < objects; i++)
+    TEST_COMPARE (atomic_load (&calls[i]), 1);
+
+  TEST_COMPARE (sem_init (&started, 0, 0), 0);
+  pthread_t runner = xpthread_create (NULL, run_cancelled, NULL);
+  TEST_COMPARE (sem_wait (&started), 0);
+  pthread_t waiter = xpthread_create (NULL, wait_cancelled, NULL);
+  TEST_COMPARE (sem_wait (&started), 0);
+  /* Let the waiter block.  */
+  nanosleep (&(struct timespec) { 0, 100000000 }, NULL);
+  xpthread_cancel (runner);
+  TEST_VERIFY (xpthread_join (runner) == PTHREAD_CANCELED);
+  xpthread_join (waiter);
+  TEST_COMPARE (cancel_value, 42);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
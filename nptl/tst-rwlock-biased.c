@@ -0,0 +1,165 @@
+/* Test the PTHREAD_RWLOCK_READER_BIASED_NP rwlock kind.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Readers of reader-biased rwlocks acquire them without writing to the
+   lock, so check that writers still exclude them: first with a reader
+   that holds the lock while a writer tries to acquire it, then with
+   concurrent readers (some of them recursive) and writers.  */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <support/check.h>
+#include <support/timespec.h>
+#include <support/xtime.h>
+#include <support/xthread.h>
+
+enum { readers = 8 };
+enum { writers = 2 };
+enum { iterations = 20000 };
+
+static pthread_rwlock_t lock;
+static pthread_barrier_t barrier;
+
+static atomic_int inside_readers;
+static atomic_int inside_writers;
+static unsigned int value;
+
+static void *
+hold_read_lock (void *closure)
+{
+  /* The first read lock enables the bias, so the second one takes the
+     reader slot of the thread.  */
+  xpthread_rwlock_rdlock (&lock);
+  xpthread_rwlock_unlock (&lock);
+  xpthread_rwlock_rdlock (&lock);
+  xpthread_barrier_wait (&barrier);
+  xpthread_barrier_wait (&barrier);
+  xpthread_rwlock_unlock (&lock);
+  return NULL;
+}
+
+static void
+check_exclusion (void)
+{
+  pthread_t thr = xpthread_create (NULL, hold_read_lock, NULL);
+  xpthread_barrier_wait (&barrier);
+
+  TEST_COMPARE (pthread_rwlock_trywrlock (&lock), EBUSY);
+  struct timespec ts = timespec_add (xclock_now (CLOCK_MONOTONIC),
+				     make_timespec (0, 100000000));
+  TEST_COMPARE (pthread_rwlock_clockwrlock (&lock, CLOCK_MONOTONIC, &ts),
+		ETIMEDOUT);
+  /* Readers can still acquire the lock.  */
+  TEST_COMPARE (pthread_rwlock_tryrdlock (&lock), 0);
+  xpthread_rwlock_unlock (&lock);
+
+  xpthread_barrier_wait (&barrier);
+  xpthread_join (thr);
+
+  xpthread_rwlock_wrlock (&lock);
+  xpthread_rwlock_unlock (&lock);
+}
+
+static void
+read_value (void)
+{
+  atomic_fetch_add (&inside_readers, 1);
+  TEST_COMPARE (atomic_load (&inside_writers), 0);
+  unsigned int v = value;
+  TEST_COMPARE (v % 2, 0);
+  atomic_fetch_sub (&inside_readers, 1);
+}
+
+static void *
+reader (void *closure)
+{
+  uintptr_t id = (uintptr_t) closure;
+  for (unsigned int i = 0; i < iterations; i++)
+    {
+      if (i % 3 == 0)
+	{
+	  if (pthread_rwlock_tryrdlock (&lock) != 0)
+	    continue;
+	}
+      else
+	xpthread_rwlock_rdlock (&lock);
+      read_value ();
+      if ((i + id) % 7 == 0)
+	{
+	  xpthread_rwlock_rdlock (&lock);
+	  read_value ();
+	  xpthread_rwlock_unlock (&lock);
+	}
+      xpthread_rwlock_unlock (&lock);
+    }
+  return NULL;
+}
+
+static void *
+writer (void *closure)
+{
+  for (unsigned int i = 0; i < iterations / 100; i++)
+    {
+      if (i % 2 == 0)
+	xpthread_rwlock_wrlock (&lock);
+      else if (pthread_rwlock_trywrlock (&lock) != 0)
+	continue;
+      atomic_fetch_add (&inside_writers, 1);
+      TEST_COMPARE (atomic_load (&inside_readers), 0);
+      value++;
+      value++;
+      atomic_fetch_sub (&inside_writers, 1);
+      xpthread_rwlock_unlock (&lock);
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_rwlockattr_t attr;
+  xpthread_rwlockattr_init (&attr);
+  xpthread_rwlockattr_setkind_np (&attr, PTHREAD_RWLOCK_READER_BIASED_NP);
+  int kind;
+  TEST_COMPARE (pthread_rwlockattr_getkind_np (&attr, &kind), 0);
+  TEST_COMPARE (kind, PTHREAD_RWLOCK_READER_BIASED_NP);
+  xpthread_rwlock_init (&lock, &attr);
+  xpthread_barrier_init (&barrier, NULL, 2);
+
+  check_exclusion ();
+
+  pthread_t thr[readers + writers];
+  for (uintptr_t i = 0; i < readers; i++)
+    thr[i] = xpthread_create (NULL, reader, (void *) i);
+  for (int i = 0; i < writers; i++)
+    thr[readers + i] = xpthread_create (NULL, writer, NULL);
+  for (int i = 0; i < readers + writers; i++)
+    xpthread_join (thr[i]);
+
+  TEST_COMPARE (value % 2, 0);
+  xpthread_rwlock_destroy (&lock);
+  xpthread_barrier_destroy (&barrier);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,121 @@
+/* Test the thread stack cache with mixed stack sizes.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Several threads create and join threads with stacks of different
+   sizes at the same time, with a small cache so that stacks are also
+   evicted from it.  Each thread must get a stack of at least the
+   requested size.  A child process created in the middle must be able
+   to reuse the cached stacks of the parent.  */
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+#include <support/xunistd.h>
+
+enum { creators = 8 };
+enum { rounds = 64 };
+enum { sizes = 5 };
+
+static size_t
+stack_size (unsigned int i)
+{
+  /* Sizes in different classes of the cache, and sizes in the same class
+     which are not a multiple of each other.  */
+  static const size_t pages[sizes] = { 16, 24, 64, 100, 256 };
+  return pages[i % sizes] * getpagesize () + PTHREAD_STACK_MIN;
+}
+
+static void *
+check_stack (void *closure)
+{
+  size_t requested = (uintptr_t) closure;
+
+  pthread_attr_t attr;
+  TEST_COMPARE (pthread_getattr_np (pthread_self (), &attr), 0);
+  size_t size;
+  void *addr;
+  TEST_COMPARE (pthread_attr_getstack (&attr, &addr, &size), 0);
+  TEST_VERIFY (size >= requested);
+  xpthread_attr_destroy (&attr);
+
+  /* Use some of the stack.  */
+  char buf[4096];
+  memset (buf, 0xa5, sizeof buf);
+  __asm__ volatile ("" : : "r" (buf) : "memory");
+  return NULL;
+}
+
+static void
+create_threads (unsigned int self)
+{
+  for (unsigned int i = 0; i < rounds; i++)
+    {
+      size_t size = stack_size (self + i);
+      pthread_attr_t attr;
+      xpthread_attr_init (&attr);
+      xpthread_attr_setstacksize (&attr, size);
+      pthread_t thr = xpthread_create (&attr, check_stack,
+				       (void *) (uintptr_t) size);
+      xpthread_attr_destroy (&attr);
+      xpthread_join (thr);
+    }
+}
+
+static void *
+creator (void *closure)
+{
+  create_threads ((uintptr_t) closure);
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+  pthread_t thr[creators];
+  for (unsigned int i = 0; i < creators; i++)
+    thr[i] = xpthread_create (NULL, creator, (void *) (uintptr_t) i);
+
+  /* Fork while the other threads use the stack cache.  */
+  pid_t pid = xfork ();
+  if (pid == 0)
+    {
+      create_threads (0);
+      _exit (0);
+    }
+
+  for (unsigned int i = 0; i < creators; i++)
+    xpthread_join (thr[i]);
+
+  int status;
+  xwaitpid (pid, &status, 0);
+  TEST_VERIFY (WIFEXITED (status) && WEXITSTATUS (status) == 0);
+
+  /* Reuse the cached stacks.  */
+  create_threads (0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
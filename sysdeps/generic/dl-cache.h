@@ -226,6 +226,21 @@ enum cache_extension_tag
       size must be a multiple of 8.  */
    cache_extension_tag_tunables,
 
+   /* Contents of the directories named by the DT_RUNPATH entries of
+      the cached libraries.  A struct cache_directories, see below.
+
+      For this section, 8-byte alignment is required, and the section
+      size must be a multiple of 8.  */
+   cache_extension_tag_directories,
+
+   /* Hash table of the library names, used instead of the binary
+      search of the sorted entries.  A struct cache_soname_hash, see
+      below.
+
+      For this section, 8-byte alignment is required, and the section
+      size must be a multiple of 8.  */
+   cache_extension_tag_soname_hash,
+
    /* Total number of known cache extension tags.  */
    cache_extension_count
   };
@@ -261,6 +276,84 @@ struct cache_extension
   struct cache_extension_section sections[];
 };
 
+/* A directory recorded in the cache_extension_tag_directories
+   section.  The offsets are relative to the start of the section.  */
+struct cache_directory
+{
+  /* Device, inode number and modification time of the directory when
+     it was read.  The recorded contents are used only if they still
+     match.  */
+  uint64_t dev;
+  uint64_t ino;
+  int64_t mtime_sec;
+  uint32_t mtime_nsec;
+
+  /* Offset of the null-terminated absolute path of the directory,
+     without a trailing slash.  */
+  uint32_t name;
+
+  /* Offset and number of the sorted, distinct _dl_new_hash values of
+     the names of the directory entries.  */
+  uint32_t hashes;
+  uint32_t count;
+};
+
+/* Contents of the cache_extension_tag_directories section.  The
+   directory entries are followed by the arrays of hash values, and
+   then by the directory names.  */
+struct cache_directories
+{
+  uint32_t count;		/* Number of directories.  */
+  uint32_t unused;
+  struct cache_directory directories[];
+};
+
+/* Value of the index of an empty slot of struct cache_soname_hash.  */
+#define CACHE_SONAME_HASH_EMPTY UINT32_MAX
+
+/* Contents of the cache_extension_tag_soname_hash section.  An open
+   addressing hash table with linear probing, with a slot for each
+   group of consecutive entries of the new format whose names compare
+   equal with _dl_cache_libcmp.  The table has at least one empty
+   slot.  */
+struct cache_soname_hash
+{
+  uint32_t nslots;		/* Number of slots, a power of two.  */
+  uint32_t unused;
+  struct
+  {
+    /* _dl_cache_soname_hash value of the name.  */
+    uint32_t hash;
+    /* Index in the libs array of struct cache_file_new of the first
+       entry of the group, or CACHE_SONAME_HASH_EMPTY.  */
+    uint32_t index;
+  } slots[];
+};
+
+/* Hash function of the cache_extension_tag_soname_hash section.  The
+   names which compare equal with _dl_cache_libcmp have the same hash
+   value: a sequence of digits is hashed by its numeric value, as a
+   single character.  */
+static inline uint32_t __attribute__ ((unused))
+_dl_cache_soname_hash (const char *name)
+{
+  uint32_t hash = 5381;
+  while (*name != '\0')
+    {
+      if (*name >= '0' && *name <= '9')
+	{
+	  uint32_t value = 0;
+	  while (*name >= '0' && *name <= '9')
+	    value = value * 10 + *name++ - '0';
+	  hash = hash * 33 + '0';
+	  hash = hash * 33 + value;
+	}
+      else
+	hash = hash * 33 + (unsigned char) *name++;
+    }
+  return hash;
+}
+
 /* A relocated version of struct cache_extension_section.  */
 struct cache_extension_loaded
 {
@@ -313,6 +406,34 @@ cache_extension_verify (struct cache_extension_all_loaded *loaded)
 	tun->flags = 0;
       }
   }
+  {
+    /* Section must not be empty, it must be aligned at 8 bytes, and
+       the size must be a multiple of 8.  */
+    struct cache_extension_loaded *dirs
+      = &loaded->sections[cache_extension_tag_directories];
+    if (dirs->size == 0
+	|| ((uintptr_t) dirs->base % 8) != 0
+	|| (dirs->size % 8) != 0)
+      {
+	dirs->base = NULL;
+	dirs->size = 0;
+	dirs->flags = 0;
+      }
+  }
+  {
+    /* Section must not be empty, it must be aligned at 8 bytes, and
+       the size must be a multiple of 8.  */
+    struct cache_extension_loaded *hash
+      = &loaded->sections[cache_extension_tag_soname_hash];
+    if (hash->size == 0
+	|| ((uintptr_t) hash->base % 8) != 0
+	|| (hash->size % 8) != 0)
+      {
+	hash->base = NULL;
+	hash->size = 0;
+	hash->flags = 0;
+      }
+  }
 }
 
 static bool __attribute__ ((unused))
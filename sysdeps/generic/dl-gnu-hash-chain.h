@@ -0,0 +1,39 @@
+/* Scan of the hash chains of DT_GNU_HASH tables.  Generic version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _DL_GNU_HASH_CHAIN_H
+#define _DL_GNU_HASH_CHAIN_H
+
+#include <elf.h>
+#include <stddef.h>
+
+/* Return the first entry at or after HASHARR, in the hash chain which
+   contains HASHARR, whose hash value is equal to HASH except for the
+   lowest bit, or NULL if the chain ends without such an entry.  The
+   lowest bit of an entry is set if it is the last of its chain.  */
+static __always_inline const Elf32_Word *
+_dl_gnu_hash_chain_find (const Elf32_Word *hasharr, Elf32_Word hash)
+{
+  do
+    if (((*hasharr ^ hash) >> 1) == 0)
+      return hasharr;
+  while ((*hasharr++ & 1u) == 0);
+  return NULL;
+}
+
+#endif /* _DL_GNU_HASH_CHAIN_H */
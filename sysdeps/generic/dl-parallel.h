@@ -0,0 +1,34 @@
+/* Running work on several threads in the dynamic linker.  Stub version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef DL_PARALLEL_H
+#define DL_PARALLEL_H
+
+/* Call WORKER (ARG) on the calling thread and on up to NTHREADS - 1
+   additional threads, and return once all the calls have returned.
+   The additional threads share the thread pointer of the calling
+   thread, so WORKER must not use thread-local storage (including
+   errno), malloc, or the error reporting functions of the dynamic
+   linker.  Fewer threads than requested may be used.  */
+static inline void
+_dl_parallel_run (void (*worker) (void *), void *arg, unsigned int nthreads)
+{
+  worker (arg);
+}
+
+#endif /* DL_PARALLEL_H */
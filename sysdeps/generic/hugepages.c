@@ -36,3 +36,9 @@ __get_hugepage_config (size_t requested, size_t *pagesize, int *flags)
   *pagesize = 0;
   *flags = 0;
 }
+
+ssize_t
+__get_thp_ranges (struct thp_range *ranges, size_t n)
+{
+  return -1;
+}
@@ -20,6 +20,8 @@
 #define _HUGEPAGES_H
 
 #include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
 
 /* The THP segment load control mode.  */
 enum dl_elf_thp_control_t
@@ -53,6 +55,22 @@ enum thp_mode_t __get_thp_mode (void) attribute_hidden;
 void __get_hugepage_config (size_t requested, size_t *pagesize, int *flags)
      attribute_hidden;
 
+/* An address range of the process, and the amount of anonymous memory in
+   it which is backed by transparent huge pages.  */
+struct thp_range
+{
+  uintptr_t start;
+  uintptr_t end;
+  size_t size;
+};
+
+/* Store in RANGES, which has room for N entries, the mappings of the
+   process with anonymous memory backed by transparent huge pages.  Return
+   the number of such mappings, which may be larger than N, or -1 if they
+   cannot be determined.  */
+ssize_t __get_thp_ranges (struct thp_range *ranges, size_t n)
+     attribute_hidden;
+
 #ifndef MALLOC_DEFAULT_THP_PAGESIZE
 # define MALLOC_DEFAULT_THP_PAGESIZE	0
 #endif
@@ -74,6 +74,12 @@ extern void add_to_cache (const char *path, const char *filename,
 			  unsigned int isa_level,
 			  struct glibc_hwcaps_subdirectory *);
 
+/* Record the directories of RUNPATH, the DT_RUNPATH of a library in
+   the directory PATH, so that their contents are stored in the cache.
+   CHROOT is the root directory, or null.  */
+extern void add_runpath_to_cache (const char *path, const char *runpath,
+				  const char *chroot);
+
 extern struct stringtable_entry *cache_store_string (const char *string);
 
 extern void init_aux_cache (void);
@@ -81,22 +87,26 @@ extern void init_aux_cache (void);
 extern void load_aux_cache (const char *aux_cache_name);
 
 extern int search_aux_cache (struct stat *stat_buf, int *flags,
-			     unsigned int *isa_level, char **soname);
+			     unsigned int *isa_level, char **soname,
+			     char **runpath);
 
 extern void add_to_aux_cache (struct stat *stat_buf, int flags,
-			      unsigned int isa_level, const char *soname);
+			      unsigned int isa_level, const char *soname,
+			      const char *runpath);
 
 extern void save_aux_cache (const char *aux_cache_name);
 
 /* Declared in readlib.c.  */
 extern int process_file (const char *real_file_name, const char *file_name,
 			 const char *lib, int *flag, unsigned int *isa_level,
-			 char **soname, int is_link, struct stat *stat_buf);
+			 char **soname, char **runpath, int is_link,
+			 struct stat *stat_buf);
 
 /* Declared in readelflib.c.  */
 extern int process_elf_file (const char *file_name, const char *lib,
 			     int *flag, unsigned int *isa_level, char **soname,
-			     void *file_contents, size_t file_length);
+			     char **runpath, void *file_contents,
+			     size_t file_length);
 
 /* Declared in chroot_canon.c.  */
 extern char *chroot_canon (const char *chroot, const char *name);
@@ -415,6 +415,9 @@ struct rtld_global
   {
     size_t len;
     struct dtv_slotinfo_list *next;
+    /* Highest generation of the entries of this element, so that
+       _dl_update_slotinfo can skip elements with no newer entry.  */
+    size_t max_gen;
     struct dtv_slotinfo
     {
       size_t gen;
@@ -600,6 +603,10 @@ struct rtld_global_ro
      See comments in elf/dl-tls.c where it is initialized.  */
   EXTERN size_t _dl_tls_static_surplus;
 
+  /* Nonzero if the dynamic TLS blocks in use are allocated when a thread
+     is created instead of on first access (glibc.rtld.tls_prealloc).  */
+  EXTERN int _dl_tls_prealloc;
+
   /* Name of the shared object to be profiled (if any).  */
   EXTERN const char *_dl_profile;
   /* Filename of the output file.  */
@@ -983,6 +990,9 @@ enum
     /* Set if dl_lookup is called for non-lazy relocation processing
        from _dl_relocate_object in elf/dl-reloc.c.  */
     DL_LOOKUP_FOR_RELOCATE = 8,
+    /* Set if dl_lookup is called from _dl_lookup_symbol_parallel, which
+       must not have any side effect.  */
+    DL_LOOKUP_PARALLEL = 16,
   };
 
 /* Lookup versioned symbol.  */
@@ -995,6 +1005,20 @@ extern lookup_t _dl_lookup_symbol_x (const char *undef,
 				     struct link_map *skip_map)
      attribute_hidden;
 
+/* Side-effect free variant of _dl_lookup_symbol_x for the relocation of
+   UNDEF_MAP, which can be called on several threads at once.  Return 1
+   and store the definition in *SYM and *MAP if it is found, 0 for an
+   undefined weak reference, and -1 if the lookup has to be done by
+   _dl_lookup_symbol_x.  */
+extern int _dl_lookup_symbol_parallel (const char *undef_name,
+				       struct link_map *undef_map,
+				       const ElfW(Sym) *ref,
+				       struct r_scope_elem *symbol_scope[],
+				       const struct r_found_version *version,
+				       int type_class, const ElfW(Sym) **sym,
+				       struct link_map **map)
+     attribute_hidden;
+
 
 /* Restricted version of _dl_lookup_symbol_x.  Searches MAP (and only
    MAP) for the symbol UNDEF_NAME, with GNU hash NEW_HASH (computed
@@ -1151,6 +1175,17 @@ const struct r_strlenpair *_dl_important_hwcaps (const char *prepend,
    or null if none is found.  Caller must free returned string.  */
 extern char *_dl_load_cache_lookup (const char *name) attribute_hidden;
 
+/* Return the hash values of the names in the directory DIR, of length
+   DIRLEN, recorded in ld.so.cache if the directory is still on device
+   DEV and has inode number INO and modification time MTIME_SEC and
+   MTIME_NSEC, and store their number in *COUNT.  Return null if there are none.  Caller must
+   free returned array.  */
+extern uint32_t *_dl_load_cache_directory (const char *dir, size_t dirlen,
+					   uint64_t dev, uint64_t ino,
+					   int64_t mtime_sec,
+					   uint32_t mtime_nsec,
+					   uint32_t *count) attribute_hidden;
+
 /* System-dependent function to read a file's whole contents in the
    most convenient manner available.  *SIZEP gets the size of the
    file.  On error MAP_FAILED is returned.  */
@@ -26,3 +26,28 @@ check_may_shrink_heap (void)
 {
   return __libc_enable_secure;
 }
+
+/* Return the number of the CPU the calling thread is running on, or a
+   negative value if it cannot be determined without a system call.  Used
+   to select the per-CPU caches (see glibc.malloc.percpu).  */
+static inline int
+malloc_getcpu (void)
+{
+  return -1;
+}
+
+/* Return the NUMA node of the CPU the calling thread is running on, or a
+   negative value if it cannot be determined.  If CHEAP, do not make a
+   system call to find out.  Used by glibc.malloc.numa.  */
+static inline int
+malloc_getnode (bool cheap)
+{
+  return -1;
+}
+
+/* Ask for the pages of the SIZE bytes mapping at P to be allocated on
+   NUMA node NODE.  */
+static inline void
+malloc_bind_node (void *p, size_t size, int node)
+{
+}
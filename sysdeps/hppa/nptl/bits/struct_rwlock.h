@@ -31,8 +31,8 @@ struct __pthread_rwlock_arch_t
   unsigned int __writers;
   unsigned int __wrphase_futex;
   unsigned int __writers_futex;
-  unsigned int __pad3;
-  unsigned int __pad4;
+  unsigned int __rbias;
+  unsigned int __rbias_inhibit;
   int __cur_writer;
   /* An unused word, reserved for future use. It was added
      to maintain the location of the flags from the Linuxthreads
@@ -0,0 +1,68 @@
+/* Post several tokens to a semaphore.  Generic version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library;  if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <semaphore.h>
+
+#include <hurdlock.h>
+#include <hurd.h>
+
+#include <pt-internal.h>
+
+int
+sem_post_multiple (sem_t *sem, unsigned int count)
+{
+  struct new_sem *isem = (struct new_sem *) sem;
+  int flags = isem->pshared ? GSYNC_SHARED : 0;
+
+  if (count == 0)
+    return 0;
+
+  /* gsync can wake either one or all the waiters, so wake them all when
+     posting more than one token.  */
+  if (count > 1)
+    flags |= GSYNC_BROADCAST;
+
+#if USE_64B_ATOMICS_ON_SEM_T
+  uint64_t d = atomic_load_relaxed (&isem->data);
+
+  do
+    {
+      if (count > SEM_VALUE_MAX - (d & SEM_VALUE_MASK))
+	return __hurd_fail (EOVERFLOW);
+    }
+  while (!atomic_compare_exchange_weak_release (&isem->data, &d, d + count));
+
+  if ((d >> SEM_NWAITERS_SHIFT) != 0)
+    __lll_wake (((unsigned int *) &isem->data) + SEM_VALUE_OFFSET, flags);
+#else
+  unsigned int v = atomic_load_relaxed (&isem->value);
+
+  do
+    {
+      if (count > SEM_VALUE_MAX - (v >> SEM_VALUE_SHIFT))
+	return __hurd_fail (EOVERFLOW);
+    }
+  while (!atomic_compare_exchange_weak_release
+	  (&isem->value, &v, v + (count << SEM_VALUE_SHIFT)));
+
+  if ((v & SEM_NWAITERS_MASK) != 0)
+    __lll_wake (&isem->value, flags);
+#endif
+
+  return 0;
+}
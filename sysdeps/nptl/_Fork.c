@@ -52,6 +52,7 @@ _Fork (void)
       INTERNAL_SYSCALL_CALL (set_robust_list, &self->robust_head,
 			     sizeof (struct robust_list_head));
       call_function_static_weak (__getrandom_fork_subprocess);
+      call_function_static_weak (__pthread_rwlock_readers_fork_subprocess);
     }
 
   __abort_lock_unlock (&original_sigmask);
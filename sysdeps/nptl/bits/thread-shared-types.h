@@ -99,8 +99,12 @@ struct __pthread_cond_s
   unsigned int __g1_orig_size;
   unsigned int __wrefs;
   unsigned int __g_signals[2];
-  unsigned int __unused_initialized_1;
-  unsigned int __unused_initialized_2;
+  __extension__ union
+  {
+    /* The mutex of the waiters, if they can be requeued to it.  */
+    void *__mutex;
+    unsigned int __unused_initialized[2];
+  };
 };
 
 typedef unsigned int __tss_t;
@@ -113,4 +117,8 @@ typedef struct
 
 #define __ONCE_FLAG_INIT { 0 }
 
+/* Value of a once control or flag after the initialization finished.  The
+   inline fast paths of pthread_once and call_once check for it.  */
+#define __PTHREAD_ONCE_DONE 2
+
 #endif /* _THREAD_SHARED_TYPES_H  */
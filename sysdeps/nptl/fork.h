@@ -24,6 +24,7 @@
 #include <ldsodefs.h>
 #include <list.h>
 #include <mqueue.h>
+#include <nptl/nptl-stack.h>
 #include <pthreadP.h>
 #include <sysdep.h>
 #include <getrandom-internal.h>
@@ -48,6 +49,7 @@ fork_system_setup_after_fork (void)
   call_function_static_weak (__mq_notify_fork_subprocess);
   call_function_static_weak (__timer_fork_subprocess);
   call_function_static_weak (__getrandom_fork_subprocess);
+  call_function_static_weak (__pthread_rwlock_readers_fork_subprocess);
 }
 
 /* In case of a fork() call the memory allocation in the child will be
@@ -109,7 +111,8 @@ reclaim_stacks (void)
 	  curp->tid = 0;
 
 	  /* Account for the size of the stack.  */
-	  GL (dl_stack_cache_actsize) += curp->stackblock_size;
+	  if (!curp->stack_pooled)
+	    GL (dl_stack_cache_actsize) += curp->stackblock_size;
 
 	  if (curp->specific_used)
 	    {
@@ -151,6 +154,10 @@ reclaim_stacks (void)
      lists is decided by the user_stack flag.  */
   list_del (&self->list);
 
+  /* The size classes of the cache may have been changed concurrently by
+     another thread, so build them again.  */
+  __nptl_stack_cache_reclaim ();
+
   /* Re-initialize the lists for all the threads.  */
   INIT_LIST_HEAD (&GL (dl_stack_used));
   INIT_LIST_HEAD (&GL (dl_stack_user));
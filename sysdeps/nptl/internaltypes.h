@@ -70,6 +70,9 @@ struct pthread_attr_extension
 
   sigset_t sigmask;
   bool sigmask_set;
+
+  /* Number of stacks of the pool, or zero.  */
+  size_t stackpool;
 };
 
 /* Mutex attribute data structure.  */
@@ -175,13 +178,14 @@ struct new_sem
 # define SEM_VALUE_MASK (~(unsigned int)0)
   uint64_t data;
   int private;
-  int pad;
+  /* Estimate of the spinning sem_wait needs before a token is posted.  */
+  int spins;
 #else
 # define SEM_VALUE_SHIFT 1
 # define SEM_NWAITERS_MASK ((unsigned int)1)
   unsigned int value;
   int private;
-  int pad;
+  int spins;
   unsigned int nwaiters;
 #endif
 };
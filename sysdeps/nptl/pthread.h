@@ -59,7 +59,10 @@ enum
 #endif
 #ifdef __USE_GNU
   /* For compatibility.  */
-  , PTHREAD_MUTEX_FAST_NP = PTHREAD_MUTEX_TIMED_NP
+  , PTHREAD_MUTEX_FAST_NP = PTHREAD_MUTEX_TIMED_NP,
+  /* Waiters queue up, and the mutex goes preferably to the waiters
+     running on the NUMA node of its owner.  */
+  PTHREAD_MUTEX_QUEUED_NP = 4
 #endif
 };
 
@@ -96,6 +99,8 @@ enum
  { {  __PTHREAD_MUTEX_INITIALIZER (PTHREAD_MUTEX_ERRORCHECK_NP) } }
 # define PTHREAD_ADAPTIVE_MUTEX_INITIALIZER_NP \
  { {  __PTHREAD_MUTEX_INITIALIZER (PTHREAD_MUTEX_ADAPTIVE_NP) } }
+# define PTHREAD_QUEUED_MUTEX_INITIALIZER_NP \
+ { {  __PTHREAD_MUTEX_INITIALIZER (PTHREAD_MUTEX_QUEUED_NP) } }
 #endif
 
 
@@ -106,6 +111,9 @@ enum
   PTHREAD_RWLOCK_PREFER_READER_NP,
   PTHREAD_RWLOCK_PREFER_WRITER_NP,
   PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP,
+# ifdef __USE_GNU
+  PTHREAD_RWLOCK_READER_BIASED_NP,
+# endif
   PTHREAD_RWLOCK_DEFAULT_NP = PTHREAD_RWLOCK_PREFER_READER_NP
 };
 
@@ -152,7 +160,7 @@ enum
 
 
 /* Conditional variable handling.  */
-#define PTHREAD_COND_INITIALIZER { { {0}, {0}, {0, 0}, 0, 0, {0, 0}, 0, 0 } }
+#define PTHREAD_COND_INITIALIZER { { {0}, {0}, {0, 0}, 0, 0, {0, 0}, {0} } }
 
 
 /* Cleanup buffers */
@@ -421,6 +429,18 @@ extern int pthread_attr_getsigmask_np (const pthread_attr_t *__attr,
    mask has not been set.  */
 #define PTHREAD_ATTR_NO_SIGMASK_NP (-1)
 
+/* Threads created with attribute ATTR take their stacks from a pool
+   of COUNT preallocated stacks, which is filled when the first of
+   them is created.  */
+extern int pthread_attr_setstackpool_np (pthread_attr_t *__attr,
+					 size_t __count)
+     __THROW __nonnull ((1));
+
+/* Get the size of the stack pool of ATTR in *COUNT.  */
+extern int pthread_attr_getstackpool_np (const pthread_attr_t *__attr,
+					 size_t *__count)
+     __THROW __nonnull ((1, 2));
+
 /* Set the default attributes to be used by pthread_create in this
    process.  */
 extern int pthread_setattr_default_np (const pthread_attr_t *__attr)
@@ -509,6 +529,18 @@ extern int pthread_getaffinity_np (pthread_t __th, size_t __cpusetsize,
 extern int pthread_once (pthread_once_t *__once_control,
 			 void (*__init_routine) (void)) __nonnull ((1, 2));
 
+#ifdef __USE_GNU
+/* Call INIT_ROUTINE with ARG only once, even if pthread_lazy_init_np is
+   executed several times with the same LAZY_CONTROL argument.
+   LAZY_CONTROL must be initialized to PTHREAD_ONCE_INIT and must not be
+   used with pthread_once.  Unlike pthread_once, threads waiting for an
+   initialization do not need a futex of their own, so a control can be
+   used for each of many small objects.  */
+extern int pthread_lazy_init_np (pthread_once_t *__lazy_control,
+				 void (*__init_routine) (void *),
+				 void *__arg) __nonnull ((1, 2));
+#endif
+
 
 /* Functions for handling cancellation.
 
@@ -1346,6 +1378,41 @@ __NTH (pthread_equal (pthread_t __thread1, pthread_t __thread2))
 {
   return __thread1 == __thread2;
 }
+
+# ifdef __REDIRECT
+/* Once the initialization finished, pthread_once only needs an acquire
+   load of the control.  Call the library only if it did not.  */
+extern int __REDIRECT (__pthread_once_alias,
+		       (pthread_once_t *__once_control,
+			void (*__init_routine) (void)), pthread_once)
+     __nonnull ((1, 2));
+
+__extern_inline int
+pthread_once (pthread_once_t *__once_control, void (*__init_routine) (void))
+{
+  if (__glibc_likely ((__atomic_load_n (__once_control, __ATOMIC_ACQUIRE)
+		       & __PTHREAD_ONCE_DONE) != 0))
+    return 0;
+  return __pthread_once_alias (__once_control, __init_routine);
+}
+
+#  ifdef __USE_GNU
+extern int __REDIRECT (__pthread_lazy_init_np_alias,
+		       (pthread_once_t *__lazy_control,
+			void (*__init_routine) (void *), void *__arg),
+		       pthread_lazy_init_np) __nonnull ((1, 2));
+
+__extern_inline int
+pthread_lazy_init_np (pthread_once_t *__lazy_control,
+		      void (*__init_routine) (void *), void *__arg)
+{
+  if (__glibc_likely ((__atomic_load_n (__lazy_control, __ATOMIC_ACQUIRE)
+		       & __PTHREAD_ONCE_DONE) != 0))
+    return 0;
+  return __pthread_lazy_init_np_alias (__lazy_control, __init_routine, __arg);
+}
+#  endif
+# endif
 #endif
 
 __END_DECLS
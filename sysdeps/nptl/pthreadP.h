@@ -143,6 +143,41 @@ enum
 					 << (sizeof (unsigned int) * 8 - 1))
 #define PTHREAD_RWLOCK_FUTEX_USED	2
 
+/* The unit of __rbias_inhibit is the hp-timing unit shifted by this
+   amount.  */
+#define PTHREAD_RWLOCK_RBIAS_TIME_SHIFT	10
+/* After a writer revoked the bias of a reader-biased rwlock, the bias is
+   not enabled again for this many times the time the revocation took,
+   and never for more than PTHREAD_RWLOCK_RBIAS_INHIBIT_MAX units.  */
+#define PTHREAD_RWLOCK_RBIAS_INHIBIT_FACTOR	9
+#define PTHREAD_RWLOCK_RBIAS_INHIBIT_MAX	(1U << 20)
+/* Values of __rbias: the bias is disabled, enabled, or disabled by a
+   writer which waits on __rbias for the readers that acquired the lock
+   through the bias to release it.  */
+#define PTHREAD_RWLOCK_RBIAS_DISABLED	0
+#define PTHREAD_RWLOCK_RBIAS_ENABLED	1
+#define PTHREAD_RWLOCK_RBIAS_REVOKING	2
+
+/* The reader slots of a thread, see pthread_rwlock_common.c.  The slots
+   are allocated from a registry which never frees them, so that writers
+   can look for readers without any lock.  */
+#define PTHREAD_RWLOCK_READER_SLOTS 4
+struct pthread_rwlock_readers
+{
+  /* The rwlocks read-locked through the slots, and the number of times
+     each of them was read-locked.  Only LOCK is read by other threads.  */
+  struct
+  {
+    pthread_rwlock_t *lock;
+    unsigned int depth;
+  } slots[PTHREAD_RWLOCK_READER_SLOTS];
+  /* Next block of reader slots in the registry, set before the block is
+     published.  */
+  struct pthread_rwlock_readers *next;
+  /* Next block on the free list of the registry.  */
+  struct pthread_rwlock_readers *next_free;
+} __attribute__ ((aligned (64)));
+
 
 /* Bits used in robust mutex implementation.  */
 #define FUTEX_WAITERS		0x80000000
@@ -150,9 +185,9 @@ enum
 #define FUTEX_TID_MASK		0x3fffffff
 
 
-/* pthread_once definitions.  See __pthread_once for how these are used.  */
+/* pthread_once definitions.  See __pthread_once for how these are used.
+   __PTHREAD_ONCE_DONE is in <bits/thread-shared-types.h>.  */
 #define __PTHREAD_ONCE_INPROGRESS	1
-#define __PTHREAD_ONCE_DONE		2
 #define __PTHREAD_ONCE_FORK_GEN_INCR	4
 
 /* Attribute to indicate thread creation was issued from C11 thrd_create.  */
@@ -351,6 +386,15 @@ libc_hidden_proto (__pthread_mutex_unlock)
 extern int __pthread_mutex_unlock_usercnt (pthread_mutex_t *__mutex,
 					   int __decr);
 libc_hidden_proto (__pthread_mutex_unlock_usercnt)
+/* Lock and unlock hooks of the mutex profiler, used when
+   __mutex_aconf.profile is set.  SITE is the caller of
+   pthread_mutex_lock.  */
+extern int __pthread_mutex_lock_profile (pthread_mutex_t *__mutex,
+					 void *__site) attribute_hidden;
+extern void __pthread_mutex_profile_release (pthread_mutex_t *__mutex)
+     attribute_hidden;
+extern void __pthread_mutex_profile_destroy (pthread_mutex_t *__mutex)
+     attribute_hidden;
 extern int __pthread_mutexattr_init (pthread_mutexattr_t *attr);
 libc_hidden_proto (__pthread_mutexattr_init)
 extern int __pthread_mutexattr_destroy (pthread_mutexattr_t *attr);
@@ -467,6 +511,21 @@ extern int __pthread_mutex_timedlock64 (pthread_mutex_t *mutex,
 libc_hidden_proto (__pthread_mutex_timedlock64)
 #endif
 
+/* See pthread_rwlock_revoke_bias.c.  */
+extern int __pthread_rwlock_revoke_bias (pthread_rwlock_t *rwlock,
+					 clockid_t clockid,
+					 const struct __timespec64 *abstime,
+					 bool wait) attribute_hidden;
+
+/* See pthread_rwlock_readers.c.  */
+extern struct pthread_rwlock_readers *__pthread_rwlock_readers_alloc (void)
+     attribute_hidden;
+extern void __pthread_rwlock_readers_release (struct pthread *pd)
+     attribute_hidden;
+extern bool __pthread_rwlock_readers_hold (pthread_rwlock_t *rwlock)
+     attribute_hidden;
+extern void __pthread_rwlock_readers_fork_subprocess (void) attribute_hidden;
+
 extern int __pthread_cond_timedwait (pthread_cond_t *cond,
 				     pthread_mutex_t *mutex,
 				     const struct timespec *abstime);
@@ -550,6 +609,11 @@ libc_hidden_proto (__pthread_attr_setsigmask_internal)
 extern __typeof (pthread_attr_getsigmask_np) __pthread_attr_getsigmask_np;
 libc_hidden_proto (__pthread_attr_getsigmask_np)
 
+extern __typeof (pthread_attr_setstackpool_np) __pthread_attr_setstackpool_np;
+libc_hidden_proto (__pthread_attr_setstackpool_np)
+
+extern __typeof (pthread_lazy_init_np) __pthread_lazy_init_np;
+
 /* Special versions which use non-exported functions.  */
 extern void __pthread_cleanup_push (struct _pthread_cleanup_buffer *buffer,
 				    void (*routine) (void *), void *arg);
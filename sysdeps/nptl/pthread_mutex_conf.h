@@ -23,6 +23,12 @@
 struct mutex_config
 {
   int spin_count;
+  /* Whether pthread_mutex_lock records contention statistics, and the
+     signal which writes them to standard error, or 0.  */
+  int profile;
+  int profile_signal;
+  /* The maximum number of times sem_wait spins before blocking.  */
+  int sem_spin_count;
 };
 
 extern struct mutex_config __mutex_aconf;
@@ -30,4 +36,7 @@ libc_hidden_proto (__mutex_aconf)
 
 extern void __pthread_tunables_init (void) attribute_hidden;
 
+/* Set up the mutex profiler, in pthread_mutex_profile.c.  */
+extern void __pthread_mutex_profile_init (void) attribute_hidden;
+
 #endif
@@ -0,0 +1,33 @@
+/* NUMA node of the running thread for queued mutexes.  Generic version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _PTHREAD_MUTEX_NUMA_H
+#define _PTHREAD_MUTEX_NUMA_H 1
+
+/* Return the NUMA node of the CPU the calling thread runs on.  The lock
+   handoff of PTHREAD_MUTEX_QUEUED_NP mutexes prefers the waiters on the
+   same node as the owner.  This is called on the contended path, so it
+   should not make a system call; all the threads are on the same node if
+   the node is not known.  */
+static inline int
+mutex_numa_node (void)
+{
+  return 0;
+}
+
+#endif
@@ -172,6 +172,23 @@ extern void mtx_destroy (mtx_t *__mutex);
    All calls must be made with the same __FLAGS object.  */
 extern void call_once (once_flag *__flag, void (*__func)(void));
 
+#if defined __USE_EXTERN_INLINES && defined __REDIRECT \
+    && defined __PTHREAD_ONCE_DONE
+/* Once __FUNC was called, call_once only needs an acquire load of the
+   flag.  Call the library only if it was not.  */
+extern void __REDIRECT (__call_once_alias,
+			(once_flag *__flag, void (*__func)(void)), call_once);
+
+__extern_inline void
+call_once (once_flag *__flag, void (*__func)(void))
+{
+  if (__glibc_likely ((__atomic_load_n (&__flag->__data, __ATOMIC_ACQUIRE)
+		       & __PTHREAD_ONCE_DONE) != 0))
+    return;
+  __call_once_alias (__flag, __func);
+}
+#endif
+
 
 /* Condition variable functions.  */
 
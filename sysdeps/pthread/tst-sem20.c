@@ -0,0 +1,125 @@
+/* Test sem_post_multiple.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <limits.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <time.h>
+#include <support/check.h>
+#include <support/xthread.h>
+
+/* Check that sem_post_multiple adds all the tokens or none of them, and
+   that the tokens posted at once to blocked waiters are all consumed,
+   each by a single waiter.  */
+
+enum { waiters = 8 };
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static sem_t sem;
+static int woken;
+
+static void *
+tf (void *arg)
+{
+  TEST_COMPARE (sem_wait (&sem), 0);
+  xpthread_mutex_lock (&lock);
+  woken++;
+  xpthread_mutex_unlock (&lock);
+  return NULL;
+}
+
+static int
+get_woken (void)
+{
+  xpthread_mutex_lock (&lock);
+  int ret = woken;
+  xpthread_mutex_unlock (&lock);
+  return ret;
+}
+
+static int
+get_value (void)
+{
+  int value;
+  TEST_COMPARE (sem_getvalue (&sem, &value), 0);
+  return value;
+}
+
+static void
+wait_for_woken (int expected)
+{
+  while (get_woken () < expected)
+    nanosleep (&(struct timespec) { 0, 1000000 }, NULL);
+  TEST_COMPARE (get_woken (), expected);
+}
+
+static int
+do_test (void)
+{
+  TEST_COMPARE (sem_init (&sem, 0, 0), 0);
+
+  /* Posting no token does nothing.  */
+  TEST_COMPARE (sem_post_multiple (&sem, 0), 0);
+  TEST_COMPARE (get_value (), 0);
+
+  TEST_COMPARE (sem_post_multiple (&sem, 5), 0);
+  TEST_COMPARE (get_value (), 5);
+  for (int i = 0; i < 5; i++)
+    TEST_COMPARE (sem_trywait (&sem), 0);
+  errno = 0;
+  TEST_COMPARE (sem_trywait (&sem), -1);
+  TEST_COMPARE (errno, EAGAIN);
+
+  /* The tokens are not added if they would overflow the semaphore.  */
+  TEST_COMPARE (sem_init (&sem, 0, SEM_VALUE_MAX - 1), 0);
+  errno = 0;
+  TEST_COMPARE (sem_post_multiple (&sem, 2), -1);
+  TEST_COMPARE (errno, EOVERFLOW);
+  errno = 0;
+  TEST_COMPARE (sem_post_multiple (&sem, UINT_MAX), -1);
+  TEST_COMPARE (errno, EOVERFLOW);
+  TEST_COMPARE (get_value (), SEM_VALUE_MAX - 1);
+  TEST_COMPARE (sem_post_multiple (&sem, 1), 0);
+  TEST_COMPARE (get_value (), SEM_VALUE_MAX);
+  TEST_COMPARE (sem_destroy (&sem), 0);
+
+  /* Wake some of the waiters, then the others.  */
+  TEST_COMPARE (sem_init (&sem, 0, 0), 0);
+  pthread_t thr[waiters];
+  for (int i = 0; i < waiters; i++)
+    thr[i] = xpthread_create (NULL, tf, NULL);
+  TEST_COMPARE (sem_post_multiple (&sem, 3), 0);
+  wait_for_woken (3);
+  /* Give the other waiters the chance to grab a token which does not
+     exist.  */
+  nanosleep (&(struct timespec) { 0, 100000000 }, NULL);
+  TEST_COMPARE (get_woken (), 3);
+  TEST_COMPARE (get_value (), 0);
+
+  TEST_COMPARE (sem_post_multiple (&sem, waiters - 3 + 2), 0);
+  for (int i = 0; i < waiters; i++)
+    xpthread_join (thr[i]);
+  TEST_COMPARE (get_woken (), waiters);
+  TEST_COMPARE (get_value (), 2);
+  TEST_COMPARE (sem_destroy (&sem), 0);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -18,16 +18,18 @@
 
 int process_elf32_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 int process_elf64_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 
 /* Returns 0 if everything is ok, != 0 in case of error.  */
 int
 process_elf_file (const char *file_name, const char *lib, int *flag,
-		  unsigned int *isa_level, char **soname, void *file_contents,
-		  size_t file_length)
+		  unsigned int *isa_level, char **soname, char **runpath,
+		  void *file_contents, size_t file_length)
 {
   ElfW(Ehdr) *elf_header = (ElfW(Ehdr) *) file_contents;
   int ret;
@@ -37,7 +39,7 @@ process_elf_file (const char *file_name, const char *lib, int *flag,
       Elf32_Ehdr *elf32_header = (Elf32_Ehdr *) elf_header;
 
       ret = process_elf32_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
 
       if (!ret && EF_ARM_EABI_VERSION (elf32_header->e_flags) == EF_ARM_EABI_VER5)
 	{
@@ -56,7 +58,7 @@ process_elf_file (const char *file_name, const char *lib, int *flag,
   else
     {
       ret = process_elf64_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
       /* AArch64 libraries are always libc.so.6+.  */
       if (!ret)
 	*flag = FLAG_AARCH64_LIB64|FLAG_ELF_LIBC6;
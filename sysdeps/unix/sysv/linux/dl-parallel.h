@@ -0,0 +1,106 @@
+/* Running work on several threads in the dynamic linker.  Linux version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* See sysdeps/generic/dl-parallel.h for documentation of this
+   interface.  */
+
+#ifndef DL_PARALLEL_H
+#define DL_PARALLEL_H
+
+#include <atomic.h>
+#include <ldsodefs.h>
+#include <lowlevellock-futex.h>
+#include <sched.h>
+#include <stackinfo.h>
+#include <sys/mman.h>
+
+/* The threads are created with clone directly, as libc.so is not
+   relocated yet.  They only run the lookups of the dynamic linker, so
+   a small stack is enough.  */
+#define DL_PARALLEL_MAX_THREADS 64
+#define DL_PARALLEL_STACK_SIZE (64 * 1024)
+
+struct dl_parallel_call
+{
+  void (*worker) (void *);
+  void *arg;
+};
+
+static int
+_dl_parallel_start (void *closure)
+{
+  struct dl_parallel_call *call = closure;
+  call->worker (call->arg);
+  return 0;
+}
+
+static void
+_dl_parallel_run (void (*worker) (void *), void *arg, unsigned int nthreads)
+{
+  struct dl_parallel_call call = { worker, arg };
+  /* Cleared by the kernel when the threads exit.  */
+  pid_t tids[DL_PARALLEL_MAX_THREADS];
+  unsigned int started = 0;
+  char *stacks = MAP_FAILED;
+  size_t size = 0;
+
+  if (nthreads > DL_PARALLEL_MAX_THREADS)
+    nthreads = DL_PARALLEL_MAX_THREADS;
+  if (nthreads > 1)
+    {
+      size = (nthreads - 1) * DL_PARALLEL_STACK_SIZE;
+      stacks = __mmap (NULL, size, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+    }
+  if (stacks != MAP_FAILED)
+    for (; started < nthreads - 1; ++started)
+      {
+	char *stack = stacks + started * DL_PARALLEL_STACK_SIZE;
+#if _STACK_GROWS_DOWN
+	/* Guard page at the bottom of each stack.  */
+	__mprotect (stack, GLRO(dl_pagesize), PROT_NONE);
+	void *sp = stack + DL_PARALLEL_STACK_SIZE;
+#else
+	__mprotect (stack + DL_PARALLEL_STACK_SIZE - GLRO(dl_pagesize),
+		    GLRO(dl_pagesize), PROT_NONE);
+	void *sp = stack;
+#endif
+	if (__clone (_dl_parallel_start, sp,
+		     CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND
+		     | CLONE_THREAD | CLONE_SYSVSEM | CLONE_PARENT_SETTID
+		     | CLONE_CHILD_CLEARTID,
+		     &call, &tids[started], NULL, &tids[started]) == -1)
+	  break;
+      }
+
+  /* The calling thread takes part in the work, which is done entirely
+     by it if no thread could be created.  */
+  worker (arg);
+
+  for (unsigned int i = 0; i < started; ++i)
+    {
+      pid_t tid;
+      while ((tid = atomic_load_acquire (&tids[i])) != 0)
+	lll_futex_wait (&tids[i], tid, LLL_SHARED);
+    }
+
+  if (stacks != MAP_FAILED)
+    __munmap (stacks, size);
+}
+
+#endif /* DL_PARALLEL_H */
@@ -0,0 +1,48 @@
+/* Implementation of futex_waitv syscall wrapper.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <sys/futex.h>
+#include <sysdep.h>
+
+int
+__futex_waitv_time64 (struct futex_waitv *waiters, unsigned int nr_futexes,
+		      unsigned int flags, const struct __timespec64 *timeout,
+		      clockid_t clockid)
+{
+  /* The syscall only supports 64-bit time_t.  */
+  return SYSCALL_CANCEL (futex_waitv, waiters, nr_futexes, flags, timeout,
+			 clockid);
+}
+#if __TIMESIZE != 64
+libc_hidden_def (__futex_waitv_time64)
+
+int
+futex_waitv (struct futex_waitv *waiters, unsigned int nr_futexes,
+	     unsigned int flags, const struct timespec *timeout,
+	     clockid_t clockid)
+{
+  struct __timespec64 timeout64, *ptimeout64 = NULL;
+  if (timeout != NULL)
+    {
+      timeout64 = valid_timespec_to_timespec64 (*timeout);
+      ptimeout64 = &timeout64;
+    }
+  return __futex_waitv_time64 (waiters, nr_futexes, flags, ptimeout64,
+			       clockid);
+}
+#endif
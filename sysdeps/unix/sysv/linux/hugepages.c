@@ -205,4 +205,114 @@ __get_hugepage_config (size_t requested, size_t *pagesize, int *flags)
   __close_nocancel (dirfd);
 }
 
+/* Parse the number in BASE at *S and advance *S past it.  */
+static uintptr_t
+parse_number (const char **s, unsigned int base)
+{
+  uintptr_t r = 0;
+  for (const char *p = *s; ; p++)
+    {
+      unsigned int digit;
+      if (*p >= '0' && *p <= '9')
+	digit = *p - '0';
+      else if (base == 16 && *p >= 'a' && *p <= 'f')
+	digit = *p - 'a' + 10;
+      else
+	{
+	  *s = p;
+	  return r;
+	}
+      r = r * base + digit;
+    }
+}
+
+/* Process the LINE of /proc/self/smaps.  The first line of a mapping has
+   its address range, which is kept in *START and *END until the
+   AnonHugePages field of the mapping is found.  */
+static void
+parse_smaps_line (const char *line, uintptr_t *start, uintptr_t *end,
+		  struct thp_range *ranges, size_t n, ssize_t *count)
+{
+  static const char anon_huge[] = "AnonHugePages:";
+
+  if ((line[0] >= '0' && line[0] <= '9') || (line[0] >= 'a' && line[0] <= 'f'))
+    {
+      /* The mapping is in the form:
+	 START-END PERMISSIONS OFFSET DEVICE INODE PATH  */
+      *start = parse_number (&line, 16);
+      *end = *line++ == '-' ? parse_number (&line, 16) : 0;
+    }
+  else if (strncmp (line, anon_huge, sizeof (anon_huge) - 1) == 0)
+    {
+      /* The field is in the form:
+	 AnonHugePages:      NUMBER kB  */
+      line += sizeof (anon_huge) - 1;
+      while (*line == ' ')
+	line++;
+      size_t size = parse_number (&line, 10) * 1024;
+      if (size != 0 && *start < *end)
+	{
+	  if ((size_t) *count < n)
+	    ranges[*count] = (struct thp_range) { *start, *end, size };
+	  ++*count;
+	}
+    }
+}
+
+ssize_t
+__get_thp_ranges (struct thp_range *ranges, size_t n)
+{
+  int fd = __open64_nocancel ("/proc/self/smaps", O_RDONLY);
+  if (fd == -1)
+    return -1;
+
+  ssize_t count = 0;
+  uintptr_t start = 0, end = 0;
+  bool skip = false;
+
+  char buf[1024 + 1];
+  size_t len = 0;
+  while (1)
+    {
+      ssize_t r = __read_nocancel (fd, buf + len, sizeof (buf) - 1 - len);
+      if (r < 0)
+	{
+	  count = -1;
+	  break;
+	}
+      if (r == 0)
+	break;
+      len += r;
+
+      char *line = buf;
+      char *nl;
+      while ((nl = memchr (line, '\n', buf + len - line)) != NULL)
+	{
+	  *nl = '\0';
+	  if (!skip)
+	    parse_smaps_line (line, &start, &end, ranges, n, &count);
+	  skip = false;
+	  line = nl + 1;
+	}
+      len = buf + len - line;
+
+      if (len == sizeof (buf) - 1)
+	{
+	  /* Only the first line of a mapping, with a long path, may not fit
+	     in the buffer.  Its address range is at the start, so parse it
+	     and skip the rest of the line.  */
+	  buf[len] = '\0';
+	  if (!skip)
+	    parse_smaps_line (buf, &start, &end, ranges, n, &count);
+	  skip = true;
+	  len = 0;
+	}
+      else
+	memmove (buf, line, len);
+    }
+
+  __close_nocancel (fd);
+  return count;
+}
+
 #endif /* !IS_IN(rtld) */
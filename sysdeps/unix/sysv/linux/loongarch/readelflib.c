@@ -19,10 +19,12 @@
 
 int process_elf32_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 int process_elf64_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 
 #define SUPPORTED_ELF_FLAGS \
   (EF_LARCH_ABI_DOUBLE_FLOAT | EF_LARCH_ABI_SOFT_FLOAT)
@@ -30,8 +32,8 @@ int process_elf64_file (const char *file_name, const char *lib,
 /* Returns 0 if everything is ok, != 0 in case of error.  */
 int
 process_elf_file (const char *file_name, const char *lib, int *flag,
-		  unsigned int *isa_level, char **soname, void *file_contents,
-		  size_t file_length)
+		  unsigned int *isa_level, char **soname, char **runpath,
+		  void *file_contents, size_t file_length)
 {
   ElfW(Ehdr) *elf_header = (ElfW(Ehdr) *) file_contents;
   Elf32_Ehdr *elf32_header = (Elf32_Ehdr *) elf_header;
@@ -45,13 +47,13 @@ process_elf_file (const char *file_name, const char *lib, int *flag,
   if (elf_header->e_ident[EI_CLASS] == ELFCLASS32)
     {
       ret = process_elf32_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
       flags = elf32_header->e_flags & ~EF_LARCH_OBJABI_V1;
     }
   else
     {
       ret = process_elf64_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
 
       /* The EF_LARCH_OBJABI_V1 flag indicate which set of static relocations
        the object might use and it only considered during static linking,
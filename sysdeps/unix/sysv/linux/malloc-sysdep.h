@@ -18,6 +18,7 @@
 
 #include <fcntl.h>
 #include <not-cancel.h>
+#include <rseq-internal.h>
 
 /* The Linux kernel overcommits address space by default and if there is not
    enough memory available, it uses various parameters to decide the process to
@@ -57,3 +58,54 @@ check_may_shrink_heap (void)
 }
 
 #define HAVE_MREMAP 1
+
+/* Return the number of the CPU the calling thread is running on, as
+   published by the kernel in the rseq area.  The value is negative if rseq
+   registration failed or was disabled with glibc.pthread.rseq=0.  */
+static inline int
+malloc_getcpu (void)
+{
+  return (int) RSEQ_GETMEM_ONCE (cpu_id);
+}
+
+/* Return the NUMA node of the CPU the calling thread is running on, or a
+   negative value if it cannot be determined.  The node is read from the
+   rseq area if the kernel provides it there, otherwise it is obtained
+   with getcpu unless CHEAP is true.  */
+static inline int
+malloc_getnode (bool cheap)
+{
+  if (RSEQ_GETMEM_ONCE (cpu_id) >= 0
+      && __rseq_size >= offsetof (struct rseq_area, mm_cid))
+    return RSEQ_GETMEM_ONCE (node_id);
+  if (cheap)
+    return -1;
+
+  unsigned int node;
+  if (INTERNAL_SYSCALL_ERROR_P (INTERNAL_SYSCALL_CALL (getcpu, NULL, &node,
+						       NULL)))
+    return -1;
+  return node;
+}
+
+/* Set the memory policy of the SIZE bytes mapping at P so that its pages
+   are preferably allocated on NUMA node NODE.  Nodes which do not fit in
+   the mask are ignored, as is failure, since the policy is only a
+   hint.  */
+static inline void
+malloc_bind_node (void *p, size_t size, int node)
+{
+#ifdef __NR_mbind
+  /* MPOL_PREFERRED from <linux/mempolicy.h>.  */
+  enum { mpol_preferred = 1 };
+  unsigned long int nodemask[1024 / (8 * sizeof (unsigned long int))] = { 0 };
+  const unsigned int bits = 8 * sizeof (nodemask[0]);
+
+  if (node < 0 || (size_t) node >= 8 * sizeof (nodemask))
+    return;
+  nodemask[node / bits] = 1UL << (node % bits);
+  /* The kernel ignores the last bit of MAXNODE.  */
+  INTERNAL_SYSCALL_CALL (mbind, p, size, mpol_preferred, nodemask,
+			 8 * sizeof (nodemask) + 1, 0);
+#endif
+}
@@ -18,16 +18,18 @@
 
 int process_elf32_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 int process_elf64_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 
 /* Returns 0 if everything is ok, != 0 in case of error.  */
 int
 process_elf_file (const char *file_name, const char *lib, int *flag,
-		  unsigned int *isa_level, char **soname, void *file_contents,
-		  size_t file_length)
+		  unsigned int *isa_level, char **soname, char **runpath,
+		  void *file_contents, size_t file_length)
 {
   union
     {
@@ -42,7 +44,7 @@ process_elf_file (const char *file_name, const char *lib, int *flag,
   if (elf_header.eh->e_ident [EI_CLASS] == ELFCLASS32)
     {
       ret = process_elf32_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
       if (!ret)
 	{
 	  Elf32_Word flags = elf_header.eh32->e_flags;
@@ -59,7 +61,7 @@ process_elf_file (const char *file_name, const char *lib, int *flag,
   else
     {
       ret = process_elf64_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
       /* n64 libraries are always libc.so.6+.  */
       if (!ret)
 	{
@@ -19,27 +19,29 @@
 
 int process_elf32_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 int process_elf64_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 
 /* Returns 0 if everything is ok, != 0 in case of error.  */
 int
 process_elf_file (const char *file_name, const char *lib, int *flag,
-		  unsigned int *isa_level, char **soname, void *file_contents,
-		  size_t file_length)
+		  unsigned int *isa_level, char **soname, char **runpath,
+		  void *file_contents, size_t file_length)
 {
   ElfW(Ehdr) *elf_header = (ElfW(Ehdr) *) file_contents;
   int ret;
 
   if (elf_header->e_ident [EI_CLASS] == ELFCLASS32)
     return process_elf32_file (file_name, lib, flag, isa_level, soname,
-			       file_contents, file_length);
+			       runpath, file_contents, file_length);
   else
     {
       ret = process_elf64_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
       /* PowerPC 64bit libraries are always libc.so.6+.  */
       if (!ret)
 	*flag = FLAG_POWERPC_LIB64|FLAG_ELF_LIBC6;
@@ -0,0 +1,37 @@
+/* NUMA node of the running thread for queued mutexes.  Linux version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _PTHREAD_MUTEX_NUMA_H
+#define _PTHREAD_MUTEX_NUMA_H 1
+
+#include <stddef.h>
+#include <rseq-internal.h>
+
+/* Return the NUMA node of the CPU the calling thread runs on, as published
+   by the kernel in the rseq area, or 0 if the kernel does not provide it
+   there (all the threads are then considered to be on the same node).  */
+static inline int
+mutex_numa_node (void)
+{
+  if ((int) RSEQ_GETMEM_ONCE (cpu_id) >= 0
+      && __rseq_size >= offsetof (struct rseq_area, mm_cid))
+    return RSEQ_GETMEM_ONCE (node_id);
+  return 0;
+}
+
+#endif
@@ -19,10 +19,12 @@
 
 int process_elf32_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 int process_elf64_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 
 /* The ELF flags supported by our current glibc port:
    - EF_RISCV_FLOAT_ABI: We support the soft and double ABIs.
@@ -38,8 +40,8 @@ int process_elf64_file (const char *file_name, const char *lib,
 /* Returns 0 if everything is ok, != 0 in case of error.  */
 int
 process_elf_file (const char *file_name, const char *lib, int *flag,
-		  unsigned int *isa_level, char **soname, void *file_contents,
-		  size_t file_length)
+		  unsigned int *isa_level, char **soname, char **runpath,
+		  void *file_contents, size_t file_length)
 {
   ElfW(Ehdr) *elf_header = (ElfW(Ehdr) *) file_contents;
   Elf32_Ehdr *elf32_header = (Elf32_Ehdr *) elf_header;
@@ -53,13 +55,13 @@ process_elf_file (const char *file_name, const char *lib, int *flag,
   if (elf_header->e_ident [EI_CLASS] == ELFCLASS32)
     {
       ret = process_elf32_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
       flags = elf32_header->e_flags;
     }
   else
     {
       ret = process_elf64_file (file_name, lib, flag, isa_level, soname,
-				file_contents, file_length);
+				runpath, file_contents, file_length);
       flags = elf64_header->e_flags;
     }
 
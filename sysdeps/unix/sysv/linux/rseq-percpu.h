@@ -0,0 +1,41 @@
+/* Restartable sequences for per-CPU data.  Generic version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef RSEQ_PERCPU_H
+#define RSEQ_PERCPU_H
+
+/* An architecture that implements the per-CPU operations with
+   restartable sequences defines RSEQ_PERCPU_HAVE_CS to 1 and provides:
+
+   bool rseq_percpu_cs_add (intptr_t *p, intptr_t value, int cpu);
+
+     Add VALUE to *P if the thread runs on CPU, and return true.  Return
+     false if the thread runs on another CPU or the sequence was
+     aborted.
+
+   int rseq_percpu_cs_cmpstore (intptr_t *p, intptr_t expected,
+				intptr_t newval, int cpu);
+
+     Store NEWVAL in *P if the thread runs on CPU and *P is EXPECTED, and
+     return 0.  Return 1 if *P is not EXPECTED, and -1 if the thread runs
+     on another CPU or the sequence was aborted.
+
+   The other architectures use atomic operations instead.  */
+#define RSEQ_PERCPU_HAVE_CS 0
+
+#endif /* rseq-percpu.h */
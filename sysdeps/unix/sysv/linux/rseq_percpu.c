@@ -0,0 +1,102 @@
+/* Per-CPU operations with restartable sequences.  Linux version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <atomic.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <sys/rseq.h>
+#include <rseq-internal.h>
+#include <rseq-percpu.h>
+
+/* With restartable sequences, the element of the current CPU is updated
+   with a plain instruction, which is restarted if the thread is
+   preempted, migrated or interrupted by a signal before it completes.
+   Without them, the thread may run on another CPU by the time it updates
+   the element, so an atomic operation is used instead.  */
+
+static inline intptr_t *
+percpu_element (intptr_t *base, size_t stride, int cpu)
+{
+  return (intptr_t *) ((char *) base + (size_t) cpu * stride);
+}
+
+/* Return the CPU the thread runs on, or zero if it is unknown.  */
+static int
+percpu_current_cpu (void)
+{
+  int cpu = RSEQ_GETMEM_ONCE (cpu_id);
+  if (__glibc_likely (cpu >= 0))
+    return cpu;
+  unsigned int ucpu;
+  if (__getcpu (&ucpu, NULL) != 0)
+    return 0;
+  return ucpu;
+}
+
+static inline int
+percpu_add (intptr_t *base, size_t stride, intptr_t value)
+{
+#if RSEQ_PERCPU_HAVE_CS
+  while (true)
+    {
+      int cpu = RSEQ_GETMEM_ONCE (cpu_id);
+      if (__glibc_unlikely (cpu < 0))
+	/* rseq is not registered.  */
+	break;
+      if (rseq_percpu_cs_add (percpu_element (base, stride, cpu), value, cpu))
+	return cpu;
+    }
+#endif
+
+  int cpu = percpu_current_cpu ();
+  atomic_fetch_add_relaxed (percpu_element (base, stride, cpu), value);
+  return cpu;
+}
+
+int
+rseq_percpu_add (intptr_t *base, size_t stride, intptr_t value)
+{
+  return percpu_add (base, stride, value);
+}
+
+int
+rseq_percpu_inc (intptr_t *base, size_t stride)
+{
+  return percpu_add (base, stride, 1);
+}
+
+int
+rseq_percpu_cmpstore (intptr_t *base, size_t stride, int cpu,
+		      intptr_t expected, intptr_t newval)
+{
+  intptr_t *p = percpu_element (base, stride, cpu);
+
+#if RSEQ_PERCPU_HAVE_CS
+  if (__glibc_likely (RSEQ_GETMEM_ONCE (cpu_id) >= 0))
+    return rseq_percpu_cs_cmpstore (p, expected, newval, cpu);
+#endif
+
+  if (percpu_current_cpu () != cpu)
+    return -1;
+  intptr_t old = expected;
+  if (atomic_compare_exchange_weak_release (p, &old, newval))
+    return 0;
+  /* A spurious failure is reported like a migration, so that the caller
+     retries.  */
+  return old != expected ? 1 : -1;
+}
@@ -0,0 +1,103 @@
+/* Waiting on several futexes.  Linux specific.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef _SYS_FUTEX_H
+#define _SYS_FUTEX_H	1
+
+#include <features.h>
+#include <bits/stdint-uintn.h>
+#include <bits/types/clockid_t.h>
+#include <bits/types/struct_timespec.h>
+
+/* Use the definitions of the kernel headers if they are available, so
+   that both can be included.  They conflict with the internal
+   definitions of the library itself.  */
+#if defined __has_include && !defined _LIBC
+# if __has_include ("linux/futex.h")
+#  include "linux/futex.h"
+# endif
+#endif
+
+/* Flags of the futexes in a struct futex_waitv.  futex_waitv only
+   supports 32-bit futex words.  */
+#ifndef FUTEX2_SIZE_U32
+# define FUTEX2_SIZE_U32	0x02
+#endif
+#ifndef FUTEX2_PRIVATE
+# define FUTEX2_PRIVATE		128 /* The futex is not shared with
+					other processes.  */
+#endif
+#ifndef FUTEX_32
+# define FUTEX_32		FUTEX2_SIZE_U32
+#endif
+
+/* The kernel headers define struct futex_waitv along with
+   FUTEX_WAITV_MAX.  */
+#ifndef FUTEX_WAITV_MAX
+/* The maximum number of futexes of a futex_waitv call.  */
+# define FUTEX_WAITV_MAX	128
+
+/* A futex to wait on with futex_waitv.  */
+struct futex_waitv
+{
+  /* The expected value of the futex word.  */
+  __uint64_t val;
+  /* The address of the futex word.  */
+  __uint64_t uaddr;
+  /* The FUTEX2_* flags of the futex.  */
+  __uint32_t flags;
+  /* Must be zero.  */
+  __uint32_t __reserved;
+};
+#endif
+
+__BEGIN_DECLS
+
+/* Wait until one of the NR_FUTEXES futexes of WAITERS is woken, if each
+   of them has its expected value.  Return the index in WAITERS of a
+   woken futex, or -1 and set errno: EAGAIN if the value of one of the
+   futexes was not the expected one, ETIMEDOUT if the absolute time
+   TIMEOUT, measured against CLOCKID, passed.  TIMEOUT may be NULL to wait
+   indefinitely.  FLAGS is reserved and must be zero.  Fail with ENOSYS
+   on kernels older than Linux 5.16, which lack the system call; there is
+   no fallback, since a thread cannot wait on several futexes otherwise.
+
+   This function is a cancellation point and therefore not marked with
+   __THROW.  */
+#ifndef __USE_TIME64_REDIRECTS
+extern int futex_waitv (struct futex_waitv *__waiters,
+			unsigned int __nr_futexes, unsigned int __flags,
+			const struct timespec *__timeout, clockid_t __clockid)
+     __nonnull ((1));
+#else
+# ifdef __REDIRECT
+extern int __REDIRECT (futex_waitv, (struct futex_waitv *__waiters,
+				     unsigned int __nr_futexes,
+				     unsigned int __flags,
+				     const struct timespec *__timeout,
+				     clockid_t __clockid),
+		       __futex_waitv_time64)
+     __nonnull ((1));
+# else
+#  define futex_waitv __futex_waitv_time64
+# endif
+#endif
+
+__END_DECLS
+
+#endif /* sys/futex.h */
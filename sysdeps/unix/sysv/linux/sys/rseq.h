@@ -177,4 +177,32 @@ extern const unsigned int __rseq_size;
 /* Flags used during rseq registration.  */
 extern const unsigned int __rseq_flags;
 
+__BEGIN_DECLS
+
+/* Per-CPU operations on an array of intptr_t elements, starting at BASE
+   and STRIDE bytes apart, with one element for each possible CPU.  The
+   element of the CPU the calling thread runs on is updated with a
+   restartable sequence, without an atomic read-modify-write operation.
+   Other threads may only read the elements.  */
+
+/* Add VALUE to the element of the current CPU.  Return the number of
+   the CPU.  */
+extern int rseq_percpu_add (intptr_t *__base, size_t __stride,
+			    intptr_t __value) __THROW __nonnull ((1));
+
+/* Add 1 to the element of the current CPU.  Return the number of the
+   CPU.  */
+extern int rseq_percpu_inc (intptr_t *__base, size_t __stride)
+     __THROW __nonnull ((1));
+
+/* If the calling thread runs on CPU and its element is EXPECTED, store
+   NEWVAL in it and return 0.  Return 1 if the element is not EXPECTED,
+   and -1 if the thread does not run on CPU or was interrupted, in which
+   case the operation may be retried.  */
+extern int rseq_percpu_cmpstore (intptr_t *__base, size_t __stride,
+				 int __cpu, intptr_t __expected,
+				 intptr_t __newval) __THROW __nonnull ((1));
+
+__END_DECLS
+
 #endif /* sys/rseq.h */
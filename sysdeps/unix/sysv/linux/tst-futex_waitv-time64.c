@@ -0,0 +1 @@
+#include "tst-futex_waitv.c"
@@ -0,0 +1,132 @@
+/* Basic tests for futex_waitv.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/futex.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include <support/check.h>
+#include <support/timespec.h>
+#include <support/xthread.h>
+#include <support/xtime.h>
+
+enum { nr_futexes = 4 };
+
+static _Atomic unsigned int words[nr_futexes];
+static struct futex_waitv waiters[nr_futexes];
+
+static void
+futex_wake (_Atomic unsigned int *futexp)
+{
+#ifdef __NR_futex
+  syscall (__NR_futex, futexp, FUTEX_WAKE_PRIVATE, 1);
+#else
+  syscall (__NR_futex_time64, futexp, FUTEX_WAKE_PRIVATE, 1);
+#endif
+}
+
+static void *
+waker (void *closure)
+{
+  _Atomic unsigned int *futexp = closure;
+  /* Let the main thread block, although the test also passes if it
+     does not.  */
+  usleep (10000);
+  atomic_store (futexp, 1);
+  futex_wake (futexp);
+  return NULL;
+}
+
+static void
+init_waiters (void)
+{
+  for (int i = 0; i < nr_futexes; i++)
+    {
+      atomic_store (&words[i], 0);
+      waiters[i] = (struct futex_waitv)
+	{
+	  .val = 0,
+	  .uaddr = (uintptr_t) &words[i],
+	  .flags = FUTEX_32 | FUTEX2_PRIVATE
+	};
+    }
+}
+
+static int
+do_test (void)
+{
+  init_waiters ();
+
+  /* All the futexes have a different value than expected.  */
+  atomic_store (&words[2], 1);
+  if (futex_waitv (waiters, nr_futexes, 0, NULL, CLOCK_MONOTONIC) == -1
+      && errno == ENOSYS)
+    FAIL_UNSUPPORTED ("futex_waitv is not supported by the kernel");
+  TEST_COMPARE (errno, EAGAIN);
+
+  /* The timeout expires.  */
+  init_waiters ();
+  struct timespec ts = timespec_add (xclock_now (CLOCK_MONOTONIC),
+				     make_timespec (0, 100000000));
+  TEST_COMPARE (futex_waitv (waiters, nr_futexes, 0, &ts, CLOCK_MONOTONIC),
+		-1);
+  TEST_COMPARE (errno, ETIMEDOUT);
+  TEST_VERIFY (support_timespec_check_in_range
+	       (ts, xclock_now (CLOCK_MONOTONIC), 1.0, 2.0));
+
+  /* A timeout against CLOCK_REALTIME.  */
+  ts = timespec_add (xclock_now (CLOCK_REALTIME),
+		     make_timespec (0, 10000000));
+  TEST_COMPARE (futex_waitv (waiters, nr_futexes, 0, &ts, CLOCK_REALTIME),
+		-1);
+  TEST_COMPARE (errno, ETIMEDOUT);
+
+  /* Each of the futexes wakes up the waiter.  */
+  for (int i = 0; i < nr_futexes; i++)
+    {
+      init_waiters ();
+      pthread_t thr = xpthread_create (NULL, waker, &words[i]);
+      int r;
+      /* Retry on spurious wake-ups.  */
+      while ((r = futex_waitv (waiters, nr_futexes, 0, NULL,
+			       CLOCK_MONOTONIC)) == -1
+	     && errno == EINTR)
+	;
+      if (r == -1)
+	TEST_COMPARE (errno, EAGAIN);
+      else
+	TEST_COMPARE (r, i);
+      TEST_COMPARE (atomic_load (&words[i]), 1);
+      xpthread_join (thr);
+    }
+
+  /* Unsupported flags.  */
+  init_waiters ();
+  TEST_COMPARE (futex_waitv (waiters, nr_futexes, 1, NULL, CLOCK_MONOTONIC),
+		-1);
+  TEST_COMPARE (errno, EINVAL);
+
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,145 @@
+/* Test the per-CPU operations of <sys/rseq.h>.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Several threads update per-CPU counters with each operation, and the
+   sums of the counters must account for every update.  The test is also
+   run with rseq disabled, where the operations fall back to atomic
+   instructions.  */
+
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/rseq.h>
+#include <sys/sysinfo.h>
+
+#include <support/check.h>
+#include <support/support.h>
+#include <support/xthread.h>
+
+enum { threads = 8 };
+enum { iterations = 100000 };
+
+/* Keep the elements of each CPU on their own cache line.  */
+enum { stride = 64 };
+
+static int nprocs;
+static intptr_t *incs;
+static intptr_t *adds;
+static intptr_t *stores;
+
+static intptr_t *
+element (intptr_t *base, int cpu)
+{
+  return (intptr_t *) ((char *) base + cpu * stride);
+}
+
+static intptr_t
+sum (intptr_t *base)
+{
+  intptr_t total = 0;
+  for (int cpu = 0; cpu < nprocs; cpu++)
+    total += *element (base, cpu);
+  return total;
+}
+
+static void *
+update (void *closure)
+{
+  for (int i = 0; i < iterations; i++)
+    {
+      int cpu = rseq_percpu_inc (incs, stride);
+      TEST_VERIFY (cpu >= 0 && cpu < nprocs);
+      cpu = rseq_percpu_add (adds, stride, 3);
+      TEST_VERIFY (cpu >= 0 && cpu < nprocs);
+
+      /* Increment with a compare-and-store.  */
+      while (true)
+	{
+	  cpu = sched_getcpu ();
+	  TEST_VERIFY_EXIT (cpu >= 0 && cpu < nprocs);
+	  intptr_t value = *element (stores, cpu);
+	  int ret = rseq_percpu_cmpstore (stores, stride, cpu, value,
+					  value + 1);
+	  if (ret == 0)
+	    break;
+	  TEST_VERIFY (ret == 1 || ret == -1);
+	}
+    }
+  return NULL;
+}
+
+static int
+do_test (void)
+{
+#ifdef RSEQ_DISABLED
+  TEST_COMPARE (__rseq_size, 0);
+#endif
+
+  nprocs = get_nprocs_conf ();
+  incs = xcalloc (nprocs, stride);
+  adds = xcalloc (nprocs, stride);
+  stores = xcalloc (nprocs, stride);
+
+  pthread_t thr[threads];
+  for (int i = 0; i < threads; i++)
+    thr[i] = xpthread_create (NULL, update, NULL);
+  for (int i = 0; i < threads; i++)
+    xpthread_join (thr[i]);
+
+  TEST_COMPARE (sum (incs), threads * iterations);
+  TEST_COMPARE (sum (adds), 3 * threads * iterations);
+  TEST_COMPARE (sum (stores), threads * iterations);
+
+  /* Pin the thread, so that it knows on which CPU it runs.  */
+  int cpu = sched_getcpu ();
+  cpu_set_t set;
+  CPU_ZERO (&set);
+  CPU_SET (cpu, &set);
+  if (sched_setaffinity (0, sizeof set, &set) == 0)
+    {
+      intptr_t value = *element (stores, cpu);
+      TEST_COMPARE (rseq_percpu_cmpstore (stores, stride, cpu, value + 1, 0),
+		    1);
+      TEST_COMPARE (*element (stores, cpu), value);
+
+      /* The sequence may still be aborted by preemption.  */
+      int ret;
+      do
+	ret = rseq_percpu_cmpstore (stores, stride, cpu, value, value + 1);
+      while (ret == -1);
+      TEST_COMPARE (ret, 0);
+      TEST_COMPARE (*element (stores, cpu), value + 1);
+
+      if (nprocs > 1)
+	{
+	  int other = (cpu + 1) % nprocs;
+	  value = *element (stores, other);
+	  TEST_COMPARE (rseq_percpu_cmpstore (stores, stride, other, value, 0),
+			-1);
+	  TEST_COMPARE (*element (stores, other), value);
+	}
+    }
+
+  free (incs);
+  free (adds);
+  free (stores);
+  return 0;
+}
+
+#include <support/test-driver.c>
@@ -0,0 +1,107 @@
+/* Restartable sequences for per-CPU data.  x86_64 version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef RSEQ_PERCPU_H
+#define RSEQ_PERCPU_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <rseq-internal.h>
+
+#define RSEQ_PERCPU_HAVE_CS 1
+
+/* Define at label 3 the struct rseq_cs of the critical section from
+   label 1 to label 2, whose abort handler is at label 4.  It has
+   relocations, so it goes in RELRO memory.  */
+#define RSEQ_PERCPU_CS_TABLE \
+  ".pushsection .data.rel.ro,\"aw\"\n\t"				\
+  ".balign 32\n"							\
+  "3:\n\t"								\
+  ".long 0, 0\n\t"							\
+  ".quad 1f, 2f - 1f, 4f\n\t"						\
+  ".popsection\n\t"
+
+/* Make the critical section active, and abort it if the thread does not
+   run on CPU.  The operands of RSEQ_PERCPU_CS_OPERANDS are used.  */
+#define RSEQ_PERCPU_CS_START \
+  "leaq 3b(%%rip), %%rax\n\t"						\
+  "movq %%rax, %%fs:%c[rseq_cs](%[offset])\n"				\
+  "1:\n\t"								\
+  "cmpl %[cpu], %%fs:%c[cpu_id](%[offset])\n\t"				\
+  "jnz 4f\n\t"
+
+#define RSEQ_PERCPU_CS_OPERANDS \
+  [offset] "r" (__rseq_offset),						\
+  [rseq_cs] "i" (offsetof (struct rseq_area, rseq_cs)),		\
+  [cpu_id] "i" (offsetof (struct rseq_area, cpu_id)),			\
+  [sig] "i" (RSEQ_SIG)
+
+/* The abort handler, preceded by the signature the kernel checks.  The
+   signature is encoded as ud1 RSEQ_SIG(%rip), %edi.  */
+#define RSEQ_PERCPU_CS_ABORT(label) \
+  ".pushsection .text.unlikely,\"ax\"\n\t"				\
+  ".byte 0x0f, 0xb9, 0x3d\n\t"						\
+  ".long %c[sig]\n"							\
+  "4:\n\t"								\
+  "jmp %l[" #label "]\n\t"						\
+  ".popsection\n\t"
+
+static __always_inline bool
+rseq_percpu_cs_add (intptr_t *p, intptr_t value, int cpu)
+{
+  __asm__ goto (RSEQ_PERCPU_CS_TABLE
+		RSEQ_PERCPU_CS_START
+		"addq %[value], (%[p])\n"
+		"2:\n\t"
+		RSEQ_PERCPU_CS_ABORT (abort)
+		:
+		: RSEQ_PERCPU_CS_OPERANDS, [cpu] "r" (cpu),
+		  [p] "r" (p), [value] "r" (value)
+		: "memory", "cc", "rax"
+		: abort);
+  return true;
+ abort:
+  return false;
+}
+
+static __always_inline int
+rseq_percpu_cs_cmpstore (intptr_t *p, intptr_t expected, intptr_t newval,
+			 int cpu)
+{
+  __asm__ goto (RSEQ_PERCPU_CS_TABLE
+		RSEQ_PERCPU_CS_START
+		"cmpq %[expected], (%[p])\n\t"
+		"jnz %l[mismatch]\n\t"
+		"movq %[newval], (%[p])\n"
+		"2:\n\t"
+		RSEQ_PERCPU_CS_ABORT (abort)
+		:
+		: RSEQ_PERCPU_CS_OPERANDS, [cpu] "r" (cpu),
+		  [p] "r" (p), [expected] "r" (expected),
+		  [newval] "r" (newval)
+		: "memory", "cc", "rax"
+		: abort, mismatch);
+  return 0;
+ mismatch:
+  return 1;
+ abort:
+  return -1;
+}
+
+#endif /* rseq-percpu.h */
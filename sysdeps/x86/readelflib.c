@@ -17,16 +17,18 @@
 
 int process_elf32_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 int process_elf64_file (const char *file_name, const char *lib,
 			int *flag, unsigned int *isa_level, char **soname,
-			void *file_contents, size_t file_length);
+			char **runpath, void *file_contents,
+			size_t file_length);
 
 /* Returns 0 if everything is ok, != 0 in case of error.  */
 int
 process_elf_file (const char *file_name, const char *lib, int *flag,
-		  unsigned int *isa_level, char **soname, void *file_contents,
-		  size_t file_length)
+		  unsigned int *isa_level, char **soname, char **runpath,
+		  void *file_contents, size_t file_length)
 {
   ElfW(Ehdr) *elf_header = (ElfW(Ehdr) *) file_contents;
   int ret, file_flag = 0;
@@ -53,10 +55,10 @@ process_elf_file (const char *file_name, const char *lib, int *flag,
 
   if (elf_header->e_ident[EI_CLASS] == ELFCLASS32)
     ret = process_elf32_file (file_name, lib, flag, isa_level, soname,
-			      file_contents, file_length);
+			      runpath, file_contents, file_length);
   else
     ret = process_elf64_file (file_name, lib, flag, isa_level, soname,
-			      file_contents, file_length);
+			      runpath, file_contents, file_length);
 
   if (!ret && file_flag)
     *flag = file_flag;
@@ -0,0 +1,67 @@
+/* Scan of the hash chains of DT_GNU_HASH tables.  x86-64 version.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* See sysdeps/generic/dl-gnu-hash-chain.h for documentation of this
+   interface.  */
+
+#ifndef _DL_GNU_HASH_CHAIN_H
+#define _DL_GNU_HASH_CHAIN_H
+
+#include <elf.h>
+#include <emmintrin.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Compare four entries at once with SSE2.  The loads are aligned to 16
+   bytes, so they do not cross a page boundary and cannot fault even if
+   they read past the end of the chain, or of the table.  */
+static __always_inline const Elf32_Word *
+_dl_gnu_hash_chain_find (const Elf32_Word *hasharr, Elf32_Word hash)
+{
+  uintptr_t misalign = (uintptr_t) hasharr & 15;
+  const __m128i *p = (const __m128i *) ((uintptr_t) hasharr - misalign);
+  const __m128i hashes = _mm_set1_epi32 (hash >> 1);
+  const __m128i ones = _mm_set1_epi32 (1);
+  /* One bit per byte of the loaded entries; ignore those before
+     HASHARR.  */
+  unsigned int valid = 0xffffu << misalign;
+
+  while (true)
+    {
+      __m128i v = _mm_load_si128 (p);
+      unsigned int match
+	= _mm_movemask_epi8 (_mm_cmpeq_epi32 (_mm_srli_epi32 (v, 1),
+					      hashes)) & valid;
+      unsigned int end
+	= _mm_movemask_epi8 (_mm_cmpeq_epi32 (_mm_and_si128 (v, ones),
+					      ones)) & valid;
+      if ((match | end) != 0)
+	{
+	  /* Entries after the end of the chain belong to other chains.  */
+	  if (match != 0
+	      && (end == 0 || __builtin_ctz (match) <= __builtin_ctz (end)))
+	    return (const Elf32_Word *) p + __builtin_ctz (match) / 4;
+	  return NULL;
+	}
+      ++p;
+      valid = 0xffffu;
+    }
+}
+
+#endif /* _DL_GNU_HASH_CHAIN_H */
@@ -0,0 +1,53 @@
+/* Multiple versions of memmem.
+   All versions must be listed in ifunc-impl-list.c.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Redefine memmem so that the compiler won't complain about the type
+   mismatch with the IFUNC selector in weak_alias, below.  */
+#undef  memmem
+#define memmem __redirect_memmem
+#undef  __memmem
+#define __memmem __redirect___memmem
+#include <string.h>
+#undef  memmem
+#undef  __memmem
+
+#define __memmem __memmem_generic
+#ifdef SHARED
+# undef libc_hidden_def
+# define libc_hidden_def(name) \
+  strong_alias (__memmem_generic, __memmem_generic_1); \
+  __hidden_ver1 (__memmem_generic, __GI___memmem, __memmem_generic);
+# undef libc_hidden_weak
+# define libc_hidden_weak(name) \
+  __hidden_ver1 (__memmem_generic_1, __GI_memmem, __memmem_generic_1) \
+  __attribute__ ((weak));
+#endif
+#undef static_weak_alias
+#define static_weak_alias(name, aliasname)
+
+extern __typeof (__redirect_memmem) __memmem_generic attribute_hidden;
+
+#include "string/memmem.c"
+#undef __memmem
+
+#define SYMBOL_NAME memmem
+#include "ifunc-strstr.h"
+
+libc_ifunc_redirected (__redirect___memmem, __memmem, IFUNC_SELECTOR ());
+weak_alias (__memmem, memmem)
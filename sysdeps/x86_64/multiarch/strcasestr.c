@@ -0,0 +1,42 @@
+/* Multiple versions of strcasestr.
+   All versions must be listed in ifunc-impl-list.c.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Redefine strcasestr so that the compiler won't complain about the type
+   mismatch with the IFUNC selector in weak_alias, below.  */
+#undef  strcasestr
+#define strcasestr __redirect_strcasestr
+#undef  __strcasestr
+#define __strcasestr __redirect___strcasestr
+#include <string.h>
+#undef  strcasestr
+#undef  __strcasestr
+
+#define STRCASESTR __strcasestr_generic
+#define NO_ALIAS
+
+extern __typeof (__redirect_strcasestr) __strcasestr_generic attribute_hidden;
+
+#include "string/strcasestr.c"
+
+#define SYMBOL_NAME strcasestr
+#include "ifunc-strstr.h"
+
+libc_ifunc_redirected (__redirect___strcasestr, __strcasestr,
+		       IFUNC_SELECTOR ());
+weak_alias (__strcasestr, strcasestr)
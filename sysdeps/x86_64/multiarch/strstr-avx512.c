@@ -0,0 +1,37 @@
+/* strstr with 512-bit AVX-512 vectors.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+#ifndef STRSTR
+# define STRSTR __strstr_avx512
+#endif
+
+#include <immintrin.h>
+#include <stdint.h>
+
+#define VEC_SIZE 64
+typedef __m512i vec_t;
+typedef __mmask64 mask_t;
+
+#define VEC_LOADU(p) _mm512_loadu_si512 (p)
+#define VEC_SET1(c) _mm512_set1_epi8 (c)
+#define VEC_OR(a, b) _mm512_or_si512 (a, b)
+#define VEC_EQ(a, b) _mm512_cmpeq_epi8_mask (a, b)
+#define VEC_EQ2(a1, b1, a2, b2) \
+  _mm512_mask_cmpeq_epi8_mask (_mm512_cmpeq_epi8_mask (a1, b1), a2, b2)
+
+#include "strstr-vec.h"
@@ -0,0 +1,248 @@
+/* strstr, memmem and strcasestr with wide vectors.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* The includer defines VEC_SIZE, the vector type vec_t, the mask type
+   mask_t and the operations VEC_LOADU, VEC_SET1, VEC_OR, VEC_EQ (the mask
+   of the equal bytes of two vectors) and VEC_EQ2 (the mask of the bytes
+   equal in both pairs of vectors).
+
+   For every VEC_SIZE positions of the haystack, the first and the last
+   character of the needle are compared with two vectors, loaded at the
+   position and NEEDLE_LEN - 1 bytes after it.  Only the positions where
+   both characters match are compared with the rest of the needle.  This
+   filter rejects almost all the positions for natural text, but not for
+   periodic inputs like "aaa...ab" where most positions are candidates.
+   The time spent comparing candidates is bounded by VERIFY_BUDGET plus
+   VERIFY_RATIO times the length of the haystack scanned so far: past it
+   the search continues with the generic implementation, whose two-way
+   algorithm is linear in the worst case.  */
+
+#include <immintrin.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#ifdef USE_AS_STRCASESTR
+# include <locale/localeinfo.h>
+#endif
+
+#ifndef STRSTR
+# error "STRSTR must be defined"
+#endif
+
+#define VERIFY_BUDGET 1024
+#define VERIFY_RATIO 4
+
+#ifndef PAGE_SIZE
+# define PAGE_SIZE 4096
+#endif
+
+/* Whether a vector load at P may cross into the next page.  */
+#define CROSS_PAGE(p) \
+  (((uintptr_t) (p) & (PAGE_SIZE - 1)) > PAGE_SIZE - VEC_SIZE)
+
+#ifdef USE_AS_MEMMEM
+# define RETURN_TYPE void *
+# define GENERIC __memmem_generic
+extern void *GENERIC (const void *, size_t, const void *, size_t)
+  attribute_hidden;
+#else
+# define RETURN_TYPE char *
+# ifdef USE_AS_STRCASESTR
+#  define GENERIC __strcasestr_generic
+# else
+#  define GENERIC __strstr_generic
+# endif
+extern char *GENERIC (const char *, const char *) attribute_hidden;
+#endif
+
+#ifdef USE_AS_STRCASESTR
+/* The vector filter and the comparison only fold the ASCII letters, so
+   they are used only if the locale has no other case mappings.  */
+static __always_inline unsigned char
+fold (unsigned char c)
+{
+  return (unsigned char) (c - 'A') < 26 ? c | 0x20 : c;
+}
+
+/* The bits to set in the haystack bytes before comparing them with C.  */
+static __always_inline unsigned char
+fold_bits (unsigned char c)
+{
+  return (unsigned char) ((c | 0x20) - 'a') < 26 ? 0x20 : 0;
+}
+
+# define FOLD(c) fold (c)
+# define VEC_FOLD(v, f) VEC_OR (v, f)
+#else
+# define FOLD(c) (c)
+# define VEC_FOLD(v, f) (v)
+#endif
+
+static __always_inline bool
+compare_rest (const unsigned char *hs, const unsigned char *ne, size_t len)
+{
+#ifdef USE_AS_STRCASESTR
+  for (size_t i = 0; i < len; i++)
+    if (fold (hs[i]) != fold (ne[i]))
+      return false;
+  return true;
+#else
+  return memcmp (hs, ne, len) == 0;
+#endif
+}
+
+/* Compare the rest of the needle at each of the positions of the bits
+   set in M, relative to P.  Return the first match, or give up on the
+   filter if comparing the candidates took too long.  */
+#define CHECK_CANDIDATES(p, m)						\
+  for (; m != 0; m &= m - 1)						\
+    {									\
+      const unsigned char *cand = (p) + __builtin_ctzll (m);		\
+      if (compare_rest (cand + 1, ne + 1, mid))		\
+	return (RETURN_TYPE) cand;					\
+      spent += mid + 1;							\
+      if (__glibc_unlikely (spent > VERIFY_BUDGET			\
+			    + VERIFY_RATIO * (size_t) (cand - hs)))	\
+	{								\
+	  next = cand + 1;						\
+	  goto two_way;							\
+	}								\
+    }
+
+#ifdef USE_AS_MEMMEM
+void *
+STRSTR (const void *haystack, size_t hs_len, const void *needle,
+	size_t ne_len)
+#else
+char *
+STRSTR (const char *haystack, const char *needle)
+#endif
+{
+  const unsigned char *hs = (const unsigned char *) haystack;
+  const unsigned char *ne = (const unsigned char *) needle;
+
+#ifdef USE_AS_MEMMEM
+  if (ne_len == 0)
+    return (void *) hs;
+  if (ne_len > hs_len)
+    return NULL;
+  if (ne_len == 1)
+    return memchr (hs, ne[0], hs_len);
+#else
+  if (ne[0] == '\0')
+    return (char *) hs;
+# ifdef USE_AS_STRCASESTR
+  if (_NL_CURRENT_WORD (LC_CTYPE, _NL_CTYPE_NONASCII_CASE) != 0)
+    return GENERIC (haystack, needle);
+# else
+  if (ne[1] == '\0')
+    return strchr (haystack, ne[0]);
+# endif
+  size_t ne_len = strlen (needle);
+  /* The loads below are safe if the bytes before the last one compared
+     with the last character of the needle are part of the string.  */
+  if (__strnlen (haystack, ne_len - 1) < ne_len - 1)
+    return NULL;
+#endif
+
+  const size_t last = ne_len - 1;
+  const size_t mid = ne_len > 2 ? ne_len - 2 : 0;
+  const unsigned char first_c = FOLD (ne[0]);
+  const unsigned char last_c = FOLD (ne[last]);
+  const vec_t first = VEC_SET1 (first_c);
+  const vec_t lastv = VEC_SET1 (last_c);
+#ifdef USE_AS_STRCASESTR
+  const vec_t first_f = VEC_SET1 (fold_bits (ne[0]));
+  const vec_t last_f = VEC_SET1 (fold_bits (ne[last]));
+#endif
+  size_t spent = 0;
+  const unsigned char *next;
+  const unsigned char *p = hs;
+
+#ifdef USE_AS_MEMMEM
+  const unsigned char *const end = hs + hs_len;
+
+  /* The number of positions left to check is END - LAST - P.  */
+  for (; (size_t) (end - p) - last >= VEC_SIZE; p += VEC_SIZE)
+    {
+      mask_t m = VEC_EQ2 (VEC_LOADU (p), first,
+			  VEC_LOADU (p + last), lastv);
+      CHECK_CANDIDATES (p, m);
+    }
+
+  size_t left = (size_t) (end - p) - last;
+  if (left == 0)
+    return NULL;
+
+  mask_t m = 0;
+  if (!CROSS_PAGE (p + last))
+    /* The haystack has at least NEEDLE_LEN bytes from P, so both loads
+       stay within the page of the last byte of the second one.  */
+    m = (VEC_EQ2 (VEC_LOADU (p), first, VEC_LOADU (p + last), lastv)
+	 & (((mask_t) 1 << left) - 1));
+  else
+    for (size_t i = 0; i < left; i++)
+      m |= (mask_t) (p[i] == first_c && p[last + i] == last_c) << i;
+  CHECK_CANDIDATES (p, m);
+  return NULL;
+
+ two_way:
+  return GENERIC (next, end - next, ne, ne_len);
+#else
+  const vec_t zero = VEC_SET1 (0);
+
+  while (true)
+    {
+      if (__glibc_unlikely (CROSS_PAGE (p + last)))
+	{
+	  /* The end of the haystack may be in this page: check this block
+	     one byte at a time.  */
+	  mask_t m = 0;
+	  size_t i;
+	  for (i = 0; i < VEC_SIZE && p[last + i] != '\0'; i++)
+	    m |= ((mask_t) (FOLD (p[i]) == first_c
+			    && FOLD (p[last + i]) == last_c) << i);
+	  CHECK_CANDIDATES (p, m);
+	  if (i < VEC_SIZE)
+	    return NULL;
+	}
+      else
+	{
+	  vec_t v1 = VEC_LOADU (p);
+	  vec_t v2 = VEC_LOADU (p + last);
+	  mask_t m = VEC_EQ2 (VEC_FOLD (v1, first_f), first,
+			      VEC_FOLD (v2, last_f), lastv);
+	  mask_t z = VEC_EQ (v2, zero);
+	  if ((m | z) != 0)
+	    {
+	      /* Only the positions before the end of the string are
+		 candidates.  */
+	      if (z != 0)
+		m &= z - 1;
+	      CHECK_CANDIDATES (p, m);
+	      if (z != 0)
+		return NULL;
+	    }
+	}
+      p += VEC_SIZE;
+    }
+
+ two_way:
+  return GENERIC ((const char *) next, needle);
+#endif
+}
@@ -31,23 +31,13 @@
   __hidden_ver1 (__strstr_generic, __GI_strstr, __strstr_generic);
 #endif
 
-extern __typeof (__redirect_strstr) __strstr_sse2_unaligned attribute_hidden;
 extern __typeof (__redirect_strstr) __strstr_generic attribute_hidden;
 
 #include "string/strstr.c"
 
-#include "init-arch.h"
-
-static inline void *
-IFUNC_SELECTOR (void)
-{
-  const struct cpu_features *cpu_features = __get_cpu_features ();
-
-  if (CPU_FEATURES_ARCH_P (cpu_features, Fast_Unaligned_Load))
-    return __strstr_sse2_unaligned;
-
-  return __strstr_generic;
-}
+#define SYMBOL_NAME strstr
+#define USE_SSE2_UNALIGNED
+#include "ifunc-strstr.h"
 
 libc_ifunc_redirected (__redirect_strstr, __libc_strstr, IFUNC_SELECTOR ());
 #undef strstr
@@ -0,0 +1,137 @@
+/* Test the x86-64 scan of the hash chains of DT_GNU_HASH tables.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+   This file is part of the GNU C Library.
+
+   The GNU C Library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   The GNU C Library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with the GNU C Library; if not, see
+   <https://www.gnu.org/licenses/>.  */
+
+/* Build hash chains starting at each 4-byte offset within 16 bytes, of
+   several lengths, with a matching entry before, at and after the entry
+   which ends the chain, and surrounded by entries which would match but
+   belong to other chains.  Check that the SSE2 version returns the same
+   entry as the generic loop.  Also check that a chain which ends at the
+   end of a page does not fault.  */
+
+#include <dl-gnu-hash-chain.h>
+
+static const Elf32_Word *
+sse2_find (const Elf32_Word *hasharr, Elf32_Word hash)
+{
+  return _dl_gnu_hash_chain_find (hasharr, hash);
+}
+
+#undef _DL_GNU_HASH_CHAIN_H
+#define _dl_gnu_hash_chain_find generic_find
+#include <sysdeps/generic/dl-gnu-hash-chain.h>
+#undef _dl_gnu_hash_chain_find
+
+#include <stdio.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <support/check.h>
+#include <support/xunistd.h>
+
+/* The hash value searched for.  Its lowest bit is not compared.  */
+#define HASH 0x2468ace0u
+/* An entry of the chain which does not match.  */
+#define OTHER 0x13579bd0u
+
+enum { max_len = 12 };
+enum { nwords = 4 + max_len + 8 };
+
+/* Build in WORDS a chain of LEN entries starting at index START, with
+   HASH (and the end bit if LOW) at index MATCH, or no matching entry in
+   the chain if MATCH is negative.  The entries outside of the chain
+   match HASH, and those before it end their own chains.  */
+static void
+build_chain (Elf32_Word *words, int start, int len, int match, bool low)
+{
+  for (int i = 0; i < nwords; i++)
+    words[i] = HASH | (i < start);
+  for (int i = start; i < start + len; i++)
+    words[i] = OTHER + 2 * i;
+  if (match >= 0)
+    words[match] = HASH | low;
+  words[start + len - 1] |= 1;
+}
+
+static void
+check (const Elf32_Word *words, int start, const char *what)
+{
+  const Elf32_Word *expected = generic_find (words + start, HASH);
+  const Elf32_Word *result = sse2_find (words + start, HASH);
+  if (result != expected)
+    FAIL ("%s: start %d: got entry %td, expected %td", what, start,
+	  result == NULL ? (ptrdiff_t) -1 : result - words,
+	  expected == NULL ? (ptrdiff_t) -1 : expected - words);
+}
+
+static int
+do_test (void)
+{
+  _Alignas (16) Elf32_Word words[nwords];
+
+  for (int start = 0; start < 4; start++)
+    for (int len = 1; len <= max_len; len++)
+      {
+	int end = start + len - 1;
+
+	/* No match in the chain, but matching entries after it.  */
+	build_chain (words, start, len, -1, false);
+	check (words, start, "no match");
+	TEST_VERIFY (sse2_find (words + start, HASH) == NULL);
+
+	/* A match before the end, at the end, and just after the end of
+	   the chain, which belongs to the next chain.  */
+	for (int match = start; match <= end + 1; match++)
+	  for (int low = 0; low < 2; low++)
+	    {
+	      if (match <= end)
+		build_chain (words, start, len, match, low);
+	      else
+		{
+		  build_chain (words, start, len, -1, false);
+		  for (int i = end + 1; i < nwords; i++)
+		    words[i] = OTHER;
+		  words[match] = HASH | low;
+		}
+	      check (words, start, "match");
+	      TEST_VERIFY ((sse2_find (words + start, HASH) != NULL)
+			   == (match <= end));
+	    }
+      }
+
+  /* The aligned loads must not read past the page which holds the end
+     of the chain.  */
+  long int pagesize = sysconf (_SC_PAGESIZE);
+  char *pages = xmmap (NULL, 2 * pagesize, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1);
+  xmprotect (pages + pagesize, pagesize, PROT_NONE);
+  Elf32_Word *page_end = (Elf32_Word *) (pages + pagesize);
+  for (int len = 1; len <= max_len; len++)
+    {
+      Elf32_Word *chain = page_end - len;
+      for (int i = 0; i < len; i++)
+	chain[i] = OTHER + 2 * i;
+      chain[len - 1] |= 1;
+      TEST_VERIFY (sse2_find (chain, HASH) == NULL);
+      chain[len - 1] = HASH | 1;
+      TEST_VERIFY (sse2_find (chain, HASH) == chain + len - 1);
+    }
+  xmunmap (pages, 2 * pagesize);
+
+  return 0;
+}
+
+#include <support/test-driver.c>